@@ -0,0 +1,85 @@
+#pragma once
+#include "core/logging.hpp"
+#include "psl/library.hpp"
+#include "psl/ustring.hpp"
+#include "spdlog/sinks/null_sink.h"
+#include <filesystem>
+#include <fstream>
+#if defined(PE_GLES) && defined(SURFACE_XCB)
+	#include <EGL/egl.h>
+	#include <EGL/eglext.h>
+#endif
+
+// None of the benchmarks need a surface. The Vulkan benchmarks can be run on lavapipe, and the GLES benchmarks use a
+// surfaceless EGL context (see egl_context), so they can be run headless on Mesa's llvmpipe:
+//   VK_ICD_FILENAMES=<path to lvp_icd.json> benchmarks --benchmark_filter=<name>
+//   LIBGL_ALWAYS_SOFTWARE=1 benchmarks --benchmark_filter=<name>
+namespace benchmarks {
+/// \brief replaces the loggers of core with ones that discard everything, so logging does not skew the measurements.
+inline void setup_logging() {
+	if(core::log)
+		return;
+	core::log		= spdlog::null_logger_mt("main");
+	core::data::log = spdlog::null_logger_mt("data");
+	core::gfx::log	= spdlog::null_logger_mt("gfx");
+#ifdef PE_VULKAN
+	core::ivk::log = spdlog::null_logger_mt("ivk");
+#endif
+#ifdef PE_GLES
+	core::igles::log = spdlog::null_logger_mt("igles");
+#endif
+}
+
+/// \returns an empty meta::library, stored in its own folder in the temporary directory.
+/// \param[in] name the name of the benchmark, the library is stored at `<temp>/<name>/<name>.metalib`.
+inline psl::meta::library make_library(const std::string& name) {
+	auto folder = std::filesystem::temp_directory_path() / name;
+	std::filesystem::create_directories(folder);
+	auto path = folder / (name + ".metalib");
+	if(!std::filesystem::exists(path))
+		std::ofstream {path};
+	return psl::meta::library {psl::to_string8_t(path.string())};
+}
+
+/// \returns an empty meta::library with an entry that is backed by a file next to the library, so that resources
+/// created for it (such as the pipeline caches) persist their content between runs.
+/// \param[in] name the name of the benchmark, see make_library(name).
+/// \param[in] uid the psl::UID of the entry.
+/// \param[in] filename the name of the file that backs the entry.
+inline psl::meta::library make_library(const std::string& name, const psl::UID& uid, psl::string8::view filename) {
+	auto library = make_library(name);
+	library.create_physical(uid, filename);
+	return library;
+}
+
+#if defined(PE_GLES) && defined(SURFACE_XCB)
+/// \brief surfaceless GLES 3 context, which is made current on the calling thread for its lifetime.
+struct egl_context {
+	egl_context() {
+		auto getPlatformDisplay =
+		  reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+		display = (getPlatformDisplay) ? getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr)
+									   : eglGetDisplay(EGL_DEFAULT_DISPLAY);
+		eglInitialize(display, nullptr, nullptr);
+		eglBindAPI(EGL_OPENGL_ES_API);
+
+		EGLint const attributes[] = {EGL_RENDERABLE_TYPE, EGL_OPENGL_ES3_BIT, EGL_NONE};
+		EGLConfig config {nullptr};
+		EGLint count {0};
+		eglChooseConfig(display, attributes, &config, 1, &count);
+
+		const EGLint context_attributes[] = {EGL_CONTEXT_CLIENT_VERSION, 3, EGL_NONE};
+		context = eglCreateContext(display, config, EGL_NO_CONTEXT, context_attributes);
+		eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context);
+	}
+	~egl_context() {
+		eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		eglDestroyContext(display, context);
+		eglTerminate(display);
+	}
+
+	EGLDisplay display {EGL_NO_DISPLAY};
+	EGLContext context {EGL_NO_CONTEXT};
+};
+#endif
+}	 // namespace benchmarks
@@ -0,0 +1,83 @@
+#ifdef PE_VULKAN
+	#include "benchmark_utils.hpp"
+	#include "core/data/buffer.hpp"
+	#include "core/resource/resource.hpp"
+	#include "core/vk/buffer.hpp"
+	#include "core/vk/context.hpp"
+	#include "core/vk/staging_ring.hpp"
+	#include <benchmark/benchmark.h>
+	#include <vector>
+
+using namespace core::resource;
+using namespace benchmarks;
+
+// Measures copying 10k small regions from a host visible buffer into a device local one with
+// core::ivk::buffer_t::copy_from, which waits for every copy to complete, against copy_from_async, which only waits
+// for the copy of the previous iteration, so that recording and executing copies overlaps.
+// The regions are either scattered, or contiguous so that they are merged into a single region.
+namespace {
+constexpr size_t region_count {10000};
+constexpr vk::DeviceSize region_size {32};
+
+struct buffers_t {
+	handle<core::ivk::buffer_t> source;
+	handle<core::ivk::buffer_t> destination;
+	std::vector<vk::BufferCopy> regions;
+};
+
+buffers_t create_buffers(cache_t& cache, handle<core::ivk::context> context, bool contiguous) {
+	constexpr size_t size {region_count * region_size * 2};
+	auto sourceData = cache.create<core::data::buffer_t>(
+	  core::gfx::memory_usage::transfer_source,
+	  core::gfx::memory_property::host_visible | core::gfx::memory_property::host_coherent,
+	  memory::region {size, 4, new memory::default_allocator(false)});
+	auto destinationData =
+	  cache.create<core::data::buffer_t>(core::gfx::memory_usage::transfer_destination,
+										 core::gfx::memory_property::device_local,
+										 memory::region {size, 4, new memory::default_allocator(false)});
+
+	buffers_t buffers {cache.create<core::ivk::buffer_t>(context, sourceData),
+					   cache.create<core::ivk::buffer_t>(context, destinationData),
+					   {}};
+	const vk::DeviceSize stride = (contiguous) ? region_size : region_size * 2;
+	for(size_t i = 0; i < region_count; ++i)
+		buffers.regions.emplace_back(i * region_size, i * stride, region_size);
+	return buffers;
+}
+
+void buffer_copy_blocking(benchmark::State& gState) {
+	setup_logging();
+	cache_t cache {make_library("buffer_copy_benchmark")};
+	auto context = cache.create<core::ivk::context>(psl::string8_t {"buffer_copy_benchmark"});
+	auto buffers = create_buffers(cache, context, gState.range(0) != 0);
+
+	for(auto _ : gState) {
+		benchmark::DoNotOptimize(buffers.destination->copy_from(buffers.source.value(), buffers.regions));
+	}
+	gState.SetItemsProcessed(gState.iterations() * region_count);
+}
+
+void buffer_copy_async(benchmark::State& gState) {
+	setup_logging();
+	cache_t cache {make_library("buffer_copy_benchmark")};
+	auto context  = cache.create<core::ivk::context>(psl::string8_t {"buffer_copy_benchmark"});
+	auto buffers  = create_buffers(cache, context, gState.range(0) != 0);
+	auto& staging = context->staging();
+
+	uint64_t previous {0};
+	for(auto _ : gState) {
+		auto completion = buffers.destination->copy_from_async(buffers.source.value(), buffers.regions);
+		staging.submit();
+		if(previous != 0)
+			staging.wait(previous);
+		previous = completion.value_or(0);
+	}
+	if(previous != 0)
+		staging.wait(previous);
+	gState.SetItemsProcessed(gState.iterations() * region_count);
+}
+}	 // namespace
+
+BENCHMARK(buffer_copy_blocking)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond)->UseRealTime();
+BENCHMARK(buffer_copy_async)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond)->UseRealTime();
+#endif
@@ -0,0 +1,88 @@
+#include "core/ecs/components/transform.hpp"
+#include "psl/math/culling.hpp"
+#include "psl/math/math.hpp"
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+using namespace psl;
+using core::ecs::components::transform;
+
+// Measures frustum culling of 1M entities spread around a camera: deriving their world space bounds from their
+// transform, and testing those bounds against the frustum, once box by box with the scalar reference, and once
+// batched through psl::math::cull.
+namespace {
+constexpr size_t entity_count {1'000'000};
+
+struct scene {
+	scene() {
+		std::mt19937 generator {42};
+		std::uniform_real_distribution<float> position {-500.0f, 500.0f};
+		std::uniform_real_distribution<float> unit {-1.0f, 1.0f};
+		transforms.reserve(entity_count);
+		for(size_t i = 0; i < entity_count; ++i) {
+			transforms.emplace_back(vec3 {position(generator), position(generator), position(generator)},
+									vec3 {1.0f + unit(generator) * 0.5f},
+									math::normalize(quat {unit(generator), unit(generator), unit(generator), 1.0f}));
+		}
+		models.resize(entity_count);
+		math::compose(std::begin(transforms), std::end(transforms), models.data());
+		boxes.resize(entity_count);
+		for(size_t i = 0; i < entity_count; ++i) boxes.set(i, math::transform(local, models[i]));
+
+		frustum = math::to_frustum(math::perspective_projection(math::radians(60.0f), 16.0f / 9.0f, 0.1f, 400.0f) *
+								   math::look_at(vec3::zero, vec3 {0.0f, 0.0f, 1.0f}, vec3::up));
+		visible.resize(entity_count);
+	}
+
+	const aabb local {vec3::zero, vec3::one};
+	std::vector<transform> transforms;
+	std::vector<mat4x4> models;
+	aabb_array boxes;
+	psl::frustum frustum;
+	std::vector<uint32_t> visible;
+};
+
+scene& get_scene() {
+	static scene instance {};
+	return instance;
+}
+
+void culling_bounds(benchmark::State& gState) {
+	auto& scene = get_scene();
+	for(auto _ : gState) {
+		math::compose(std::begin(scene.transforms), std::end(scene.transforms), scene.models.data());
+		for(size_t i = 0; i < entity_count; ++i) scene.boxes.set(i, math::transform(scene.local, scene.models[i]));
+		benchmark::ClobberMemory();
+	}
+	gState.SetItemsProcessed(gState.iterations() * entity_count);
+}
+
+void culling_scalar(benchmark::State& gState) {
+	auto& scene = get_scene();
+	for(auto _ : gState) {
+		size_t count {0};
+		for(size_t i = 0; i < entity_count; ++i) {
+			if(math::intersects(scene.frustum, scene.boxes.get(i)))
+				scene.visible[count++] = static_cast<uint32_t>(i);
+		}
+		benchmark::DoNotOptimize(count);
+		benchmark::ClobberMemory();
+	}
+	gState.SetItemsProcessed(gState.iterations() * entity_count);
+}
+
+void culling_batched(benchmark::State& gState) {
+	auto& scene = get_scene();
+	for(auto _ : gState) {
+		auto count = math::cull(scene.frustum, scene.boxes, 0, entity_count, scene.visible.data());
+		benchmark::DoNotOptimize(count);
+		benchmark::ClobberMemory();
+	}
+	gState.SetItemsProcessed(gState.iterations() * entity_count);
+}
+}	 // namespace
+
+BENCHMARK(culling_bounds)->Unit(benchmark::kMillisecond);
+BENCHMARK(culling_scalar)->Unit(benchmark::kMillisecond);
+BENCHMARK(culling_batched)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,144 @@
+#include "core/gfx/drawlist.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using core::gfx::drawlayer;
+using core::gfx::drawlist;
+
+// Measures the CPU cost of ordering the draws of a frame, and walking them as a backend would while recording. This
+// compares the nested loop the drawpasses used (gathering and sorting the render indices of every layer, then testing
+// every drawcall against every render index), against building a core::gfx::drawlist, radix sorting it, and walking it
+// linearly while skipping the material and geometry binds that are the same as those of the previous draw.
+// Only the CPU side is measured, the binds are counted instead of recorded.
+namespace {
+constexpr size_t layer_count {4};
+constexpr uint32_t render_indices_per_layer {16};
+constexpr size_t materials_per_render_index {8};
+constexpr size_t geometry_count {128};
+
+// a drawcall, as a bundle with a material per render index, and the geometry it draws
+struct drawcall_t {
+	size_t layer {0};
+	std::vector<uint32_t> renderIndices;
+	std::vector<size_t> materials;
+	std::vector<size_t> geometry;
+};
+
+struct scene_t {
+	std::vector<drawlayer> layers;
+	std::vector<drawcall_t> drawcalls;
+	std::vector<psl::UID> materials;
+	std::vector<psl::UID> geometry;
+};
+
+struct counters_t {
+	size_t materials {0};
+	size_t geometry {0};
+	size_t draws {0};
+};
+
+scene_t create_scene(size_t count) {
+	std::mt19937 generator {42};
+	scene_t scene {};
+	for(size_t i = 0; i < layer_count; ++i)
+		scene.layers.emplace_back(drawlayer {"layer", static_cast<uint32_t>(i * 1000), 1000});
+	for(size_t i = 0; i < layer_count * render_indices_per_layer * materials_per_render_index; ++i)
+		scene.materials.emplace_back(psl::UID::generate());
+	for(size_t i = 0; i < geometry_count; ++i) scene.geometry.emplace_back(psl::UID::generate());
+
+	std::uniform_int_distribution<size_t> layer {0, layer_count - 1};
+	std::uniform_int_distribution<uint32_t> renderIndex {0, render_indices_per_layer - 1};
+	std::uniform_int_distribution<size_t> material {0, materials_per_render_index - 1};
+	std::uniform_int_distribution<size_t> geometry {0, geometry_count - 1};
+	std::uniform_int_distribution<size_t> amount {1, 2};
+	for(size_t i = 0; i < count; ++i) {
+		auto& drawcall = scene.drawcalls.emplace_back();
+		drawcall.layer = layer(generator);
+		for(size_t n = amount(generator); n > 0; --n) {
+			const auto index = renderIndex(generator);
+			if(std::find(std::begin(drawcall.renderIndices), std::end(drawcall.renderIndices), index) !=
+			   std::end(drawcall.renderIndices))
+				continue;
+			drawcall.renderIndices.emplace_back(index);
+			drawcall.materials.emplace_back((drawcall.layer * render_indices_per_layer + index) *
+											  materials_per_render_index +
+											material(generator));
+		}
+		drawcall.geometry.emplace_back(geometry(generator));
+	}
+	return scene;
+}
+
+void drawlist_nested(benchmark::State& gState) {
+	const auto scene = create_scene(static_cast<size_t>(gState.range(0)));
+	for(auto _ : gState) {
+		counters_t counters {};
+		for(size_t layer = 0; layer < scene.layers.size(); ++layer) {
+			std::vector<uint32_t> renderIndices;
+			for(const auto& drawcall : scene.drawcalls) {
+				if(drawcall.layer == layer)
+					renderIndices.insert(
+					  std::end(renderIndices), std::begin(drawcall.renderIndices), std::end(drawcall.renderIndices));
+			}
+			std::sort(std::begin(renderIndices), std::end(renderIndices));
+			renderIndices.erase(std::unique(std::begin(renderIndices), std::end(renderIndices)),
+								std::end(renderIndices));
+			for(auto renderIndex : renderIndices) {
+				for(const auto& drawcall : scene.drawcalls) {
+					auto it =
+					  std::find(std::begin(drawcall.renderIndices), std::end(drawcall.renderIndices), renderIndex);
+					if(drawcall.layer != layer || it == std::end(drawcall.renderIndices))
+						continue;
+					// every drawcall binds its material, and every draw its geometry
+					++counters.materials;
+					counters.geometry += drawcall.geometry.size();
+					counters.draws += drawcall.geometry.size();
+				}
+			}
+		}
+		benchmark::DoNotOptimize(counters);
+		gState.counters["binds"] = static_cast<double>(counters.materials + counters.geometry);
+	}
+	gState.SetItemsProcessed(gState.iterations() * gState.range(0));
+}
+
+void drawlist_sorted(benchmark::State& gState) {
+	const auto scene = create_scene(static_cast<size_t>(gState.range(0)));
+	drawlist list {};
+	for(auto _ : gState) {
+		list.clear();
+		for(const auto& layer : scene.layers) list.add_layer(layer);
+		for(const auto& drawcall : scene.drawcalls) {
+			for(size_t i = 0; i < drawcall.renderIndices.size(); ++i) {
+				const auto material = list.id(scene.materials[drawcall.materials[i]]);
+				for(auto geometry : drawcall.geometry) {
+					const auto key = drawlist::key(static_cast<uint32_t>(drawcall.layer),
+												   drawcall.renderIndices[i],
+												   material,
+												   list.id(scene.geometry[geometry]));
+					list.add(key, drawlist::draw_t {});
+				}
+			}
+		}
+		list.sort();
+
+		// the draws are walked linearly, binding only the state that differs from the previous draw
+		counters_t counters {};
+		for(size_t i = 0; i < list.size(); ++i) {
+			const auto difference = (i == 0) ? ~uint64_t {0} : list.sort_key(i) ^ list.sort_key(i - 1);
+			counters.materials += (difference >> drawlist::geometry_bits) != 0;
+			counters.geometry += difference != 0;
+			++counters.draws;
+			benchmark::DoNotOptimize(list[i]);
+		}
+		benchmark::DoNotOptimize(counters);
+		gState.counters["binds"] = static_cast<double>(counters.materials + counters.geometry);
+	}
+	gState.SetItemsProcessed(gState.iterations() * gState.range(0));
+}
+}	 // namespace
+
+BENCHMARK(drawlist_nested)->Arg(1000)->Arg(10000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(drawlist_sorted)->Arg(1000)->Arg(10000)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,289 @@
+#ifdef PE_VULKAN
+	#include "benchmark_utils.hpp"
+	#include "core/resource/resource.hpp"
+	#include "core/vk/context.hpp"
+	#include <benchmark/benchmark.h>
+	#include <algorithm>
+	#include <future>
+	#include <thread>
+	#include <vector>
+
+using namespace core::resource;
+using namespace benchmarks;
+
+// Measures the CPU cost of recording the draw instructions of a core::ivk::drawpass, comparing recording every layer
+// inline into one primary command buffer (the previous behaviour), recording the layers into secondary command buffers
+// in parallel, and re-recording only a single changed layer while the others are reused. The indirect variant measures
+// recording every layer as a single multi-draw, which core::ivk::drawpass uses for draws that share their buffers.
+// The commands are only recorded, they are never submitted.
+namespace {
+constexpr size_t draws_per_layer {256};
+constexpr uint32_t vertex_bindings {3};
+constexpr vk::Extent2D extent {256, 256};
+
+// the minimal set of vulkan objects needed to record a renderpass with draws into.
+class scene {
+  public:
+	scene(const core::ivk::context& context, size_t layers) : m_Device(context.device()) {
+		vk::AttachmentDescription attachment;
+		attachment.format		 = vk::Format::eR8G8B8A8Unorm;
+		attachment.loadOp		 = vk::AttachmentLoadOp::eClear;
+		attachment.storeOp		 = vk::AttachmentStoreOp::eStore;
+		attachment.finalLayout	 = vk::ImageLayout::eColorAttachmentOptimal;
+		vk::AttachmentReference reference {0, vk::ImageLayout::eColorAttachmentOptimal};
+		vk::SubpassDescription subpass;
+		subpass.colorAttachmentCount = 1;
+		subpass.pColorAttachments	 = &reference;
+		vk::RenderPassCreateInfo rpci;
+		rpci.attachmentCount = 1;
+		rpci.pAttachments	 = &attachment;
+		rpci.subpassCount	 = 1;
+		rpci.pSubpasses		 = &subpass;
+		utility::vulkan::check(m_Device.createRenderPass(&rpci, nullptr, &m_RenderPass));
+
+		vk::ImageCreateInfo ici;
+		ici.imageType	= vk::ImageType::e2D;
+		ici.format		= attachment.format;
+		ici.extent		= vk::Extent3D {extent.width, extent.height, 1};
+		ici.mipLevels	= 1;
+		ici.arrayLayers = 1;
+		ici.usage		= vk::ImageUsageFlagBits::eColorAttachment;
+		utility::vulkan::check(m_Device.createImage(&ici, nullptr, &m_Image));
+		m_ImageMemory = allocate(context, m_Device.getImageMemoryRequirements(m_Image));
+		utility::vulkan::check(m_Device.bindImageMemory(m_Image, m_ImageMemory, 0));
+
+		vk::ImageViewCreateInfo ivci;
+		ivci.image			  = m_Image;
+		ivci.viewType		  = vk::ImageViewType::e2D;
+		ivci.format			  = attachment.format;
+		ivci.subresourceRange = vk::ImageSubresourceRange {vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1};
+		utility::vulkan::check(m_Device.createImageView(&ivci, nullptr, &m_View));
+
+		vk::FramebufferCreateInfo fci;
+		fci.renderPass		= m_RenderPass;
+		fci.attachmentCount = 1;
+		fci.pAttachments	= &m_View;
+		fci.width			= extent.width;
+		fci.height			= extent.height;
+		fci.layers			= 1;
+		utility::vulkan::check(m_Device.createFramebuffer(&fci, nullptr, &m_Framebuffer));
+
+		vk::BufferCreateInfo bci;
+		bci.size  = 1024 * 1024;
+		bci.usage = vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eIndexBuffer |
+					vk::BufferUsageFlagBits::eIndirectBuffer;
+		utility::vulkan::check(m_Device.createBuffer(&bci, nullptr, &m_Buffer));
+		m_BufferMemory = allocate(context, m_Device.getBufferMemoryRequirements(m_Buffer));
+		utility::vulkan::check(m_Device.bindBufferMemory(m_Buffer, m_BufferMemory, 0));
+
+		vk::CommandPoolCreateInfo pci;
+		pci.queueFamilyIndex = context.graphics_queue_index();
+		pci.flags			 = vk::CommandPoolCreateFlagBits::eResetCommandBuffer;
+		utility::vulkan::check(m_Device.createCommandPool(&pci, nullptr, &m_PrimaryPool));
+		vk::CommandBufferAllocateInfo cbai;
+		cbai.commandPool		= m_PrimaryPool;
+		cbai.commandBufferCount = 1;
+		cbai.level				= vk::CommandBufferLevel::ePrimary;
+		utility::vulkan::check(m_Device.allocateCommandBuffers(&cbai, &m_Primary));
+
+		// one pool per layer, like core::ivk::drawpass, so layers can be recorded concurrently
+		m_Pools.resize(layers);
+		m_Secondaries.resize(layers);
+		cbai.level = vk::CommandBufferLevel::eSecondary;
+		for(size_t i = 0; i < layers; ++i) {
+			utility::vulkan::check(m_Device.createCommandPool(&pci, nullptr, &m_Pools[i]));
+			cbai.commandPool = m_Pools[i];
+			utility::vulkan::check(m_Device.allocateCommandBuffers(&cbai, &m_Secondaries[i]));
+		}
+	}
+
+	~scene() {
+		for(auto pool : m_Pools) m_Device.destroyCommandPool(pool);
+		m_Device.destroyCommandPool(m_PrimaryPool);
+		m_Device.destroyBuffer(m_Buffer);
+		m_Device.freeMemory(m_BufferMemory);
+		m_Device.destroyFramebuffer(m_Framebuffer);
+		m_Device.destroyImageView(m_View);
+		m_Device.destroyImage(m_Image);
+		m_Device.freeMemory(m_ImageMemory);
+		m_Device.destroyRenderPass(m_RenderPass);
+	}
+
+	size_t layers() const noexcept { return m_Secondaries.size(); }
+
+	void record_inline() {
+		begin(vk::SubpassContents::eInline);
+		for(size_t i = 0; i < layers(); ++i) record_draws(m_Primary);
+		end();
+	}
+
+	void record_inline_indirect() {
+		begin(vk::SubpassContents::eInline);
+		for(size_t i = 0; i < layers(); ++i) {
+			record_state(m_Primary);
+			for(uint32_t binding = 0; binding < vertex_bindings; ++binding) {
+				vk::DeviceSize offset {binding * 64u};
+				m_Primary.bindVertexBuffers(binding, 1, &m_Buffer, &offset);
+			}
+			m_Primary.bindIndexBuffer(m_Buffer, 0, vk::IndexType::eUint32);
+			m_Primary.drawIndexedIndirect(
+			  m_Buffer, 0, (uint32_t)draws_per_layer, (uint32_t)sizeof(vk::DrawIndexedIndirectCommand));
+		}
+		end();
+	}
+
+	void record_layer(size_t layer) {
+		vk::CommandBufferInheritanceInfo inheritanceInfo;
+		inheritanceInfo.renderPass	= m_RenderPass;
+		inheritanceInfo.framebuffer = m_Framebuffer;
+		vk::CommandBufferBeginInfo beginInfo;
+		beginInfo.flags			   = vk::CommandBufferUsageFlagBits::eRenderPassContinue;
+		beginInfo.pInheritanceInfo = &inheritanceInfo;
+		utility::vulkan::check(m_Secondaries[layer].begin(beginInfo));
+		record_draws(m_Secondaries[layer]);
+		utility::vulkan::check(m_Secondaries[layer].end());
+	}
+
+	void record_primary() {
+		begin(vk::SubpassContents::eSecondaryCommandBuffers);
+		m_Primary.executeCommands((uint32_t)m_Secondaries.size(), m_Secondaries.data());
+		end();
+	}
+
+  private:
+	static vk::DeviceMemory allocate(const core::ivk::context& context, const vk::MemoryRequirements& requirements) {
+		vk::MemoryAllocateInfo mai;
+		mai.allocationSize = requirements.size;
+		context.memory_type(
+		  requirements.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal, &mai.memoryTypeIndex);
+		vk::DeviceMemory memory;
+		utility::vulkan::check(context.device().allocateMemory(&mai, nullptr, &memory));
+		return memory;
+	}
+
+	void begin(vk::SubpassContents contents) {
+		vk::CommandBufferBeginInfo beginInfo;
+		utility::vulkan::check(m_Primary.begin(beginInfo));
+		vk::ClearValue clearValue;
+		vk::RenderPassBeginInfo rpbi;
+		rpbi.renderPass		   = m_RenderPass;
+		rpbi.framebuffer	   = m_Framebuffer;
+		rpbi.renderArea.extent = extent;
+		rpbi.clearValueCount   = 1;
+		rpbi.pClearValues	   = &clearValue;
+		m_Primary.beginRenderPass(rpbi, contents);
+	}
+
+	void end() {
+		m_Primary.endRenderPass();
+		utility::vulkan::check(m_Primary.end());
+	}
+
+	// mirrors the commands core::ivk::drawpass records per draw, the commands are never executed so no pipeline is
+	// needed.
+	void record_state(vk::CommandBuffer cmdBuffer) {
+		vk::Viewport viewport {0.0f, 0.0f, (float)extent.width, (float)extent.height, 0.0f, 1.0f};
+		cmdBuffer.setViewport(0, 1, &viewport);
+		vk::Rect2D scissor {{0, 0}, extent};
+		cmdBuffer.setScissor(0, 1, &scissor);
+	}
+
+	void record_draws(vk::CommandBuffer cmdBuffer) {
+		record_state(cmdBuffer);
+		for(size_t draw = 0; draw < draws_per_layer; ++draw) {
+			for(uint32_t binding = 0; binding < vertex_bindings; ++binding) {
+				vk::DeviceSize offset {(draw * vertex_bindings + binding) * 64};
+				cmdBuffer.bindVertexBuffers(binding, 1, &m_Buffer, &offset);
+			}
+			cmdBuffer.bindIndexBuffer(m_Buffer, draw * 4, vk::IndexType::eUint32);
+			cmdBuffer.drawIndexed(36, 16, 0, 0, 0);
+		}
+	}
+
+	vk::Device m_Device;
+	vk::RenderPass m_RenderPass;
+	vk::Image m_Image;
+	vk::DeviceMemory m_ImageMemory;
+	vk::ImageView m_View;
+	vk::Framebuffer m_Framebuffer;
+	vk::Buffer m_Buffer;
+	vk::DeviceMemory m_BufferMemory;
+	vk::CommandPool m_PrimaryPool;
+	vk::CommandBuffer m_Primary;
+	std::vector<vk::CommandPool> m_Pools;
+	std::vector<vk::CommandBuffer> m_Secondaries;
+};
+
+void record_parallel(scene& scene) {
+	const size_t worker_count =
+	  std::min<size_t>(scene.layers(), std::max<size_t>(1, std::thread::hardware_concurrency()));
+	const size_t batch_size = (scene.layers() + worker_count - 1) / worker_count;
+	std::vector<std::future<void>> workers {};
+	for(size_t begin = 0; begin < scene.layers(); begin += batch_size) {
+		auto end = std::min(begin + batch_size, scene.layers());
+		workers.emplace_back(std::async(std::launch::async, [&scene, begin, end]() {
+			for(auto i = begin; i < end; ++i) scene.record_layer(i);
+		}));
+	}
+	for(auto& worker : workers) worker.get();
+	scene.record_primary();
+}
+
+void drawpass_record_inline(benchmark::State& gState) {
+	setup_logging();
+	cache_t cache {make_library("drawpass_benchmark")};
+	auto context = cache.create<core::ivk::context>(psl::string8_t {"drawpass_benchmark"});
+	scene scene {context.value(), static_cast<size_t>(gState.range(0))};
+
+	for(auto _ : gState) {
+		scene.record_inline();
+	}
+	gState.SetItemsProcessed(gState.iterations() * gState.range(0) * draws_per_layer);
+}
+
+void drawpass_record_indirect(benchmark::State& gState) {
+	setup_logging();
+	cache_t cache {make_library("drawpass_benchmark")};
+	auto context = cache.create<core::ivk::context>(psl::string8_t {"drawpass_benchmark"});
+	scene scene {context.value(), static_cast<size_t>(gState.range(0))};
+
+	for(auto _ : gState) {
+		scene.record_inline_indirect();
+	}
+	gState.SetItemsProcessed(gState.iterations() * gState.range(0) * draws_per_layer);
+}
+
+void drawpass_record_parallel(benchmark::State& gState) {
+	setup_logging();
+	cache_t cache {make_library("drawpass_benchmark")};
+	auto context = cache.create<core::ivk::context>(psl::string8_t {"drawpass_benchmark"});
+	scene scene {context.value(), static_cast<size_t>(gState.range(0))};
+
+	for(auto _ : gState) {
+		record_parallel(scene);
+	}
+	gState.SetItemsProcessed(gState.iterations() * gState.range(0) * draws_per_layer);
+}
+
+void drawpass_record_reuse(benchmark::State& gState) {
+	setup_logging();
+	cache_t cache {make_library("drawpass_benchmark")};
+	auto context = cache.create<core::ivk::context>(psl::string8_t {"drawpass_benchmark"});
+	scene scene {context.value(), static_cast<size_t>(gState.range(0))};
+	record_parallel(scene);
+
+	size_t changed {0};
+	for(auto _ : gState) {
+		scene.record_layer(changed);
+		scene.record_primary();
+		changed = (changed + 1) % scene.layers();
+	}
+	gState.SetItemsProcessed(gState.iterations() * gState.range(0) * draws_per_layer);
+}
+}	 // namespace
+
+BENCHMARK(drawpass_record_inline)->RangeMultiplier(4)->Range(4, 64)->Unit(benchmark::kMicrosecond)->UseRealTime();
+BENCHMARK(drawpass_record_indirect)->RangeMultiplier(4)->Range(4, 64)->Unit(benchmark::kMicrosecond)->UseRealTime();
+BENCHMARK(drawpass_record_parallel)->RangeMultiplier(4)->Range(4, 64)->Unit(benchmark::kMicrosecond)->UseRealTime();
+BENCHMARK(drawpass_record_reuse)->RangeMultiplier(4)->Range(4, 64)->Unit(benchmark::kMicrosecond)->UseRealTime();
+#endif
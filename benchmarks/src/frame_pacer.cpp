@@ -0,0 +1,115 @@
+#if defined(PE_GLES) && defined(SURFACE_XCB)
+	#include "benchmark_utils.hpp"
+	#include "core/gles/frame_pacer.hpp"
+	#include "core/gles/igles.hpp"
+	#include <benchmark/benchmark.h>
+	#include <chrono>
+
+using namespace benchmarks;
+
+// Measures the CPU frame time of a frame loop that simulates a game tick followed by rendering, once serialized with
+// glFinish, and once paced with core::igles::frame_pacer so the tick can overlap with the GPU.
+namespace {
+constexpr GLsizei target_size {1024};
+// duration of the simulated CPU work (ECS tick) per frame
+constexpr std::chrono::microseconds tick_duration {2000};
+
+constexpr const char* vertex_source {"#version 300 es\n"
+									 "void main() {\n"
+									 "	vec2 uv = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);\n"
+									 "	gl_Position = vec4(uv * 2.0 - 1.0, 0.0, 1.0);\n"
+									 "}\n"};
+constexpr const char* fragment_source {"#version 300 es\n"
+									   "precision highp float;\n"
+									   "out vec4 color;\n"
+									   "void main() {\n"
+									   "	vec2 value = gl_FragCoord.xy;\n"
+									   "	for(int i = 0; i < 32; ++i) value = sin(value.yx * 1.1 + value);\n"
+									   "	color = vec4(value, 0.0, 1.0);\n"
+									   "}\n"};
+
+/// \brief offscreen target and program to render a fixed amount of GPU work into.
+struct scene {
+	scene() {
+		glGenRenderbuffers(1, &renderbuffer);
+		glBindRenderbuffer(GL_RENDERBUFFER, renderbuffer);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, target_size, target_size);
+		glGenFramebuffers(1, &framebuffer);
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffer);
+
+		auto vertex	  = compile(GL_VERTEX_SHADER, vertex_source);
+		auto fragment = compile(GL_FRAGMENT_SHADER, fragment_source);
+		program		  = glCreateProgram();
+		glAttachShader(program, vertex);
+		glAttachShader(program, fragment);
+		glLinkProgram(program);
+		glDeleteShader(vertex);
+		glDeleteShader(fragment);
+		glGenVertexArrays(1, &vao);
+
+		glViewport(0, 0, target_size, target_size);
+	}
+	~scene() {
+		glDeleteVertexArrays(1, &vao);
+		glDeleteProgram(program);
+		glDeleteFramebuffers(1, &framebuffer);
+		glDeleteRenderbuffers(1, &renderbuffer);
+	}
+
+	static GLuint compile(GLenum stage, const char* source) {
+		auto shader = glCreateShader(stage);
+		glShaderSource(shader, 1, &source, nullptr);
+		glCompileShader(shader);
+		return shader;
+	}
+
+	void render() const {
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+		glUseProgram(program);
+		glBindVertexArray(vao);
+		glDrawArrays(GL_TRIANGLES, 0, 3);
+	}
+
+	GLuint renderbuffer {0};
+	GLuint framebuffer {0};
+	GLuint program {0};
+	GLuint vao {0};
+};
+
+void tick() {
+	auto end = std::chrono::steady_clock::now() + tick_duration;
+	while(std::chrono::steady_clock::now() < end) {
+	}
+}
+
+void frame_pacer_finish(benchmark::State& gState) {
+	setup_logging();
+	egl_context context {};
+	scene scene {};
+
+	for(auto _ : gState) {
+		tick();
+		scene.render();
+		glFinish();
+	}
+}
+
+void frame_pacer_fences(benchmark::State& gState) {
+	setup_logging();
+	egl_context context {};
+	scene scene {};
+	core::igles::frame_pacer pacer {static_cast<uint32_t>(gState.range(0))};
+
+	for(auto _ : gState) {
+		tick();
+		scene.render();
+		pacer.end_frame();
+	}
+	pacer.wait_idle();
+}
+}	 // namespace
+
+BENCHMARK(frame_pacer_finish)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(frame_pacer_fences)->DenseRange(1, 3)->Unit(benchmark::kMillisecond)->UseRealTime();
+#endif
@@ -0,0 +1,45 @@
+#include "psl/generator.hpp"
+#include <benchmark/benchmark.h>
+
+// Measures psl::generator on fragmented id spaces, as instance ids of bundles end up after many instances have been
+// released. Every other id is released before measuring, so the amount of free ranges equals half the amount of ids.
+namespace {
+psl::generator<uint32_t> create_fragmented(uint32_t count) {
+	psl::generator<uint32_t> generator {count * 2};
+	generator.create(count);
+	for(uint32_t i = 0; i < count; i += 2) generator.destroy(i);
+	return generator;
+}
+
+// creates a single id, which takes the lowest free id, and releases it again
+void generator_create(benchmark::State& gState) {
+	auto generator = create_fragmented(static_cast<uint32_t>(gState.range(0)));
+	for(auto _ : gState) {
+		auto id = generator.create();
+		benchmark::DoNotOptimize(id);
+		generator.destroy(id);
+	}
+	gState.SetItemsProcessed(gState.iterations());
+}
+
+// creates ranges that don't fit in any of the holes, and releases them again
+void generator_create_range(benchmark::State& gState) {
+	auto generator = create_fragmented(static_cast<uint32_t>(gState.range(0)));
+	for(auto _ : gState) {
+		auto id = generator.create(4);
+		benchmark::DoNotOptimize(id);
+		generator.destroy(id, 4);
+	}
+	gState.SetItemsProcessed(gState.iterations());
+}
+
+void generator_available(benchmark::State& gState) {
+	const auto generator = create_fragmented(static_cast<uint32_t>(gState.range(0)));
+	for(auto _ : gState) benchmark::DoNotOptimize(generator.available());
+	gState.SetItemsProcessed(gState.iterations());
+}
+}	 // namespace
+
+BENCHMARK(generator_create)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK(generator_create_range)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK(generator_available)->Arg(1 << 10)->Arg(1 << 16);
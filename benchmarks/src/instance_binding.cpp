@@ -0,0 +1,79 @@
+#include "core/gfx/bundle.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+using core::gfx::details::instance::binding;
+using core::gfx::details::instance::binding_id;
+using core::gfx::details::instance::object;
+
+// Measures the CPU cost of resolving the instance data segment a core::gfx::bundle::set call writes to. This compares
+// looking the binding up by name (creating a psl::string from the constant, and comparing it against the name of every
+// binding of the geometry), against looking it up by its precomputed core::gfx::details::instance::binding_id.
+// Both include the lookup of the geometry itself, the upload is not measured.
+namespace {
+constexpr size_t geometry_count {256};
+constexpr size_t set_count {4096};
+
+const psl::string_view names[] {
+  psl::string_view {"INSTANCE_COLOR"},
+  psl::string_view {"INSTANCE_BONES"},
+  psl::string_view {"INSTANCE_WIND"},
+  core::gfx::constants::INSTANCE_MODELMATRIX,
+};
+
+struct scene_t {
+	std::unordered_map<psl::UID, object> objects;
+	std::vector<psl::UID> sets;
+};
+
+scene_t create_scene() {
+	std::mt19937 generator {42};
+	scene_t scene {};
+	std::vector<psl::UID> geometry;
+	for(size_t i = 0; i < geometry_count; ++i) {
+		auto uid	   = geometry.emplace_back(psl::UID::generate());
+		auto& instance = scene.objects.emplace(uid, object {uid}).first->second;
+		for(auto name : names) {
+			instance.description.emplace_back(binding::header {psl::string {name}, 64, binding_id {name}});
+			instance.data.emplace_back();
+		}
+	}
+
+	std::uniform_int_distribution<size_t> index {0, geometry_count - 1};
+	for(size_t i = 0; i < set_count; ++i) scene.sets.emplace_back(geometry[index(generator)]);
+	return scene;
+}
+
+void instance_binding_by_name(benchmark::State& gState) {
+	const auto scene = create_scene();
+	for(auto _ : gState) {
+		for(const auto& geometry : scene.sets) {
+			const psl::string name {core::gfx::constants::INSTANCE_MODELMATRIX};
+			const auto& object = scene.objects.find(geometry)->second;
+			const auto& descr  = object.description;
+			auto it			   = std::find_if(
+				 std::begin(descr), std::end(descr), [&name](const auto& header) { return header.name == name; });
+			benchmark::DoNotOptimize(object.data[std::distance(std::begin(descr), it)]);
+		}
+	}
+	gState.SetItemsProcessed(gState.iterations() * set_count);
+}
+
+void instance_binding_by_id(benchmark::State& gState) {
+	const auto scene = create_scene();
+	for(auto _ : gState) {
+		for(const auto& geometry : scene.sets) {
+			const auto& object = scene.objects.find(geometry)->second;
+			auto index		   = object.find(core::gfx::constants::INSTANCE_MODELMATRIX_ID);
+			benchmark::DoNotOptimize(object.data[index.value()]);
+		}
+	}
+	gState.SetItemsProcessed(gState.iterations() * set_count);
+}
+}	 // namespace
+
+BENCHMARK(instance_binding_by_name)->Unit(benchmark::kMicrosecond);
+BENCHMARK(instance_binding_by_id)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,108 @@
+#include "psl/math/math.hpp"
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+using namespace psl;
+
+// Measures the psl::math operations that have SIMD kernels, on arrays of values. Which kernels are measured depends on
+// the PE_INSTRUCTION_SET the benchmarks are built with, so the backends are compared by building them with each of
+// fallback, SSE, AVX and AVX2.
+namespace {
+constexpr size_t count {1024};
+
+float random_value() {
+	static std::mt19937 generator {42};
+	static std::uniform_real_distribution<float> distribution {-1.0f, 1.0f};
+	return distribution(generator);
+}
+
+std::vector<mat4x4> create_matrices() {
+	std::vector<mat4x4> result(count);
+	for(auto& mat : result) {
+		for(size_t i = 0; i < 16; ++i) mat[i] = random_value();
+		// the diagonal is weighted, so that the matrix is invertible
+		for(size_t i = 0; i < 4; ++i) mat[{i, i}] += 4.0f;
+	}
+	return result;
+}
+
+std::vector<quat> create_quats() {
+	std::vector<quat> result(count);
+	for(auto& value : result)
+		value = math::normalize(quat {random_value(), random_value(), random_value(), random_value()});
+	return result;
+}
+
+std::vector<vec4> create_vecs() {
+	std::vector<vec4> result(count);
+	for(auto& value : result) value = vec4 {random_value(), random_value(), random_value(), random_value()};
+	return result;
+}
+
+template <typename T, typename Fn>
+void run(benchmark::State& gState, std::vector<T>& results, Fn&& fn) {
+	for(auto _ : gState) {
+		for(size_t i = 0; i < count; ++i) results[i] = fn(i);
+		benchmark::DoNotOptimize(results.data());
+		benchmark::ClobberMemory();
+	}
+	gState.SetItemsProcessed(gState.iterations() * count);
+}
+
+void math_mat4_multiply(benchmark::State& gState) {
+	const auto left	 = create_matrices();
+	const auto right = create_matrices();
+	std::vector<mat4x4> results(count);
+	run(gState, results, [&](size_t i) { return left[i] * right[i]; });
+}
+
+void math_mat4_transpose(benchmark::State& gState) {
+	const auto matrices = create_matrices();
+	std::vector<mat4x4> results(count);
+	run(gState, results, [&](size_t i) { return math::transpose(matrices[i]); });
+}
+
+void math_mat4_inverse(benchmark::State& gState) {
+	const auto matrices = create_matrices();
+	std::vector<mat4x4> results(count);
+	run(gState, results, [&](size_t i) { return math::inverse(matrices[i]); });
+}
+
+void math_quat_rotate(benchmark::State& gState) {
+	const auto rotations = create_quats();
+	const auto vecs		 = create_vecs();
+	std::vector<vec3> results(count);
+	run(gState, results, [&](size_t i) {
+		return math::rotate(rotations[i], vec3 {vecs[i][0], vecs[i][1], vecs[i][2]});
+	});
+}
+
+void math_quat_slerp(benchmark::State& gState) {
+	const auto from = create_quats();
+	const auto to	= create_quats();
+	std::vector<quat> results(count);
+	run(gState, results, [&](size_t i) { return math::slerp(from[i], to[i], static_cast<float>(i) / count); });
+}
+
+void math_vec4_normalize(benchmark::State& gState) {
+	const auto vecs = create_vecs();
+	std::vector<vec4> results(count);
+	run(gState, results, [&](size_t i) { return math::normalize(vecs[i]); });
+}
+
+void math_vec4_dot(benchmark::State& gState) {
+	const auto left	 = create_vecs();
+	const auto right = create_vecs();
+	std::vector<float> results(count);
+	run(gState, results, [&](size_t i) { return math::dot(left[i], right[i]); });
+}
+}	 // namespace
+
+BENCHMARK(math_mat4_multiply)->Unit(benchmark::kMicrosecond);
+BENCHMARK(math_mat4_transpose)->Unit(benchmark::kMicrosecond);
+BENCHMARK(math_mat4_inverse)->Unit(benchmark::kMicrosecond);
+BENCHMARK(math_quat_rotate)->Unit(benchmark::kMicrosecond);
+BENCHMARK(math_quat_slerp)->Unit(benchmark::kMicrosecond);
+BENCHMARK(math_vec4_normalize)->Unit(benchmark::kMicrosecond);
+BENCHMARK(math_vec4_dot)->Unit(benchmark::kMicrosecond);
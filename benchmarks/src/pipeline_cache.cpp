@@ -0,0 +1,107 @@
+#ifdef PE_VULKAN
+	#include "benchmark_utils.hpp"
+	#include "core/resource/resource.hpp"
+	#include "core/vk/context.hpp"
+	#include "core/vk/pipeline_cache.hpp"
+	#include <benchmark/benchmark.h>
+	#include <array>
+
+using namespace core::resource;
+using namespace benchmarks;
+
+// Measures the cold start cost of compiling pipelines, with and without the persisted core::ivk::pipeline_cache.
+// When running on Mesa (such as lavapipe), its shader cache should be disabled with MESA_SHADER_CACHE_DISABLE=true,
+// otherwise the "cold" runs will hit its on-disk cache instead.
+namespace {
+constexpr psl::UID pipeline_cache_uid {"7d0c4f1a-92b6-4e5d-b3a8-16e2c9f0d574"_uid};
+
+// SPIR-V for an empty compute shader, the LocalSize x component is patched to create unique pipelines.
+// #version 450
+// layout(local_size_x = 1) in;
+// void main() {}
+constexpr size_t local_size_x_word {18};
+constexpr std::array<uint32_t, 35> empty_compute_spirv {
+  0x07230203, 0x00010000, 0x00000000, 0x00000005, 0x00000000,				// header, bound 5
+  0x00020011, 0x00000001,													// OpCapability Shader
+  0x0003000E, 0x00000000, 0x00000001,										// OpMemoryModel Logical GLSL450
+  0x0005000F, 0x00000005, 0x00000001, 0x6E69616D, 0x00000000,				// OpEntryPoint GLCompute %1 "main"
+  0x00060010, 0x00000001, 0x00000011, 0x00000001, 0x00000001, 0x00000001,	// OpExecutionMode %1 LocalSize 1 1 1
+  0x00020013, 0x00000002,													// %2 = OpTypeVoid
+  0x00030021, 0x00000003, 0x00000002,										// %3 = OpTypeFunction %2
+  0x00050036, 0x00000002, 0x00000001, 0x00000000, 0x00000003,				// %1 = OpFunction %2 None %3
+  0x000200F8, 0x00000004,													// %4 = OpLabel
+  0x000100FD,																// OpReturn
+  0x00010038																// OpFunctionEnd
+};
+
+void compile(const core::ivk::context& context, vk::PipelineCache pipelineCache, size_t count) {
+	auto device = context.device();
+
+	vk::PipelineLayoutCreateInfo plci;
+	vk::PipelineLayout layout;
+	utility::vulkan::check(device.createPipelineLayout(&plci, nullptr, &layout));
+
+	auto spirv = empty_compute_spirv;
+	for(size_t i = 0; i < count; ++i) {
+		spirv[local_size_x_word] = static_cast<uint32_t>(i + 1);
+
+		vk::ShaderModuleCreateInfo smci;
+		smci.codeSize = spirv.size() * sizeof(uint32_t);
+		smci.pCode	  = spirv.data();
+		vk::ShaderModule module;
+		utility::vulkan::check(device.createShaderModule(&smci, nullptr, &module));
+
+		vk::ComputePipelineCreateInfo cpci;
+		cpci.stage.stage  = vk::ShaderStageFlagBits::eCompute;
+		cpci.stage.module = module;
+		cpci.stage.pName  = "main";
+		cpci.layout		  = layout;
+		vk::Pipeline pipeline;
+		utility::vulkan::check(device.createComputePipelines(pipelineCache, 1, &cpci, nullptr, &pipeline));
+
+		device.destroyPipeline(pipeline);
+		device.destroyShaderModule(module);
+	}
+	device.destroyPipelineLayout(layout);
+}
+
+void pipeline_cache_startup(benchmark::State& gState, bool warm) {
+	setup_logging();
+	auto count = static_cast<size_t>(gState.range(0));
+	cache_t cache {make_library("pipeline_cache_benchmark", pipeline_cache_uid, "pipeline.cache")};
+	auto context = cache.create<core::ivk::context>(psl::string8_t {"pipeline_cache_benchmark"});
+
+	// the pipeline_cache writes its data back to the library on destruction
+	cache.library().write(pipeline_cache_uid, {});
+	if(warm) {
+		auto pipelineCache = cache.create_using<core::ivk::pipeline_cache>(pipeline_cache_uid, context);
+		compile(context.value(), pipelineCache->vkPipelineCache(), count);
+		pipelineCache = {};
+		cache.free();
+	}
+
+	for(auto _ : gState) {
+		auto pipelineCache = cache.create_using<core::ivk::pipeline_cache>(pipeline_cache_uid, context);
+		compile(context.value(), pipelineCache->vkPipelineCache(), count);
+
+		gState.PauseTiming();
+		pipelineCache = {};
+		cache.free();
+		if(!warm)
+			cache.library().write(pipeline_cache_uid, {});
+		gState.ResumeTiming();
+	}
+}
+
+void pipeline_cache_cold(benchmark::State& gState) {
+	pipeline_cache_startup(gState, false);
+}
+
+void pipeline_cache_warm(benchmark::State& gState) {
+	pipeline_cache_startup(gState, true);
+}
+}	 // namespace
+
+BENCHMARK(pipeline_cache_cold)->RangeMultiplier(4)->Range(16, 256)->Unit(benchmark::kMillisecond);
+BENCHMARK(pipeline_cache_warm)->RangeMultiplier(4)->Range(16, 256)->Unit(benchmark::kMillisecond);
+#endif
@@ -0,0 +1,90 @@
+#if defined(PE_GLES) && defined(SURFACE_XCB)
+	#include "benchmark_utils.hpp"
+	#include "core/data/material.hpp"
+	#include "core/gles/igles.hpp"
+	#include "core/gles/program.hpp"
+	#include "core/gles/program_cache.hpp"
+	#include "core/meta/shader.hpp"
+	#include "core/resource/resource.hpp"
+	#include <benchmark/benchmark.h>
+
+using namespace core::resource;
+using namespace benchmarks;
+
+// Measures the link time of GLES programs, with and without the persisted core::igles::program_cache.
+// When running on Mesa (such as llvmpipe), its shader cache should be disabled with MESA_SHADER_CACHE_DISABLE=true,
+// otherwise the "cold" runs will hit its on-disk cache instead.
+namespace {
+constexpr psl::UID program_cache_uid {"e5a2b7d4-3c19-4f0e-8d6b-92f1a0c4e7b3"_uid};
+
+constexpr psl::string8::view vertex_source {"#version 300 es\n"
+											"layout(location = 0) in vec3 position;\n"
+											"void main() { gl_Position = vec4(position, 1.0); }\n"};
+
+psl::string8_t fragment_source(size_t index) {
+	return "#version 300 es\n"
+		   "precision mediump float;\n"
+		   "out vec4 color;\n"
+		   "void main() { color = vec4(" +
+		   std::to_string(static_cast<float>(index)) + ", 0.0, 0.0, 1.0); }\n";
+}
+
+psl::array<handle<core::data::material_t>> make_materials(cache_t& cache, size_t count) {
+	auto& library = cache.library();
+	auto vertex	  = library.create<core::meta::shader>(psl::string8_t {vertex_source});
+	vertex.second.stage(core::gfx::shader_stage::vertex);
+
+	psl::array<handle<core::data::material_t>> materials {};
+	for(size_t i = 0; i < count; ++i) {
+		auto fragment = library.create<core::meta::shader>(fragment_source(i));
+		fragment.second.stage(core::gfx::shader_stage::fragment);
+
+		auto& material = materials.emplace_back(cache.create<core::data::material_t>());
+		material->from_shaders(library, {&vertex.second, &fragment.second});
+	}
+	return materials;
+}
+
+void program_cache_link(benchmark::State& gState, bool warm) {
+	setup_logging();
+	egl_context context {};
+	auto count = static_cast<size_t>(gState.range(0));
+	cache_t cache {make_library("program_cache_benchmark", program_cache_uid, "program.cache")};
+	auto materials = make_materials(cache, count);
+
+	// the program_cache writes its binaries back to the library on destruction
+	cache.library().write(program_cache_uid, {});
+	if(warm) {
+		auto programCache = cache.create_using<core::igles::program_cache>(program_cache_uid);
+		for(auto& material : materials) programCache->get(psl::UID::generate(), material);
+		programCache = {};
+		cache.free();
+	}
+
+	for(auto _ : gState) {
+		auto programCache = cache.create_using<core::igles::program_cache>(program_cache_uid);
+		for(auto& material : materials) {
+			benchmark::DoNotOptimize(programCache->get(psl::UID::generate(), material)->id());
+		}
+
+		gState.PauseTiming();
+		programCache = {};
+		cache.free();
+		if(!warm)
+			cache.library().write(program_cache_uid, {});
+		gState.ResumeTiming();
+	}
+}
+
+void program_cache_cold(benchmark::State& gState) {
+	program_cache_link(gState, false);
+}
+
+void program_cache_warm(benchmark::State& gState) {
+	program_cache_link(gState, true);
+}
+}	 // namespace
+
+BENCHMARK(program_cache_cold)->RangeMultiplier(4)->Range(16, 256)->Unit(benchmark::kMillisecond);
+BENCHMARK(program_cache_warm)->RangeMultiplier(4)->Range(16, 256)->Unit(benchmark::kMillisecond);
+#endif
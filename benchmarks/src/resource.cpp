@@ -0,0 +1,95 @@
+#include "benchmark_utils.hpp"
+#include "core/resource/resource.hpp"
+#include <benchmark/benchmark.h>
+
+using namespace core::resource;
+using namespace benchmarks;
+
+namespace {
+struct dummy_resource {
+	dummy_resource(cache_t& cache, const metadata& metaData, psl::meta::file* metaFile, size_t value) noexcept
+		: value(value) {}
+
+	size_t value;
+	std::array<std::byte, 48> payload {};
+};
+}	 // namespace
+
+void resource_create(benchmark::State& gState) {
+	auto count = static_cast<size_t>(gState.range(0));
+	cache_t cache {make_library("resource_benchmark")};
+	psl::array<handle<dummy_resource>> handles {};
+	handles.reserve(count);
+
+	for(auto _ : gState) {
+		for(size_t i = 0; i < count; ++i) handles.emplace_back(cache.create<dummy_resource>(i));
+
+		gState.PauseTiming();
+		handles.clear();
+		cache.free();
+		gState.ResumeTiming();
+	}
+}
+
+void resource_find(benchmark::State& gState) {
+	auto count = static_cast<size_t>(gState.range(0));
+	cache_t cache {make_library("resource_benchmark")};
+	psl::array<handle<dummy_resource>> handles {};
+	psl::array<psl::UID> uids {};
+	handles.reserve(count);
+	uids.reserve(count);
+	for(size_t i = 0; i < count; ++i) {
+		uids.emplace_back(handles.emplace_back(cache.create<dummy_resource>(i)).uid());
+	}
+
+	for(auto _ : gState) {
+		size_t sum = 0;
+		for(const auto& uid : uids) sum += cache.find<dummy_resource>(uid)->value;
+		benchmark::DoNotOptimize(sum);
+	}
+	handles.clear();
+}
+
+void resource_find_index(benchmark::State& gState) {
+	auto count = static_cast<size_t>(gState.range(0));
+	cache_t cache {make_library("resource_benchmark")};
+	psl::array<handle<dummy_resource>> handles {};
+	psl::array<size_t> indices {};
+	handles.reserve(count);
+	indices.reserve(count);
+	for(size_t i = 0; i < count; ++i) {
+		indices.emplace_back(handles.emplace_back(cache.create<dummy_resource>(i)).resource_metadata()->index);
+	}
+
+	for(auto _ : gState) {
+		size_t sum = 0;
+		for(auto index : indices) sum += cache.at<dummy_resource>(index)->value;
+		benchmark::DoNotOptimize(sum);
+	}
+	handles.clear();
+}
+
+void resource_release(benchmark::State& gState) {
+	auto count = static_cast<size_t>(gState.range(0));
+	cache_t cache {make_library("resource_benchmark")};
+	psl::array<handle<dummy_resource>> handles {};
+	handles.reserve(count);
+
+	for(auto _ : gState) {
+		gState.PauseTiming();
+		for(size_t i = 0; i < count; ++i) handles.emplace_back(cache.create<dummy_resource>(i));
+		gState.ResumeTiming();
+
+		for(auto& handle : handles) cache.free(handle);
+
+		gState.PauseTiming();
+		handles.clear();
+		cache.free();
+		gState.ResumeTiming();
+	}
+}
+
+BENCHMARK(resource_create)->RangeMultiplier(10)->Range(1'000, 100'000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(resource_find)->RangeMultiplier(10)->Range(1'000, 100'000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(resource_find_index)->RangeMultiplier(10)->Range(1'000, 100'000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(resource_release)->RangeMultiplier(10)->Range(1'000, 100'000)->Unit(benchmark::kMicrosecond);
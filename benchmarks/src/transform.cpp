@@ -0,0 +1,59 @@
+#include "core/ecs/components/transform.hpp"
+#include "psl/math/math.hpp"
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+using namespace psl;
+using core::ecs::components::transform;
+
+// Compares composing the model matrices of transform components through the intermediate matrices (as the geometry
+// instancing systems used to), against the batched closed form of psl::math::compose.
+namespace {
+std::vector<transform> create_transforms(size_t count) {
+	std::mt19937 generator {42};
+	std::uniform_real_distribution<float> distribution {-1.0f, 1.0f};
+	std::vector<transform> result;
+	result.reserve(count);
+	for(size_t i = 0; i < count; ++i) {
+		auto rotation = math::normalize(
+		  quat {distribution(generator), distribution(generator), distribution(generator), distribution(generator)});
+		result.emplace_back(vec3 {distribution(generator), distribution(generator), distribution(generator)} * 100.0f,
+							vec3 {1.0f + distribution(generator) * 0.5f},
+							rotation);
+	}
+	return result;
+}
+
+void transform_compose_scalar(benchmark::State& gState) {
+	auto transforms = create_transforms(static_cast<size_t>(gState.range(0)));
+	std::vector<mat4x4> matrices(transforms.size());
+
+	for(auto _ : gState) {
+		for(size_t i = 0; i < transforms.size(); ++i) {
+			const mat4x4 translationMat = math::translate(transforms[i].position);
+			const mat4x4 rotationMat	= math::to_matrix(transforms[i].rotation);
+			const mat4x4 scaleMat		= math::scale(transforms[i].scale);
+			matrices[i]					= translationMat * rotationMat * scaleMat;
+		}
+		benchmark::DoNotOptimize(matrices.data());
+		benchmark::ClobberMemory();
+	}
+	gState.SetItemsProcessed(gState.iterations() * gState.range(0));
+}
+
+void transform_compose_batch(benchmark::State& gState) {
+	auto transforms = create_transforms(static_cast<size_t>(gState.range(0)));
+	std::vector<mat4x4> matrices(transforms.size());
+
+	for(auto _ : gState) {
+		math::compose(std::begin(transforms), std::end(transforms), matrices.data());
+		benchmark::DoNotOptimize(matrices.data());
+		benchmark::ClobberMemory();
+	}
+	gState.SetItemsProcessed(gState.iterations() * gState.range(0));
+}
+}	 // namespace
+
+BENCHMARK(transform_compose_scalar)->RangeMultiplier(8)->Range(64, 1 << 18)->Unit(benchmark::kMicrosecond);
+BENCHMARK(transform_compose_batch)->RangeMultiplier(8)->Range(64, 1 << 18)->Unit(benchmark::kMicrosecond);
@@ -18,4 +18,8 @@ struct renderable {
 };
 
 struct dont_render_tag {};
+
+/// \brief set by core::ecs::systems::culling on the dynamic renderables that no camera can see, they won't have an
+/// instance uploaded or drawn until they are visible again.
+struct culled_tag {};
 }	 // namespace core::ecs::components
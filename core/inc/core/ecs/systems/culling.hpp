@@ -0,0 +1,65 @@
+#pragma once
+#include "core/ecs/components/camera.hpp"
+#include "core/ecs/components/renderable.hpp"
+#include "core/ecs/components/transform.hpp"
+#include "core/resource/resource.hpp"
+#include "psl/array_view.hpp"
+#include "psl/ecs/state.hpp"
+#include "psl/math/culling.hpp"
+#include <unordered_map>
+
+namespace core::os {
+class surface;
+}
+
+namespace core::ecs::systems {
+/// \brief culls the dynamic renderables against the view frustum of every camera.
+///
+/// Every tick the world space bounds of the renderables are derived from their transform and the model space bounds
+/// of their geometry (see core::gfx::geometry_t::bounds()), and stored as a structure of arrays. These are then
+/// tested against the frustum of every camera, resulting in a compact list of the visible entities per camera.
+/// Renderables that no camera can see get the core::ecs::components::culled_tag, which removes them from the dynamic
+/// instances of core::ecs::systems::geometry_instancing, so they are neither uploaded nor drawn.
+/// \note static renderables are not culled, their instance is only uploaded once and releasing it would cost more
+/// than drawing it.
+class culling {
+  public:
+	culling(psl::ecs::state_t& state, core::resource::handle<core::os::surface> surface);
+	~culling()						   = default;
+	culling(const culling&)			   = delete;
+	culling(culling&&)				   = delete;
+	culling& operator=(const culling&) = delete;
+	culling& operator=(culling&&)	   = delete;
+
+	/// \returns the renderable entities that were visible to the camera during the last tick.
+	/// \note the view is invalidated by the next tick.
+	psl::array_view<psl::ecs::entity_t> visible(psl::ecs::entity_t camera) const noexcept;
+
+  private:
+	void tick(psl::ecs::info_t& info,
+			  psl::ecs::pack_direct_full_t<psl::ecs::entity_t,
+										   const core::ecs::components::camera,
+										   const core::ecs::components::transform> cameras,
+			  psl::ecs::pack_direct_full_t<psl::ecs::entity_t,
+										   const core::ecs::components::renderable,
+										   const core::ecs::components::transform,
+										   const core::ecs::components::dynamic_tag,
+										   psl::ecs::except<core::ecs::components::dont_render_tag>> renderables,
+			  psl::ecs::pack_direct_full_t<psl::ecs::entity_t, const core::ecs::components::culled_tag> culled);
+
+	core::resource::handle<core::os::surface> m_Surface;
+
+	// world space bounds of the renderables, in the order of the renderables pack
+	psl::aabb_array m_Bounds;
+	psl::array<psl::mat4x4> m_Models;
+	psl::array<uint32_t> m_Indices;
+	// per renderable, set when atleast one camera can see it
+	psl::array<uint8_t> m_Seen;
+	// scratch buffers for the changes to the culled_tag
+	psl::array<psl::ecs::entity_t::size_type> m_Tagged;
+	psl::array<psl::ecs::entity_t> m_Hidden;
+	psl::array<psl::ecs::entity_t> m_Revealed;
+	// the visible entities, keyed on the camera entity
+	std::unordered_map<psl::ecs::entity_t::size_type, psl::array<psl::ecs::entity_t>> m_Visible;
+};
+}	 // namespace core::ecs::systems
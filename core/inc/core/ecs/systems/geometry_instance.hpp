@@ -6,6 +6,11 @@
 #include "core/vk/geometry.hpp"
 #include "psl/ecs/order_by.hpp"
 #include "psl/ecs/state.hpp"
+#include "psl/literals.hpp"
+#include "psl/memory/region.hpp"
+#include "psl/sparse_array.hpp"
+#include <unordered_map>
+#include <vector>
 
 namespace core::ecs::systems {
 class geometry_instancing {
@@ -27,6 +32,26 @@ class geometry_instancing {
 		uint32_t id;
 	};
 
+	/// \brief the instances of a geometry in a bundle that are owned by dynamic entities.
+	struct dynamic_group {
+		core::resource::handle<core::gfx::bundle> bundle;
+		core::resource::handle<core::gfx::geometry_t> geometry;
+		// the entity owning each instance id, released ids are swapped with the last id so the ids stay compact
+		std::vector<psl::ecs::entity_t> owners;
+		// instance ids whose model matrix needs to be uploaded
+		std::vector<uint32_t> dirty;
+		// entities that need a new instance, and their transform
+		std::vector<std::pair<psl::ecs::entity_t, core::ecs::components::transform>> pending;
+	};
+
+	/// \brief the instance slot of a dynamic entity, which stays stable for as long as the entity is rendered.
+	struct dynamic_instance {
+		dynamic_group* group {nullptr};
+		uint32_t id {0};
+		core::ecs::components::transform transform;
+		uint64_t tick {0};
+	};
+
   public:
 	geometry_instancing(psl::ecs::state_t& state);
 	~geometry_instancing() = default;
@@ -44,11 +69,16 @@ class geometry_instancing {
 	*/
 	void dynamic_system(
 	  psl::ecs::info_t& info,
-	  psl::ecs::pack_direct_full_t<core::ecs::components::renderable,
+	  psl::ecs::pack_direct_full_t<psl::ecs::entity_t,
+								   const core::ecs::components::renderable,
 								   const core::ecs::components::transform,
 								   const core::ecs::components::dynamic_tag,
-								   psl::ecs::except<core::ecs::components::dont_render_tag>,
-								   psl::ecs::order_by<renderer_sort, core::ecs::components::renderable>> geometry_pack);
+								   psl::ecs::except<core::ecs::components::dont_render_tag,
+													core::ecs::components::culled_tag>> geometry_pack);
+
+	dynamic_group& dynamic_group_for(const core::ecs::components::renderable& renderer);
+	/// \brief releases the instance of the entity, moving the last instance of its group into the freed slot.
+	void dynamic_release(psl::ecs::entity_t entity);
 
 	void
 	static_add(psl::ecs::info_t& info,
@@ -85,5 +115,13 @@ class geometry_instancing {
 	// void static_disable();
 	// void static_enable(psl::ecs::info& info, psl::ecs::pack_direct_full_t<psl::ecs::entity_t, const
 	// core::ecs::components::renderable, const instance_id, core::ecs::components::dont_render_tag> dont_render);
+
+	// the dynamic groups, keyed on bundle and geometry
+	std::unordered_map<psl::UID, std::unordered_map<psl::UID, dynamic_group>> m_DynamicGroups;
+	psl::sparse_array<dynamic_instance, psl::ecs::entity_t::size_type> m_DynamicInstances;
+	uint64_t m_Tick {0};
+	// the model matrices that are uploaded during a tick, they only live until their upload is committed so the
+	// region is reset at the start of every tick.
+	memory::region m_FrameMemory {16_mb, alignof(psl::mat4x4), new memory::linear_allocator(true)};
 };
 }	 // namespace core::ecs::systems
@@ -1,9 +1,12 @@
 #pragma once
 #include "core/gfx/context.hpp"
 #include "core/resource/resource.hpp"
+#include "psl/ecs/entity.hpp"
 #include "psl/ecs/pack.hpp"
 #include "psl/math/math.hpp"
 #include "psl/memory/segment.hpp"
+#include "psl/sparse_array.hpp"
+#include <atomic>
 
 namespace core::gfx {
 class buffer_t;
@@ -25,6 +28,11 @@ struct info_t;
 }	 // namespace psl::ecs
 
 namespace core::ecs::systems {
+/// \brief uploads the framedata of every camera to the shader_buffer_binding, in the order of the camera pack.
+///
+/// The framedata of all cameras is written into a contiguous staging array in parallel, and uploaded in a single commit
+/// per frame. A camera only recomputes its framedata when its transform, its camera component or the surface size has
+/// changed since the previous frame, and nothing is uploaded when no camera changed.
 class gpu_camera {
 	const psl::mat4x4
 	  clip {1.0f, 0.0f, 0.0f, 0.0f, +0.0f, -1.0f, 0.0f, 0.0f, +0.0f, 0.0f, 0.5f, 0.0f, +0.0f, 0.0f, 0.5f, 1.0f};
@@ -50,11 +58,32 @@ class gpu_camera {
 			   core::resource::handle<core::os::surface> surface,
 			   core::resource::handle<core::gfx::shader_buffer_binding> binding,
 			   core::gfx::graphics_backend backend);
+	void prepare(psl::ecs::info_t& info,
+				 psl::ecs::pack_direct_full_t<psl::ecs::entity_t,
+											  const core::ecs::components::camera,
+											  const core::ecs::components::transform> cameras);
+	void update(psl::ecs::info_t& info,
+				psl::ecs::pack_direct_partial_t<psl::ecs::entity_t,
+												const core::ecs::components::camera,
+												const core::ecs::components::transform> cameras);
 	void tick(psl::ecs::info_t& info,
 			  psl::ecs::pack_direct_full_t<const core::ecs::components::camera, const core::ecs::components::transform>
 				cameras);
 
   private:
+	// everything the framedata of a camera is derived from
+	using inputs_t = std::array<float, 12>;
+
+	struct slot_t {
+		psl::ecs::entity_t entity {};
+		inputs_t inputs {};
+	};
+
+	static inputs_t inputs(const core::ecs::components::transform& transform,
+						   const core::ecs::components::camera& camera,
+						   float width,
+						   float height) noexcept;
+
 	void update_buffer(size_t index,
 					   const core::ecs::components::transform& transform,
 					   const core::ecs::components::camera& camera);
@@ -62,7 +91,15 @@ class gpu_camera {
 	core::resource::handle<core::os::surface> m_Surface;
 	core::resource::handle<core::gfx::shader_buffer_binding> m_Binding;
 	size_t m_Max {0};
+	size_t m_Stride {0};
 	core::gfx::graphics_backend m_Backend;
+
+	// the slot of every camera entity, in the order of the camera pack
+	psl::sparse_array<uint32_t, psl::ecs::entity_t::size_type> m_Indices;
+	psl::array<slot_t> m_Slots;
+	// the framedata of every slot, m_Stride bytes apart, as it is uploaded
+	psl::array<std::byte> m_Frames;
+	std::atomic<bool> m_Dirty {true};
 };
 
 }	 // namespace core::ecs::systems
@@ -1,11 +1,15 @@
 #pragma once
+#include "core/ecs/components/camera.hpp"
 #include "core/ecs/components/lighting.hpp"
 #include "core/ecs/components/transform.hpp"
 #include "core/ecs/systems/render.hpp"
 #include "core/resource/resource.hpp"
 #include "psl/ecs/entity.hpp"
 #include "psl/ecs/selectors.hpp"
+#include "psl/math/clusters.hpp"
+#include "psl/sparse_array.hpp"
 #include "psl/view_ptr.hpp"
+#include <mutex>
 #include <stdint.h>
 
 namespace core::gfx {
@@ -34,8 +38,37 @@ class region;
 namespace core::ecs::systems {
 //	class render;
 
+/// \brief creates the shadow passes of the lights, and assigns the lights to the clusters of every camera.
+///
+/// Every tick the lights are uploaded to GLOBAL_LIGHT_DATA, with the directional lights first, as they affect every
+/// cluster. The view frustum of every camera is subdivided in a psl::cluster_grid, and the point and spot lights are
+/// assigned to the clusters they overlap in parallel (as spheres, spot lights use their length as radius). The compact
+/// per cluster light lists are uploaded to GLOBAL_LIGHT_CLUSTERS, in the same order as the cameras of
+/// core::ecs::systems::gpu_camera, so that shaders only have to iterate the lights of the cluster a fragment is in.
 class lighting_system {
   public:
+	/// \brief a light as it is laid out in GLOBAL_LIGHT_DATA, after a header of four `uint32_t`, the amount of
+	/// lights and the amount of directional lights.
+	struct light_data {
+		psl::vec4 position;		// xyz position, w radius (or length for spot lights)
+		psl::vec4 color;		// rgb color, w intensity
+		psl::vec4 direction;	// xyz direction, w the core::ecs::components::light::type
+		psl::vec4 angles;		// x inner, y outer angle of spot lights
+	};
+
+	/// \brief the header of the clusters of a camera in GLOBAL_LIGHT_CLUSTERS, it is followed by the offsets
+	/// (`dimensions.w + 1` of them) and the light indices, see psl::cluster_lights.
+	struct cluster_header {
+		std::array<uint32_t, 4> dimensions;	   // xyz the cluster_grid::dimensions(), w the amount of clusters
+		psl::vec4 depth;					   // x near, y far, z and w the cluster_grid::slice_transform()
+	};
+
+	static constexpr std::array<uint32_t, 3> cluster_dimensions {16, 9, 24};
+	static constexpr size_t max_lights {4096};
+	static constexpr size_t max_cameras {4};
+	// the maximum amount of light indices of all clusters of a camera combined
+	static constexpr size_t max_cluster_lights {65536};
+
 	lighting_system(psl::view_ptr<psl::ecs::state_t> state,
 					psl::view_ptr<core::resource::cache_t> cache,
 					memory::region& resource_region,
@@ -54,6 +87,34 @@ class lighting_system {
 		pack);
 
   private:
+	struct camera_clusters {
+		psl::mat4x4 view;
+		// the fov, aspect ratio, near and far the grid was built for, the grid is only built again when they change
+		psl::vec4 projection;
+		psl::cluster_grid grid;
+		// (cluster, light) pairs, appended to by every invocation of assign_clusters
+		psl::array<std::pair<uint32_t, uint32_t>> pairs;
+		psl::cluster_lights lights;
+		// set while the light indices do not fit the upload, the warning is only logged when it becomes set
+		bool truncated {false};
+	};
+
+	void prepare_clusters(
+	  psl::ecs::info_t& info,
+	  psl::ecs::pack_direct_full_t<const core::ecs::components::camera, const core::ecs::components::transform>
+		cameras,
+	  psl::ecs::pack_direct_full_t<psl::ecs::entity_t,
+								   const core::ecs::components::light,
+								   const core::ecs::components::transform> lights);
+
+	void assign_clusters(psl::ecs::info_t& info,
+						 psl::ecs::pack_direct_partial_t<psl::ecs::entity_t,
+														 const core::ecs::components::light,
+														 const core::ecs::components::transform> lights);
+
+	void upload_clusters(psl::ecs::info_t& info,
+						 psl::ecs::pack_direct_full_t<const core::ecs::components::camera> cameras);
+
 	psl::view_ptr<core::resource::cache_t> m_Cache;
 	psl::view_ptr<core::gfx::render_graph> m_RenderGraph;
 	psl::view_ptr<core::gfx::drawpass> m_DependsPass;
@@ -62,6 +123,18 @@ class lighting_system {
 	core::resource::handle<core::os::surface> m_Surface;
 	core::resource::handle<core::gfx::buffer_t> m_LightDataBuffer;
 	memory::segment m_LightSegment;
+	core::resource::handle<core::gfx::buffer_t> m_ClusterBuffer;
+	memory::segment m_ClusterSegment;
+
+	psl::array<light_data> m_Lights;
+	uint32_t m_DirectionalLights {0};
+	// set while not all lights fit the upload, the warning is only logged when it becomes set
+	bool m_TruncatedLights {false};
+	// the index of every light entity in m_Lights
+	psl::sparse_array<uint32_t, psl::ecs::entity_t::size_type> m_LightIndices;
+	psl::array<camera_clusters> m_Clusters;
+	std::mutex m_ClustersMutex;
+	psl::array<std::byte> m_Staging;
 
 	// std::unordered_map<psl::ecs::entity_t, psl::view_ptr<core::gfx::drawpass>> m_Passes;
 	std::unordered_map<psl::ecs::entity_t::size_type, psl::unique_ptr<core::ecs::systems::render>> m_Systems;
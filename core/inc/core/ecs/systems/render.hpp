@@ -22,7 +22,7 @@ class render {
   public:
 	render(psl::ecs::state_t& state, psl::view_ptr<core::gfx::drawpass> pass);
 
-	~render() = default;
+	~render();
 
 	render(const render&)			 = delete;
 	render(render&&)				 = delete;
@@ -26,6 +26,7 @@ enum class geometry_type { STATIC = 0, DYNAMIC = 1 };
 namespace constants {
 	static constexpr psl::string_view INSTANCE_MODELMATRIX		  = "INSTANCE_TRANSFORM";
 	static constexpr psl::string_view INSTANCE_LEGACY_MODELMATRIX = "iModelMat";
+	static constexpr details::instance::binding_id INSTANCE_MODELMATRIX_ID {INSTANCE_MODELMATRIX};
 }	 // namespace constants
 
 /// \detail
@@ -111,25 +112,81 @@ class bundle final {
 	/// \brief set instance data for the given instance (and range)
 	/// \param[in] geometry target UID
 	/// \param[in] id first instance ID
-	/// \param[in] name name of the buffer (present in the shader)
+	/// \param[in] binding the id of the buffer's name (present in the shader), see details::instance::binding_id
 	/// \param[in] values the values to set, where the size + id indicates the end of the range
 	/// \returns true if the geometry was found, all instances were present, and the upload dispatched. The upload
 	/// is async.
 	template <typename T>
 	bool set(core::resource::tag<core::gfx::geometry_t> geometry,
 			 uint32_t id,
-			 psl::string_view name,
+			 details::instance::binding_id binding,
 			 const psl::array<T>& values) {
 		static_assert(std::is_trivially_copyable<T>::value, "the type has to be trivially copyable");
 		static_assert(std::is_standard_layout<T>::value, "the type has to be is_standard_layout");
-		auto res = m_InstanceData.segment(geometry, name);
+		auto res = m_InstanceData.segment(geometry, binding);
 		if(!res) {
-			core::gfx::log->error("The element name {} was not found on geometry {}", name, geometry.uid().to_string());
+			core::gfx::log->error(
+			  "The element with id {} was not found on geometry {}", binding.value, geometry.uid().to_string());
 			return false;
 		}
 		return set(geometry, id, res.value().first, res.value().second, values.data(), sizeof(T), values.size());
 	}
 
+	/// \brief set instance data for the given instance (and range)
+	/// \param[in] name name of the buffer (present in the shader)
+	/// \note prefer passing a precomputed details::instance::binding_id for repeated updates.
+	template <typename T>
+	bool set(core::resource::tag<core::gfx::geometry_t> geometry,
+			 uint32_t id,
+			 psl::string_view name,
+			 const psl::array<T>& values) {
+		return set(geometry, id, details::instance::binding_id {name}, values);
+	}
+
+	/// \brief set instance data for several ranges of instances in a single upload
+	/// \param[in] geometry target UID
+	/// \param[in] binding the id of the buffer's name (present in the shader), see details::instance::binding_id
+	/// \param[in] ranges the [first, last) instance ID ranges to write to
+	/// \param[in] values the values to set, where the values of every range follow the ones of the previous range
+	/// \returns true if the geometry was found, and the upload dispatched. The upload is async.
+	template <typename T>
+	bool set(core::resource::tag<core::gfx::geometry_t> geometry,
+			 details::instance::binding_id binding,
+			 const psl::array<std::pair<uint32_t, uint32_t>>& ranges,
+			 const psl::array<T>& values) {
+		return set(geometry, binding, ranges, values.data());
+	}
+
+	/// \brief set instance data for several ranges of instances in a single upload
+	/// \param[in] values points to the values of all ranges, where the values of every range follow the ones of the
+	/// previous range. These only have to stay alive for the duration of the call.
+	template <typename T>
+	bool set(core::resource::tag<core::gfx::geometry_t> geometry,
+			 details::instance::binding_id binding,
+			 const psl::array<std::pair<uint32_t, uint32_t>>& ranges,
+			 const T* values) {
+		static_assert(std::is_trivially_copyable<T>::value, "the type has to be trivially copyable");
+		static_assert(std::is_standard_layout<T>::value, "the type has to be is_standard_layout");
+		auto res = m_InstanceData.segment(geometry, binding);
+		if(!res) {
+			core::gfx::log->error(
+			  "The element with id {} was not found on geometry {}", binding.value, geometry.uid().to_string());
+			return false;
+		}
+		return set(geometry, res.value().first, res.value().second, ranges, values, sizeof(T));
+	}
+
+	/// \brief set instance data for several ranges of instances in a single upload
+	/// \param[in] name name of the buffer (present in the shader)
+	/// \note prefer passing a precomputed details::instance::binding_id for repeated updates.
+	template <typename T>
+	bool set(core::resource::tag<core::gfx::geometry_t> geometry,
+			 psl::string_view name,
+			 const psl::array<std::pair<uint32_t, uint32_t>>& ranges,
+			 const psl::array<T>& values) {
+		return set(geometry, details::instance::binding_id {name}, ranges, values);
+	}
+
 	template <typename T>
 	bool set(core::resource::tag<core::gfx::material_t> material, const T& value, size_t offset = 0) {
 		static_assert(std::is_trivially_copyable<T>::value, "the type has to be trivially copyable");
@@ -174,6 +231,13 @@ class bundle final {
 			 size_t size,
 			 size_t count = 1);
 
+	bool set(core::resource::tag<core::gfx::geometry_t> geometry,
+			 memory::segment segment,
+			 uint32_t size_of_element,
+			 const psl::array<std::pair<uint32_t, uint32_t>>& ranges,
+			 const void* data,
+			 size_t size);
+
 	bool set(core::resource::tag<core::gfx::material_t> material, const void* data, size_t size, size_t offset);
 
 	// ------------------------------------------------------------------------------------------------------------
@@ -50,6 +50,8 @@ class context {
 #endif
 	};
 	void wait_idle();
+	/// \brief marks the end of a frame, allowing the backend to recycle the resources that are no longer in flight.
+	void end_frame();
 
   private:
 	core::gfx::graphics_backend m_Backend {graphics_backend::undefined};
@@ -22,18 +22,36 @@ class material_t;
 }	 // namespace core::gfx
 
 namespace core::gfx::details::instance {
+/// \brief identifies an instance binding by the hash of its name.
+/// \details The hash can be computed at compile time, so that the well known bindings (such as
+/// core::gfx::constants::INSTANCE_MODELMATRIX) are looked up without creating, or comparing strings.
+struct binding_id {
+	constexpr binding_id() noexcept = default;
+	constexpr explicit binding_id(psl::string_view name) noexcept {
+		// 64bit FNV-1a
+		for(auto character : name) value = (value ^ static_cast<uint64_t>(character)) * 0x100000001b3;
+	}
+
+	constexpr bool operator==(const binding_id& b) const noexcept = default;
+	uint64_t value {0xcbf29ce484222325};
+};
+
 struct binding {
 	struct header final {
 		bool operator==(const header& b) const noexcept {
-			return /*size_of_element == b.size_of_element && */ name == b.name;
+			return /*size_of_element == b.size_of_element && */ id == b.id;
 		}
 		psl::string name {};
 		uint32_t size_of_element {0};
+		binding_id id {};
 	};
 
 	bool operator==(const binding& b) const noexcept { return description == b.description; }
 	header description;
 	uint32_t slot;
+	// index of the binding in the unique bindings of the instance data, which is also its index in the description
+	// and data of every object.
+	uint32_t index {0};
 };
 
 struct object final {
@@ -46,6 +64,15 @@ struct object final {
 	psl::generator<uint32_t> id_generator;
 	psl::array<binding::header> description;
 	psl::array<memory::segment> data;
+
+	/// \returns the index of the binding in description and data, if this object has it.
+	std::optional<size_t> find(binding_id id) const noexcept {
+		for(size_t i = 0; i < description.size(); ++i) {
+			if(description[i].id == id)
+				return i;
+		}
+		return std::nullopt;
+	}
 };
 }	 // namespace core::gfx::details::instance
 
@@ -62,7 +89,7 @@ struct hash<core::gfx::details::instance::object> {
 template <>
 struct hash<core::gfx::details::instance::binding::header> {
 	std::size_t operator()(const core::gfx::details::instance::binding::header& s) const noexcept {
-		std::size_t seed = std::hash<psl::string> {}(s.name);
+		std::size_t seed = static_cast<std::size_t>(s.id.value);
 		// seed ^= (uint64_t)s.size_of_element + 0x9e3779b9 + (seed << 6) + (seed >> 2);
 		return seed;
 	}
@@ -102,15 +129,28 @@ class data final {
 	bool remove(core::resource::handle<core::gfx::material_t> material) noexcept;
 
 
-	bool has_element(core::resource::tag<core::gfx::geometry_t> geometry, psl::string_view name) const noexcept;
+	bool has_element(core::resource::tag<core::gfx::geometry_t> geometry, binding_id id) const noexcept;
+	bool has_element(core::resource::tag<core::gfx::geometry_t> geometry, psl::string_view name) const noexcept {
+		return has_element(geometry, binding_id {name});
+	}
+
+	/// \returns the segment of the binding's instance data for the given geometry, and the size of a single element.
 	std::optional<std::pair<memory::segment, uint32_t>> segment(core::resource::tag<core::gfx::geometry_t> geometry,
-																psl::string_view name) const noexcept;
+																binding_id id) const noexcept;
+	std::optional<std::pair<memory::segment, uint32_t>> segment(core::resource::tag<core::gfx::geometry_t> geometry,
+																psl::string_view name) const noexcept {
+		return segment(geometry, binding_id {name});
+	}
 	uint32_t count(core::resource::tag<core::gfx::geometry_t> uid) const noexcept;
 
 	psl::array<std::pair<size_t, std::uintptr_t>>
 	bindings(core::resource::tag<core::gfx::material_t> material,
 			 core::resource::tag<core::gfx::geometry_t> geometry) const noexcept;
 
+	/// \returns the size of a single instance element of every binding of the material, in the same order as
+	/// bindings().
+	psl::array<uint32_t> strides(core::resource::tag<core::gfx::material_t> material) const noexcept;
+
 	core::resource::handle<core::gfx::buffer_t> vertex_buffer() const noexcept { return m_VertexInstanceBuffer; }
 	core::resource::handle<core::gfx::buffer_t> material_buffer() const noexcept;
 
@@ -40,9 +40,19 @@ class drawcall {
 
 	void bundle(core::resource::handle<core::gfx::bundle> bundle) noexcept;
 	core::resource::handle<core::gfx::bundle> bundle() const noexcept;
+	/// \returns the geometry of the drawcall, along with the amount of times it was added.
+	const std::vector<std::pair<core::resource::handle<core::gfx::geometry_t>, size_t>>& geometry() const noexcept {
+		return m_Geometry;
+	}
+
+	/// \returns a value that changes whenever the bundle or the geometry (including the amount of references to it) of
+	/// the drawcall changes, it is unique across all drawcalls.
+	/// \note changes made to the bundle itself (i.e. setting a material) are not tracked.
+	uint64_t version() const noexcept { return m_Version; }
 
   private:
 	core::resource::handle<core::gfx::bundle> m_Bundle;
 	std::vector<std::pair<core::resource::handle<core::gfx::geometry_t>, size_t>> m_Geometry;
+	uint64_t m_Version {0};
 };
 }	 // namespace core::gfx
@@ -21,6 +21,7 @@ namespace core::gfx {
 class bundle;
 class drawgroup;
 class drawcall;
+class drawlist;
 
 /// \brief a collection of draw instructions to be recorded and sent to the GPU.
 ///
@@ -51,6 +52,29 @@ class drawgroup {
 	std::optional<std::reference_wrapper<drawcall>> get(const drawlayer& layer,
 														core::resource::handle<core::gfx::bundle> bundle) noexcept;
 
+	/// \brief a render index of a drawlayer that has draws, and a value that identifies the state of those draws.
+	struct segment_t {
+		uint32_t renderIndex {0};
+		/// \brief changes whenever one of the drawcalls that have a material at the render index changes, or when the
+		/// amount of instances of one of their geometries changes.
+		uint64_t version {0};
+	};
+
+	/// \returns the drawlayers of the group, ordered on their priority.
+	std::vector<std::reference_wrapper<const drawlayer>> layers() const;
+	/// \returns the render indices of the drawlayer that the drawcalls have materials at, ordered on the render index.
+	/// \details this only inspects the drawcalls, so it can be used to find the render indices that changed without
+	/// resolving any draws (see core::gfx::drawcall::version()).
+	std::vector<segment_t> segments(const drawlayer& layer) const;
+
+	/// \brief appends the drawlayers of the group, and a draw for every material and geometry combination of the
+	/// drawcalls that has instances, to the list.
+	/// \details the work is proportional to the amount of draws that are produced, the list still has to be sorted
+	/// (see core::gfx::drawlist::sort()) before it can be consumed.
+	void build(drawlist& list) const;
+	/// \brief appends only the draws at the render index of the drawlayer to the list, as a drawlayer of their own.
+	void build(drawlist& list, const drawlayer& layer, uint32_t renderIndex) const;
+
 	// bool remove(const drawlayer& layer);
 	// bool remove(const drawcall& call);
 	// bool remove(const drawlayer& layer, const drawcall& call);
@@ -1,5 +1,6 @@
 #pragma once
-
+#include "psl/ustring.hpp"
+#include <cstdint>
 
 namespace core::gfx {
 struct drawlayer {
@@ -0,0 +1,86 @@
+#pragma once
+#include "core/fwd/gfx/bundle.hpp"
+#include "core/fwd/gfx/geometry.hpp"
+#include "core/fwd/gfx/material.hpp"
+#include "core/gfx/drawlayer.hpp"
+#include "core/resource/resource.hpp"
+#include <unordered_map>
+#include <vector>
+
+namespace core::gfx {
+/// \brief a flat list of draws, ordered on a packed 64bit sort key.
+///
+/// The key packs, from most to least significant, the index of the drawlayer the draw belongs to, the render index of
+/// the material relative to the start of the drawlayer, the material, and the geometry. After sort() the draws of the
+/// same drawlayer are consecutive, ordered on their render index, and within the same render index draws that share
+/// their material (and then geometry) are consecutive. Backends can then consume the list linearly,
+/// skipping the pipeline, descriptor and vertex binds that are the same as those of the previous draw.
+///
+/// Materials and geometry are identified in the key by a dense id (see id()), which is only stable until clear().
+class drawlist {
+  public:
+	struct draw_t {
+		core::resource::handle<core::gfx::bundle> bundle;
+		core::resource::handle<core::gfx::material_t> material;
+		core::resource::handle<core::gfx::geometry_t> geometry;
+		// index of the drawlayer in layers()
+		uint32_t layer {0};
+		uint32_t renderLayer {0};
+		uint32_t instances {0};
+	};
+
+	static constexpr uint64_t layer_bits {16};
+	static constexpr uint64_t order_bits {16};
+	static constexpr uint64_t material_bits {16};
+	static constexpr uint64_t geometry_bits {16};
+	static_assert(layer_bits + order_bits + material_bits + geometry_bits == 64);
+
+	/// \brief the amount of drawlayers a single list can hold, see add_layer().
+	static constexpr size_t max_layers {size_t {1} << layer_bits};
+
+	/// \brief packs the sort key, every field is truncated to the amount of bits it has in the key.
+	static constexpr uint64_t key(uint32_t layer, uint32_t order, uint32_t material, uint32_t geometry) noexcept {
+		auto field = [](uint64_t value, uint64_t bits) { return value & ((uint64_t {1} << bits) - 1); };
+		uint64_t res {field(layer, layer_bits)};
+		res = (res << order_bits) | field(order, order_bits);
+		res = (res << material_bits) | field(material, material_bits);
+		res = (res << geometry_bits) | field(geometry, geometry_bits);
+		return res;
+	}
+
+	void clear() noexcept;
+
+	/// \brief appends a drawlayer to the list.
+	/// \returns the index of the drawlayer, draws are ordered on this index first.
+	/// \warning a list can hold up to max_layers drawlayers.
+	uint32_t add_layer(const drawlayer& layer);
+	const std::vector<drawlayer>& layers() const noexcept { return m_Layers; }
+
+	/// \returns a dense id for the resource, that is used to group draws on in the sort key.
+	uint32_t id(const psl::UID& uid);
+
+	/// \brief adds the draw, deriving its key from the draw's layer, render index, material and geometry.
+	void add(const draw_t& draw);
+	/// \brief adds the draw with an explicit sort key (see key()).
+	void add(uint64_t key, const draw_t& draw);
+
+	/// \brief radix sorts the draws on their key, draws with identical keys keep the order they were added in.
+	void sort();
+
+	size_t size() const noexcept { return m_Draws.size(); }
+	bool empty() const noexcept { return m_Draws.empty(); }
+	/// \returns the draw at the given index, in sorted order after sort().
+	const draw_t& operator[](size_t index) const noexcept { return m_Draws[m_Order[index]]; }
+	uint64_t sort_key(size_t index) const noexcept { return m_Keys[index]; }
+
+  private:
+	std::vector<drawlayer> m_Layers {};
+	std::vector<draw_t> m_Draws {};
+	// the keys and the index of their draw, both in sorted order after sort()
+	std::vector<uint64_t> m_Keys {};
+	std::vector<uint32_t> m_Order {};
+	std::vector<uint64_t> m_KeysScratch {};
+	std::vector<uint32_t> m_OrderScratch {};
+	std::unordered_map<psl::UID, uint32_t> m_Ids {};
+};
+}	 // namespace core::gfx
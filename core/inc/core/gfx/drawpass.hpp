@@ -71,7 +71,11 @@ class drawpass {
 	bool disconnect(psl::view_ptr<core::gfx::computepass> child) noexcept {
 		return true;
 	};
+	/// \brief adds the drawgroup to the pass, the pass refers to the group so it should be removed before it is
+	/// destroyed.
+	/// \note changes made to the group are picked up the next time the pass is built, see dirty().
 	void add(core::gfx::drawgroup& group) noexcept;
+	void remove(const core::gfx::drawgroup& group) noexcept;
 
 	void dirty(bool value) noexcept {
 		m_Dirty = value;
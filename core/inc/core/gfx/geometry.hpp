@@ -1,6 +1,7 @@
 #pragma once
 #include "core/fwd/gfx/geometry.hpp"
 #include "core/resource/resource.hpp"
+#include "psl/math/culling.hpp"
 
 namespace core::data {
 class geometry_t;
@@ -53,8 +54,13 @@ class geometry_t {
 	size_t indices() const noexcept;
 	size_t triangles() const noexcept;
 
+	/// \returns the bounds of the vertex positions in model space, these are computed when the data is (re)loaded.
+	/// \note geometry without position data has infinite bounds, and so is never culled.
+	const psl::aabb& bounds() const noexcept { return m_Bounds; }
+
   private:
 	core::gfx::graphics_backend m_Backend {graphics_backend::undefined};
+	psl::aabb m_Bounds {psl::vec3::zero, psl::vec3::infinity};
 #ifdef PE_VULKAN
 	core::resource::handle<core::ivk::geometry_t> m_VKHandle;
 #endif
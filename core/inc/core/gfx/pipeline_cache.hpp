@@ -1,10 +1,14 @@
 #pragma once
 #include "core/fwd/gfx/pipeline_cache.hpp"
 #include "core/resource/resource.hpp"
+#include "psl/array_view.hpp"
 #include <variant>
 
 namespace core::gfx {
 class context;
+class framebuffer_t;
+class swapchain;
+class material_t;
 
 class pipeline_cache {
   public:
@@ -27,6 +31,15 @@ class pipeline_cache {
 	pipeline_cache& operator=(const pipeline_cache& other)	   = default;
 	pipeline_cache& operator=(pipeline_cache&& other) noexcept = default;
 
+	/// \brief starts compiling the pipelines of the materials when bound to the framebuffer, in the background.
+	/// \note only the vulkan backend compiles ahead of time, see core::ivk::pipeline_cache::prewarm().
+	void prewarm(psl::array_view<core::resource::handle<material_t>> materials,
+				 core::resource::handle<framebuffer_t> framebuffer);
+	/// \brief starts compiling the pipelines of the materials when bound to the swapchain, in the background.
+	/// \note only the vulkan backend compiles ahead of time, see core::ivk::pipeline_cache::prewarm().
+	void prewarm(psl::array_view<core::resource::handle<material_t>> materials,
+				 core::resource::handle<swapchain> swapchain);
+
 	template <core::gfx::graphics_backend backend>
 	core::resource::handle<backend_type_t<pipeline_cache, backend>> resource() const noexcept {
 #ifdef PE_VULKAN
@@ -4,6 +4,7 @@
 #include "core/resource/resource.hpp"
 #include "psl/array.hpp"
 #include "psl/memory/segment.hpp"
+#include <deque>
 #include <optional>
 
 namespace core::data {
@@ -11,6 +12,12 @@ class buffer_t;
 }
 
 namespace core::igles {
+/// \brief GPU buffer, backed by a core::data::buffer_t.
+///
+/// Buffers whose data is written every frame (core::gfx::memory_write_frequency::per_frame) stream their commits
+/// through a ring of staging memory that is mapped unsynchronized, and copied into the buffer on the GPU. Every
+/// commit is fenced, and the ring grows rather than waiting on a fence that has not been signalled yet, so it
+/// settles at holding the writes of a few frames without ever synchronizing with the GPU.
 class buffer_t {
   public:
 	buffer_t(core::resource::cache_t& cache,
@@ -66,13 +73,35 @@ class buffer_t {
 
 	bool copy_from(const buffer_t& other, const psl::array<core::gfx::memory_copy>& ranges);
 
+	/// \brief writes the instructions into the buffer, instructions into contiguous ranges are merged.
 	bool commit(const psl::array<core::gfx::commit_instruction>& instructions);
 	size_t free_size() const noexcept;
 
+	/// \returns true when commits to this buffer are streamed through a staging ring.
+	bool streaming() const noexcept { return m_Streaming; }
+
   private:
+	struct fence_t {
+		GLsync sync;
+		// ring position up to which the staged data has been consumed once the fence is signalled
+		size_t end {0};
+	};
+
+	/// \returns the offset in the staging ring of a free range of the given size.
+	size_t stream_allocate(size_t size);
+	void stream_grow(size_t size);
+
 	GLuint m_Buffer;
 	GLint m_BufferType;
 	core::resource::handle<core::data::buffer_t> m_BufferDataHandle;
 	psl::UID m_UID;
+
+	bool m_Streaming {false};
+	GLuint m_Stream {0};
+	size_t m_StreamCapacity {0};
+	// monotonically increasing positions, the offset in the ring is the position modulo the capacity.
+	size_t m_StreamHead {0};
+	size_t m_StreamTail {0};
+	std::deque<fence_t> m_StreamFences;
 };
 }	 // namespace core::igles
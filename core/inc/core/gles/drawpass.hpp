@@ -1,14 +1,20 @@
 #pragma once
 #include "core/gfx/computecall.hpp"
 #include "core/gfx/drawgroup.hpp"
+#include "core/gfx/drawlist.hpp"
+#include "core/gles/frame_pacer.hpp"
 #include "core/gles/types.hpp"
 #include "core/resource/resource.hpp"
+#include "psl/view_ptr.hpp"
 
 namespace core::igles {
 class swapchain;
 class framebuffer_t;
 class computepass;
 
+/// \brief records and submits the drawgroups into a framebuffer or swapchain.
+/// \note drawpasses that present to a swapchain pace the frames, so the CPU can run up to frames_in_flight() frames
+/// ahead of the GPU (see core::igles::frame_pacer).
 class drawpass {
 	struct memory_barrier_t {
 		GLbitfield barrier {0};
@@ -16,14 +22,14 @@ class drawpass {
 	};
 
   public:
-	drawpass(core::resource::handle<swapchain> swapchain);
+	drawpass(core::resource::handle<swapchain> swapchain, uint32_t framesInFlight = 2);
 	drawpass(core::resource::handle<framebuffer_t> framebuffer);
-	~drawpass() = default;
+	~drawpass();
 
-	drawpass(const drawpass& other)				   = default;
-	drawpass(drawpass&& other) noexcept			   = default;
-	drawpass& operator=(const drawpass& other)	   = default;
-	drawpass& operator=(drawpass&& other) noexcept = default;
+	drawpass(const drawpass& other)				   = delete;
+	drawpass(drawpass&& other) noexcept			   = delete;
+	drawpass& operator=(const drawpass& other)	   = delete;
+	drawpass& operator=(drawpass&& other) noexcept = delete;
 
 	void clear();
 	void prepare();
@@ -31,7 +37,14 @@ class drawpass {
 	void present();
 
 	bool is_swapchain() const noexcept { return m_Swapchain; }
+
+	/// \returns how many frames the CPU can run ahead of the GPU.
+	uint32_t frames_in_flight() const noexcept { return m_Pacer.frames_in_flight(); }
+	void frames_in_flight(uint32_t value) noexcept { m_Pacer.frames_in_flight(value); }
+	/// \brief adds the drawgroup to the pass, the pass refers to the group so it should be removed before it is
+	/// destroyed.
 	void add(core::gfx::drawgroup& group) noexcept;
+	void remove(const core::gfx::drawgroup& group) noexcept;
 
 	void connect(psl::view_ptr<drawpass> pass) noexcept;
 	void connect(psl::view_ptr<computepass> pass) noexcept;
@@ -42,6 +55,10 @@ class drawpass {
 	core::resource::handle<swapchain> m_Swapchain {};
 	core::resource::handle<framebuffer_t> m_Framebuffer {};
 	psl::array<memory_barrier_t> m_MemoryBarriers {};
-	psl::array<core::gfx::drawgroup> m_DrawGroups {};
+	psl::array<psl::view_ptr<const core::gfx::drawgroup>> m_DrawGroups {};
+	// the draws of all groups, rebuilt and sorted by build() when the pass is dirty. The instance counts are looked up
+	// again when presenting.
+	core::gfx::drawlist m_DrawList {};
+	core::igles::frame_pacer m_Pacer;
 };
 }	 // namespace core::igles
@@ -0,0 +1,45 @@
+#pragma once
+#include "core/gles/types.hpp"
+#include <cstdint>
+#include <deque>
+
+namespace core::igles {
+/// \brief limits how many frames the CPU can run ahead of the GPU.
+///
+/// Every frame ends with a fence (see glFenceSync), and the CPU only waits on the fence of the frame that is
+/// `frames_in_flight()` frames behind the current one. This lets the CPU prepare the next frame while the GPU is
+/// still rendering the previous ones, instead of serializing both every frame (as glFinish does).
+/// \note resources the CPU writes to every frame should not be reused before the frame that used them completed,
+/// see core::igles::buffer_t for how buffers handle this.
+class frame_pacer {
+  public:
+	/// \param[in] framesInFlight how many frames can be pending on the GPU, 1 waits for every frame to complete.
+	explicit frame_pacer(uint32_t framesInFlight = 2) noexcept;
+	~frame_pacer();
+	frame_pacer(const frame_pacer&)			   = delete;
+	frame_pacer(frame_pacer&&)				   = delete;
+	frame_pacer& operator=(const frame_pacer&) = delete;
+	frame_pacer& operator=(frame_pacer&&)	   = delete;
+
+	/// \brief fences the commands of the current frame, and waits until no more than frames_in_flight() - 1 frames
+	/// are still pending on the GPU.
+	void end_frame();
+
+	/// \brief waits for all pending frames to complete.
+	void wait_idle();
+
+	uint32_t frames_in_flight() const noexcept { return m_FramesInFlight; }
+	/// \note lowering the amount of frames in flight will wait on the frames that exceed it at the next end_frame().
+	void frames_in_flight(uint32_t value) noexcept;
+
+	/// \returns the amount of frames that have ended.
+	uint64_t frame() const noexcept { return m_Frame; }
+
+  private:
+	void wait(size_t remaining);
+
+	std::deque<GLsync> m_Fences;
+	uint32_t m_FramesInFlight {2};
+	uint64_t m_Frame {0};
+};
+}	 // namespace core::igles
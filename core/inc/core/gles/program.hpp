@@ -1,5 +1,10 @@
 #pragma once
 #include "core/fwd/resource/resource.hpp"
+#include "core/gles/types.hpp"
+#include "psl/ustring.hpp"
+#include <cstddef>
+#include <optional>
+#include <vector>
 
 namespace core::data {
 class material_t;
@@ -8,14 +13,40 @@ class material_t;
 namespace core::igles {
 class program {
   public:
+	/// \brief binary representation of a linked program, as retrieved from the driver.
+	struct binary_t {
+		GLenum format {0};
+		std::vector<std::byte> data {};
+	};
+
 	program(core::resource::cache_t& cache,
 			const core::resource::metadata& metaData,
 			psl::meta::file* metaFile,
 			core::resource::handle<core::data::material_t> data);
+
+	/// \brief creates the program from a binary that was previously retrieved using binary().
+	/// \details when the driver rejects the binary (for example after a driver update), this falls back to
+	/// compiling the shaders of the material. Use from_binary() to know which path was taken.
+	program(core::resource::cache_t& cache,
+			const core::resource::metadata& metaData,
+			psl::meta::file* metaFile,
+			core::resource::handle<core::data::material_t> data,
+			GLenum binaryFormat,
+			psl::string8::view binary);
 	~program();
 	unsigned int id() const noexcept { return m_Program; }
 
+	/// \returns the binary of the linked program, or nothing when the program is invalid, or the driver does not
+	/// support program binaries.
+	std::optional<binary_t> binary() const;
+
+	/// \returns true when the program was created from a binary, instead of from the shader sources.
+	bool from_binary() const noexcept { return m_FromBinary; }
+
   private:
-	unsigned int m_Program;
+	void link(core::resource::cache_t& cache, psl::meta::file* metaFile, const core::data::material_t& data);
+
+	unsigned int m_Program {0};
+	bool m_FromBinary {false};
 };
 }	 // namespace core::igles
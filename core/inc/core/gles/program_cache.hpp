@@ -1,17 +1,25 @@
 #pragma once
 #include "core/fwd/resource/resource.hpp"
+#include "core/gles/program.hpp"
+#include "psl/meta.hpp"
+#include <cstdint>
+#include <unordered_map>
 
 namespace core::data {
 class material_t;
 }
 
 namespace core::igles {
-class program;
-
+/// \brief caches the linked programs, and their binaries.
+///
+/// programs are keyed on a hash of their shader sources. When the psl::meta::library contains a physical file for
+/// the psl::UID of this resource, then the program binaries (see glGetProgramBinary) are loaded from it at creation,
+/// and written back on destruction. This avoids compiling and linking the shaders on subsequent runs. The stored
+/// binaries are tagged with the vendor, renderer and version of the driver, and are discarded when they differ.
 class program_cache {
   public:
 	program_cache(core::resource::cache_t& cache, const core::resource::metadata& metaData, psl::meta::file* metaFile);
-	~program_cache() = default;
+	~program_cache();
 
 	program_cache(const program_cache& other)				 = delete;
 	program_cache(program_cache&& other) noexcept			 = delete;
@@ -24,7 +32,21 @@ class program_cache {
 	core::resource::handle<core::igles::program> get(const psl::UID& uid,
 													 core::resource::handle<core::data::material_t> data);
 
+	/// \brief writes the known program binaries to the psl::meta::library.
+	/// \returns false when the library has no physical file for this resource, or the data could not be written.
+	/// \note this is done automatically on destruction.
+	bool save();
+
   private:
+	uint64_t key(const core::data::material_t& data);
+
+	psl::UID m_UID;
 	core::resource::cache_t* m_Cache;
+	uint64_t m_Driver {0};
+	bool m_SupportsBinaries {false};
+	bool m_Dirty {false};
+	std::unordered_map<uint64_t, program::binary_t> m_Binaries;
+	// hash of the source of every shader that was used, keyed on the shader's psl::UID
+	std::unordered_map<psl::UID, uint64_t> m_Sources;
 };
 }	 // namespace core::igles
@@ -2,10 +2,17 @@
 #include "core/fwd/resource/resource.hpp"
 #include "psl/library.hpp"
 #include "psl/meta.hpp"
-#include <cstdint>		  // uintptr_t
+#include <chrono>
+#include <cstdint>	  // uintptr_t
+#include <functional>
+#include <future>
+#include <tuple>
 #include <type_traits>	  // std::remove_const/etc
 //#include "psl/memory/region.hpp"
 #include "core/logging.hpp"
+#include "core/resource/details/loader.hpp"
+#include "core/resource/details/pool.hpp"
+#include "psl/platform_utils.hpp"
 #include "psl/profiling/profiler.hpp"
 #include "psl/serialization/serializer.hpp"
 #include "psl/static_array.hpp"
@@ -94,6 +101,8 @@ struct metadata {
 	status state;
 	size_t reference_count;
 	bool strong_type;
+	/// \brief dense index of the resource in its cache, see core::resource::cache_t::at()
+	size_t index;
 };
 
 class cache_t {
@@ -102,9 +111,11 @@ class cache_t {
 		metadata metaData;
 		void* resource {nullptr};
 		size_t age {0};
+		details::pool_base* pool {nullptr};
+		psl::meta::file* metaFile {nullptr};
 	};
 	struct entry {
-		psl::array<psl::unique_ptr<description>> descriptions;
+		psl::array<description*> descriptions;	  // owned by the description pool
 		psl::view_ptr<psl::meta::file> metaFile;	// owned by the library
 	};
 
@@ -123,25 +134,11 @@ class cache_t {
 	}
 	template <typename T, typename... Args>
 	handle<T> instantiate_using(const psl::UID& uid, const psl::UID& resource_uid, Args&&... args) {
-		using value_type   = std::remove_cv_t<std::remove_const_t<T>>;
-		using meta_type	   = typename resource_traits<T>::meta_type;
-		constexpr auto key = details::key_for<value_type>();
-		if(auto it = m_Deleters.find(key); it == std::end(m_Deleters)) {
-			m_Deleters[key]	 = [](void* resource) { delete((T*)(resource)); };
-			m_TypeNames[key] = typeid(T).name();
-		}
+		using meta_type					 = typename resource_traits<T>::meta_type;
 		auto& data						 = m_Cache[uid];
 		m_RemappedResource[resource_uid] = uid;
 
-		auto& descr = *data.descriptions.emplace_back(
-		  new description {metadata {uid,
-									 resource_uid,
-									 key,
-									 status::initial,
-									 0u,
-									 std::is_same_v<typename details::alias_type<value_type>::type, void>},
-						   nullptr,
-						   m_AgeCounter++});
+		auto& descr = emplace_description<T>(data, uid, resource_uid);
 
 		if(data.metaFile == nullptr) {
 			if(auto optMetaFile = m_Library.get<meta_type>(resource_uid); optMetaFile)
@@ -152,12 +149,17 @@ class cache_t {
 				return {nullptr, this, &descr.metaData, nullptr};
 			}
 		}
+		descr.metaFile = data.metaFile;
 
-		auto task = [&descr, &cache = *this, &library = m_Library, metaFile = data.metaFile](auto&&... values) {
+		auto task = [&descr,
+					 &cache	  = *this,
+					 &pool	  = pool_for<T>(),
+					 &library = m_Library,
+					 metaFile = data.metaFile](auto&&... values) {
 			descr.metaData.state = status::loading;
 			T* resource			 = nullptr;
 			resource =
-			  new T(cache, descr.metaData, (meta_type*)&metaFile.get(), std::forward<decltype(values)>(values)...);
+			  pool.create(cache, descr.metaData, (meta_type*)&metaFile.get(), std::forward<decltype(values)>(values)...);
 			if constexpr(psl::serialization::details::is_collection<T>::value) {
 				if(auto result = library.load(descr.metaData.resource_uid); result) {
 					psl::serialization::serializer s;
@@ -166,6 +168,7 @@ class cache_t {
 				} else {
 					core::log->error("could not load resource [uid: '{}'] reason: missing",
 									 descr.metaData.resource_uid.to_string());
+					pool.destroy(resource);
 					descr.metaData.state = status::missing;
 					return;
 				}
@@ -178,6 +181,128 @@ class cache_t {
 		return {descr.resource, this, &descr.metaData, data.metaFile};
 	}
 
+	/// \brief instantiates the resource, but parses its content on one of the loader's worker threads.
+	///
+	/// The returned handle will be in the status::loading state until the load has been finalized through poll(),
+	/// await() or await_all(). Finalizing constructs the resource (which might create graphics API objects), and so
+	/// should happen on the thread that owns the cache. When the content could not be loaded the handle ends up in the
+	/// status::invalid state, the storage of the resource is kept until the cache frees it so that copies of the
+	/// handle never point to memory that got reused.
+	/// \note the content is loaded through the library on the calling thread, as the library is not thread safe.
+	/// \note the arguments are copied and kept alive until the load is finalized.
+	template <typename T, typename... Args>
+	handle<T> instantiate_async(const psl::UID& resource_uid, Args&&... args) {
+		using meta_type = typename resource_traits<T>::meta_type;
+		if constexpr(!psl::serialization::details::is_collection<T>::value) {
+			return instantiate<T>(resource_uid, std::forward<Args>(args)...);
+		} else {
+			auto uid						 = psl::UID::generate();
+			auto& data						 = m_Cache[uid];
+			m_RemappedResource[resource_uid] = uid;
+
+			auto& descr = emplace_description<T>(data, uid, resource_uid);
+			if(auto optMetaFile = m_Library.get<meta_type>(resource_uid); optMetaFile)
+				data.metaFile = static_cast<psl::meta::file*>(optMetaFile.value());
+			else {
+				core::log->error("could not load resource [uid: '{}'] reason: missing", resource_uid.to_string());
+				descr.metaData.state = status::missing;
+				return {nullptr, this, &descr.metaData, nullptr};
+			}
+			descr.metaFile = data.metaFile;
+
+			// the storage is reserved upfront so that the handles we give out remain valid once it is constructed.
+			auto& pool			 = pool_for<T>();
+			descr.resource		 = (void*)pool.reserve();
+			descr.metaData.state = status::loading;
+
+			auto finalize = [&descr,
+							 &cache	   = *this,
+							 &pool	   = pool,
+							 metaFile  = data.metaFile,
+							 arguments = std::tuple<std::decay_t<Args>...> {std::forward<Args>(args)...}](
+							  std::unique_ptr<psl::format::container> container) mutable {
+				if(!container) {
+					core::log->error("could not load resource [uid: '{}'] reason: invalid content",
+									 descr.metaData.resource_uid.to_string());
+					descr.metaData.state = status::invalid;
+					return;
+				}
+				auto storage  = reinterpret_cast<T*>(descr.resource);
+				auto resource = std::apply(
+				  [&](auto&... values) {
+					  return pool.construct(storage, cache, descr.metaData, (meta_type*)&metaFile.get(), values...);
+				  },
+				  arguments);
+				psl::serialization::serializer s;
+				s.deserialize<psl::serialization::decode_from_format, T>(*resource, *container);
+				descr.metaData.state = status::loaded;
+			};
+
+			auto content = m_Library.load(resource_uid);
+			if(!content) {
+				finalize(nullptr);
+				return {descr.resource, this, &descr.metaData, data.metaFile};
+			}
+
+			// the view is only valid until the library evicts it, so the worker parses its own copy.
+			if(!m_Loader)
+				m_Loader = std::make_unique<details::loader>();
+			auto container = m_Loader->submit(
+			  [content = psl::string8_t {content.value()}]() -> std::unique_ptr<psl::format::container> {
+				  try {
+					  return std::make_unique<psl::format::container>(content);
+				  } catch(const std::exception&) {
+					  return nullptr;
+				  }
+			  });
+
+			m_Pending.emplace_back(pending_t {descr.metaData.index, std::move(container), std::move(finalize)});
+			return {descr.resource, this, &descr.metaData, data.metaFile};
+		}
+	}
+
+	/// \brief finalizes all asynchronous loads that have finished reading and parsing, without blocking.
+	/// \returns the amount of loads that are still in flight.
+	size_t poll() {
+		auto it = std::stable_partition(std::begin(m_Pending), std::end(m_Pending), [](const pending_t& pending) {
+			return pending.content.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+		});
+		// finalizing can instantiate new resources, so we move the ready loads out before invoking them.
+		psl::array<pending_t> ready {std::make_move_iterator(it), std::make_move_iterator(std::end(m_Pending))};
+		m_Pending.erase(it, std::end(m_Pending));
+		for(auto& pending : ready) pending.finalize(pending.content.get());
+		return m_Pending.size();
+	}
+
+	/// \brief blocks until the given handle is finalized.
+	/// \returns true when the resource is loaded.
+	template <typename T>
+	bool await(const handle<T>& target) {
+		if(target.state() != status::loading)
+			return target.state() == status::loaded;
+
+		auto it = std::find_if(
+		  std::begin(m_Pending), std::end(m_Pending), [index = target.resource_metadata()->index](const auto& pending) {
+			  return pending.index == index;
+		  });
+		if(it == std::end(m_Pending))
+			return false;
+
+		auto pending = std::move(*it);
+		m_Pending.erase(it);
+		pending.finalize(pending.content.get());
+		return target.state() == status::loaded;
+	}
+
+	/// \brief blocks until all asynchronous loads are finalized.
+	void await_all() {
+		while(!m_Pending.empty()) {
+			auto pending = std::move(m_Pending);
+			m_Pending.clear();
+			for(auto& it : pending) it.finalize(it.content.get());
+		}
+	}
+
 	template <typename T, typename... Args>
 	handle<T> create(Args&&... args) {
 		return create_using<T>(psl::UID::generate(), std::forward<Args>(args)...);
@@ -186,37 +311,26 @@ class cache_t {
 
 	template <typename T, typename... Args>
 	handle<T> create_using(const psl::UID& uid, Args&&... args) {
-		using value_type   = std::remove_cv_t<std::remove_const_t<T>>;
-		using meta_type	   = typename resource_traits<T>::meta_type;
-		constexpr auto key = details::key_for<value_type>();
-		if(auto it = m_Deleters.find(key); it == std::end(m_Deleters)) {
-			m_Deleters[key]	 = [](void* resource) { delete((T*)(resource)); };
-			m_TypeNames[key] = typeid(T).name();
-		}
+		using meta_type = typename resource_traits<T>::meta_type;
 
 		auto& data = m_Cache[uid];
 		if(data.metaFile == nullptr) {
-			data.metaFile = static_cast<psl::meta::file*>(&m_Library.create<meta_type>(uid).second);
+			// the library might already know the UID, for example when it is backed by a file on disk
+			if(auto metaFile = m_Library.get<meta_type>(uid); metaFile)
+				data.metaFile = static_cast<psl::meta::file*>(metaFile.value());
+			else
+				data.metaFile = static_cast<psl::meta::file*>(&m_Library.create<meta_type>(uid).second);
 		}
 
+		auto& descr	   = emplace_description<T>(data, uid, psl::UID::invalid_uid);
+		descr.metaFile = data.metaFile;
 
-		auto& descr = *data.descriptions.emplace_back(
-		  new description {metadata {uid,
-									 psl::UID::invalid_uid,
-									 details::key_for<value_type>(),
-									 status::initial,
-									 0u,
-									 std::is_same_v<typename details::alias_type<value_type>::type, void>},
-						   nullptr,
-						   m_AgeCounter++});
-
-
-		auto task = [&descr, &cache = *this, metaFile = data.metaFile](auto&&... values) {
+		auto task = [&descr, &cache = *this, &pool = pool_for<T>(), metaFile = data.metaFile](auto&&... values) {
 			descr.metaData.state = status::loading;
 			T* resource			 = nullptr;
 
 			resource =
-			  new T(cache, descr.metaData, (meta_type*)&metaFile.get(), std::forward<decltype(values)>(values)...);
+			  pool.create(cache, descr.metaData, (meta_type*)&metaFile.get(), std::forward<decltype(values)>(values)...);
 			descr.resource		 = (void*)resource;
 			descr.metaData.state = status::loaded;
 		};
@@ -226,38 +340,24 @@ class cache_t {
 	}
 	template <typename T, typename... Args>
 	handle<T> create_using(std::unique_ptr<typename resource_traits<T>::meta_type> metaData, Args&&... args) {
-		using value_type   = std::remove_cv_t<std::remove_const_t<T>>;
-		using meta_type	   = typename resource_traits<T>::meta_type;
-		constexpr auto key = details::key_for<value_type>();
-		if(auto it = m_Deleters.find(key); it == std::end(m_Deleters)) {
-			m_Deleters[key]	 = [](void* resource) { delete((T*)(resource)); };
-			m_TypeNames[key] = typeid(T).name();
-		}
-		psl::UID uid = psl::UID::generate();
-		auto pair	 = m_Library.add(uid, std::move(metaData));
+		using meta_type = typename resource_traits<T>::meta_type;
+		psl::UID uid	= psl::UID::generate();
+		auto pair		= m_Library.add(uid, std::move(metaData));
 
 		auto& data	  = m_Cache[uid];
 		data.metaFile = &pair.second;
 
-		auto& descr = *data.descriptions.emplace_back(
-		  new description {metadata {uid,
-									 psl::UID::invalid_uid,
-									 details::key_for<value_type>(),
-									 status::initial,
-									 0u,
-									 std::is_same_v<typename details::alias_type<value_type>::type, void>},
-						   nullptr,
-						   m_AgeCounter++});
+		auto& descr	   = emplace_description<T>(data, uid, psl::UID::invalid_uid);
+		descr.metaFile = data.metaFile;
 
-
-		auto task = [&descr, &cache = *this, metaFile = data.metaFile](auto&&... values) {
+		auto task = [&descr, &cache = *this, &pool = pool_for<T>(), metaFile = data.metaFile](auto&&... values) {
 			descr.metaData.state = status::loading;
 			T* resource			 = nullptr;
 
-			resource			 = new T(cache,
-							 descr.metaData,
-							 reinterpret_cast<meta_type*>(&metaFile.get()),
-							 std::forward<decltype(values)>(values)...);
+			resource			 = pool.create(cache,
+								   descr.metaData,
+								   reinterpret_cast<meta_type*>(&metaFile.get()),
+								   std::forward<decltype(values)>(values)...);
 			descr.resource		 = (void*)resource;
 			descr.metaData.state = status::loaded;
 		};
@@ -268,6 +368,26 @@ class cache_t {
 
 	bool contains(const psl::UID& uid) const noexcept { return m_Cache.find(uid) != std::end(m_Cache); }
 
+	/// \brief resolves a resource through its dense index (see core::resource::metadata::index).
+	///
+	/// Unlike find() this does not need to hash the UID, making it the preferred lookup for hot paths that store the
+	/// index of the resources they depend on.
+	/// \note types that are assembled from an alias are resolved through find() on the UID of the indexed
+	/// resource, as they combine all the resources of that UID.
+	template <typename T>
+	handle<T> at(size_t index) noexcept {
+		using value_type = std::remove_cv_t<std::remove_const_t<T>>;
+		if(index >= m_Descriptions.size() || m_Descriptions[index] == nullptr)
+			return {};
+		auto& descr = *m_Descriptions[index];
+		if(descr.metaData.type == details::key_for<T>())
+			return {descr.resource, this, &descr.metaData, descr.metaFile};
+
+		if constexpr(!std::is_same_v<typename details::alias_type<value_type>::type, void>)
+			return find<T>(descr.metaData.uid);
+		return {};
+	}
+
 	template <typename T, typename... Args>
 	handle<T> find(const psl::UID& uid) noexcept {
 		using value_type = std::remove_cv_t<std::remove_const_t<T>>;
@@ -297,11 +417,11 @@ class cache_t {
 			  std::begin(it->second.descriptions),
 			  std::end(it->second.descriptions),
 			  std::back_inserter(eligable),
-			  [&alias_keys](psl::unique_ptr<description>& descr) {
+			  [&alias_keys](description* descr) {
 				  return std::find(std::begin(alias_keys), std::end(alias_keys), descr->metaData.type) !=
 						 std::end(alias_keys);
 			  },
-			  [](psl::unique_ptr<description>& descr) -> description* { return &descr.get(); });
+			  [](description* descr) -> description* { return descr; });
 
 			if(eligable.size() == 0)
 				return {};
@@ -338,11 +458,11 @@ class cache_t {
 			  std::begin(it->second.descriptions),
 			  std::end(it->second.descriptions),
 			  std::back_inserter(eligable),
-			  [&alias_keys](psl::unique_ptr<description>& descr) {
+			  [&alias_keys](description* descr) {
 				  return std::find(std::begin(alias_keys), std::end(alias_keys), descr->metaData.type) !=
 						 std::end(alias_keys);
 			  },
-			  [](psl::unique_ptr<description>& descr) -> description* { return &descr.get(); });
+			  [](description* descr) -> description* { return descr; });
 
 			if(eligable.size() == 0)
 				return {};
@@ -357,7 +477,7 @@ class cache_t {
 	bool free(resource::handle<T>& target) {
 		if(target.m_MetaData->reference_count <= 1 && target.m_MetaData->state == status::loaded) {
 			target.m_MetaData->state = status::unloading;
-			std::invoke(m_Deleters[target.m_MetaData->type], target.m_Resource);
+			m_Descriptions[target.m_MetaData->index]->pool->destroy(target.m_Resource);
 			target.m_MetaData->state = status::unloaded;
 			return true;
 		}
@@ -368,7 +488,7 @@ class cache_t {
 	bool free(resource::weak_handle<T>& target) {
 		if(target.m_MetaData->reference_count <= 1 && target.m_MetaData->state == status::loaded) {
 			target.m_MetaData->state = status::unloading;
-			std::invoke(m_Deleters[target.m_MetaData->type], target.m_Resource);
+			m_Descriptions[target.m_MetaData->index]->pool->destroy(target.m_Resource);
 			target.m_MetaData->state = status::unloaded;
 			return true;
 		}
@@ -389,10 +509,15 @@ class cache_t {
 					bLeaks |= it->metaData.state == status::loaded;
 					if(it->metaData.reference_count == 0 && it->metaData.state == status::loaded) {
 						it->metaData.state = status::unloading;
-						std::invoke(m_Deleters[it->metaData.type], it->resource);
+						it->pool->destroy(it->resource);
 						it->metaData.state = status::unloaded;
 						bErased			   = true;
 						++count;
+					} else if(it->metaData.reference_count == 0 && it->metaData.state == status::invalid &&
+							  it->resource != nullptr) {
+						// storage of a failed asynchronous load, it was never constructed.
+						it->pool->release(it->resource);
+						it->metaData.state = status::unloaded;
 					}
 				}
 			}
@@ -402,11 +527,15 @@ class cache_t {
 
 
 		for(auto it = std::begin(m_Cache); it != std::end(m_Cache);) {
-			it->second.descriptions.erase(
-			  std::remove_if(std::begin(it->second.descriptions),
-							 std::end(it->second.descriptions),
-							 [](const auto& it) { return it->metaData.state == status::unloaded; }),
-			  std::end(it->second.descriptions));
+			it->second.descriptions.erase(std::remove_if(std::begin(it->second.descriptions),
+														 std::end(it->second.descriptions),
+														 [this](description* descr) {
+															 if(descr->metaData.state != status::unloaded)
+																 return false;
+															 erase_description(descr);
+															 return true;
+														 }),
+										  std::end(it->second.descriptions));
 			if(it->second.descriptions.size() == 0) {
 				m_Library.unload(it->first);
 				it = m_Cache.erase(it);
@@ -426,7 +555,7 @@ class cache_t {
 				for(auto& it : pair.second.descriptions) {
 #ifdef PE_DEBUG
 					if(it->age < oldest) {
-						oldest_descr = &it.get();
+						oldest_descr = it;
 						oldest_uid	 = pair.first;
 						oldest		 = it->age;
 					}
@@ -468,11 +597,70 @@ class cache_t {
 	}
 
   private:
+	/// \brief asynchronous load that still has to be finalized on the owning thread.
+	struct pending_t {
+		size_t index;
+		std::future<std::unique_ptr<psl::format::container>> content;
+		std::function<void(std::unique_ptr<psl::format::container>)> finalize;
+	};
+
+	template <typename T>
+	details::pool<std::remove_cv_t<T>>& pool_for() {
+		using value_type = std::remove_cv_t<T>;
+		const auto index = details::type_index<value_type>();
+		if(index >= m_Pools.size())
+			m_Pools.resize(index + 1);
+		if(!m_Pools[index]) {
+			m_Pools[index]								= std::make_unique<details::pool<value_type>>();
+			m_TypeNames[details::key_for<value_type>()] = typeid(T).name();
+		}
+		return static_cast<details::pool<value_type>&>(*m_Pools[index]);
+	}
+
+	template <typename T>
+	description& emplace_description(entry& data, const psl::UID& uid, const psl::UID& resource_uid) {
+		using value_type = std::remove_cv_t<T>;
+		size_t index	 = m_Descriptions.size();
+		if(m_FreeIndices.size() > 0) {
+			index = m_FreeIndices.back();
+			m_FreeIndices.pop_back();
+		} else {
+			m_Descriptions.emplace_back(nullptr);
+		}
+
+		auto descr = m_DescriptionPool.create(
+		  description {metadata {uid,
+								 resource_uid,
+								 details::key_for<value_type>(),
+								 status::initial,
+								 0u,
+								 std::is_same_v<typename details::alias_type<value_type>::type, void>,
+								 index},
+					   nullptr,
+					   m_AgeCounter++,
+					   &pool_for<value_type>(),
+					   nullptr});
+		m_Descriptions[index] = descr;
+		return *data.descriptions.emplace_back(descr);
+	}
+
+	void erase_description(description* descr) noexcept {
+		m_Descriptions[descr->metaData.index] = nullptr;
+		m_FreeIndices.emplace_back(descr->metaData.index);
+		m_DescriptionPool.destroy(descr);
+	}
+
 	size_t m_AgeCounter {0};
 	psl::meta::library m_Library;
 	std::unordered_map<psl::UID, entry> m_Cache {};
 	std::unordered_map<psl::UID, psl::UID> m_RemappedResource {};
 	std::unordered_map<resource_key_t, psl::string8_t> m_TypeNames {};
-	std::unordered_map<resource_key_t, std::function<void(void*)>> m_Deleters {};
+
+	details::slab<description> m_DescriptionPool {};
+	psl::array<description*> m_Descriptions {};	   // dense lookup, indexed by metadata::index
+	psl::array<size_t> m_FreeIndices {};
+	psl::array<std::unique_ptr<details::pool_base>> m_Pools {};	   // indexed by details::type_index
+	psl::array<pending_t> m_Pending {};
+	std::unique_ptr<details::loader> m_Loader {};	 // created on the first asynchronous load
 };
 }	 // namespace core::resource
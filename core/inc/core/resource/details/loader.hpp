@@ -0,0 +1,84 @@
+#pragma once
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace core::resource::details {
+/// \brief fixed size pool of worker threads for the asynchronous loads of the core::resource::cache_t.
+///
+/// Jobs are queued and picked up in submission order, so the amount of concurrent loads is bounded by the amount of
+/// workers rather than by the amount of requested resources. The workers are only started once the first job is
+/// submitted.
+/// \note jobs that are still queued when the loader is destroyed are dropped, their futures will report a
+/// std::future_errc::broken_promise.
+class loader {
+  public:
+	loader(size_t workers = default_workers()) noexcept : m_Capacity(std::max<size_t>(workers, 1)) {}
+	~loader() {
+		{
+			std::lock_guard<std::mutex> lock {m_Lock};
+			m_Stop = true;
+			m_Queue.clear();
+		}
+		m_Condition.notify_all();
+		for(auto& worker : m_Workers) worker.join();
+	}
+
+	loader(const loader&)			 = delete;
+	loader(loader&&)				 = delete;
+	loader& operator=(const loader&) = delete;
+	loader& operator=(loader&&)		 = delete;
+
+	template <typename Fn>
+	std::future<std::invoke_result_t<Fn>> submit(Fn&& job) {
+		auto task	= std::make_shared<std::packaged_task<std::invoke_result_t<Fn>()>>(std::forward<Fn>(job));
+		auto result = task->get_future();
+		{
+			std::lock_guard<std::mutex> lock {m_Lock};
+			m_Queue.emplace_back([task = std::move(task)]() { (*task)(); });
+			if(m_Workers.size() < m_Capacity && m_Workers.size() < m_Queue.size())
+				m_Workers.emplace_back(&loader::run, this);
+		}
+		m_Condition.notify_one();
+		return result;
+	}
+
+	/// \returns the amount of workers that are allowed to run concurrently.
+	size_t capacity() const noexcept { return m_Capacity; }
+
+	static size_t default_workers() noexcept {
+		return std::clamp<size_t>(std::thread::hardware_concurrency() / 2, 1, 4);
+	}
+
+  private:
+	void run() {
+		while(true) {
+			std::function<void()> job {};
+			{
+				std::unique_lock<std::mutex> lock {m_Lock};
+				m_Condition.wait(lock, [this]() { return m_Stop || !m_Queue.empty(); });
+				if(m_Stop)
+					return;
+				job = std::move(m_Queue.front());
+				m_Queue.pop_front();
+			}
+			job();
+		}
+	}
+
+	size_t m_Capacity;
+	std::mutex m_Lock {};
+	std::condition_variable m_Condition {};
+	std::deque<std::function<void()>> m_Queue {};
+	std::vector<std::thread> m_Workers {};
+	bool m_Stop {false};
+};
+}	 // namespace core::resource::details
@@ -0,0 +1,141 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace core::resource::details {
+/// \brief slab backed object storage with stable addresses.
+///
+/// Objects are constructed in place in fixed size slabs, destroyed slots are recycled through an intrusive free list.
+/// This avoids an allocation per object, and keeps objects of the same type close together in memory.
+/// \note destroying the slab releases the memory, but does not invoke the destructors of the objects that are still
+/// alive.
+template <typename T, size_t SlabSize = 256>
+class slab {
+	static_assert(SlabSize > 0, "a slab should be able to contain atleast one element");
+
+	union slot_t {
+		slot_t* next;
+		alignas(T) std::byte storage[sizeof(T)];
+	};
+
+  public:
+	slab() = default;
+	~slab() = default;
+
+	slab(const slab&)				 = delete;
+	slab(slab&&) noexcept			 = default;
+	slab& operator=(const slab&)	 = delete;
+	slab& operator=(slab&&) noexcept = default;
+
+	template <typename... Args>
+	T* create(Args&&... args) {
+		return construct(reserve(), std::forward<Args>(args)...);
+	}
+
+	void destroy(T* target) noexcept {
+		if(target == nullptr)
+			return;
+		target->~T();
+		release(target);
+	}
+
+	/// \brief reserves the storage for an object, without constructing it.
+	/// \note the storage should either be constructed using construct(), or returned using release().
+	T* reserve() {
+		if(m_Free == nullptr)
+			grow();
+
+		auto slot = m_Free;
+		m_Free	  = slot->next;
+		++m_Size;
+		return reinterpret_cast<T*>(slot->storage);
+	}
+
+	template <typename... Args>
+	T* construct(T* target, Args&&... args) {
+		return new((void*)target) T(std::forward<Args>(args)...);
+	}
+
+	/// \brief returns storage that was reserved, but never constructed (or already destructed).
+	void release(T* target) noexcept {
+		auto slot  = reinterpret_cast<slot_t*>(target);
+		slot->next = m_Free;
+		m_Free	   = slot;
+		--m_Size;
+	}
+
+	/// \returns the amount of live objects.
+	size_t size() const noexcept { return m_Size; }
+
+	/// \returns the amount of objects that can be alive before a new slab has to be allocated.
+	size_t capacity() const noexcept { return m_Slabs.size() * SlabSize; }
+
+  private:
+	void grow() {
+		auto& slab = m_Slabs.emplace_back(std::make_unique<slot_t[]>(SlabSize));
+		for(size_t i = SlabSize; i > 0; --i) {
+			slab[i - 1].next = m_Free;
+			m_Free			 = &slab[i - 1];
+		}
+	}
+
+	std::vector<std::unique_ptr<slot_t[]>> m_Slabs {};
+	slot_t* m_Free {nullptr};
+	size_t m_Size {0};
+};
+
+/// \brief type erased interface for the per-type resource pools of the core::resource::cache_t.
+class pool_base {
+  public:
+	pool_base()			 = default;
+	virtual ~pool_base() = default;
+
+	pool_base(const pool_base&)			   = delete;
+	pool_base& operator=(const pool_base&) = delete;
+
+	virtual void destroy(void* resource) noexcept = 0;
+	/// \brief returns reserved storage that was never constructed.
+	virtual void release(void* resource) noexcept = 0;
+	virtual size_t size() const noexcept		  = 0;
+};
+
+template <typename T>
+class pool final : public pool_base {
+  public:
+	template <typename... Args>
+	T* create(Args&&... args) {
+		return m_Slab.create(std::forward<Args>(args)...);
+	}
+
+	T* reserve() { return m_Slab.reserve(); }
+
+	template <typename... Args>
+	T* construct(T* target, Args&&... args) {
+		return m_Slab.construct(target, std::forward<Args>(args)...);
+	}
+
+	void release(T* target) noexcept { m_Slab.release(target); }
+	void release(void* resource) noexcept override { m_Slab.release(reinterpret_cast<T*>(resource)); }
+
+	void destroy(void* resource) noexcept override { m_Slab.destroy(reinterpret_cast<T*>(resource)); }
+	size_t size() const noexcept override { return m_Slab.size(); }
+
+  private:
+	slab<T> m_Slab {};
+};
+
+inline size_t next_type_index() noexcept {
+	static size_t counter {0};
+	return counter++;
+}
+
+/// \brief dense, runtime assigned, index for a type. Used to find the pool of a type without hashing.
+template <typename T>
+size_t type_index() noexcept {
+	static const size_t index {next_type_index()};
+	return index;
+}
+}	 // namespace core::resource::details
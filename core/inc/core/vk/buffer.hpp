@@ -4,6 +4,7 @@
 #include "core/vk/ivk.hpp"
 #include "psl/memory/segment.hpp"
 #include <optional>
+#include <vector>
 
 
 namespace core::data {
@@ -27,9 +28,8 @@ class buffer_t {
 	/// \brief constructs a buffer from the given buffer_data, as well as optionally sets a staging resource.
 	/// \param[in] buffer_data the data source to bind to this buffer. (see note for more info)
 	/// \param[in] staging_buffer the staging buffer to use in case staging is needed. (see warning for more info)
-	/// \warning it is recommended to give a staging_buffer unless you know this is a host-only resource.
-	/// failing to give a staging resource to a device-local region that cannot be accessed by the host
-	/// will result in performance degradation as it has to keep making temporary staging buffers instead.
+	/// \note when no staging_buffer is given, device-local regions are uploaded through the context's
+	/// core::ivk::staging_ring instead.
 	/// \note buffer_data dictates the size, and alignment of this buffer resource. In the event that the
 	/// allignment is incorrect, a suitable warning (and potential override) will be supplied.
 	/// If the supplied buffer_data is non-virtual (i.e. backed by real memory location), then the resource
@@ -77,11 +77,13 @@ class buffer_t {
 	///
 	/// this method tries to commit the given instruction into the buffer. depending on the type of buffer
 	/// how this does that can differ greatly.
-	/// \warning if the buffer is device local and no staging buffer is known, it will try to create a staging
-	/// buffer to facilitate transfers this has a performance overhead. \param[in] instructions all the instructions
-	/// you wish to send to the GPU in this batch. \returns success if the instruction has been sent. \note this
-	/// method will try to figure out the best way to send this set of instructions to the GPU, possibly merging
-	/// instructions together.
+	/// \note if the buffer is device local and no staging buffer is known, the instructions are staged in the
+	/// context's core::ivk::staging_ring, and are uploaded with the next batch it submits (see is_busy()). When a
+	/// staging buffer is known, the copies out of it are recorded in that same batch, and its segments are released
+	/// once the copies have completed.
+	/// \param[in] instructions all the instructions you wish to send to the GPU in this batch.
+	/// \returns success if the instruction has been sent. \note this method will try to figure out the best way to
+	/// send this set of instructions to the GPU, possibly merging instructions together.
 	bool commit(std::vector<core::gfx::commit_instruction> instructions);
 
 	/// \brief marks the specific region of memory available again.
@@ -98,11 +100,25 @@ class buffer_t {
 	// bool copy_from(const buffer& other, std::optional<vk::DeviceSize> size = {}, std::optional<vk::DeviceSize>
 	// dstOffset = {}, std::optional<vk::DeviceSize> srcOffset = {});
 	/// \brief allows you to copy from one buffer into another.
+	/// \details blocking variant of copy_from_async(), it waits until the copy has completed, and when this buffer is
+	/// host visible, replicates the copied regions into its core::data::buffer_t.
 	/// \param[in] other the buffer to copy from into this instance.
 	/// \param[in] copyRegions the batch of copy instructions.
 	/// \returns true in case the instructions were successfully uploaded to the GPU.
 	bool copy_from(const buffer_t& other, const std::vector<vk::BufferCopy>& copyRegions);
 
+	/// \brief records a copy from one buffer into another, without waiting for it to complete.
+	/// \details the copy is recorded into the current batch of the context's core::ivk::staging_ring, ordered with
+	/// the uploads staged before and after it, and is executed when that batch is submitted. Consecutive regions that
+	/// are contiguous in both buffers are merged into a single region.
+	/// \param[in] other the buffer to copy from into this instance.
+	/// \param[in] copyRegions the batch of copy instructions.
+	/// \returns the timeline value that signals the completion of the copy (see core::ivk::staging_ring::wait()), or
+	/// nothing when the regions are out of bounds.
+	/// \warning the source regions should not be written to until the copy has completed, and the host side copy of
+	/// this buffer (see data()) is not updated.
+	std::optional<uint64_t> copy_from_async(const buffer_t& other, std::vector<vk::BufferCopy> copyRegions);
+
 	// bool set(const void* data, vk::DeviceSize size, std::optional<vk::DeviceSize> dstOffset = {},
 	// std::optional<vk::DeviceSize> srcOffset = {});
 	bool set(const void* data, std::vector<vk::BufferCopy> commands);
@@ -140,6 +156,11 @@ class buffer_t {
 
   private:
 	bool map(const void* data, vk::DeviceSize size, vk::DeviceSize offset);
+	/// \brief deallocates the segments of this (staging) buffer whose copies have completed.
+	void release_staged();
+	/// \brief waits on the oldest copy that is still in flight out of this (staging) buffer, and releases its segments.
+	/// \returns false when no copies were in flight.
+	bool wait_staged();
 	core::resource::handle<core::ivk::context> m_Context;
 	vk::DescriptorBufferInfo m_Descriptor;
 
@@ -148,6 +169,11 @@ class buffer_t {
 	vk::DeviceMemory m_Memory;
 	vk::Fence m_BufferCompleted;
 	vk::CommandBuffer m_CommandBuffer;
+	// timeline value of the core::ivk::staging_ring batch that contains the last staged upload
+	uint64_t m_Pending {0};
+	// segments of this buffer that are in use by copies that are in flight, and the timeline value that signals their
+	// completion. These are tracked on the staging buffer, as it can be shared by several buffers.
+	std::vector<std::pair<uint64_t, memory::segment>> m_Staged;
 
 	core::resource::handle<core::data::buffer_t> m_BufferDataHandle;
 	core::resource::handle<core::ivk::buffer_t> m_StagingBuffer;
@@ -2,6 +2,8 @@
 #include "core/fwd/resource/resource.hpp"
 #include "core/gfx/limits.hpp"
 #include "core/vk/ivk.hpp"
+#include <algorithm>
+#include <memory>
 #include <optional>
 
 namespace core::ivk {
@@ -108,6 +110,10 @@ namespace core::resource {
 class cache_t;
 }
 namespace core::ivk {
+class staging_ring;
+class descriptor_allocator;
+}
+namespace core::ivk {
 /// \brief encapsulated a graphics context.
 ///
 /// a context encapsulated a physical device (GPU), as well as a instance of the graphics context on the driver.
@@ -148,16 +154,18 @@ class context {
 
 	/// \returns the command_pool that commands can be enqueued on.
 	const vk::CommandPool& command_pool() const noexcept;
+	/// \returns the command_pool for commands that are executed on the transfer_queue().
 	const vk::CommandPool& transfer_command_pool() const noexcept;
-	/// \returns the descriptor pool for allocating various pipeline descriptors.
-	const vk::DescriptorPool& descriptor_pool() const noexcept;
 
 	/// \returns the device queue for enqueuing commands.
 	const vk::Queue& queue() const noexcept;
+	/// \returns the device queue for asynchronous transfers.
+	/// \note on devices without a separate transfer capable queue family, this is the same queue as queue().
 	const vk::Queue& transfer_queue() const noexcept;
 
 	/// \returns the queue index the graphics pipeline is running on.
 	uint32_t graphics_queue_index() const noexcept;
+	/// \returns the queue family index of the transfer_queue().
 	uint32_t transfer_que_index() const noexcept;
 
 	/// \param[in] typeBits the MemoryRequirements you get back from vulkan query operations that resquest the
@@ -180,6 +188,25 @@ class context {
 	/// \param[in] free defines if we should free the command buffer at the end (true) or not (false).
 	void flush(vk::CommandBuffer commandBuffer, bool free);
 
+	/// \returns the staging ring that batches the uploads to device local resources.
+	/// \see core::ivk::staging_ring
+	core::ivk::staging_ring& staging() const noexcept { return *m_Staging; }
+
+	/// \returns the allocator for the descriptor sets (and their layouts) of the pipelines.
+	/// \see core::ivk::descriptor_allocator
+	core::ivk::descriptor_allocator& descriptors() const noexcept { return *m_Descriptors; }
+
+	/// \brief marks the end of a frame, recycling the resources (such as descriptor sets) that were released long
+	/// enough ago to no longer be used by any frame in flight.
+	/// \note should be called once per frame, after all passes have been presented.
+	void end_frame();
+
+	/// \returns the amount of frames that can be in flight on the GPU at the same time.
+	uint32_t frames_in_flight() const noexcept { return m_FramesInFlight; }
+	/// \brief raises the amount of frames that can be in flight, passes call this with the amount of frames they
+	/// fence on. The amount is never lowered, as other passes can still rely on it.
+	void frames_in_flight(uint32_t count) noexcept { m_FramesInFlight = std::max(m_FramesInFlight, count); }
+
 	// todo we're not using these.
 	bool consume(vk::MemoryHeapFlagBits type, vk::DeviceSize amount);
 	bool release(vk::MemoryHeapFlagBits type, vk::DeviceSize amount);
@@ -196,12 +223,10 @@ class context {
 	void init_device();
 	void init_debug();
 	void init_command_pool();
-	void init_descriptor_pool();
 
 	void deinit_device();
 	void deinit_debug();
 	void deinit_command_pool();
-	void deinit_descriptor_pool();
 
 	vk::Result create_device(vk::DeviceQueueCreateInfo* requestedQueues, uint32_t queueSize, vk::Device& device);
 	// from a list of all devices, select the one that is the most appropriate (usually the one with the best
@@ -233,7 +258,10 @@ class context {
 	vk::CommandPool m_CommandPool;
 	vk::CommandPool m_TransferCommandPool;
 
-	vk::DescriptorPool m_DescriptorPool;
+	std::unique_ptr<core::ivk::descriptor_allocator> m_Descriptors;
+	std::unique_ptr<core::ivk::staging_ring> m_Staging;
+
+	uint32_t m_FramesInFlight {1};
 
 	uint32_t m_GraphicsQueueIndex = 0;
 	uint32_t m_TransferQueueIndex = 0;
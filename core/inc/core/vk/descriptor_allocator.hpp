@@ -0,0 +1,92 @@
+#pragma once
+#include "core/vk/ivk.hpp"
+#include "psl/array_view.hpp"
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace core::ivk {
+class context;
+}
+
+namespace core::ivk {
+/// \brief allocates, shares, and recycles the descriptor sets of the pipelines.
+///
+/// Descriptor set layouts are cached, so pipelines with identical bindings share the same layout. Every layout gets
+/// its own chain of descriptor pools that are sized for exactly that layout, so allocations never fail due to a
+/// mismatch in descriptor types.
+/// Sets are shared between users that write identical descriptors into the same layout, and all descriptors of a
+/// set are written in a single vkUpdateDescriptorSets call when it is first created.
+/// Sets are never rewritten while they are in use: a set that is no longer referenced is retired, and only recycled
+/// once the frames that might still use it have completed (see advance()).
+/// \warning the allocator is owned by, and should be accessed through, core::ivk::context::descriptors(). It is not
+/// thread-safe.
+class descriptor_allocator {
+  public:
+	/// \param[in] context the context to allocate the descriptor sets on.
+	/// \param[in] setsPerPool the amount of sets every descriptor pool can hold.
+	descriptor_allocator(core::ivk::context& context, uint32_t setsPerPool);
+	~descriptor_allocator();
+	descriptor_allocator(const descriptor_allocator&)			 = delete;
+	descriptor_allocator(descriptor_allocator&&)				 = delete;
+	descriptor_allocator& operator=(const descriptor_allocator&) = delete;
+	descriptor_allocator& operator=(descriptor_allocator&&)		 = delete;
+
+	/// \returns a descriptor set layout for the given bindings, identical bindings share the same layout.
+	/// \note the layout is owned by the allocator, and should not be destroyed.
+	vk::DescriptorSetLayout layout(psl::array_view<vk::DescriptorSetLayoutBinding> bindings);
+
+	/// \returns a descriptor set of the given layout with the writes applied.
+	/// \details when a set with identical writes already exists it is shared instead. The dstSet of the writes is
+	/// ignored, and every descriptor has to be valid.
+	/// \note every acquired set should be released again.
+	/// \param[in] layout a layout created through layout().
+	/// \param[in] writes the descriptors to write into the set.
+	vk::DescriptorSet acquire(vk::DescriptorSetLayout layout, psl::array_view<vk::WriteDescriptorSet> writes);
+
+	/// \brief releases a set acquired through acquire(), once it is no longer referenced it will be recycled.
+	void release(vk::DescriptorSet set);
+
+	/// \brief marks the end of a frame, recycling the sets that were retired long enough ago to no longer be in use.
+	/// \param[in] framesInFlight the maximum amount of frames the GPU can be behind on.
+	/// \note this is driven by core::ivk::context::end_frame().
+	void advance(uint32_t framesInFlight);
+
+  private:
+	struct layout_t {
+		std::vector<vk::DescriptorSetLayoutBinding> bindings;
+		vk::DescriptorSetLayout layout;
+		std::vector<vk::DescriptorPoolSize> sizes;
+		std::vector<vk::DescriptorPool> pools;
+		// sets remaining in the last pool
+		uint32_t remaining {0};
+		std::vector<vk::DescriptorSet> free;
+	};
+	struct set_t {
+		layout_t* layout {nullptr};
+		// the flattened descriptors written into the set, used to find identical sets
+		std::vector<uint64_t> contents;
+		uint64_t hash {0};
+		uint32_t references {0};
+	};
+	struct retired_t {
+		uint64_t frame {0};
+		layout_t* layout {nullptr};
+		vk::DescriptorSet set;
+	};
+
+	layout_t* find(vk::DescriptorSetLayout layout) noexcept;
+	vk::DescriptorSet allocate(layout_t& layout);
+
+	core::ivk::context& m_Context;
+	uint32_t m_SetsPerPool {0};
+	uint64_t m_Frame {0};
+
+	std::vector<std::unique_ptr<layout_t>> m_Layouts;
+	// all acquired sets, keyed on their handle
+	std::unordered_map<uint64_t, set_t> m_Sets;
+	// the shareable sets, keyed on the hash of their layout and contents
+	std::unordered_map<uint64_t, vk::DescriptorSet> m_Shared;
+	std::vector<retired_t> m_Retired;
+};
+}	 // namespace core::ivk
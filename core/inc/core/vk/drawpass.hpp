@@ -1,8 +1,10 @@
 #pragma once
+#include "core/gfx/drawlist.hpp"
 #include "core/resource/resource.hpp"
 #include "core/vk/ivk.hpp"
 #include "psl/math/vec.hpp"
 #include "psl/view_ptr.hpp"
+#include <memory>
 #include <vector>
 
 namespace core::gfx {
@@ -37,6 +39,9 @@ struct depth_bias {
 /// subsequent passes, or present it to a core::gfx::surface.
 /// Passes also make sure that they don't create race conditions with other passes that have been assigned as its
 /// dependencies.
+/// Every drawlayer is recorded into its own secondary command buffers, in parallel, and these are reused for as long
+/// as the layer does not change. Recording happens per frame in flight, right before the frame is submitted, so
+/// rebuilding never has to wait for the device to become idle.
 class drawpass {
   public:
 	/// \brief creates a pass that targets a framebuffer.
@@ -63,17 +68,25 @@ class drawpass {
 	void present();
 
 	/// \brief set the depth bias on the current pass.
+	/// \note a different bias re-records the command buffers of all layers.
 	void bias(const core::ivk::depth_bias& bias) noexcept;
 
 	/// \brief returns the current dept bias on this instance.
 	/// \returns the current dept bias on this instance.
 	core::ivk::depth_bias bias() const noexcept;
 
-	/// \brief build, and records the draw, and other instructions associated with this pass.
-	/// \returns true on success, false if submitting the instructions to the GPU failed.
-	bool build();
+	/// \brief builds the draw, and other instructions associated with this pass.
+	/// \details the changed drawlayers are resolved immediately, the command buffers are (re-)recorded by present()
+	/// once their frame is no longer in flight. Every render index of a drawlayer is resolved and recorded on its own,
+	/// so only the render indices at which a drawcall changed (see core::gfx::drawcall::version()) are resolved and
+	/// recorded again.
+	/// \param[in] force resolve all drawlayers, i.e. when state that the drawcalls do not track has changed.
+	/// \returns true on success.
+	bool build(bool force = false);
 
 	/// \brief add an additional drawgroup to be included in this pass' draw instructions.
+	/// \note the pass refers to the group, changes made to the group are picked up by the next build(). The group
+	/// should be removed before it is destroyed.
 	void add(core::gfx::drawgroup& group) noexcept;
 
 	/// \brief makes the current pass wait for the given pass to complete
@@ -90,14 +103,20 @@ class drawpass {
 	bool is_swapchain() const noexcept;
 
   private:
-	void build_drawgroup(core::gfx::drawgroup& group,
-						 vk::CommandBuffer cmdBuffer,
-						 core::resource::handle<core::ivk::framebuffer_t> framebuffer,
-						 uint32_t index);
-	void build_drawgroup(core::gfx::drawgroup& group,
-						 vk::CommandBuffer cmdBuffer,
-						 core::resource::handle<core::ivk::swapchain> swapchain,
-						 uint32_t index);
+	struct layer_t;
+
+	/// \brief resolves the drawlayers of the sorted draw list into the plain vulkan state needed to record them.
+	/// \warning this touches the resources, and so has to be called from the thread that owns them.
+	void resolve(std::vector<std::unique_ptr<layer_t>>& layers);
+	/// \brief records the primary command buffer of the given framebuffer index, recording the secondary command
+	/// buffers of the layers that changed first.
+	/// \warning the command buffers of the index should not be in flight.
+	void record(uint32_t index);
+	/// \brief creates the command pool, and secondary command buffers of the layer.
+	void allocate(layer_t& layer);
+	/// \brief destroys the layer once no primary command buffer references it anymore.
+	void retire(std::unique_ptr<layer_t> layer);
+	void destroy(layer_t& layer);
 	/// \brief creates the vk::Fence's that will be used to sync access to this pass.
 	/// \param[in] size the amount of fences to create.
 	void create_fences(const size_t size = 1u);
@@ -108,7 +127,9 @@ class drawpass {
 	core::resource::handle<core::ivk::framebuffer_t> m_Framebuffer;
 	core::resource::handle<core::ivk::swapchain> m_Swapchain;
 	const bool m_UsingSwap;
-	std::vector<core::gfx::drawgroup> m_AllGroups;
+	std::vector<psl::view_ptr<const core::gfx::drawgroup>> m_AllGroups;
+	// the draws of all groups, rebuilt and sorted on every build()
+	core::gfx::drawlist m_DrawList;
 
 	std::vector<vk::Semaphore> m_WaitFor;
 	vk::Semaphore m_PresentComplete;
@@ -116,6 +137,11 @@ class drawpass {
 	std::vector<vk::Fence> m_WaitFences;
 
 	std::vector<vk::CommandBuffer> m_DrawCommandBuffers;
+	// which primary command buffers have to be re-recorded, and which ones have been recorded at least once
+	std::vector<bool> m_Dirty;
+	std::vector<bool> m_Recorded;
+	std::vector<std::unique_ptr<layer_t>> m_Layers;
+	std::vector<std::unique_ptr<layer_t>> m_Retired;
 	uint32_t m_Buffers;
 	uint32_t m_CurrentBuffer;
 	uint64_t m_FrameCount {0u};
@@ -25,6 +25,28 @@ class geometry_t {
 	};
 
   public:
+	/// \brief a vertex buffer binding at an attribute location.
+	struct vertex_binding_t {
+		uint32_t location {0};
+		vk::DeviceSize offset {0};
+		/// \brief the size of a single element in the bound stream.
+		vk::DeviceSize stride {0};
+
+		bool operator==(const vertex_binding_t& other) const noexcept = default;
+	};
+
+	/// \brief the buffer bindings bind() records, resolved ahead of recording.
+	/// \details this contains no resource handles, so it can be recorded from any thread.
+	struct bindings_t {
+		vk::Buffer vertexBuffer;
+		std::vector<vertex_binding_t> vertices;
+		vk::Buffer indexBuffer;
+		vk::DeviceSize indexOffset {0};
+		vk::IndexType indexType {vk::IndexType::eUint32};
+
+		bool operator==(const bindings_t& other) const noexcept = default;
+	};
+
 	/// \brief constructs, and uploads the geometry data to the buffers.
 	/// \param[in] data the geometry source data for this instance.
 	/// \param[in] geometryBuffer the buffer that the mesh data will be uploaded to.
@@ -57,6 +79,15 @@ class geometry_t {
 	/// \warning only invoke this method in the context of recording draw instructions.
 	void bind(vk::CommandBuffer& buffer, const core::ivk::material_t& material) const noexcept;
 
+	/// \returns the bindings that bind() records for the given material.
+	/// \param[in] material the material to bind with.
+	bindings_t bindings(const core::ivk::material_t& material) const noexcept;
+
+	/// \brief records previously resolved bindings.
+	/// \param[in] buffer the command buffer to upload the commands to.
+	/// \param[in] bindings the result of a bindings() call.
+	static void bind(vk::CommandBuffer& buffer, const bindings_t& bindings) noexcept;
+
 	/// \returns the geometry data used by this instance.
 	core::resource::handle<core::data::geometry_t> data() const noexcept { return m_Data; };
 
@@ -4,6 +4,7 @@
 #include "core/vk/ivk.hpp"
 #include "psl/generator.hpp"
 #include <optional>
+#include <vector>
 
 namespace core::data {
 class material_t;
@@ -36,6 +37,19 @@ namespace core::ivk {
 /// Together with a core::ivk::geometry_t, this describes all the resources you need to render something on screen.
 class material_t final {
   public:
+	/// \brief the pipeline state bind_pipeline() records, resolved ahead of recording.
+	/// \details this contains no resource handles, so it can be recorded from any thread.
+	struct bindings_t {
+		vk::PipelineBindPoint bindPoint {vk::PipelineBindPoint::eGraphics};
+		vk::Pipeline pipeline;
+		vk::PipelineLayout layout;
+		vk::DescriptorSet descriptorSet;
+		std::vector<uint32_t> dynamicOffsets;
+		bool pushConstants {false};
+
+		bool operator==(const bindings_t& other) const noexcept = default;
+	};
+
 	/// \brief the constructor that will create and bind the necesary resources to create a valid pipeline.
 	/// \param[in] cache resource cache that is constructing this material.
 	/// \param[in] metaData metadata associated with the material.
@@ -91,6 +105,30 @@ class material_t final {
 					   core::resource::handle<core::ivk::swapchain> swapchain,
 					   uint32_t drawIndex);
 
+	/// \returns the pipeline state that bind_pipeline() would record, or nothing when the pipeline is incomplete.
+	/// \note the dynamic offsets are captured as they are at the time of the call.
+	/// \param[in] framebuffer the framebuffer the pipeline will be bound to.
+	std::optional<bindings_t> bindings(core::resource::handle<core::ivk::framebuffer_t> framebuffer);
+
+	/// \returns the pipeline state that bind_pipeline() would record, or nothing when the pipeline is incomplete.
+	/// \note the dynamic offsets are captured as they are at the time of the call.
+	/// \param[in] swapchain the swapchain the pipeline will be bound to.
+	std::optional<bindings_t> bindings(core::resource::handle<core::ivk::swapchain> swapchain);
+
+	/// \returns the pipeline that the last bindings() call resolved.
+	core::resource::handle<core::ivk::pipeline> bound() const noexcept { return m_Bound; }
+
+	/// \brief records previously resolved pipeline state.
+	/// \param[in] cmdBuffer the command buffer you'll be recording to
+	/// \param[in] bindings the result of a bindings() call.
+	/// \param[in] drawIndex the index to be set in the push constant.
+	static void bind(vk::CommandBuffer cmdBuffer, const bindings_t& bindings, uint32_t drawIndex);
+	/// \brief records the bindings, skipping the pipeline and descriptor set binds that are identical to those of the
+	/// previously recorded bindings.
+	/// \param[in] previous the bindings that were last recorded into the command buffer.
+	static void
+	bind(vk::CommandBuffer cmdBuffer, const bindings_t& bindings, const bindings_t& previous, uint32_t drawIndex);
+
 	void bind_material_instance_data(core::resource::handle<core::ivk::buffer_t> buffer, memory::segment segment);
 	bool bind_instance_data(uint32_t binding, uint32_t offset);
 
@@ -125,8 +163,16 @@ class material_t final {
 	memory::segment m_MaterialBufferRange;
 	core::resource::handle<core::ivk::buffer_t> m_MaterialBuffer;
 
-	// psl::UID maps to the psl::UID of a framebuffer or a swapchain
-	std::unordered_map<psl::UID, core::resource::handle<core::ivk::pipeline>> m_Pipeline;
+	/// \brief the pipeline of a framebuffer or a swapchain, see get().
+	struct target_pipeline_t {
+		// the dense index of the target in the cache, see core::resource::metadata::index
+		size_t index;
+		psl::UID uid;
+		core::resource::handle<core::ivk::pipeline> pipeline;
+	};
+	// a material is bound to a handful of targets at most, and is looked up on every bind, so these are found through
+	// the dense index of the target rather than by hashing its UID.
+	std::vector<target_pipeline_t> m_Pipeline;
 	core::resource::handle<core::ivk::pipeline> m_Bound;
 
 	// value to indicate if this material can actually be used or not
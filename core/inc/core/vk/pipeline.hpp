@@ -1,8 +1,10 @@
 #pragma once
 
+#include "core/fwd/vk/shader.hpp"
 #include "core/resource/resource.hpp"
 #include "core/vk/ivk.hpp"
 #include "psl/array_view.hpp"
+#include <optional>
 #include <vector>
 
 namespace core::data {
@@ -13,11 +15,71 @@ namespace core::ivk {
 class context;
 class buffer_t;
 }	 // namespace core::ivk
+namespace core::ivk::details {
+/// \brief self contained description of all the state that goes into compiling a vk::Pipeline.
+///
+/// Resolving the state needs the core::resource::cache_t, compiling it does not. This allows the expensive part,
+/// the compilation, to happen on worker threads (see core::ivk::pipeline_cache::prewarm).
+/// \warning the state holds handles to the shaders it uses, so it should be created and destroyed on the thread
+/// that owns the core::resource::cache_t.
+class pipeline_state {
+  public:
+	/// \brief resolves the state of the material when used in the given renderpass.
+	/// \returns nothing when the material could not be resolved, inspect the logs for the reason.
+	static std::optional<pipeline_state> resolve(core::resource::cache_t& cache,
+												 const core::data::material_t& data,
+												 vk::RenderPass renderPass,
+												 uint32_t attachmentCount);
+
+	/// \returns a structural hash of everything that influences the compiled vk::Pipeline.
+	/// \note the resources bound to the material (textures, buffers) are not part of the hash.
+	uint64_t hash() const noexcept { return m_Hash; }
+
+	vk::PipelineBindPoint bind_point() const noexcept { return m_BindPoint; }
+
+	/// \returns the descriptor set layout bindings of the shaders.
+	const std::vector<vk::DescriptorSetLayoutBinding>& layout_bindings() const noexcept { return m_LayoutBindings; }
+
+	/// \brief creates a descriptor set layout, and pipeline layout that are compatible with this state.
+	bool create_layout(const vk::Device& device,
+					   vk::DescriptorSetLayout& descriptorSetLayout,
+					   vk::PipelineLayout& pipelineLayout) const;
+
+	/// \brief creates a pipeline layout for this state using an existing (compatible) descriptor set layout.
+	bool create_pipeline_layout(const vk::Device& device,
+								vk::DescriptorSetLayout descriptorSetLayout,
+								vk::PipelineLayout& pipelineLayout) const;
+
+	/// \brief compiles the pipeline, this is safe to call from any thread.
+	std::optional<vk::Pipeline>
+	compile(const vk::Device& device, vk::PipelineCache pipelineCache, vk::PipelineLayout layout) const;
+
+  private:
+	std::vector<core::resource::handle<core::ivk::shader>> m_Shaders;
+	std::vector<vk::PipelineShaderStageCreateInfo> m_Stages;
+	std::vector<vk::DescriptorSetLayoutBinding> m_LayoutBindings;
+	std::vector<vk::VertexInputBindingDescription> m_VertexBindings;
+	std::vector<vk::VertexInputAttributeDescription> m_VertexAttributes;
+	std::vector<vk::PipelineColorBlendAttachmentState> m_BlendAttachments;
+	vk::PipelineBindPoint m_BindPoint {vk::PipelineBindPoint::eGraphics};
+	vk::RenderPass m_RenderPass;
+	uint32_t m_AttachmentCount {0};
+	vk::CullModeFlags m_CullMode;
+	bool m_Wireframe {false};
+	bool m_DepthTest {true};
+	bool m_DepthWrite {true};
+	uint64_t m_Hash {0};
+};
+}	 // namespace core::ivk::details
+
 namespace core::ivk {
 /// \brief encapsulated the concept of a graphics pipeline on the GPU
-/// \warning calling the update method family _during_ the recording of the vk::CommandBuffer's will invalidate the
-/// command buffer
-/// \todo find a solution around the warning
+///
+/// The descriptor set layout and descriptor set are owned by the core::ivk::descriptor_allocator of the context.
+/// Pipelines that bind identical resources share the same descriptor set.
+/// \warning the update method family never rewrites a descriptor set that is in use, instead a new set is acquired.
+/// Command buffers that were recorded before the update keep using the old set, and so have to be re-recorded to
+/// observe the change.
 class pipeline {
   public:
 	/// \brief creates a graphics pipeline
@@ -54,6 +116,11 @@ class pipeline {
 	vk::PipelineLayout vkLayout() const noexcept { return m_PipelineLayout; };
 	/// \returns the allocated descriptor set for this instance.
 	vk::DescriptorSet const* vkDescriptorSet() const noexcept { return &m_DescriptorSet; }
+	/// \returns a value that changes every time the pipeline acquires a different descriptor set.
+	/// \note command buffers recorded at an older generation bind a set that might already be recycled.
+	uint64_t generation() const noexcept { return m_Generation; }
+	/// \returns the bind point (graphics or compute) of this instance.
+	vk::PipelineBindPoint bind_point() const noexcept { return m_BindPoint; }
 
 	/// \returns true if there was a binding at that binding location.
 	/// \param[in] bindingLocation the binding location to check.
@@ -106,7 +173,9 @@ class pipeline {
 
   private:
 	bool completeness_check() noexcept;
-	bool update(core::resource::cache_t& cache, const core::data::material_t& data, vk::DescriptorSet set);
+	bool update(core::resource::cache_t& cache, const core::data::material_t& data);
+	/// \brief acquires a descriptor set for the current descriptors, and releases the previous one.
+	void commit();
 	core::resource::handle<core::ivk::context> m_Context;
 
 	vk::DescriptorSet m_DescriptorSet;
@@ -119,6 +188,7 @@ class pipeline {
 	std::vector<vk::WriteDescriptorSet> m_DescriptorSets;
 	std::vector<std::unique_ptr<vk::DescriptorBufferInfo>> m_TrackedBufferInfos;
 	core::resource::cache_t& m_Cache;
+	uint64_t m_Generation {0};
 	bool m_HasPushConstants {false};
 	bool m_IsValid {true};
 	bool m_IsComplete {true};
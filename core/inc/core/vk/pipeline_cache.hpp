@@ -1,6 +1,12 @@
 #pragma once
 #include "core/resource/resource.hpp"
 #include "core/vk/ivk.hpp"
+#include "core/vk/pipeline.hpp"
+#include "psl/array_view.hpp"
+#include "psl/utility/hash.hpp"
+#include <atomic>
+#include <future>
+#include <unordered_set>
 
 namespace core::ivk {
 class context;
@@ -19,42 +25,28 @@ struct UID;
 
 
 namespace core::ivk {
-/// \brief the pipeline key creates a hash of the important elements of a vk::Pipeline
+/// \brief the pipeline key identifies a pipeline of a specific material.
 ///
 /// when you want to store, and lookup pipelines based on their properties, then pipeline_key
-/// is the way to go. the pipeline key allows you to calculate a hash based on the identifying
-/// properties that make it unique (for the GPU), and easily retrieve it.
+/// is the way to go. the pipeline key combines the material's psl::UID with the renderpass and the amount of color
+/// attachments it is bound to, which are cheap to compare, so that a lookup does not have to resolve the pipeline
+/// state.
 /// to see this being used, check core::ivk::pipeline_cache.
+/// \warning the pipeline_key does not update when the material data has been updated.
 /// \see core::ivk::pipeline_cache
 struct pipeline_key {
 	pipeline_key() = default;
-	/// \brief constructor based on the data you wish to store.
-	/// \warning the pipeline_key does not update when the material data has been updated.
-	/// the material will no longer be able to use this key when it changes its properties.
-	pipeline_key(const psl::UID& uid, core::resource::handle<core::data::material_t> data, vk::RenderPass pass);
+	pipeline_key(const psl::UID& uid, vk::RenderPass renderPass, uint32_t attachmentCount) noexcept
+		: uid(uid), renderPass(renderPass), attachmentCount(attachmentCount) {}
 
 	bool operator==(const pipeline_key& other) const noexcept {
-		return renderPass.operator VkRenderPass() == other.renderPass.operator VkRenderPass() &&
-			   descriptors.size() == other.descriptors.size() &&
-			   std::equal(std::begin(descriptors),
-						  std::end(descriptors),
-						  std::begin(other.descriptors),
-						  std::end(other.descriptors));
-	}
-	bool operator!=(const pipeline_key& other) const noexcept {
-		return renderPass.operator VkRenderPass() != other.renderPass.operator VkRenderPass() ||
-			   descriptors.size() != other.descriptors.size() ||
-			   !std::equal(std::begin(descriptors),
-						   std::end(descriptors),
-						   std::begin(other.descriptors),
-						   std::end(other.descriptors));
+		return renderPass == other.renderPass && attachmentCount == other.attachmentCount && uid == other.uid;
 	}
+	bool operator!=(const pipeline_key& other) const noexcept { return !(*this == other); }
 
-	/// \brief the contained descriptors that describe this key.
-	const std::vector<std::pair<vk::DescriptorType, uint32_t>> descriptors;
-	/// \brief the bound renderpass of this key.
-	const vk::RenderPass renderPass;
 	psl::UID uid;
+	vk::RenderPass renderPass;
+	uint32_t attachmentCount {0};
 };
 }	 // namespace core::ivk
 
@@ -62,13 +54,10 @@ namespace std {
 template <>
 struct hash<core::ivk::pipeline_key> {
 	std::size_t operator()(core::ivk::pipeline_key const& s) const noexcept {
-		std::size_t seed = std::hash<psl::UID> {}(s.uid);
-		for(auto& i : s.descriptors) {
-			seed ^= (uint64_t)i.first + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-			seed ^= (uint64_t)i.second + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-		}
-		seed += (uint64_t)s.renderPass.operator VkRenderPass() + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-		return seed;
+		uint64_t seed = std::hash<psl::UID> {}(s.uid);
+		psl::utility::hash_combine(seed, std::hash<VkRenderPass> {}(static_cast<VkRenderPass>(s.renderPass)));
+		psl::utility::hash_combine(seed, s.attachmentCount);
+		return static_cast<std::size_t>(seed);
 	}
 };
 }	 // namespace std
@@ -79,6 +68,15 @@ namespace core::ivk {
 /// the pipeline cache allows sharing of pipelines between various materials.
 /// it is responsible for the creation and destruction of all pipeline objects, as well as
 /// providing easy facilities to get pipelines based on material descriptions.
+///
+/// pipelines can be compiled ahead of time on worker threads using prewarm(). Compilation is deduplicated on the
+/// structural hash of the pipeline state, and the results are stored in the shared vk::PipelineCache, so that the
+/// later get() calls only have to wait on the pipelines they actually need.
+///
+/// when the psl::meta::library contains a physical file for the psl::UID of this resource, then the driver's
+/// vk::PipelineCache data is loaded from that file at creation, and written back to it on destruction. The stored
+/// data is tagged with the vendor, device, driver version and pipelineCacheUUID of the physical device it was created
+/// on, and is discarded when any of them differ.
 class pipeline_cache {
   public:
 	pipeline_cache(core::resource::cache_t& cache,
@@ -108,7 +106,48 @@ class pipeline_cache {
 													core::resource::handle<core::data::material_t> data,
 													core::resource::handle<core::ivk::swapchain> swapchain);
 
+	/// \brief compiles the pipelines for the given materials, when bound to the given framebuffer, on worker threads.
+	/// \details pipelines that share their state (see core::ivk::details::pipeline_state::hash()) are only compiled
+	/// once. get() will wait for the compilation of the pipeline it needs (or compile it itself when no worker has
+	/// picked it up yet), all others keep compiling in the background.
+	/// \param[in] materials the materials to compile the pipelines for.
+	/// \param[in] framebuffer the framebuffer that will be bound to.
+	void prewarm(psl::array_view<core::resource::handle<core::data::material_t>> materials,
+				 core::resource::handle<core::ivk::framebuffer_t> framebuffer);
+
+	/// \brief compiles the pipelines for the given materials, when bound to the given swapchain, on worker threads.
+	/// \copydetails prewarm()
+	/// \param[in] materials the materials to compile the pipelines for.
+	/// \param[in] swapchain the swapchain that will be bound to.
+	void prewarm(psl::array_view<core::resource::handle<core::data::material_t>> materials,
+				 core::resource::handle<core::ivk::swapchain> swapchain);
+
+	/// \brief writes the current content of the vk::PipelineCache to the psl::meta::library.
+	/// \returns false when the library has no physical file for this resource, or the data could not be written.
+	/// \note this is done automatically on destruction.
+	bool save();
+
+	vk::PipelineCache vkPipelineCache() const noexcept { return m_PipelineCache; }
+
   private:
+	struct compile_job_t {
+		compile_job_t(details::pipeline_state state) : state(std::move(state)) {}
+		details::pipeline_state state;
+		std::atomic_flag claimed {};
+		std::atomic_flag finished {};
+	};
+
+	core::resource::handle<core::ivk::pipeline> get(const psl::UID& uid,
+													core::resource::handle<core::data::material_t> data,
+													vk::RenderPass renderPass,
+													uint32_t attachmentCount);
+	void prewarm(psl::array_view<core::resource::handle<core::data::material_t>> materials,
+				 vk::RenderPass renderPass,
+				 uint32_t attachmentCount);
+	void compile(compile_job_t& job) const;
+	void collect();
+
+	psl::UID m_UID;
 	core::resource::handle<core::ivk::context> m_Context;
 	core::resource::cache_t& m_Cache;
 	vk::PipelineCache m_PipelineCache;
@@ -116,5 +155,10 @@ class pipeline_cache {
 	// std::vector<core::resource::handle<core::ivk::pipeline>> m_Pipelines;
 
 	std::unordered_map<pipeline_key, core::resource::handle<core::ivk::pipeline>> m_Pipelines;
+
+	// prewarm jobs keyed on their structural hash, released once all workers are done.
+	std::unordered_map<uint64_t, std::unique_ptr<compile_job_t>> m_Jobs;
+	std::unordered_set<uint64_t> m_Prewarmed;
+	std::vector<std::future<void>> m_Workers;
 };
 }	 // namespace core::ivk
@@ -0,0 +1,164 @@
+#pragma once
+#include "core/vk/ivk.hpp"
+#include <deque>
+#include <limits>
+#include <optional>
+#include <unordered_set>
+#include <vector>
+
+namespace core::ivk {
+class context;
+}
+
+namespace core::ivk {
+/// \brief persistently mapped ring of host visible memory that batches uploads to the GPU.
+///
+/// Uploads are written into the ring, and the copies out of it are recorded into a batch that is submitted once
+/// (usually once per frame, see core::ivk::drawpass::present). Adjacent copy regions targetting the same buffer are
+/// merged, so a batch results in a minimal amount of vk::BufferCopy instructions. Every submitted batch signals the
+/// next value on a timeline semaphore, which is used both to reclaim ring space and to let resources query if their
+/// uploads have completed, without needing a fence per upload.
+/// When the context has a dedicated transfer queue (see core::ivk::context::transfer_queue()), the batch is executed
+/// on it, and handed over to the graphics queue by a second submission that waits on the transfer. Images are
+/// transferred to the graphics queue family through handoff(), buffers are created with concurrent sharing instead.
+/// On single queue devices both are executed on the graphics queue.
+/// Buffers that were written by an earlier batch could still be read by frames that are in flight. A batch that
+/// writes into such a buffer first waits on all work previously submitted to the graphics queue (see release()), first
+/// uploads into a buffer are not held back by it.
+/// \note uploads that do not fit in the ring get a dedicated buffer that lives as long as the batch it belongs to.
+/// \warning the ring is owned by, and should be accessed through, core::ivk::context::staging(). It is not
+/// thread-safe.
+class staging_ring {
+  public:
+	/// \brief location of staged data in a source buffer.
+	struct allocation_t {
+		vk::Buffer buffer;
+		vk::DeviceSize offset {0};
+	};
+
+	staging_ring(core::ivk::context& context, vk::DeviceSize capacity);
+	~staging_ring();
+	staging_ring(const staging_ring&)			 = delete;
+	staging_ring(staging_ring&&)				 = delete;
+	staging_ring& operator=(const staging_ring&) = delete;
+	staging_ring& operator=(staging_ring&&)		 = delete;
+
+	/// \brief copies the data into the ring.
+	/// \details when the ring is full, the current batch is submitted and the oldest batch is waited on.
+	/// \param[in] data the source to copy from.
+	/// \param[in] size the size in bytes of the data.
+	/// \param[in] alignment the alignment of the resulting offset, this has to be a power of 2.
+	/// \returns the location of the data, or nothing when no memory could be allocated for it.
+	std::optional<allocation_t> write(const void* data, vk::DeviceSize size, vk::DeviceSize alignment = 4);
+
+	/// \brief enqueues a copy from the staged data into the destination buffer in the current batch.
+	/// \note the copy is recorded on submit(), merged with the other copies into the same destination.
+	void copy(const allocation_t& source, vk::Buffer destination, vk::DeviceSize dstOffset, vk::DeviceSize size);
+
+	/// \brief records a copy between two buffers into the current batch.
+	/// \details the copy is ordered after every copy that was enqueued before it, and before every copy enqueued
+	/// after it, so the source can be the destination of earlier uploads, and can be written again afterwards.
+	/// Consecutive contiguous regions are merged (see coalesce()).
+	/// \returns the timeline value of the batch, which is signalled when the copy has completed.
+	uint64_t copy(vk::Buffer source, vk::Buffer destination, std::vector<vk::BufferCopy> regions);
+
+	/// \returns the command buffer of the current batch, for uploads that need to record their own commands
+	/// (such as vk::Image layout transitions and copies).
+	/// \warning the command buffer is only valid until the next submit(), and might execute on the transfer queue,
+	/// so it should only record transfer commands. Use handoff() to finalize images.
+	vk::CommandBuffer commands();
+
+	/// \brief transitions the image to its final layout after the batch, and transfers its ownership to the graphics
+	/// queue family when the batch is executed on a dedicated transfer queue.
+	void handoff(vk::Image image,
+				 const vk::ImageSubresourceRange& range,
+				 vk::ImageLayout oldLayout,
+				 vk::ImageLayout newLayout);
+
+	/// \brief submits the current batch to the queue, this does not wait for its completion.
+	/// \returns the timeline value that will be signalled when the batch completes.
+	uint64_t submit();
+
+	/// \returns the timeline value that the current (unsubmitted) batch will signal.
+	uint64_t pending() const noexcept { return m_Submitted + (m_Dedicated ? 3 : 1); }
+
+	/// \returns true when the batch of the given timeline value has completed on the GPU.
+	bool is_complete(uint64_t value) const;
+
+	/// \brief waits until the batch of the given timeline value has completed, submitting it when needed.
+	bool wait(uint64_t value, uint64_t timeout = std::numeric_limits<uint64_t>::max());
+
+	/// \returns the timeline semaphore that gets signalled by the batches.
+	vk::Semaphore semaphore() const noexcept { return m_Semaphore; }
+
+	/// \brief stops tracking the buffer, this should be called before it is destroyed.
+	void forget(vk::Buffer buffer);
+
+	/// \brief merges consecutive regions that are contiguous in both source and destination.
+	/// \note the order of the regions is preserved, so overlapping writes keep their relative order.
+	static void coalesce(std::vector<vk::BufferCopy>& regions);
+
+  private:
+	struct overflow_t {
+		vk::Buffer buffer;
+		vk::DeviceMemory memory;
+	};
+	struct copy_t {
+		vk::Buffer source;
+		vk::Buffer destination;
+		std::vector<vk::BufferCopy> regions;
+	};
+	struct batch_t {
+		uint64_t value {0};
+		uint64_t end {0};
+		vk::CommandBuffer commands;
+		vk::CommandBuffer acquire;
+		std::vector<overflow_t> overflow;
+		std::vector<vk::Buffer> destinations;
+		// true when the batch writes into buffers that the graphics queue could still be reading from.
+		bool release {false};
+	};
+
+	/// \returns the command pool, and queue the batches are recorded for.
+	const vk::CommandPool& pool() const noexcept;
+	const vk::Queue& queue() const noexcept;
+
+	std::optional<vk::DeviceSize> allocate(vk::DeviceSize size, vk::DeviceSize alignment);
+	std::optional<allocation_t> write_overflow(const void* data, vk::DeviceSize size);
+	void record(copy_t& copy);
+	/// \brief orders the writes into the destination after the graphics work that was submitted before the batch, when
+	/// an earlier batch already wrote into it.
+	/// \details on the graphics queue this is an execution barrier, on a dedicated transfer queue the batch waits on a
+	/// timeline value that the graphics queue signals once the work submitted before the batch completed.
+	void release(vk::Buffer destination);
+	/// \brief records the enqueued copies, followed by a barrier that orders them before later transfers.
+	void flush();
+	vk::CommandBuffer record_acquire();
+	void reclaim();
+	void recycle(batch_t& batch);
+
+	core::ivk::context& m_Context;
+	vk::Buffer m_Buffer;
+	vk::DeviceMemory m_Memory;
+	std::byte* m_Data {nullptr};
+	vk::DeviceSize m_Capacity {0};
+
+	// monotonically increasing positions, the offset in the ring is the position modulo the capacity.
+	uint64_t m_Head {0};
+	uint64_t m_Tail {0};
+
+	vk::Semaphore m_Semaphore;
+	uint64_t m_Submitted {0};
+	// true when the batches are executed on a queue family other than the graphics queue family.
+	bool m_Dedicated {false};
+
+	batch_t m_Current;
+	std::vector<copy_t> m_Copies;
+	std::vector<vk::ImageMemoryBarrier> m_Acquires;
+	std::deque<batch_t> m_InFlight;
+	// buffers that were written by submitted batches, and so can be in use by the graphics queue.
+	std::unordered_set<VkBuffer> m_Written;
+	std::vector<vk::CommandBuffer> m_FreeCommands;
+	std::vector<vk::CommandBuffer> m_FreeAcquires;
+};
+}	 // namespace core::ivk
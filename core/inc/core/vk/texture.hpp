@@ -67,6 +67,8 @@ class texture_t {
 	vk::ImageLayout m_ImageLayout {vk::ImageLayout::eGeneral};
 	vk::ImageSubresourceRange m_SubresourceRange;
 	uint32_t m_MipLevels {0};
+	// timeline value of the core::ivk::staging_ring batch that uploads the texture data
+	uint64_t m_Pending {0};
 
 	core::resource::cache_t& m_Cache;
 	core::resource::handle<core::ivk::context> m_Context;
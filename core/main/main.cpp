@@ -63,6 +63,7 @@
 #include "psl/ecs/state.hpp"
 
 #include "core/ecs/systems/attractor.hpp"
+#include "core/ecs/systems/culling.hpp"
 #include "core/ecs/systems/death.hpp"
 #include "core/ecs/systems/fly.hpp"
 #include "core/ecs/systems/geometry_instance.hpp"
@@ -599,8 +600,14 @@ int entry(gfx::graphics_backend backend, core::os::context& os_context) {
 	cache.library().set(frameCamBufferBinding, "GLOBAL_DYNAMIC_WORLD_VIEW_PROJECTION_MATRIX");
 
 
-	// create a pipeline cache
-	auto pipeline_cache = cache.create<core::gfx::pipeline_cache>(context_handle);
+	// create a pipeline cache, its data is persisted between runs in a file next to the library. Every backend has
+	// its own file, as their data is not compatible.
+	const auto pipeline_cache_uid = "3c8a1e52-7f0d-4b96-a2e1-5d9c60b7f413"_uid;
+	if(!cache.library().contains(pipeline_cache_uid))
+		cache.library().create_physical(pipeline_cache_uid,
+										(backend == core::gfx::graphics_backend::vulkan) ? "pipeline.vk.cache"
+																						 : "pipeline.gles.cache");
+	auto pipeline_cache = cache.create_using<core::gfx::pipeline_cache>(pipeline_cache_uid, context_handle);
 
 	psl::array<core::resource::handle<core::gfx::material_t>> materials;
 	core::resource::handle<core::gfx::material_t> depth_material =
@@ -678,6 +685,12 @@ int entry(gfx::graphics_backend backend, core::os::context& os_context) {
 	  cache.create<core::gfx::material_t>(context_handle, post_effect_data, pipeline_cache, instanceMaterialBuffer);
 	post_effect_bundle->set_material(post_effect_material, 4000);
 	post_effect_bundle->set("color", psl::vec4::one);
+
+	// compile the pipelines in the background while the rest of the scene is set up, the first frames then only wait
+	// on the pipelines that are not done yet.
+	pipeline_cache->prewarm(materials, geometryFBO);
+	pipeline_cache->prewarm(psl::array<core::resource::handle<core::gfx::material_t>> {post_effect_material},
+							swapchain_handle);
 	// auto fbo_texture = geometryFBO->texture(0);
 
 	/*
@@ -757,6 +770,7 @@ int entry(gfx::graphics_backend backend, core::os::context& os_context) {
 								  });
 
 	ECSState.declare<"attractor">(psl::ecs::threading::par, core::ecs::systems::attractor);
+	core::ecs::systems::culling culling_system {ECSState, surface_handle};
 	core::ecs::systems::geometry_instancing geometry_instancing_system {ECSState};
 
 	core::ecs::systems::lighting_system lighting {psl::view_ptr(&ECSState),
@@ -859,12 +873,18 @@ ECSState.create(
 		core::log->info("There are {} renderables alive right now", ECSState.size<renderable>());
 		core::profiler.next_frame();
 
+		// finalize the resources that finished loading in the background
+		core::profiler.scope_begin("finalizing resources");
+		cache.poll();
+		core::profiler.scope_end();
+
 		core::profiler.scope_begin("system tick");
 		ECSState.tick(dTime * timeScale);
 		core::profiler.scope_end();
 
 		core::profiler.scope_begin("presenting");
 		renderGraph.present();
+		context_handle->end_frame();
 		core::profiler.scope_end();
 
 		core::profiler.scope_begin("creating entities");
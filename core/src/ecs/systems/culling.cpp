@@ -0,0 +1,94 @@
+#include "core/ecs/systems/culling.hpp"
+#include "core/gfx/geometry.hpp"
+#include "core/os/surface.hpp"
+#include "psl/math/math.hpp"
+#include <algorithm>
+
+using namespace core::ecs::systems;
+using namespace core::ecs::components;
+using namespace psl;
+using namespace psl::ecs;
+
+#undef near
+#undef far
+
+culling::culling(state_t& state, core::resource::handle<core::os::surface> surface) : m_Surface(surface) {
+	state.declare<"culling::tick">(threading::seq, &culling::tick, this);
+}
+
+psl::array_view<entity_t> culling::visible(entity_t camera) const noexcept {
+	if(auto it = m_Visible.find(camera.value); it != std::end(m_Visible))
+		return it->second;
+	return {};
+}
+
+void culling::tick(
+  info_t& info,
+  pack_direct_full_t<entity_t, const camera, const transform> cameras,
+  pack_direct_full_t<entity_t, const renderable, const transform, const dynamic_tag, except<dont_render_tag>>
+	renderables,
+  pack_direct_full_t<entity_t, const culled_tag> culled) {
+	PROFILE_SCOPE(core::profiler)
+	const auto entities	  = renderables.get<entity_t>();
+	const auto renderers  = renderables.get<const renderable>();
+	const auto transforms = renderables.get<const transform>();
+	const size_t count	  = renderables.size();
+
+	core::profiler.scope_begin("bounds");
+	m_Models.resize(count);
+	math::compose(std::begin(transforms), std::end(transforms), m_Models.data());
+	m_Bounds.resize(count);
+	for(size_t i = 0; i < count; ++i) {
+		// geometry that isn't loaded yet is never culled
+		const auto& geometry = renderers[i].geometry;
+		m_Bounds.set(i,
+					 (geometry) ? math::transform(geometry->bounds(), m_Models[i])
+								: aabb {vec3::zero, vec3::infinity});
+	}
+	core::profiler.scope_end();
+
+	core::profiler.scope_begin("frustum");
+	const float aspectRatio = (float)m_Surface->data().width() / (float)m_Surface->data().height();
+	// drop the lists of the cameras that no longer exist
+	const auto cameraEntities = cameras.get<entity_t>();
+	std::erase_if(m_Visible, [&cameraEntities](const auto& entry) {
+		return std::find(std::begin(cameraEntities), std::end(cameraEntities), entity_t {entry.first}) ==
+			   std::end(cameraEntities);
+	});
+	m_Indices.resize(count);
+	// without a camera there is nothing to cull against
+	m_Seen.assign(count, (cameras.size() == 0) ? 1 : 0);
+	for(auto [entity, camera, transform] : cameras) {
+		const vec3 direction = transform.rotation * vec3::forward;
+		const auto viewProjection =
+		  math::perspective_projection(math::radians(camera.fov), aspectRatio, camera.near, camera.far) *
+		  math::look_at(transform.position, transform.position + direction, vec3::up);
+
+		const auto visibleCount = math::cull(math::to_frustum(viewProjection), m_Bounds, 0, count, m_Indices.data());
+		auto& visible			= m_Visible[entity.value];
+		visible.resize(visibleCount);
+		for(size_t i = 0; i < visibleCount; ++i) {
+			visible[i]			 = entities[m_Indices[i]];
+			m_Seen[m_Indices[i]] = 1;
+		}
+	}
+	core::profiler.scope_end();
+
+	core::profiler.scope_begin("tagging");
+	const auto tagged = culled.get<entity_t>();
+	m_Tagged.resize(tagged.size());
+	std::transform(std::begin(tagged), std::end(tagged), std::begin(m_Tagged), [](entity_t e) { return e.value; });
+	std::sort(std::begin(m_Tagged), std::end(m_Tagged));
+	m_Hidden.clear();
+	m_Revealed.clear();
+	for(size_t i = 0; i < count; ++i) {
+		const bool isTagged = std::binary_search(std::begin(m_Tagged), std::end(m_Tagged), entities[i].value);
+		if(!m_Seen[i] && !isTagged)
+			m_Hidden.emplace_back(entities[i]);
+		else if(m_Seen[i] && isTagged)
+			m_Revealed.emplace_back(entities[i]);
+	}
+	info.command_buffer.add_components<culled_tag>(m_Hidden);
+	info.command_buffer.remove_components<culled_tag>(m_Revealed);
+	core::profiler.scope_end();
+}
@@ -1,4 +1,5 @@
 #include <stdint.h>
+#include <algorithm>
 
 #include "core/ecs/components/renderable.hpp"
 #include "core/ecs/components/transform.hpp"
@@ -29,79 +30,161 @@ geometry_instancing::geometry_instancing(psl::ecs::state_t& state) {
 
 
 void geometry_instancing::dynamic_system(info_t& info,
-										 pack_direct_full_t<renderable,
+										 pack_direct_full_t<entity_t,
+															const renderable,
 															const transform,
 															const dynamic_tag,
-															except<dont_render_tag>,
-															order_by<renderer_sort, renderable>> geometry_pack) {
-	// todo clean up in case the last renderable from a dynamic object is despawned. The instance will not be released
-	// todo this will trash static instances as well
-	core::log->warn("todo: instance leak");
-	core::profiler.scope_begin("release_all");
-
-	{
-		auto renderers = geometry_pack.get<renderable>();
-		for(auto renderable : renderers)
-			if(renderable.bundle)
-				renderable.bundle->release_all();
-	}
-
-	core::profiler.scope_end();
+															except<dont_render_tag, culled_tag>> geometry_pack) {
+	// dynamic entities keep their instance for as long as they are rendered with the same bundle and geometry, so
+	// only the model matrices of the entities that moved have to be uploaded. Culled entities are left out of the
+	// pack, which releases their instance until they are visible again.
+	++m_Tick;
 
 	core::profiler.scope_begin("mapping");
-	std::unordered_map<psl::UID, std::unordered_map<psl::UID, geometry_instance>> UniqueCombinations;
-
-	for(uint32_t i = 0; i < (uint32_t)geometry_pack.size(); ++i) {
-		const auto& renderer = std::get<renderable&>(geometry_pack[i]);
+	for(auto [entity, renderer, transform] : geometry_pack) {
 		if(!renderer.bundle)
 			continue;
-		if(UniqueCombinations[renderer.bundle].find(renderer.geometry) ==
-		   std::end(UniqueCombinations[renderer.bundle])) {
-			UniqueCombinations[renderer.bundle].emplace(renderer.geometry, geometry_instance {i, 0});
+
+		if(auto instance = m_DynamicInstances.try_get(entity.value); instance) {
+			auto& group = *instance->group;
+			if(group.bundle.uid() == renderer.bundle.uid() && group.geometry.uid() == renderer.geometry.uid()) {
+				instance->tick = m_Tick;
+				if(instance->transform.position != transform.position ||
+				   instance->transform.rotation != transform.rotation || instance->transform.scale != transform.scale) {
+					instance->transform = transform;
+					group.dirty.emplace_back(instance->id);
+				}
+				continue;
+			}
+			dynamic_release(entity);
 		}
-		UniqueCombinations[renderer.bundle][renderer.geometry].count += 1;
+		dynamic_group_for(renderer).pending.emplace_back(entity, transform);
 	}
 	core::profiler.scope_end();
 
-	core::profiler.scope_begin("create_all");
-	std::vector<psl::mat4x4> modelMats;
-	for(const auto& unique_bundle : UniqueCombinations) {
-		modelMats.clear();
-
-		for(const auto& [geometryUID, geometryData] : unique_bundle.second) {
-			const auto& renderer = std::get<renderable&>(geometry_pack[geometryData.startIndex]);
-			auto bundleHandle	 = renderer.bundle;
-			auto geometryHandle	 = renderer.geometry;
+	core::profiler.scope_begin("release");
+	{
+		// entities that were not part of the pack were either destroyed, or are no longer rendered as dynamic
+		std::vector<entity_t> released;
+		auto indices = m_DynamicInstances.indices();
+		auto dense	 = m_DynamicInstances.dense();
+		for(size_t i = 0; i < dense.size(); ++i) {
+			if(dense[i].tick != m_Tick)
+				released.emplace_back(indices[i]);
+		}
+		for(auto entity : released) dynamic_release(entity);
+	}
+	core::profiler.scope_end();
 
-			auto instancesID = bundleHandle->instantiate(geometryHandle, (uint32_t)geometryData.count);
+	core::profiler.scope_begin("create");
+	for(auto& [bundleUID, groups] : m_DynamicGroups) {
+		for(auto& [geometryUID, group] : groups) {
+			if(group.pending.empty())
+				continue;
 
-			size_t indicesCompleted = 0;
+			auto pending	 = group.pending.begin();
+			auto instancesID = group.bundle->instantiate(group.geometry, (uint32_t)group.pending.size());
 			for(auto [startIndex, endIndex] : instancesID) {
-				auto range = endIndex - startIndex;
-				for(auto i = 0u; i < range; ++i, ++indicesCompleted) {
-					const auto& transform = std::get<const core::ecs::components::transform&>(
-					  geometry_pack[indicesCompleted + geometryData.startIndex]);
-					const psl::mat4x4 translationMat = translate(transform.position);
-					const psl::mat4x4 rotationMat	 = to_matrix(transform.rotation);
-					const psl::mat4x4 scaleMat		 = scale(transform.scale);
-					modelMats.emplace_back(translationMat * rotationMat * scaleMat);
+				if(group.owners.size() < endIndex)
+					group.owners.resize(endIndex, invalid_entity);
+				for(auto id = startIndex; id < endIndex; ++id, ++pending) {
+					auto& instance	   = m_DynamicInstances[pending->first.value];
+					instance.group	   = &group;
+					instance.id		   = id;
+					instance.tick	   = m_Tick;
+					instance.transform = pending->second;
+					group.owners[id]   = pending->first;
+					group.dirty.emplace_back(id);
 				}
+			}
+			group.pending.clear();
+		}
+	}
+	core::profiler.scope_end();
+
+	core::profiler.scope_begin("upload");
+	static_cast<memory::linear_allocator*>(m_FrameMemory.allocator())->reset();
+	psl::array<std::pair<uint32_t, uint32_t>> ranges;
+	psl::array<psl::mat4x4> modelMats;
+	psl::array<transform> transforms;
+	for(auto& [bundleUID, groups] : m_DynamicGroups) {
+		for(auto& [geometryUID, group] : groups) {
+			if(group.dirty.empty())
+				continue;
+
+			// contiguous instance ids are merged into a single range, and all ranges are uploaded in one commit
+			std::sort(std::begin(group.dirty), std::end(group.dirty));
+			group.dirty.erase(std::unique(std::begin(group.dirty), std::end(group.dirty)), std::end(group.dirty));
+			ranges.clear();
+			transforms.clear();
+			for(auto id : group.dirty) {
+				if(id >= group.owners.size() || !group.owners[id])
+					continue;
+				if(ranges.empty() || ranges.back().second != id)
+					ranges.emplace_back(id, id + 1);
+				else
+					ranges.back().second = id + 1;
+				transforms.emplace_back(m_DynamicInstances.at(group.owners[id].value).transform);
+			}
+			group.dirty.clear();
+			if(ranges.empty())
+				continue;
 
-				if(!bundleHandle->set(
-					 geometryHandle, startIndex, psl::string {core::gfx::constants::INSTANCE_MODELMATRIX}, modelMats))
-					core::log->error(
-					  "could not set the instance data for the dynamic elements in geometry: {} startIndex: {} size: "
-					  "{}",
-					  geometryHandle,
-					  startIndex,
-					  modelMats.size());
-				modelMats.clear();
+			// the matrices are written into the frame memory, only when it is exhausted they go through the heap
+			psl::mat4x4* matrices {nullptr};
+			if(auto segment = m_FrameMemory.allocate(sizeof(psl::mat4x4) * transforms.size()); segment) {
+				matrices = reinterpret_cast<psl::mat4x4*>(segment.value().range().begin);
+			} else {
+				modelMats.resize(transforms.size());
+				matrices = modelMats.data();
 			}
+			psl::math::compose(std::begin(transforms), std::end(transforms), matrices);
+
+			if(!group.bundle->set(group.geometry, core::gfx::constants::INSTANCE_MODELMATRIX_ID, ranges, matrices))
+				core::log->error("could not set the instance data for the dynamic elements in geometry: {} ranges: {}",
+								 group.geometry,
+								 ranges.size());
 		}
 	}
 	core::profiler.scope_end();
 }
 
+geometry_instancing::dynamic_group& geometry_instancing::dynamic_group_for(const renderable& renderer) {
+	auto& group = m_DynamicGroups[renderer.bundle][renderer.geometry];
+	if(!group.bundle) {
+		group.bundle   = renderer.bundle;
+		group.geometry = renderer.geometry;
+	}
+	return group;
+}
+
+void geometry_instancing::dynamic_release(entity_t entity) {
+	auto& instance = m_DynamicInstances.at(entity.value);
+	auto& group	   = *instance.group;
+	auto id		   = instance.id;
+	m_DynamicInstances.erase(entity.value);
+
+	// the last instance takes the place of the released one, so that the instances stay compact
+	auto last = (uint32_t)group.owners.size() - 1;
+	if(last != id) {
+		auto moved							  = group.owners[last];
+		group.owners[id]					  = moved;
+		m_DynamicInstances.at(moved.value).id = id;
+		group.dirty.emplace_back(id);
+	}
+	group.owners[last] = invalid_entity;
+	group.bundle->release(group.geometry, last);
+	while(!group.owners.empty() && !group.owners.back()) group.owners.pop_back();
+
+	if(group.owners.empty() && group.pending.empty()) {
+		auto bundle	 = group.bundle.uid();
+		auto& groups = m_DynamicGroups[bundle];
+		groups.erase(group.geometry.uid());
+		if(groups.empty())
+			m_DynamicGroups.erase(bundle);
+	}
+}
+
 void geometry_instancing::static_add(info_t& info,
 									 pack_direct_full_t<entity_t,
 														const renderable,
@@ -126,6 +209,7 @@ void geometry_instancing::static_add(info_t& info,
 	core::profiler.scope_end();
 
 	core::profiler.scope_begin("create_all");
+	auto transforms = geometry_pack.get<const transform>();
 	std::vector<psl::mat4x4> modelMats;
 	psl::array<entity_t> eIds;
 	eIds.resize(1);
@@ -141,21 +225,15 @@ void geometry_instancing::static_add(info_t& info,
 
 			uint32_t indicesCompleted = 0;
 			for(auto [startIndex, endIndex] : instancesID) {
-				for(auto i = startIndex; i < endIndex; ++i, ++indicesCompleted) {
-					const auto& transform = std::get<const core::ecs::components::transform&>(
-					  geometry_pack[indicesCompleted + geometryData.startIndex]);
-					const psl::mat4x4 translationMat = translate(transform.position);
-					const psl::mat4x4 rotationMat	 = to_matrix(transform.rotation);
-					const psl::mat4x4 scaleMat		 = scale(transform.scale);
-					modelMats.emplace_back(translationMat * rotationMat * scaleMat);
+				auto first = std::next(std::begin(transforms), geometryData.startIndex + indicesCompleted);
+				modelMats.resize(endIndex - startIndex);
+				psl::math::compose(first, std::next(first, endIndex - startIndex), modelMats.data());
 
+				for(auto i = startIndex; i < endIndex; ++i, ++indicesCompleted) {
 					eIds[0] = std::get<entity_t&>(geometry_pack[indicesCompleted + geometryData.startIndex]);
 					info.command_buffer.add_components<instance_id>(eIds, instance_id {i});
 				}
-				bundleHandle->set(
-				  geometryHandle, startIndex, psl::string {core::gfx::constants::INSTANCE_MODELMATRIX}, modelMats);
-
-				modelMats.clear();
+				bundleHandle->set(geometryHandle, startIndex, core::gfx::constants::INSTANCE_MODELMATRIX_ID, modelMats);
 			}
 		}
 	}
@@ -4,6 +4,8 @@
 #include "core/gfx/buffer.hpp"
 #include "core/os/surface.hpp"
 #include "psl/ecs/state.hpp"
+#include <algorithm>
+#include <cstring>
 
 using namespace core::ecs::systems;
 using namespace psl;
@@ -18,26 +20,82 @@ gpu_camera::gpu_camera(psl::ecs::state_t& state,
 					   core::resource::handle<core::gfx::shader_buffer_binding> binding,
 					   core::gfx::graphics_backend backend)
 	: m_Surface(surface), m_Binding(binding), m_Backend(backend) {
-	m_Max = m_Binding->segment.range().size() / sizeof(framedata);
+	m_Stride = std::max<size_t>(m_Binding->region.alignment(), sizeof(framedata));
+	m_Max	 = m_Binding->segment.range().size() / m_Stride;
+	state.declare<"gpu_camera::prepare">(psl::ecs::threading::seq, &gpu_camera::prepare, this);
+	state.declare<"gpu_camera::update">(psl::ecs::threading::par, &gpu_camera::update, this);
 	state.declare<"gpu_camera::tick">(psl::ecs::threading::seq, &gpu_camera::tick, this);
 }
 
-void gpu_camera::tick(
-  psl::ecs::info_t& info,
-  psl::ecs::pack_direct_full_t<const core::ecs::components::camera, const core::ecs::components::transform> cameras) {
-	size_t i {0};
-	if(cameras.size() >= m_Max)
+gpu_camera::inputs_t gpu_camera::inputs(const core::ecs::components::transform& transform,
+										const core::ecs::components::camera& camera,
+										float width,
+										float height) noexcept {
+	return {transform.position[0],
+			transform.position[1],
+			transform.position[2],
+			transform.rotation[0],
+			transform.rotation[1],
+			transform.rotation[2],
+			transform.rotation[3],
+			camera.fov,
+			camera.near,
+			camera.far,
+			width,
+			height};
+}
+
+void gpu_camera::prepare(psl::ecs::info_t& info,
+						 psl::ecs::pack_direct_full_t<psl::ecs::entity_t,
+													  const core::ecs::components::camera,
+													  const core::ecs::components::transform> cameras) {
+	if(cameras.size() > m_Max)
 		throw std::runtime_error(
 		  fmt::format("cannot allocate more than {}, but {} was requested for this frame", m_Max, cameras.size()));
 
-	auto camera_components = cameras.get<const core::ecs::components::camera>();
-	auto transf_components = cameras.get<const core::ecs::components::transform>();
+	if(m_Slots.size() != cameras.size())
+		m_Dirty = true;
+	m_Slots.resize(cameras.size());
+	m_Frames.resize(cameras.size() * m_Stride);
+	m_Indices.clear();
+	auto entities = cameras.get<psl::ecs::entity_t>();
+	for(size_t i = 0; i < cameras.size(); ++i) m_Indices.insert(entities[i].value, static_cast<uint32_t>(i));
+}
+
+void gpu_camera::update(psl::ecs::info_t& info,
+						psl::ecs::pack_direct_partial_t<psl::ecs::entity_t,
+														const core::ecs::components::camera,
+														const core::ecs::components::transform> cameras) {
+	const float width  = (float)m_Surface->data().width();
+	const float height = (float)m_Surface->data().height();
+	for(auto [entity, camera, transform] : cameras) {
+		if(!m_Indices.has(entity.value))
+			continue;
+
+		// every slot is only touched by the invocation that owns its entity
+		const auto index = m_Indices.at(entity.value);
+		auto& slot		 = m_Slots[index];
+		auto current	 = inputs(transform, camera, width, height);
+		if(slot.entity == entity && slot.inputs == current)
+			continue;
 
-	for(size_t i = 0; i < cameras.size(); ++i) {
-		update_buffer(i, transf_components[i], camera_components[i]);
+		slot.entity = entity;
+		slot.inputs = current;
+		update_buffer(index, transform, camera);
+		m_Dirty = true;
 	}
 }
 
+void gpu_camera::tick(
+  psl::ecs::info_t& info,
+  psl::ecs::pack_direct_full_t<const core::ecs::components::camera, const core::ecs::components::transform> cameras) {
+	if(!m_Dirty.exchange(false) || m_Frames.empty())
+		return;
+
+	m_Binding->buffer->commit({core::gfx::commit_instruction {
+	  m_Frames.data(), m_Frames.size(), m_Binding->segment, memory::range_t {0, m_Frames.size()}}});
+}
+
 void gpu_camera::update_buffer(size_t index,
 							   const core::ecs::components::transform& transform,
 							   const core::ecs::components::camera& camera) {
@@ -69,10 +127,5 @@ void gpu_camera::update_buffer(size_t index,
 	fdata.viewDirQuat = transform.rotation;
 	fdata.VP		  = fdata.clipMatrix * fdata.projectionMatrix * fdata.viewMatrix;
 	fdata.WVP		  = fdata.VP * fdata.modelMatrix;
-	fdata.viewMatrix  = fdata.viewMatrix;
-	std::vector<core::gfx::commit_instruction> instructions;
-	m_Binding->buffer->commit({core::gfx::commit_instruction {
-	  &fdata,
-	  m_Binding->segment,
-	  memory::range_t {index * m_Binding->region.alignment(), (index + 1) * m_Binding->region.alignment()}}});
+	std::memcpy(m_Frames.data() + index * m_Stride, &fdata, sizeof(framedata));
 }
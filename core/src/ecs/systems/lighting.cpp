@@ -12,7 +12,10 @@
 #include "core/gfx/sampler.hpp"
 #include "core/os/surface.hpp"
 #include "psl/ecs/state.hpp"
+#include "psl/math/math.hpp"
 #include "psl/memory/region.hpp"
+#include <algorithm>
+#include <cstring>
 
 using namespace core::ecs::systems;
 using namespace core;
@@ -20,6 +23,24 @@ using namespace core::resource;
 using namespace core::ecs::components;
 using namespace psl::ecs;
 
+#undef near
+#undef far
+
+namespace {
+constexpr size_t align(size_t size, size_t alignment) noexcept {
+	return (size + alignment - 1) / alignment * alignment;
+}
+
+// the size of the clusters of a single camera in GLOBAL_LIGHT_CLUSTERS
+size_t cluster_slot_size(size_t alignment) noexcept {
+	const auto& dimensions = lighting_system::cluster_dimensions;
+	const size_t clusters  = size_t {dimensions[0]} * dimensions[1] * dimensions[2];
+	return align(sizeof(lighting_system::cluster_header) + sizeof(uint32_t) * (clusters + 1) +
+				   sizeof(uint32_t) * lighting_system::max_cluster_lights,
+				 alignment);
+}
+}	 // namespace
+
 lighting_system::lighting_system(psl::view_ptr<psl::ecs::state_t> state,
 								 psl::view_ptr<core::resource::cache_t> cache,
 								 memory::region& resource_region,
@@ -30,17 +51,183 @@ lighting_system::lighting_system(psl::view_ptr<psl::ecs::state_t> state,
 	: m_Cache(cache), m_RenderGraph(renderGraph), m_DependsPass(pass), m_State(state), m_Context(context),
 	  m_Surface(surface) {
 	state->declare(&lighting_system::create_dir, this);
+	state->declare<"lighting_system::prepare_clusters">(threading::seq, &lighting_system::prepare_clusters, this);
+	state->declare<"lighting_system::assign_clusters">(threading::par, &lighting_system::assign_clusters, this);
+	state->declare<"lighting_system::upload_clusters">(threading::seq, &lighting_system::upload_clusters, this);
 
-	auto bufferData = cache->create<data::buffer_t>(
-	  gfx::memory_usage::uniform_buffer,
+	const auto alignment = m_Context->limits().storage.alignment;
+	auto bufferData		 = cache->create<data::buffer_t>(
+	  gfx::memory_usage::storage_buffer,
 	  gfx::memory_property::host_visible | gfx::memory_property::host_coherent,
 	  resource_region
-		.create_region(sizeof(light) * 1024, m_Context->limits().uniform.alignment, new memory::default_allocator(true))
+		.create_region(align(sizeof(std::array<uint32_t, 4>) + sizeof(light_data) * max_lights, alignment),
+					   alignment,
+					   new memory::default_allocator(true))
 		.value());
 
 	m_LightDataBuffer = cache->create<gfx::buffer_t>(m_Context, bufferData);
 	cache->library().set(m_LightDataBuffer, "GLOBAL_LIGHT_DATA");
 	m_LightSegment = m_LightDataBuffer->reserve(m_LightDataBuffer->free_size()).value();
+
+	auto clusterData = cache->create<data::buffer_t>(
+	  gfx::memory_usage::storage_buffer,
+	  gfx::memory_property::host_visible | gfx::memory_property::host_coherent,
+	  resource_region
+		.create_region(cluster_slot_size(alignment) * max_cameras, alignment, new memory::default_allocator(true))
+		.value());
+
+	m_ClusterBuffer = cache->create<gfx::buffer_t>(m_Context, clusterData);
+	cache->library().set(m_ClusterBuffer, "GLOBAL_LIGHT_CLUSTERS");
+	m_ClusterSegment = m_ClusterBuffer->reserve(m_ClusterBuffer->free_size()).value();
+}
+
+void lighting_system::prepare_clusters(info_t& info,
+									   pack_direct_full_t<const camera, const transform> cameras,
+									   pack_direct_full_t<entity_t, const light, const transform> lights) {
+	PROFILE_SCOPE(core::profiler)
+	// directional lights go first, they are not clustered as they affect every cluster
+	m_Lights.clear();
+	m_LightIndices.clear();
+	auto add = [this](entity_t entity, const light& light, const transform& transform) {
+		if(m_Lights.size() >= max_lights)
+			return;
+		light_data data {};
+		data.position  = psl::vec4(transform.position, 0.0f);
+		data.color	   = psl::vec4(light.color, light.intensity);
+		data.direction = psl::vec4(transform.rotation * psl::vec3::forward, static_cast<float>(light.type));
+		switch(light.type) {
+		case light::type::POINT:
+			data.position[3] = light.uPoint.radius;
+			break;
+		case light::type::SPOT:
+			data.position[3] = light.uSpot.length;
+			data.angles		 = psl::vec4(light.uSpot.innerAngle, light.uSpot.outerAngle, 0.0f, 0.0f);
+			break;
+		default:
+			break;
+		}
+		m_LightIndices.insert(entity.value, static_cast<uint32_t>(m_Lights.size()));
+		m_Lights.emplace_back(data);
+	};
+	for(auto [entity, light, transform] : lights)
+		if(light.type == light::type::DIRECTIONAL)
+			add(entity, light, transform);
+	m_DirectionalLights = static_cast<uint32_t>(m_Lights.size());
+	for(auto [entity, light, transform] : lights)
+		if(light.type != light::type::DIRECTIONAL)
+			add(entity, light, transform);
+	if(const bool truncated = m_Lights.size() < lights.size(); truncated != m_TruncatedLights) {
+		m_TruncatedLights = truncated;
+		if(truncated)
+			core::log->warn("only {} of the {} lights are uploaded to GLOBAL_LIGHT_DATA", max_lights, lights.size());
+	}
+
+	// the cameras are in the same order as they are uploaded by core::ecs::systems::gpu_camera
+	const size_t count = std::min(cameras.size(), max_cameras);
+	m_Clusters.resize(count);
+	const float aspectRatio = (float)m_Surface->data().width() / (float)m_Surface->data().height();
+	size_t i {0};
+	for(auto [camera, transform] : cameras) {
+		if(i == count)
+			break;
+		auto& clusters			  = m_Clusters[i++];
+		const psl::vec3 direction = transform.rotation * psl::vec3::forward;
+		clusters.view = psl::math::look_at(transform.position, transform.position + direction, psl::vec3::up);
+
+		const psl::vec4 projection {camera.fov, aspectRatio, camera.near, camera.far};
+		if(clusters.grid.size() == 0 || clusters.projection != projection) {
+			const auto matrix =
+			  psl::math::perspective_projection(psl::math::radians(camera.fov), aspectRatio, camera.near, camera.far);
+			clusters.projection = projection;
+			clusters.grid		= psl::cluster_grid {matrix, cluster_dimensions};
+		}
+		clusters.pairs.clear();
+	}
+}
+
+void lighting_system::assign_clusters(info_t& info,
+									  pack_direct_partial_t<entity_t, const light, const transform> lights) {
+	PROFILE_SCOPE(core::profiler)
+	if(m_Clusters.empty())
+		return;
+
+	psl::array<uint32_t> indices {};
+	psl::array<std::pair<uint32_t, uint32_t>> pairs {};
+	for(size_t i = 0; i < m_Clusters.size(); ++i) {
+		const auto& clusters = m_Clusters[i];
+		indices.resize(clusters.grid.size());
+		pairs.clear();
+		for(auto [entity, light, transform] : lights) {
+			if((light.type != light::type::POINT && light.type != light::type::SPOT) ||
+			   !m_LightIndices.has(entity.value))
+				continue;
+
+			// spot lights are treated as a sphere of their length, which conservatively contains their cone
+			const float radius = (light.type == light::type::POINT) ? light.uPoint.radius : light.uSpot.length;
+			const auto center  = clusters.view * psl::vec4(transform.position, 1.0f);
+			const auto count   = psl::math::assign(
+				clusters.grid, psl::sphere {psl::vec3(center[0], center[1], center[2]), radius}, indices.data());
+
+			const auto index = m_LightIndices.at(entity.value);
+			for(size_t n = 0; n < count; ++n) pairs.emplace_back(indices[n], index);
+		}
+
+		std::lock_guard lock {m_ClustersMutex};
+		m_Clusters[i].pairs.insert(std::end(m_Clusters[i].pairs), std::begin(pairs), std::end(pairs));
+	}
+}
+
+void lighting_system::upload_clusters(info_t& info, pack_direct_full_t<const camera> cameras) {
+	PROFILE_SCOPE(core::profiler)
+	const std::array<uint32_t, 4> header {static_cast<uint32_t>(m_Lights.size()), m_DirectionalLights, 0, 0};
+	m_Staging.resize(sizeof(header) + sizeof(light_data) * m_Lights.size());
+	std::memcpy(m_Staging.data(), &header, sizeof(header));
+	std::memcpy(m_Staging.data() + sizeof(header), m_Lights.data(), sizeof(light_data) * m_Lights.size());
+	m_LightDataBuffer->commit({core::gfx::commit_instruction {
+	  m_Staging.data(), m_Staging.size(), m_LightSegment, memory::range_t {0, m_Staging.size()}}});
+
+	const auto slotSize = cluster_slot_size(m_Context->limits().storage.alignment);
+	for(size_t i = 0; i < m_Clusters.size(); ++i) {
+		auto& clusters = m_Clusters[i];
+		clusters.lights.build(clusters.grid.size(), clusters.pairs);
+
+		const auto& offsets = clusters.lights.offsets();
+		const auto& indices = clusters.lights.indices();
+		auto indexCount		= indices.size();
+		if(const bool truncated = indexCount > max_cluster_lights; truncated != clusters.truncated) {
+			clusters.truncated = truncated;
+			if(truncated)
+				core::log->warn("the clusters of camera {} contain {} light indices, only {} are uploaded",
+								i,
+								indexCount,
+								max_cluster_lights);
+		}
+		indexCount = std::min(indexCount, max_cluster_lights);
+
+		const auto& dimensions		  = clusters.grid.dimensions();
+		const auto [scale, bias]	  = clusters.grid.slice_transform();
+		const cluster_header clusterHeader {
+		  {dimensions[0], dimensions[1], dimensions[2], static_cast<uint32_t>(clusters.grid.size())},
+		  psl::vec4(clusters.grid.near(), clusters.grid.far(), scale, bias)};
+
+		// offsets past the truncated indices are clamped, so that shaders never read past the uploaded indices
+		m_Staging.resize(sizeof(clusterHeader) + sizeof(uint32_t) * (offsets.size() + indexCount));
+		auto* destination = m_Staging.data();
+		std::memcpy(destination, &clusterHeader, sizeof(clusterHeader));
+		destination += sizeof(clusterHeader);
+		for(auto offset : offsets) {
+			const auto clamped = std::min(offset, static_cast<uint32_t>(indexCount));
+			std::memcpy(destination, &clamped, sizeof(uint32_t));
+			destination += sizeof(uint32_t);
+		}
+		std::memcpy(destination, indices.data(), sizeof(uint32_t) * indexCount);
+
+		m_ClusterBuffer->commit({core::gfx::commit_instruction {
+		  m_Staging.data(),
+		  m_Staging.size(),
+		  m_ClusterSegment,
+		  memory::range_t {i * slotSize, i * slotSize + m_Staging.size()}}});
+	}
 }
 
 void lighting_system::create_dir(info_t& info, pack_direct_full_t<entity_t, light, on_combine<light, transform>> pack) {
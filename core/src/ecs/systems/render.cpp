@@ -18,14 +18,20 @@ using std::chrono::duration;
 
 render::render(state_t& state, psl::view_ptr<core::gfx::drawpass> pass) : m_Pass(pass) {
 	state.declare<"render::tick_draws">(threading::seq, &render::tick_draws, this);
+	m_Pass->add(m_DrawGroup);
+}
+
+render::~render() {
+	m_Pass->remove(m_DrawGroup);
 }
 void render::tick_draws(info_t& info,
 						pack_direct_full_t<const renderable, on_add<renderable>> renderables,
 						pack_direct_full_t<const renderable, on_remove<renderable>> broken_renderables) {
 	if(!renderables.size() && !broken_renderables.size())
 		return;
+	// the changes are applied to the drawgroup the pass refers to, the pass only resolves and records the render
+	// indices of the drawcalls that changed again (see core::gfx::drawcall::version())
 	m_Pass->dirty(true);
-	m_Pass->clear();
 
 	// for each RenderRange, create a drawgroup. assign all bundles to that group
 	for(auto renderRange : m_RenderRanges) {
@@ -43,7 +49,6 @@ void render::tick_draws(info_t& info,
 			}
 		}
 	}
-	m_Pass->add(m_DrawGroup);
 }
 
 void render::add_render_range(uint32_t begin, uint32_t end) {
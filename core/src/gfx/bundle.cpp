@@ -23,7 +23,7 @@ bundle::bundle(core::resource::cache_t& cache,
 
 std::optional<core::resource::handle<core::gfx::material_t>> bundle::get(uint32_t renderlayer) const noexcept {
 	if(auto it = std::find(std::begin(m_Layers), std::end(m_Layers), renderlayer); it != std::end(m_Layers)) {
-		auto index = std::distance(std::begin(m_Layers), std::prev(it));
+		auto index = std::distance(std::begin(m_Layers), it);
 		return m_Materials[index];
 	}
 	return std::nullopt;
@@ -117,6 +117,24 @@ bool bundle::set(tag<core::gfx::geometry_t> geometry,
 	  (void*)data, size * count, segment, memory::range_t {size_of_element * id, size_of_element * (id + count)}}});
 }
 
+bool bundle::set(tag<core::gfx::geometry_t> geometry,
+				 memory::segment segment,
+				 uint32_t size_of_element,
+				 const psl::array<std::pair<uint32_t, uint32_t>>& ranges,
+				 const void* data,
+				 size_t size) {
+	psl::array<core::gfx::commit_instruction> instructions;
+	instructions.reserve(ranges.size());
+	auto source = (std::uintptr_t)data;
+	for(auto [first, last] : ranges) {
+		auto count = last - first;
+		instructions.emplace_back(core::gfx::commit_instruction {
+		  (void*)source, size * count, segment, memory::range_t {size_of_element * first, size_of_element * last}});
+		source += size * count;
+	}
+	return m_InstanceData.vertex_buffer()->commit(instructions);
+}
+
 
 bool bundle::set(tag<core::gfx::material_t> material, const void* data, size_t size, size_t offset) {
 	return m_InstanceData.set(material, data, size, offset);
@@ -68,3 +68,15 @@ void context::wait_idle() {
 
 #endif
 }
+
+void context::end_frame() {
+#ifdef PE_VULKAN
+	if(m_VKHandle) {
+		m_VKHandle->end_frame();
+		return;
+	}
+#endif
+#ifdef PE_GLES
+	// the GLES drawpass paces its frames itself, see core::igles::frame_pacer
+#endif
+}
@@ -70,9 +70,10 @@ void data::add(core::resource::handle<material_t> material) {
 			  std::end(meta->inputs()),
 			  [location = attribute.location()](const auto& attribute) { return attribute.location() == location; });
 
-			data.emplace_back(
-			  binding {binding::header {psl::string {attribute.tag()}, static_cast<uint32_t>(shader_attribute->size())},
-					   attribute.location()});
+			data.emplace_back(binding {binding::header {psl::string {attribute.tag()},
+														static_cast<uint32_t>(shader_attribute->size()),
+														binding_id {attribute.tag()}},
+									   attribute.location()});
 		}
 	}
 
@@ -83,10 +84,11 @@ void data::add(core::resource::handle<material_t> material) {
 	if(accum > 0) {
 		m_MaterialDataSizes.emplace_back(accum);
 	}
-	for(const auto& d : data) {
+	for(auto& d : data) {
 		auto it = std::find_if(std::begin(m_UniqueBindings), std::end(m_UniqueBindings), [&d](const auto& pair) {
 			return pair.first == d.description;
 		});
+		d.index = static_cast<uint32_t>(std::distance(std::begin(m_UniqueBindings), it));
 		if(it == std::end(m_UniqueBindings)) {
 			m_UniqueBindings.emplace_back(std::pair<binding::header, uint32_t> {d.description, 0});
 
@@ -169,44 +171,34 @@ psl::array<std::pair<size_t, std::uintptr_t>> data::bindings(tag<material_t> mat
 	psl::array<std::pair<size_t, std::uintptr_t>> result {};
 	if(auto matIt = m_Bindings.find(material); matIt != std::end(m_Bindings)) {
 		if(auto geomIt = m_InstanceData.find(geometry); geomIt != std::end(m_InstanceData)) {
-			size_t count = {0};
-			for(const auto& binding : matIt->second) {
-				auto it = std::find_if(
-				  std::begin(geomIt->second.description),
-				  std::end(geomIt->second.description),
-				  [&bDescr = binding.description](const binding::header& descr) { return descr == bDescr; });
-
-				auto index	  = std::distance(std::begin(geomIt->second.description), it);
-				auto& segment = *std::next(std::begin(geomIt->second.data), index);
-
-				result.emplace_back(binding.slot, segment.range().begin);
-			}
+			// the bindings of the material were resolved to their index in the object's data when it was added
+			result.reserve(matIt->second.size());
+			for(const auto& binding : matIt->second)
+				result.emplace_back(binding.slot, geomIt->second.data[binding.index].range().begin);
 		}
 	}
 	return result;
 }
 
-
-bool data::has_element(tag<geometry_t> geometry, psl::string_view name) const noexcept {
-	if(auto it = m_InstanceData.find(geometry); it != std::end(m_InstanceData)) {
-		return std::find_if(std::begin(it->second.description),
-							std::end(it->second.description),
-							[&name](const auto& descr) { return descr.name == name; }) !=
-			   std::end(it->second.description);
+psl::array<uint32_t> data::strides(tag<material_t> material) const noexcept {
+	psl::array<uint32_t> result {};
+	if(auto matIt = m_Bindings.find(material); matIt != std::end(m_Bindings)) {
+		for(const auto& binding : matIt->second) result.emplace_back(binding.description.size_of_element);
 	}
+	return result;
+}
+
+bool data::has_element(tag<geometry_t> geometry, binding_id id) const noexcept {
+	if(auto it = m_InstanceData.find(geometry); it != std::end(m_InstanceData))
+		return it->second.find(id).has_value();
 	return false;
 }
 
 std::optional<std::pair<memory::segment, uint32_t>> data::segment(tag<geometry_t> geometry,
-																  psl::string_view name) const noexcept {
+																  binding_id id) const noexcept {
 	if(auto it = m_InstanceData.find(geometry); it != std::end(m_InstanceData)) {
-		auto descrIt = std::find_if(std::begin(it->second.description),
-									std::end(it->second.description),
-									[&name](const auto& descr) { return descr.name == name; });
-		if(descrIt != std::end(it->second.description)) {
-			auto index = std::distance(std::begin(it->second.description), descrIt);
-
-			return std::pair {*std::next(std::begin(it->second.data), index), descrIt->size_of_element};
+		if(auto index = it->second.find(id); index) {
+			return std::pair {it->second.data[index.value()], it->second.description[index.value()].size_of_element};
 		}
 	}
 	return std::nullopt;
@@ -2,20 +2,28 @@
 #include "core/gfx/geometry.hpp"
 #include "core/resource/resource.hpp"
 #include <algorithm>
+#include <atomic>
 
 
 using namespace psl;
 using namespace core::gfx;
 using namespace core::ivk;
 using namespace core::resource;
+
+namespace {
+// versions are unique across all drawcalls, so a version identifies the state of a single drawcall
+std::atomic<uint64_t> next_version {1};
+}	 // namespace
+
 drawcall::drawcall(handle<core::gfx::bundle> bundle,
 				   const std::vector<handle<core::gfx::geometry_t>>& geometry) noexcept
-	: m_Bundle(bundle) {
+	: m_Bundle(bundle), m_Version(next_version++) {
 	for(auto& g : geometry) m_Geometry.emplace_back(g, 1);
 }
 
 
 bool drawcall::add(handle<core::gfx::geometry_t> geometry) noexcept {
+	m_Version = next_version++;
 	if(auto it = std::find_if(std::begin(m_Geometry),
 							  std::end(m_Geometry),
 							  [&geometry](const std::pair<handle<core::gfx::geometry_t>, size_t>& geomHandle) {
@@ -30,6 +38,7 @@ bool drawcall::add(handle<core::gfx::geometry_t> geometry) noexcept {
 	return false;
 }
 bool drawcall::remove(core::resource::handle<core::gfx::geometry_t> geometry) noexcept {
+	m_Version = next_version++;
 	if(auto it = std::find_if(std::begin(m_Geometry),
 							  std::end(m_Geometry),
 							  [&geometry](const std::pair<handle<core::gfx::geometry_t>, size_t>& geomHandle) {
@@ -45,6 +54,7 @@ bool drawcall::remove(core::resource::handle<core::gfx::geometry_t> geometry) no
 	return false;
 }
 bool drawcall::remove(const UID& geometry) noexcept {
+	m_Version = next_version++;
 	if(auto it = std::find_if(std::begin(m_Geometry),
 							  std::end(m_Geometry),
 							  [&geometry](const std::pair<handle<core::gfx::geometry_t>, size_t>& geomHandle) {
@@ -59,7 +69,8 @@ bool drawcall::remove(const UID& geometry) noexcept {
 	return false;
 }
 void drawcall::bundle(handle<core::gfx::bundle> bundle) noexcept {
-	m_Bundle = bundle;
+	m_Bundle  = bundle;
+	m_Version = next_version++;
 }
 core::resource::handle<core::gfx::bundle> drawcall::bundle() const noexcept {
 	return m_Bundle;
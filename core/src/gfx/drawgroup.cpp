@@ -1,10 +1,27 @@
 
 #include "core/gfx/drawgroup.hpp"
 #include "core/data/geometry.hpp"
+#include "core/gfx/bundle.hpp"
+#include "core/gfx/drawlist.hpp"
 #include "core/logging.hpp"
+#include "psl/utility/hash.hpp"
 
 using namespace core::gfx;
+using psl::utility::hash_combine;
 
+namespace {
+/// \brief appends the draws of the drawcall for the material at the render index, when the bundle has one.
+void append(drawlist& list, uint32_t layer, const drawcall& drawCall, uint32_t renderLayer) {
+	const auto& bundle = drawCall.bundle();
+	auto material	   = bundle->get(renderLayer);
+	if(!material)
+		return;
+	for(const auto& [geometry, count] : drawCall.geometry()) {
+		if(auto instances = bundle->instances(geometry); instances > 0)
+			list.add(drawlist::draw_t {bundle, material.value(), geometry, layer, renderLayer, instances});
+	}
+}
+}	 // namespace
 
 const drawlayer& drawgroup::layer(const psl::string& layer, uint32_t priority, uint32_t extent) noexcept {
 	auto it = std::find_if(
@@ -75,3 +92,58 @@ drawgroup::get(const drawlayer& layer, core::resource::handle<core::gfx::bundle>
 
 	return std::nullopt;
 }
+
+std::vector<std::reference_wrapper<const drawlayer>> drawgroup::layers() const {
+	std::vector<std::reference_wrapper<const drawlayer>> res {};
+	for(const auto& [drawLayer, drawCalls] : m_Group) res.emplace_back(drawLayer);
+	return res;
+}
+
+std::vector<drawgroup::segment_t> drawgroup::segments(const drawlayer& layer) const {
+	std::vector<segment_t> res {};
+	auto it = m_Group.find(layer);
+	if(it == std::end(m_Group))
+		return res;
+
+	for(const auto& drawCall : it->second) {
+		if(drawCall.m_Geometry.empty())
+			continue;
+		for(auto renderIndex : drawCall.m_Bundle->materialIndices(layer.begin(), layer.end())) {
+			auto segment = std::lower_bound(
+			  std::begin(res), std::end(res), renderIndex, [](const segment_t& segment, uint32_t renderIndex) {
+				  return segment.renderIndex < renderIndex;
+			  });
+			if(segment == std::end(res) || segment->renderIndex != renderIndex)
+				segment = res.insert(segment, segment_t {renderIndex, renderIndex});
+			hash_combine(segment->version, drawCall.version());
+			// instances are added and released without touching the drawcall, but they change the draws all the same
+			for(const auto& [geometry, count] : drawCall.m_Geometry)
+				hash_combine(segment->version, drawCall.m_Bundle->instances(geometry));
+		}
+	}
+	return res;
+}
+
+void drawgroup::build(drawlist& list) const {
+	for(const auto& [drawLayer, drawCalls] : m_Group) {
+		const auto layer = list.add_layer(drawLayer);
+		for(const auto& drawCall : drawCalls) {
+			if(drawCall.m_Geometry.empty())
+				continue;
+			for(auto renderLayer : drawCall.m_Bundle->materialIndices(drawLayer.begin(), drawLayer.end()))
+				append(list, layer, drawCall, renderLayer);
+		}
+	}
+}
+
+void drawgroup::build(drawlist& list, const drawlayer& layer, uint32_t renderIndex) const {
+	auto it = m_Group.find(layer);
+	if(it == std::end(m_Group))
+		return;
+
+	const auto index = list.add_layer(drawlayer {layer.name, renderIndex, 1});
+	for(const auto& drawCall : it->second) {
+		if(!drawCall.m_Geometry.empty())
+			append(list, index, drawCall, renderIndex);
+	}
+}
@@ -0,0 +1,43 @@
+#include "core/gfx/drawlist.hpp"
+#include "core/gfx/bundle.hpp"
+#include "core/gfx/geometry.hpp"
+#include "core/gfx/material.hpp"
+#include "psl/algorithm.hpp"
+#include "psl/assertions.hpp"
+
+using namespace core::gfx;
+
+void drawlist::clear() noexcept {
+	m_Layers.clear();
+	m_Draws.clear();
+	m_Keys.clear();
+	m_Order.clear();
+	m_Ids.clear();
+}
+
+uint32_t drawlist::add_layer(const drawlayer& layer) {
+	psl_assert(m_Layers.size() < max_layers, "the drawlist can hold up to {} layers", max_layers);
+	m_Layers.emplace_back(layer);
+	return static_cast<uint32_t>(m_Layers.size() - 1);
+}
+
+uint32_t drawlist::id(const psl::UID& uid) {
+	return m_Ids.try_emplace(uid, static_cast<uint32_t>(m_Ids.size())).first->second;
+}
+
+void drawlist::add(const draw_t& draw) {
+	const auto order = draw.renderLayer - m_Layers[draw.layer].begin();
+	add(key(draw.layer, order, id(draw.material.uid()), id(draw.geometry.uid())), draw);
+}
+
+void drawlist::add(uint64_t key, const draw_t& draw) {
+	m_Order.emplace_back(static_cast<uint32_t>(m_Draws.size()));
+	m_Keys.emplace_back(key);
+	m_Draws.emplace_back(draw);
+}
+
+void drawlist::sort() {
+	m_KeysScratch.resize(m_Keys.size());
+	m_OrderScratch.resize(m_Order.size());
+	psl::sorting::radix(m_Keys.data(), m_Order.data(), m_Keys.size(), m_KeysScratch.data(), m_OrderScratch.data());
+}
@@ -103,7 +103,7 @@ bool drawpass::build(bool force) {
 #endif
 #ifdef PE_VULKAN
 	if(m_VKHandle)
-		return m_VKHandle->build();
+		return m_VKHandle->build(force);
 #endif
 	return false;
 }
@@ -172,3 +172,14 @@ void drawpass::add(core::gfx::drawgroup& group) noexcept {
 		m_VKHandle->add(group);
 #endif
 }
+
+void drawpass::remove(const core::gfx::drawgroup& group) noexcept {
+#ifdef PE_GLES
+	if(m_GLESHandle)
+		m_GLESHandle->remove(group);
+#endif
+#ifdef PE_VULKAN
+	if(m_VKHandle)
+		m_VKHandle->remove(group);
+#endif
+}
@@ -1,6 +1,8 @@
 #include "core/gfx/geometry.hpp"
+#include "core/data/geometry.hpp"
 #include "core/gfx/buffer.hpp"
 #include "core/gfx/context.hpp"
+#include <algorithm>
 
 #ifdef PE_GLES
 	#include "core/gles/geometry.hpp"
@@ -13,9 +15,34 @@ using namespace core;
 using namespace core::gfx;
 using namespace core::resource;
 
+namespace {
+psl::aabb compute_bounds(const core::data::geometry_t& data) noexcept {
+	if(!data.contains(core::data::geometry_t::constants::POSITION))
+		return psl::aabb {psl::vec3::zero, psl::vec3::infinity};
+
+	const auto& stream = data.vertices(core::data::geometry_t::constants::POSITION);
+	if(!stream.is<psl::vec3>() || stream.size() == 0)
+		return psl::aabb {psl::vec3::zero, psl::vec3::infinity};
+
+	const auto& positions = stream.get<core::vertex_stream_t::type::vec3>();
+	psl::vec3 min {positions[0]};
+	psl::vec3 max {positions[0]};
+	for(const auto& position : positions) {
+		for(size_t axis = 0; axis < 3; ++axis) {
+			min[axis] = std::min(min[axis], position[axis]);
+			max[axis] = std::max(max[axis], position[axis]);
+		}
+	}
+	return psl::aabb {(min + max) * 0.5f, (max - min) * 0.5f};
+}
+}	 // namespace
+
 #ifdef PE_VULKAN
 geometry_t::geometry_t(core::resource::handle<core::ivk::geometry_t>& handle)
-	: m_Backend(graphics_backend::vulkan), m_VKHandle(handle) {}
+	: m_Backend(graphics_backend::vulkan), m_VKHandle(handle) {
+	if(auto data = m_VKHandle->data(); data)
+		m_Bounds = compute_bounds(data.value());
+}
 #endif
 #ifdef PE_GLES
 geometry_t::geometry_t(core::resource::handle<core::igles::geometry_t>& handle)
@@ -29,7 +56,7 @@ geometry_t::geometry_t(core::resource::cache_t& cache,
 					   core::resource::handle<core::data::geometry_t> data,
 					   core::resource::handle<buffer_t> geometryBuffer,
 					   core::resource::handle<buffer_t> indicesBuffer)
-	: m_Backend(context->backend()) {
+	: m_Backend(context->backend()), m_Bounds(compute_bounds(data.value())) {
 	switch(m_Backend) {
 #ifdef PE_GLES
 	case graphics_backend::gles:
@@ -54,6 +81,7 @@ geometry_t::geometry_t(core::resource::cache_t& cache,
 geometry_t::~geometry_t() {}
 
 void geometry_t::recreate(core::resource::handle<core::data::geometry_t> data) {
+	m_Bounds = compute_bounds(data.value());
 #ifdef PE_GLES
 	if(m_GLESHandle) {
 		m_GLESHandle->recreate(data);
@@ -70,6 +98,7 @@ void geometry_t::recreate(core::resource::handle<core::data::geometry_t> data) {
 void geometry_t::recreate(core::resource::handle<core::data::geometry_t> data,
 						  core::resource::handle<core::gfx::buffer_t> geometryBuffer,
 						  core::resource::handle<core::gfx::buffer_t> indicesBuffer) {
+	m_Bounds = compute_bounds(data.value());
 #ifdef PE_GLES
 	if(m_GLESHandle && geometryBuffer->resource<graphics_backend::gles>() &&
 	   indicesBuffer->resource<graphics_backend::gles>()) {
@@ -1,11 +1,15 @@
 #include "core/gfx/pipeline_cache.hpp"
 #include "core/gfx/context.hpp"
+#include "core/gfx/framebuffer.hpp"
+#include "core/gfx/material.hpp"
+#include "core/gfx/swapchain.hpp"
 #include "core/gfx/types.hpp"
 
 #ifdef PE_GLES
 	#include "core/gles/program_cache.hpp"
 #endif
 #ifdef PE_VULKAN
+	#include "core/vk/material.hpp"
 	#include "core/vk/pipeline_cache.hpp"
 #endif
 
@@ -41,3 +45,28 @@ pipeline_cache::pipeline_cache(core::resource::cache_t& cache,
 #endif
 	}
 }
+
+#ifdef PE_VULKAN
+namespace {
+psl::array<handle<core::data::material_t>> material_data(psl::array_view<handle<material_t>> materials) {
+	psl::array<handle<core::data::material_t>> res {};
+	res.reserve(materials.size());
+	for(const auto& material : materials) res.emplace_back(material->resource<graphics_backend::vulkan>()->data());
+	return res;
+}
+}	 // namespace
+#endif
+
+void pipeline_cache::prewarm(psl::array_view<handle<material_t>> materials, handle<framebuffer_t> framebuffer) {
+#ifdef PE_VULKAN
+	if(m_Backend == graphics_backend::vulkan)
+		m_VKHandle->prewarm(material_data(materials), framebuffer->resource<graphics_backend::vulkan>());
+#endif
+}
+
+void pipeline_cache::prewarm(psl::array_view<handle<material_t>> materials, handle<swapchain> swapchain) {
+#ifdef PE_VULKAN
+	if(m_Backend == graphics_backend::vulkan)
+		m_VKHandle->prewarm(material_data(materials), swapchain->resource<graphics_backend::vulkan>());
+#endif
+}
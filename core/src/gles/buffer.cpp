@@ -2,6 +2,9 @@
 #include "core/data/buffer.hpp"
 #include "core/gles/conversion.hpp"
 #include "core/logging.hpp"
+#include <algorithm>
+#include <cstring>
+#include <limits>
 
 using namespace core::igles;
 using namespace core::gfx;
@@ -10,11 +13,39 @@ using namespace core;
 
 #define USE_BUFFER_SUBDATA
 
+// the staging ring of a streaming buffer never grows beyond this many times the size of the buffer, at which point
+// it will wait on the fences instead.
+static constexpr size_t max_stream_frames {3};
+
+namespace {
+/// \brief a write of the source into the destination offset of the buffer.
+struct write_t {
+	std::uintptr_t source;
+	size_t offset;
+	size_t size;
+};
+
+/// \brief sorts the writes on their destination so that adjacent writes can be merged into a single range.
+/// \note when writes overlap their order is significant, and so they are kept in the order they were given.
+void order(std::vector<write_t>& writes) {
+	std::vector<write_t> sorted {writes};
+	std::stable_sort(std::begin(sorted), std::end(sorted), [](const auto& lhs, const auto& rhs) {
+		return lhs.offset < rhs.offset;
+	});
+	for(size_t i = 1; i < sorted.size(); ++i) {
+		if(sorted[i - 1].offset + sorted[i - 1].size > sorted[i].offset)
+			return;
+	}
+	writes = std::move(sorted);
+}
+}	 // namespace
+
 buffer_t::buffer_t(core::resource::cache_t& cache,
 				   const core::resource::metadata& metaData,
 				   psl::meta::file* metaFile,
 				   core::resource::handle<core::data::buffer_t> buffer_data)
-	: m_BufferDataHandle(buffer_data), m_UID(metaData.uid) {
+	: m_BufferDataHandle(buffer_data), m_UID(metaData.uid),
+	  m_Streaming(buffer_data->write_frequency() == memory_write_frequency::per_frame) {
 	m_BufferType = to_gles(buffer_data->usage());
 
 
@@ -48,6 +79,9 @@ buffer_t::buffer_t(core::resource::cache_t& cache,
 }
 
 buffer_t::~buffer_t() {
+	for(const auto& fence : m_StreamFences) glDeleteSync(fence.sync);
+	if(m_Stream)
+		glDeleteBuffers(1, &m_Stream);
 	glDeleteBuffers(1, &m_Buffer);
 }
 
@@ -176,24 +210,126 @@ bool buffer_t::copy_from(const buffer_t& other, const psl::array<core::gfx::memo
 
 
 bool buffer_t::commit(const psl::array<core::gfx::commit_instruction>& instructions) {
-	glBindBuffer(GL_COPY_WRITE_BUFFER, m_Buffer);
+	PROFILE_SCOPE(core::profiler)
+	if(instructions.empty())
+		return true;
+
+	std::vector<write_t> writes;
+	writes.reserve(instructions.size());
+	size_t total {0};
 	for(const auto& instruction : instructions) {
 		std::uintptr_t offset = instruction.segment.range().begin -
 								(std::uintptr_t)m_BufferDataHandle->region().data() +
 								instruction.sub_range.value_or(memory::range_t {}).begin;
+		writes.emplace_back(write_t {instruction.source, offset, instruction.size});
+		total += instruction.size;
+	}
+
+	if(!m_Streaming) {
+		glBindBuffer(GL_COPY_WRITE_BUFFER, m_Buffer);
+		for(const auto& write : writes) {
 #ifdef USE_BUFFER_SUBDATA
-		glBufferSubData(GL_COPY_WRITE_BUFFER, offset, instruction.size, (void*)((std::uintptr_t)instruction.source));
+			glBufferSubData(GL_COPY_WRITE_BUFFER, write.offset, write.size, (void*)write.source);
 #else
-		auto ptr = glMapBufferRange(GL_COPY_WRITE_BUFFER, offset, instruction.size, GL_MAP_WRITE_BIT);
-		memcpy(ptr, (void*)(instruction.source), instruction.size);
-		glUnmapBuffer(GL_COPY_WRITE_BUFFER);
-
+			auto ptr = glMapBufferRange(GL_COPY_WRITE_BUFFER, write.offset, write.size, GL_MAP_WRITE_BIT);
+			memcpy(ptr, (void*)write.source, write.size);
+			glUnmapBuffer(GL_COPY_WRITE_BUFFER);
 #endif
+		}
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+		return true;
+	}
+
+	// the writes are packed back to back in the staging ring, so writes that are contiguous in the buffer are
+	// contiguous in the ring as well, and can be copied as one range.
+	order(writes);
+	auto staged = stream_allocate(total);
+
+	glBindBuffer(GL_COPY_READ_BUFFER, m_Stream);
+	// the fences guarantee the GPU no longer reads this range, so the driver does not need to synchronize.
+	auto ptr = (std::byte*)glMapBufferRange(GL_COPY_READ_BUFFER,
+											staged,
+											total,
+											GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+	if(!ptr) {
+		core::igles::log->error("could not map the staging ring of buffer {}", utility::to_string(m_UID));
+		glBindBuffer(GL_COPY_READ_BUFFER, 0);
+		return false;
+	}
+	for(const auto& write : writes) {
+		memcpy(ptr, (void*)write.source, write.size);
+		ptr += write.size;
+	}
+	glUnmapBuffer(GL_COPY_READ_BUFFER);
+
+	glBindBuffer(GL_COPY_WRITE_BUFFER, m_Buffer);
+	size_t source {staged};
+	for(size_t i = 0; i < writes.size();) {
+		auto offset = writes[i].offset;
+		auto size	= writes[i].size;
+		for(++i; i < writes.size() && writes[i].offset == offset + size; ++i) size += writes[i].size;
+
+		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, source, offset, size);
+		source += size;
 	}
 	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+	glBindBuffer(GL_COPY_READ_BUFFER, 0);
+
+	m_StreamFences.emplace_back(fence_t {glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), m_StreamHead});
 	return true;
 }
 
+size_t buffer_t::stream_allocate(size_t size) {
+	if(size > m_StreamCapacity)
+		stream_grow(size);
+
+	while(true) {
+		// allocations never wrap around the end of the ring
+		auto offset = m_StreamHead % m_StreamCapacity;
+		auto head	= (offset + size > m_StreamCapacity) ? m_StreamHead + (m_StreamCapacity - offset) : m_StreamHead;
+		if(head + size - m_StreamTail <= m_StreamCapacity) {
+			m_StreamHead = head + size;
+			return head % m_StreamCapacity;
+		}
+
+		if(m_StreamFences.empty()) {
+			// everything staged has been consumed, so the ring can start over
+			m_StreamHead = m_StreamTail = 0;
+			continue;
+		}
+
+		auto& fence = m_StreamFences.front();
+		if(glClientWaitSync(fence.sync, 0, 0) == GL_TIMEOUT_EXPIRED) {
+			// rather than stalling on the GPU, the ring grows until it can hold the writes of the frames in flight
+			if(m_StreamCapacity < m_BufferDataHandle->size() * max_stream_frames) {
+				stream_grow(size);
+				continue;
+			}
+			glClientWaitSync(fence.sync, GL_SYNC_FLUSH_COMMANDS_BIT, std::numeric_limits<GLuint64>::max());
+		}
+		m_StreamTail = fence.end;
+		glDeleteSync(fence.sync);
+		m_StreamFences.pop_front();
+	}
+}
+
+void buffer_t::stream_grow(size_t size) {
+	// the old ring can be deleted right away, the driver keeps it alive until the GPU is done with it.
+	for(const auto& fence : m_StreamFences) glDeleteSync(fence.sync);
+	m_StreamFences.clear();
+	if(m_Stream)
+		glDeleteBuffers(1, &m_Stream);
+
+	m_StreamCapacity = std::max(m_StreamCapacity * 2, size * max_stream_frames);
+	m_StreamHead	 = 0;
+	m_StreamTail	 = 0;
+
+	glGenBuffers(1, &m_Stream);
+	glBindBuffer(GL_COPY_READ_BUFFER, m_Stream);
+	glBufferData(GL_COPY_READ_BUFFER, m_StreamCapacity, nullptr, GL_STREAM_DRAW);
+	glBindBuffer(GL_COPY_READ_BUFFER, 0);
+}
+
 size_t buffer_t::free_size() const noexcept {
 	auto available = m_BufferDataHandle->region().allocator()->available();
 	return std::accumulate(std::next(std::begin(available)),
@@ -21,9 +21,14 @@
 using namespace core::igles;
 using namespace core::resource;
 
-drawpass::drawpass(handle<swapchain> swapchain) : m_Swapchain(swapchain) {}
+drawpass::drawpass(handle<swapchain> swapchain, uint32_t framesInFlight)
+	: m_Swapchain(swapchain), m_Pacer(framesInFlight) {}
 drawpass::drawpass(handle<framebuffer_t> framebuffer) : m_Framebuffer(framebuffer) {}
 
+drawpass::~drawpass() {
+	m_Pacer.wait_idle();
+}
+
 
 void drawpass::clear() {
 	m_DrawGroups.clear();
@@ -103,6 +108,10 @@ void drawpass::prepare() {
 		m_Swapchain->clear();
 }
 bool drawpass::build() {
+	PROFILE_SCOPE(core::profiler);
+	m_DrawList.clear();
+	for(const auto& group : m_DrawGroups) group->build(m_DrawList);
+	m_DrawList.sort();
 	return true;
 }
 void drawpass::present() {
@@ -115,75 +124,40 @@ void drawpass::present() {
 		glMemoryBarrier(barrier.barrier);
 	}
 
-	for(const auto& group : m_DrawGroups) {
-		for(auto& drawLayer : group.m_Group) {
-			// todo: draw call sorting should be done ahead of time in the "build" pass.
-			psl::array<uint32_t> render_indices;
-			for(auto& drawCall : drawLayer.second) {
-				auto matIndices = drawCall.m_Bundle->materialIndices(drawLayer.first.begin(), drawLayer.first.end());
-				render_indices.insert(std::end(render_indices), std::begin(matIndices), std::end(matIndices));
-			}
-			std::sort(std::begin(render_indices), std::end(render_indices));
-			render_indices.erase(std::unique(std::begin(render_indices), std::end(render_indices)),
-								 std::end(render_indices));
-			for(auto renderLayer : render_indices) {
-				for(auto& drawCall : drawLayer.second) {
-					if(drawCall.m_Geometry.size() == 0 || !drawCall.m_Bundle->has(renderLayer))
-						continue;
-					auto bundle = drawCall.m_Bundle;
-
-					if(!bundle->bind_material(renderLayer))
-						continue;
-					auto gfxmat {bundle->bound()};
-					auto mat {gfxmat->resource<gfx::graphics_backend::gles>()};
-
-					mat->bind();
-					for(auto& [gfxGeometryHandle, count] : drawCall.m_Geometry) {
-						auto geometryHandle = gfxGeometryHandle->resource<gfx::graphics_backend::gles>();
-						uint32_t instance_n = bundle->instances(gfxGeometryHandle);
-						if(instance_n == 0 || !geometryHandle->compatible(mat.value()))
-							continue;
-						core::profiler.scope_begin("create_vao");
-						geometryHandle->create_vao(
-						  mat,
-						  bundle->m_InstanceData.vertex_buffer()->resource<gfx::graphics_backend::gles>(),
-						  bundle->m_InstanceData.bindings(gfxmat, gfxGeometryHandle));
-						core::profiler.scope_end();
-						// for(const auto& b : bundle->m_InstanceData.bindings(gfxmat, gfxGeometryHandle))
-						//{
-						//	auto buffer =
-						// bundle->m_InstanceData.buffer()->resource().get<core::igles::buffer_t>()->id();
-						//	glBindBuffer(GL_ARRAY_BUFFER, buffer);
-						//	glEnableVertexAttribArray(b.first);
-						//	glEnableVertexAttribArray(b.first + 1);
-						//	glEnableVertexAttribArray(b.first + 2);
-						//	glEnableVertexAttribArray(b.first + 3);
-						//	for(int i = 0; i < 4; ++i)
-						//	{
-						//		glGetError();
-						//		auto offset = b.second + (i * sizeof(float) * 4);
-						//		//glVertexAttribPointer(b.first + i, 4, GL_FLOAT, GL_FALSE, 16 * sizeof(float),
-						//		//					  (void*)(offset));
-
-						//		glVertexAttribPointer(b.first, 4, GL_FLOAT, GL_FALSE, sizeof(GLfloat) * 4 * 4,
-						//							  (void*)(0));
-						//		glGetError();
-						//		glVertexAttribDivisor(b.first + i, 1);
-						//		glGetError();
-						//	}
-						//	glBindBuffer(GL_ARRAY_BUFFER, 0);
-						//}
-
-						geometryHandle->bind(mat, instance_n);
-
-						/*for(const auto& b : bundle->m_InstanceData.bindings(gfxmat, gfxGeometryHandle))
-						{
-							glDisableVertexAttribArray(b.first);
-						}*/
-					}
-				}
-			}
+	// the draws are ordered on their drawlayer, render index and material, the material state only has to be bound
+	// again when the material, or the bundle (and so the offsets of its instance data) changes.
+	handle<core::gfx::bundle> bundle {};
+	handle<core::gfx::material_t> gfxmat {};
+	uint32_t renderLayer {0};
+	bool bound {false};
+	for(size_t i = 0; i < m_DrawList.size(); ++i) {
+		const auto& entry = m_DrawList[i];
+		if(entry.bundle != bundle || entry.renderLayer != renderLayer || entry.material != gfxmat) {
+			bundle		= entry.bundle;
+			renderLayer = entry.renderLayer;
+			gfxmat		= entry.material;
+			bound		= bundle->bind_material(renderLayer);
+			if(bound)
+				gfxmat->resource<gfx::graphics_backend::gles>()->bind();
 		}
+		if(!bound)
+			continue;
+
+		// instances are added and released without dirtying the pass, so the count of the list can be outdated
+		auto instances = bundle->instances(entry.geometry);
+		if(instances == 0)
+			continue;
+
+		auto mat			= gfxmat->resource<gfx::graphics_backend::gles>();
+		auto geometryHandle = entry.geometry->resource<gfx::graphics_backend::gles>();
+		if(!geometryHandle->compatible(mat.value()))
+			continue;
+		core::profiler.scope_begin("create_vao");
+		geometryHandle->create_vao(mat,
+								   bundle->m_InstanceData.vertex_buffer()->resource<gfx::graphics_backend::gles>(),
+								   bundle->m_InstanceData.bindings(gfxmat, entry.geometry));
+		core::profiler.scope_end();
+		geometryHandle->bind(mat, instances);
 	}
 	glEnable(GL_DEPTH_TEST);
 	glCullFace(GL_FRONT);
@@ -203,13 +177,17 @@ void drawpass::present() {
 
 	if(m_Swapchain) {
 		m_Swapchain->present();
-		glFinish();
+		m_Pacer.end_frame();
 	}
 	glGetError();
 }
 
 void drawpass::add(core::gfx::drawgroup& group) noexcept {
-	m_DrawGroups.push_back(group);
+	if(std::find(std::begin(m_DrawGroups), std::end(m_DrawGroups), &group) == std::end(m_DrawGroups))
+		m_DrawGroups.emplace_back(&group);
+}
+void drawpass::remove(const core::gfx::drawgroup& group) noexcept {
+	m_DrawGroups.erase(std::remove(std::begin(m_DrawGroups), std::end(m_DrawGroups), &group), std::end(m_DrawGroups));
 }
 
 void drawpass::connect(psl::view_ptr<drawpass> pass) noexcept {};
@@ -0,0 +1,40 @@
+#include "core/gles/frame_pacer.hpp"
+#include "core/gles/igles.hpp"
+#include "core/logging.hpp"
+#include <algorithm>
+#include <limits>
+
+using namespace core::igles;
+
+frame_pacer::frame_pacer(uint32_t framesInFlight) noexcept : m_FramesInFlight(std::max(framesInFlight, 1u)) {}
+
+frame_pacer::~frame_pacer() {
+	for(auto fence : m_Fences) glDeleteSync(fence);
+}
+
+void frame_pacer::end_frame() {
+	PROFILE_SCOPE(core::profiler)
+	m_Fences.emplace_back(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+	// make sure the GPU starts on the frame, as we might not wait on this fence for several frames.
+	glFlush();
+	++m_Frame;
+	wait(m_FramesInFlight - 1);
+}
+
+void frame_pacer::wait_idle() {
+	wait(0);
+}
+
+void frame_pacer::frames_in_flight(uint32_t value) noexcept {
+	m_FramesInFlight = std::max(value, 1u);
+}
+
+void frame_pacer::wait(size_t remaining) {
+	while(m_Fences.size() > remaining) {
+		auto fence = m_Fences.front();
+		if(glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, std::numeric_limits<GLuint64>::max()) == GL_WAIT_FAILED)
+			core::igles::log->error("failed to wait on the fence of a frame");
+		glDeleteSync(fence);
+		m_Fences.pop_front();
+	}
+}
@@ -14,10 +14,38 @@ program::program(core::resource::cache_t& cache,
 				 const core::resource::metadata& metaData,
 				 psl::meta::file* metaFile,
 				 core::resource::handle<core::data::material_t> data) {
+	link(cache, metaFile, data.value());
+}
+
+program::program(core::resource::cache_t& cache,
+				 const core::resource::metadata& metaData,
+				 psl::meta::file* metaFile,
+				 core::resource::handle<core::data::material_t> data,
+				 GLenum binaryFormat,
+				 psl::string8::view binary) {
+	m_Program = glCreateProgram();
+	glProgramBinary(m_Program, binaryFormat, binary.data(), static_cast<GLsizei>(binary.size()));
+
+	GLint linked {GL_FALSE};
+	glGetProgramiv(m_Program, GL_LINK_STATUS, &linked);
+	if(linked) {
+		m_FromBinary = true;
+		return;
+	}
+
+	// the binary format is no longer accepted (driver update, different GPU), rebuild from source
+	core::igles::log->info("program binary for {0} was rejected, recompiling from source", metaFile->ID().to_string());
+	glDeleteProgram(m_Program);
+	m_Program = 0;
+	glGetError();
+	link(cache, metaFile, data.value());
+}
+
+void program::link(core::resource::cache_t& cache, psl::meta::file* metaFile, const core::data::material_t& data) {
 	GLint linked;
 
 	std::vector<GLint> shaderStages;
-	for(const auto& stage : data->stages()) {
+	for(const auto& stage : data.stages()) {
 		auto shader_handle = cache.find<core::igles::shader>(stage.shader());
 		if(!shader_handle)
 			shader_handle = cache.create_using<core::igles::shader>(stage.shader());
@@ -34,6 +62,8 @@ program::program(core::resource::cache_t& cache,
 	for(auto shader : shaderStages) {
 		glAttachShader(m_Program, shader);
 	}
+	// we want to be able to retrieve the binary afterwards to store it in the program_cache
+	glProgramParameteri(m_Program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 	glLinkProgram(m_Program);
 	glGetProgramiv(m_Program, GL_LINK_STATUS, &linked);
 
@@ -43,7 +73,7 @@ program::program(core::resource::cache_t& cache,
 		glGetProgramiv(m_Program, GL_INFO_LOG_LENGTH, &infoLen);
 
 		psl::string shader_uids;
-		std::for_each(std::begin(data->stages()), std::end(data->stages()), [&shader_uids](const auto& stage) noexcept {
+		std::for_each(std::begin(data.stages()), std::end(data.stages()), [&shader_uids](const auto& stage) noexcept {
 			shader_uids += stage.shader().to_string();
 			shader_uids += ", ";
 		});
@@ -69,3 +99,23 @@ program::program(core::resource::cache_t& cache,
 program::~program() {
 	glDeleteProgram(m_Program);
 }
+
+std::optional<program::binary_t> program::binary() const {
+	if(m_Program == 0)
+		return std::nullopt;
+
+	GLint size {0};
+	glGetProgramiv(m_Program, GL_PROGRAM_BINARY_LENGTH, &size);
+	if(size <= 0)
+		return std::nullopt;
+
+	binary_t result {};
+	result.data.resize(static_cast<size_t>(size));
+	GLsizei written {0};
+	glGetProgramBinary(m_Program, size, &written, &result.format, result.data.data());
+	if(written <= 0 || glGetError() != GL_NO_ERROR)
+		return std::nullopt;
+
+	result.data.resize(static_cast<size_t>(written));
+	return result;
+}
@@ -1,21 +1,179 @@
 #include "core/gles/program_cache.hpp"
+#include "core/data/material.hpp"
+#include "core/gles/igles.hpp"
 #include "core/gles/program.hpp"
+#include "core/logging.hpp"
 #include "core/resource/resource.hpp"
+#include <cstring>
 
 using namespace core::igles;
 using namespace core::resource;
 
+namespace {
+struct cache_header_t {
+	uint32_t magic;
+	uint32_t version;
+	uint64_t driver;
+	uint64_t count;
+};
+
+struct entry_header_t {
+	uint64_t key;
+	uint32_t format;
+	uint32_t size;
+};
+
+constexpr uint32_t cache_magic {0x53454C47};	// "GLES"
+constexpr uint32_t cache_version {2};
+
+constexpr uint64_t fnv1a(const void* data, size_t size, uint64_t hash = 0xcbf29ce484222325) noexcept {
+	for(size_t i = 0; i < size; ++i) {
+		hash ^= static_cast<uint64_t>(static_cast<const unsigned char*>(data)[i]);
+		hash *= 0x100000001b3;
+	}
+	return hash;
+}
+
+uint64_t driver_hash() noexcept {
+	uint64_t hash {0xcbf29ce484222325};
+	for(auto name : {GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+		if(auto value = reinterpret_cast<const char*>(glGetString(name)); value)
+			hash = fnv1a(value, std::strlen(value) + 1, hash);
+	}
+	return hash;
+}
+}	 // namespace
+
 program_cache::program_cache(core::resource::cache_t& cache,
 							 const core::resource::metadata& metaData,
 							 psl::meta::file* metaFile)
-	: m_Cache(&cache) {}
+	: m_UID(metaData.uid), m_Cache(&cache) {
+	GLint formats {0};
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+	m_SupportsBinaries = formats > 0;
+	m_Driver		   = driver_hash();
 
+	auto& library = m_Cache->library();
+	if(!m_SupportsBinaries) {
+		core::igles::log->info("the driver does not support program binaries, they won't be persisted");
+		return;
+	}
+	if(!library.is_physical_file(m_UID)) {
+		core::igles::log->warn("the igles::program_cache [uid: '{}'] has no file in the library, its data won't be "
+							   "persisted",
+							   m_UID.to_string());
+		return;
+	}
+
+	auto content = library.load(m_UID);
+	if(!content || content.value().size() < sizeof(cache_header_t))
+		return;
+
+	auto view = content.value();
+	cache_header_t header {};
+	std::memcpy(&header, view.data(), sizeof(cache_header_t));
+	if(header.magic != cache_magic || header.version != cache_version || header.driver != m_Driver) {
+		core::igles::log->info("discarding the persisted program binaries, they were created by another driver");
+		library.unload(m_UID);
+		return;
+	}
+
+	size_t offset = sizeof(cache_header_t);
+	for(uint64_t i = 0; i < header.count; ++i) {
+		entry_header_t entry {};
+		if(view.size() - offset < sizeof(entry_header_t))
+			break;
+		std::memcpy(&entry, view.data() + offset, sizeof(entry_header_t));
+		offset += sizeof(entry_header_t);
+		if(view.size() - offset < entry.size)
+			break;
+
+		auto& binary  = m_Binaries[entry.key];
+		binary.format = entry.format;
+		binary.data.resize(entry.size);
+		std::memcpy(binary.data.data(), view.data() + offset, entry.size);
+		offset += entry.size;
+	}
+	library.unload(m_UID);
+}
+
+program_cache::~program_cache() {
+	save();
+}
+
+uint64_t program_cache::key(const core::data::material_t& data) {
+	uint64_t hash {m_Driver};
+	for(const auto& stage : data.stages()) {
+		auto stage_value = static_cast<uint64_t>(stage.shader_stage());
+		hash			 = fnv1a(&stage_value, sizeof(stage_value), hash);
+
+		// the source is only loaded and hashed the first time a shader is used
+		auto it = m_Sources.find(stage.shader());
+		if(it == std::end(m_Sources)) {
+			uint64_t source_hash {0};
+			if(auto source = m_Cache->library().load(stage.shader()); source)
+				source_hash = fnv1a(source.value().data(), source.value().size());
+			it = m_Sources.emplace(stage.shader(), source_hash).first;
+		}
+		hash = fnv1a(&it->second, sizeof(it->second), hash);
+	}
+	return hash;
+}
 
 core::resource::handle<core::igles::program> program_cache::get(const psl::UID& uid,
 																core::resource::handle<core::data::material_t> data) {
 	auto handle = m_Cache->find<program>(uid);
-	if(handle.state() != core::resource::status::loaded)
+	if(handle.state() == core::resource::status::loaded)
+		return handle;
+
+	if(!m_SupportsBinaries)
+		return m_Cache->create_using<program>(uid, data);
+
+	const auto program_key = key(data.value());
+	if(auto it = m_Binaries.find(program_key); it != std::end(m_Binaries)) {
+		const auto& binary = it->second;
+		auto view = psl::string8::view {reinterpret_cast<const psl::string8::char_t*>(binary.data.data()),
+										binary.data.size()};
+		handle	  = m_Cache->create_using<program>(uid, data, binary.format, view);
+		if(handle->from_binary())
+			return handle;
+	} else {
 		handle = m_Cache->create_using<program>(uid, data);
+	}
 
+	// the program was linked from source, store its binary for the next run
+	if(auto binary = handle->binary(); binary) {
+		m_Binaries[program_key] = std::move(binary.value());
+		m_Dirty					= true;
+	}
 	return handle;
 }
+
+bool program_cache::save() {
+	auto& library = m_Cache->library();
+	if(!m_Dirty || !library.is_physical_file(m_UID))
+		return false;
+
+	size_t size = sizeof(cache_header_t);
+	for(const auto& [key, binary] : m_Binaries) size += sizeof(entry_header_t) + binary.data.size();
+
+	psl::string8_t content(size, '\0');
+	cache_header_t header {cache_magic, cache_version, m_Driver, m_Binaries.size()};
+	std::memcpy(content.data(), &header, sizeof(cache_header_t));
+
+	size_t offset = sizeof(cache_header_t);
+	for(const auto& [key, binary] : m_Binaries) {
+		entry_header_t entry {key, binary.format, static_cast<uint32_t>(binary.data.size())};
+		std::memcpy(content.data() + offset, &entry, sizeof(entry_header_t));
+		offset += sizeof(entry_header_t);
+		std::memcpy(content.data() + offset, binary.data.data(), binary.data.size());
+		offset += binary.data.size();
+	}
+
+	if(!library.write(m_UID, content)) {
+		core::igles::log->error("could not persist the igles::program_cache");
+		return false;
+	}
+	m_Dirty = false;
+	return true;
+}
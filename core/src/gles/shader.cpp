@@ -33,8 +33,10 @@ shader::shader(core::resource::cache_t& cache, const core::resource::metadata& m
 	if(shader == 0)
 		throw std::runtime_error("could not load the given shader");
 
-	auto shaderData = result.value().data();
-	glShaderSource(shader, 1, &shaderData, NULL);
+	// the content can be a view into a mapped file, which isn't null terminated
+	auto shaderData	  = result.value().data();
+	auto shaderLength = static_cast<GLint>(result.value().size());
+	glShaderSource(shader, 1, &shaderData, &shaderLength);
 
 	glCompileShader(shader);
 
@@ -3,6 +3,9 @@
 #include "core/logging.hpp"
 #include "core/vk/context.hpp"
 #include "core/vk/conversion.hpp"
+#include "core/vk/staging_ring.hpp"
+#include <algorithm>
+#include <array>
 
 using namespace psl;
 using namespace core;
@@ -14,6 +17,11 @@ using namespace core::resource;
 // https://www.khronos.org/registry/vulkan/specs/1.1-extensions/man/html/vkCmdUpdateBuffer.html
 static const size_t max_size_set {65535};
 
+// 0 disables the tracing of copies, 1 traces every copy, 2 traces every region of every copy as well.
+#ifndef PE_TRACE_LEVEL
+	#define PE_TRACE_LEVEL 0
+#endif
+
 buffer_t::buffer_t(core::resource::cache_t& cache,
 				   const core::resource::metadata& metaData,
 				   psl::meta::file* metaFile,
@@ -59,6 +67,17 @@ buffer_t::buffer_t(core::resource::cache_t& cache,
 	bufCreateInfo.size	= m_BufferDataHandle->size();
 	bufCreateInfo.flags = vk::BufferCreateFlagBits();
 
+	// uploads and copies can be executed on a dedicated transfer queue (see core::ivk::staging_ring), sharing the
+	// buffer between both queue families avoids ownership transfers for every (partial) update. The ring orders the
+	// rewrites of the buffer after the frames that could still be reading it.
+	std::array<uint32_t, 2> queueFamilies {m_Context->graphics_queue_index(), m_Context->transfer_que_index()};
+	if(type & (vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eTransferSrc) &&
+	   queueFamilies[0] != queueFamilies[1]) {
+		bufCreateInfo.sharingMode			= vk::SharingMode::eConcurrent;
+		bufCreateInfo.queueFamilyIndexCount = static_cast<uint32_t>(queueFamilies.size());
+		bufCreateInfo.pQueueFamilyIndices	= queueFamilies.data();
+	}
+
 	utility::vulkan::check(m_Context->device().createBuffer(&bufCreateInfo, nullptr, &m_Buffer));
 
 	memReqs = m_Context->device().getBufferMemoryRequirements(m_Buffer), memAllocInfo.allocationSize = memReqs.size;
@@ -98,6 +117,10 @@ buffer_t::buffer_t(core::resource::cache_t& cache,
 buffer_t::~buffer_t() {
 	PROFILE_SCOPE(core::profiler)
 	core::ivk::log->info("destroying an ivk::buffer_t of {0} bytes size.", m_BufferDataHandle->size());
+	wait_until_ready();
+	// copies out of this buffer could still be in flight when it is used as a staging buffer
+	while(wait_staged()) {}
+	m_Context->staging().forget(m_Buffer);
 	m_Context->device().destroyBuffer(m_Buffer, nullptr);
 	m_Context->device().freeMemory(m_Memory, nullptr);
 	m_Context->device().destroyFence(m_BufferCompleted);
@@ -166,34 +189,47 @@ failure:
 
 bool buffer_t::commit(std::vector<core::gfx::commit_instruction> instructions) {
 	PROFILE_SCOPE(core::profiler)
-	vk::DeviceSize totalSize =
-	  std::accumulate(std::next(std::begin(instructions)),
-					  std::end(instructions),
-					  std::begin(instructions)->size,
-					  [](vk::DeviceSize sum, const commit_instruction& element) { return sum + element.size; });
-
 	if(m_BufferDataHandle->memoryPropertyFlags() & core::gfx::memory_property::device_local) {
+		if(!m_StagingBuffer) {
+			// the copies are batched in the context's staging ring, and submitted together with the next frame
+			auto& staging = m_Context->staging();
+			for(const auto& instruction : instructions) {
+				auto allocation = staging.write((const void*)instruction.source, instruction.size);
+				if(!allocation) {
+					core::ivk::log->error("could not stage {} bytes for an ivk::buffer_t.", instruction.size);
+					return false;
+				}
+
+				if(m_BufferDataHandle->region().allocator()->is_physically_backed()) {
+					memcpy((void*)(instruction.segment.range().begin +
+								   instruction.sub_range.value_or(memory::range_t {}).begin),
+						   (void*)(instruction.source),
+						   instruction.size);
+				}
+
+				staging.copy(allocation.value(),
+							 m_Buffer,
+							 instruction.segment.range().begin +
+							   instruction.sub_range.value_or(memory::range_t {}).begin -
+							   (std::uintptr_t)m_BufferDataHandle->region().data(),
+							 instruction.size);
+			}
+			m_Pending = staging.pending();
+			return true;
+		}
+
 		std::vector<vk::DeviceSize> sizeRequests;
 		sizeRequests.reserve(instructions.size());
 		for(const auto& instruction : instructions) sizeRequests.emplace_back(instruction.size);
 
 		auto stagingBuffer = m_StagingBuffer;
-		if(!stagingBuffer) {
-			core::ivk::log->warn("inefficient loading, dynamically creating a staging ivk::buffer_t.");
-			memory::region temp_region {totalSize, 4, new memory::default_allocator(false)};
-			auto buffer_data = m_Cache.create<core::data::buffer_t>(core::gfx::memory_usage::transfer_source,
-																	core::gfx::memory_property::host_visible |
-																	  core::gfx::memory_property::host_coherent,
-																	std::move(temp_region));
-
-			stagingBuffer = m_Cache.create<core::ivk::buffer_t>(m_Context, buffer_data);
-		}
-		if(!stagingBuffer) {
-			core::ivk::log->error("could not create an ivk::buffer_t for staging.");
-			return false;
-		}
 
+		stagingBuffer->release_staged();
 		auto stagingSegments = stagingBuffer->reserve(sizeRequests, true);
+		// the staging buffer could be full of segments that are still in flight, either of this buffer or of any other
+		// buffer that stages through it
+		while(stagingSegments.size() == 0 && stagingBuffer->wait_staged())
+			stagingSegments = stagingBuffer->reserve(sizeRequests, true);
 		if(stagingSegments.size() == 0) {
 			core::ivk::log->error("could not reserve the requested size in the staging buffer.");
 			return false;
@@ -226,10 +262,6 @@ bool buffer_t::commit(std::vector<core::gfx::commit_instruction> instructions) {
 				return false;
 			}
 
-			if(i == 4) {
-				core::log->info("first element: {}", *(float*)(instructions[i].source));
-			}
-
 			memcpy((void*)((std::uintptr_t)tuple.value + stagingSegments[i].second.begin),
 				   (void*)(instructions[i].source),
 				   instructions[i].size);
@@ -241,7 +273,6 @@ bool buffer_t::commit(std::vector<core::gfx::commit_instruction> instructions) {
 					   instructions[i].size);
 			}
 
-			// todo we can collapse these regions and so invoke less buffercopy commands
 			vk::BufferCopy& copyRegion = copyRegions.emplace_back();
 			copyRegion.srcOffset	   = offset + stagingSegments[i].second.begin;
 			copyRegion.dstOffset	   = instructions[i].segment.range().begin +
@@ -256,12 +287,16 @@ bool buffer_t::commit(std::vector<core::gfx::commit_instruction> instructions) {
 		if(stagingSegments.size() > 0 && stagingSegments[0].first.range().size() == 0)
 			debug_break();
 		m_Context->device().unmapMemory(stagingBuffer->m_Memory);
-		auto res = copy_from(stagingBuffer.value(), copyRegions);
+		auto completion = copy_from_async(stagingBuffer.value(), std::move(copyRegions));
 		for(auto segm : stagingSegments) {
-			if(segm.second.begin == 0)
+			if(segm.second.begin != 0)
+				continue;
+			if(completion)
+				stagingBuffer->m_Staged.emplace_back(completion.value(), segm.first);
+			else
 				stagingBuffer->deallocate(segm.first);
 		}
-		return res;
+		return completion.has_value();
 	} else {
 		// core::ivk::log->info("mapping {0} regions into an ivk::buffer_t from CPU.", instructions.size());
 		for(auto& instruction : instructions) {
@@ -302,23 +337,15 @@ bool buffer_t::map(const void* data, vk::DeviceSize size, vk::DeviceSize offset)
 			m_StagingBuffer->map(data, size, 0);
 			return copy_from(m_StagingBuffer.value(), {vk::BufferCopy {0u, offset, size}});
 		} else {
-			// make a local staging buffer, this is hardly efficient. todo find better way.
-			core::ivk::log->warn("inefficient loading, dynamically creating a staging ivk::buffer_t.");
-			memory::region temp_region {size * 2, 4, new memory::default_allocator(true)};
-			auto buffer_data = m_Cache.create<core::data::buffer_t>(core::gfx::memory_usage::transfer_source,
-																	core::gfx::memory_property::host_visible |
-																	  core::gfx::memory_property::host_coherent,
-																	std::move(temp_region));
-			auto staging	 = m_Cache.create<core::ivk::buffer_t>(m_Context, buffer_data);
-
-			auto tuple = m_Context->device().mapMemory(staging->m_Memory, 0, size);
-			if(!utility::vulkan::check(tuple.result)) {
-				debug_break();
+			auto& staging	= m_Context->staging();
+			auto allocation = staging.write(data, size);
+			if(!allocation) {
+				core::ivk::log->error("could not stage {} bytes for an ivk::buffer_t.", size);
+				return false;
 			}
-			memcpy(tuple.value, data, size);
-			m_Context->device().unmapMemory(staging->m_Memory);
-
-			return copy_from(staging.value(), {vk::BufferCopy {0u, offset, size}});
+			staging.copy(allocation.value(), m_Buffer, offset, size);
+			m_Pending = staging.pending();
+			return true;
 		}
 	} else {
 		// core::ivk::log->info("mapping ivk::buffer_t data from CPU.");
@@ -346,76 +373,18 @@ bool buffer_t::map(const void* data, vk::DeviceSize size, vk::DeviceSize offset)
 
 bool buffer_t::copy_from(const buffer_t& other, const std::vector<vk::BufferCopy>& copyRegions) {
 	PROFILE_SCOPE(core::profiler)
-	core::profiler.scope_begin("prepare", this);
-	vk::Queue queue = m_Context->queue();
-	wait_until_ready();
-
-	auto totalsize =
-	  std::accumulate(copyRegions.begin(), copyRegions.end(), 0, [&](int sum, const vk::BufferCopy& region) {
-		  return sum + (int)region.size;
-	  });
-
-	core::ivk::log->info("copying buffer {0} into {1} for a total size of {2} using {3} copy instructions",
-						 utility::to_string(other.m_UID),
-						 utility::to_string(m_UID),
-						 totalsize,
-						 copyRegions.size());
-
-	for(const auto& region : copyRegions) {
-		core::ivk::log->info(
-		  "srcOffset | dstOffset | size : {0} | {1} | {2}", region.srcOffset, region.dstOffset, region.size);
-	}
-
-	vk::CommandBufferBeginInfo cmdBufferBeginInfo;
-	cmdBufferBeginInfo.pNext = NULL;
-
-	// Put buffer region copies into command buffer
-	// Note that the staging buffer must not be deleted before the copies
-	// have been submitted and executed
-	utility::vulkan::check(m_CommandBuffer.begin(&cmdBufferBeginInfo));
-	m_CommandBuffer.copyBuffer(other.m_Buffer, m_Buffer, (uint32_t)copyRegions.size(), copyRegions.data());
-	m_CommandBuffer.end();
+	auto completion = copy_from_async(other, copyRegions);
+	if(!completion)
+		return false;
 
-	// Submit copies to the queue
-	vk::SubmitInfo copySubmitInfo;
-	copySubmitInfo.commandBufferCount = 1;
-	copySubmitInfo.pCommandBuffers	  = &m_CommandBuffer;
-	m_Context->device().resetFences(m_BufferCompleted);
-	core::profiler.scope_end(this);
-	utility::vulkan::check(queue.submit(1, &copySubmitInfo, m_BufferCompleted));
-	core::profiler.scope_begin("wait idle", this);
-	queue.waitIdle();
+	core::profiler.scope_begin("wait", this);
+	m_Context->staging().wait(completion.value());
 	core::profiler.scope_end(this);
 
 	if(m_BufferDataHandle->memoryPropertyFlags() & core::gfx::memory_property::host_visible) {
 		core::profiler.scope_begin("replicate to host", this);
-		// TODO this really needs to be per region..
-		// auto tuple = m_Context->Device().mapMemory(m_Memory, 0, m_Descriptor.range);
-		// utility::vulkan::check(tuple.result);
-		// memcpy(m_BufferData.Data(), tuple.value, m_Descriptor.range);
-		// m_Context->Device().unmapMemory(m_Memory);
-
-		core::ivk::log->info("mapping an ivk::buffer_t of size {0} to a pool of size {1}",
-							 utility::to_string(m_BufferDataHandle->size()),
-							 utility::to_string(m_BufferDataHandle->size()));
-
-		uint32_t minVal {std::numeric_limits<uint32_t>::max()}, maxVal {std::numeric_limits<uint32_t>::min()};
-		for(const auto& region : copyRegions) {
-			minVal = std::min((uint32_t)region.dstOffset, minVal);
-			maxVal = std::max((uint32_t)(region.dstOffset + region.size), maxVal);
-		}
-		core::ivk::log->info("copy range (start|finish): {0} | {1}", minVal, maxVal);
-
-		if(maxVal > m_BufferDataHandle->size()) {
-			core::ivk::log->error("range exceeds the allocated ivk::buffer_t size! (src|dst) {0} | {1}",
-								  m_BufferDataHandle->size(),
-								  maxVal);
-			debug_break();
-		}
-
 		for(const auto& region : copyRegions) {
 			auto tuple = m_Context->device().mapMemory(m_Memory, region.dstOffset, region.size);
-			core::ivk::log->info("(dstOffset|size) {0} | {1}", region.dstOffset, region.size);
 			if(utility::vulkan::check(tuple.result)) {
 				if(auto segment = m_BufferDataHandle->allocate(region.size); segment) {
 					memcpy((void*)(segment.value().range().begin), tuple.value, region.size);
@@ -427,10 +396,76 @@ bool buffer_t::copy_from(const buffer_t& other, const std::vector<vk::BufferCopy
 			m_Context->device().unmapMemory(m_Memory);
 		}
 		core::profiler.scope_end(this);
-		return true;
 	}
+	return true;
+}
 
-	// m_CommandBuffer.reset(vk::CommandBufferResetFlagBits::eReleaseResources);
+std::optional<uint64_t> buffer_t::copy_from_async(const buffer_t& other, std::vector<vk::BufferCopy> copyRegions) {
+	PROFILE_SCOPE(core::profiler)
+	copyRegions.erase(std::remove_if(std::begin(copyRegions),
+									 std::end(copyRegions),
+									 [](const vk::BufferCopy& region) { return region.size == 0; }),
+					  std::end(copyRegions));
+	if(copyRegions.empty())
+		return m_Pending;
+
+	for(const auto& region : copyRegions) {
+		if(region.srcOffset + region.size > other.m_BufferDataHandle->size() ||
+		   region.dstOffset + region.size > m_BufferDataHandle->size()) {
+			core::ivk::log->error("copy region (src|dst|size) {0} | {1} | {2} exceeds the ivk::buffer_t size",
+								  region.srcOffset,
+								  region.dstOffset,
+								  region.size);
+			return std::nullopt;
+		}
+	}
+
+#if PE_TRACE_LEVEL >= 1
+	core::ivk::log->trace("copying buffer {0} into {1} using {2} copy instructions",
+						  utility::to_string(other.m_UID),
+						  utility::to_string(m_UID),
+						  copyRegions.size());
+#endif
+#if PE_TRACE_LEVEL >= 2
+	for(const auto& region : copyRegions) {
+		core::ivk::log->trace(
+		  "srcOffset | dstOffset | size : {0} | {1} | {2}", region.srcOffset, region.dstOffset, region.size);
+	}
+#endif
+
+	// copies recorded by set() are submitted outside of the staging ring, they have to complete first
+	if(m_Context->device().getFenceStatus(m_BufferCompleted) != vk::Result::eSuccess)
+		m_Context->device().waitForFences(m_BufferCompleted, VK_TRUE, UINT64_MAX);
+
+	m_Pending = m_Context->staging().copy(other.m_Buffer, m_Buffer, std::move(copyRegions));
+	return m_Pending;
+}
+
+void buffer_t::release_staged() {
+	if(m_Staged.empty())
+		return;
+
+	auto& staging = m_Context->staging();
+	size_t kept {0};
+	for(auto& staged : m_Staged) {
+		if(staging.is_complete(staged.first))
+			deallocate(staged.second);
+		else
+			m_Staged[kept++] = staged;
+	}
+	m_Staged.resize(kept);
+}
+
+bool buffer_t::wait_staged() {
+	if(m_Staged.empty())
+		return false;
+
+	auto oldest = std::min_element(std::begin(m_Staged), std::end(m_Staged), [](const auto& lhs, const auto& rhs) {
+		return lhs.first < rhs.first;
+	});
+	if(!m_Context->staging().wait(oldest->first))
+		return false;
+	release_staged();
 	return true;
 }
 
@@ -487,6 +522,7 @@ bool buffer_t::set(const void* data,
 	copySubmitInfo.pCommandBuffers	  = &m_CommandBuffer;
 
 	m_Context->device().resetFences(m_BufferCompleted);
+	m_Context->staging().submit();
 	utility::vulkan::check(queue.submit(1, &copySubmitInfo, m_BufferCompleted));
 	// queue.waitIdle();
 	// m_CommandBuffer.reset(vk::CommandBufferResetFlagBits::eReleaseResources);
@@ -494,14 +530,18 @@ bool buffer_t::set(const void* data,
 	return true;
 }
 bool buffer_t::is_busy() const {
-	return m_Context->device().getFenceStatus(m_BufferCompleted) != vk::Result::eSuccess;
+	return m_Context->device().getFenceStatus(m_BufferCompleted) != vk::Result::eSuccess ||
+		   !m_Context->staging().is_complete(m_Pending);
 }
 
 void buffer_t::wait_until_ready(uint64_t timeout) const {
 	PROFILE_SCOPE(core::profiler)
-	if(is_busy()) {
+	if(m_Context->device().getFenceStatus(m_BufferCompleted) != vk::Result::eSuccess) {
 		m_Context->device().waitForFences(m_BufferCompleted, VK_TRUE, timeout);
 	}
+	if(!m_Context->staging().is_complete(m_Pending)) {
+		m_Context->staging().wait(m_Pending, timeout);
+	}
 }
 
 const vk::Buffer& buffer_t::gpu_buffer() const {
@@ -6,6 +6,8 @@
 #include "core/paradigm.hpp"
 #include "core/resource/resource.hpp"
 #include "core/vk/conversion.hpp"
+#include "core/vk/descriptor_allocator.hpp"
+#include "core/vk/staging_ring.hpp"
 #include "psl/meta.hpp"
 #include "psl/ustream.hpp"
 
@@ -24,6 +26,11 @@ using namespace psl;
 using namespace core::ivk;
 using namespace core::os;
 
+// size of the persistently mapped staging ring, uploads that exceed it get a dedicated staging buffer
+static const vk::DeviceSize staging_capacity {32 * 1024 * 1024};
+// amount of descriptor sets every descriptor pool can hold, pools are created per descriptor set layout
+static const uint32_t descriptor_sets_per_pool {64};
+
 VKAPI_ATTR VkBool32 VKAPI_CALL VulkanDebugCB(VkDebugReportFlagsEXT flags,
 											 VkDebugReportObjectTypeEXT objectType,
 											 uint64_t object,
@@ -240,7 +247,8 @@ context::context(core::resource::cache_t& cache,
 	}
 
 	init_command_pool();
-	init_descriptor_pool();
+	m_Descriptors = std::make_unique<core::ivk::descriptor_allocator>(*this, descriptor_sets_per_pool);
+	m_Staging = std::make_unique<core::ivk::staging_ring>(*this, staging_capacity);
 
 	{
 		psl::string information;
@@ -547,7 +555,8 @@ context::context(core::resource::cache_t& cache,
 
 context::~context() {
 	m_Device.waitIdle();
-	deinit_descriptor_pool();
+	m_Staging.reset();
+	m_Descriptors.reset();
 	deinit_command_pool();
 	deinit_device();
 	deinit_debug();
@@ -577,6 +586,29 @@ void context::deinit_debug() {
 	}
 }
 
+// finds the queue family for asynchronous transfers. This prefers a family that only supports transfers (usually a
+// dedicated DMA engine), then any family that does not support graphics. Devices without such a family (such as
+// lavapipe) fall back to the graphics family.
+static uint32_t transfer_queue_family(const std::vector<vk::QueueFamilyProperties>& families, uint32_t graphicsIndex) {
+	uint32_t result = graphicsIndex;
+	int bestScore	= 0;
+	for(uint32_t i = 0; i < families.size(); ++i) {
+		const auto flags = families[i].queueFlags;
+		// graphics and compute families support transfers, even when they don't report it
+		if(i == graphicsIndex || families[i].queueCount == 0 ||
+		   !(flags & (vk::QueueFlagBits::eTransfer | vk::QueueFlagBits::eCompute)) ||
+		   flags & vk::QueueFlagBits::eGraphics)
+			continue;
+
+		int score = (flags & vk::QueueFlagBits::eCompute) ? 1 : 2;
+		if(score > bestScore) {
+			bestScore = score;
+			result	  = i;
+		}
+	}
+	return result;
+}
+
 bool context::queue_index(vk::QueueFlags flag, vk::Queue& queue, uint32_t& queueIndex) {
 	// Find a queue that supports graphics operations
 	std::vector<vk::QueueFamilyProperties> queueProps = m_PhysicalDevice.getQueueFamilyProperties();
@@ -649,14 +681,17 @@ void context::init_device() {
 	m_PhysicalDeviceFeatures		 = m_PhysicalDevice.getFeatures();
 	m_PhysicalDeviceMemoryProperties = m_PhysicalDevice.getMemoryProperties();
 
-	bool has_transfer = queue_index(vk::QueueFlagBits::eTransfer, m_TransferQueue, m_TransferQueueIndex);
 	if(!queue_index(vk::QueueFlagBits::eGraphics, m_Queue, m_GraphicsQueueIndex)) {
 		core::ivk::log->critical("could not find a graphics queue, even though it was requested, crashing now...");
 		exit(1);
 	}
+	m_TransferQueueIndex = transfer_queue_family(m_PhysicalDevice.getQueueFamilyProperties(), m_GraphicsQueueIndex);
+	core::ivk::log->info("using queue family {} for graphics, and {} for transfers",
+						 m_GraphicsQueueIndex,
+						 m_TransferQueueIndex);
 
 	std::vector<vk::DeviceQueueCreateInfo> queueCreateInfo;
-	if(m_TransferQueueIndex == m_GraphicsQueueIndex && has_transfer) {
+	if(m_TransferQueueIndex == m_GraphicsQueueIndex) {
 		// Vulkan device
 		std::array<float, 1> queuePriorities = {1.0f};
 		queueCreateInfo.resize(1);
@@ -712,6 +747,19 @@ vk::Result context::create_device(vk::DeviceQueueCreateInfo* requestedQueues, ui
 	core::log->flush();
 	deviceCreateInfo.pEnabledFeatures = &m_PhysicalDeviceFeatures;
 
+	// timeline semaphores are used to track the completion of uploads (see core::ivk::staging_ring)
+	vk::PhysicalDeviceVulkan12Features supported12;
+	vk::PhysicalDeviceFeatures2 supported;
+	supported.pNext = &supported12;
+	m_PhysicalDevice.getFeatures2(&supported);
+	if(!supported12.timelineSemaphore) {
+		core::ivk::log->critical("the device does not support timeline semaphores, crashing now...");
+		std::exit(-1);
+	}
+	vk::PhysicalDeviceVulkan12Features features12;
+	features12.timelineSemaphore = VK_TRUE;
+	deviceCreateInfo.pNext		 = &features12;
+
 	deviceCreateInfo.enabledExtensionCount	 = (uint32_t)m_DeviceExtensionList.size();
 	deviceCreateInfo.ppEnabledExtensionNames = m_DeviceExtensionList.data();
 
@@ -732,7 +780,8 @@ void context::init_command_pool() {
 
 
 	CI.queueFamilyIndex = m_TransferQueueIndex;
-	CI.flags			= vk::CommandPoolCreateFlagBits::eTransient;
+	// the staging_ring reuses its command buffers, so they have to be resettable
+	CI.flags = vk::CommandPoolCreateFlagBits::eTransient | vk::CommandPoolCreateFlagBits::eResetCommandBuffer;
 	utility::vulkan::check(m_Device.createCommandPool(&CI, nullptr, &m_TransferCommandPool));
 }
 
@@ -743,31 +792,6 @@ void context::deinit_command_pool() {
 	m_TransferCommandPool = nullptr;
 }
 
-void context::init_descriptor_pool() {
-	// We need to tell the API the number of max. requested descriptors per type
-	std::vector<vk::DescriptorPoolSize> typeCounts = {
-	  utility::vulkan::defaults::descriptor_pool_size(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 64),
-	  utility::vulkan::defaults::descriptor_pool_size(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 16),
-	  utility::vulkan::defaults::descriptor_pool_size(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 64),
-	  utility::vulkan::defaults::descriptor_pool_size(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 64),
-	  utility::vulkan::defaults::descriptor_pool_size(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 64)};
-	// For additional types you need to add new entries in the type count list
-	// E.g. for two combined image samplers :
-	// typeCounts[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-	// typeCounts[1].descriptorCount = 2;
-
-	// Create the global descriptor pool
-	// All descriptors used in this example are allocated from this pool
-	vk::DescriptorPoolCreateInfo descriptorPoolInfo =
-	  utility::vulkan::defaults::descriptor_pool_ci((uint32_t)typeCounts.size(), typeCounts.data(), 32);
-	descriptorPoolInfo.flags = vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet;
-	utility::vulkan::check(m_Device.createDescriptorPool(&descriptorPoolInfo, nullptr, &m_DescriptorPool));
-}
-
-void context::deinit_descriptor_pool() {
-	m_Device.destroyDescriptorPool(m_DescriptorPool);
-}
-
 vk::Bool32
 context::memory_type(uint32_t typeBits, const vk::MemoryPropertyFlags& properties, uint32_t* typeIndex) const noexcept {
 	for(uint32_t i = 0; i < 32; i++) {
@@ -822,6 +846,10 @@ void context::flush(vk::CommandBuffer commandBuffer, bool free) {
 	}
 }
 
+void context::end_frame() {
+	m_Descriptors->advance(m_FramesInFlight);
+}
+
 bool has_queue(const vk::PhysicalDevice& device, vk::QueueFlags flag) noexcept {
 	std::vector<vk::QueueFamilyProperties> queueProps = device.getQueueFamilyProperties();
 	return std::any_of(std::begin(queueProps), std::end(queueProps), [flag](const auto& queue) noexcept {
@@ -887,10 +915,6 @@ const vk::CommandPool& context::transfer_command_pool() const noexcept {
 	return m_TransferCommandPool;
 }
 
-const vk::DescriptorPool& context::descriptor_pool() const noexcept {
-	return m_DescriptorPool;
-}
-
 const vk::Queue& context::queue() const noexcept {
 	return m_Queue;
 }
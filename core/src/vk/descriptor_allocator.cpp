@@ -0,0 +1,178 @@
+#include "core/vk/descriptor_allocator.hpp"
+#include "core/logging.hpp"
+#include "core/vk/context.hpp"
+#include "psl/utility/hash.hpp"
+#include <algorithm>
+
+using namespace core::ivk;
+using psl::utility::hash_combine;
+
+namespace {
+template <typename T>
+uint64_t to_integer(T handle) noexcept {
+	// non-dispatchable handles are either pointers or 64bit integers, depending on the platform
+	return (uint64_t)(static_cast<typename T::CType>(handle));
+}
+
+/// \brief flattens the writes into a sequence that uniquely identifies the contents of a descriptor set.
+std::vector<uint64_t> flatten(psl::array_view<vk::WriteDescriptorSet> writes) {
+	std::vector<uint64_t> result {};
+	for(const auto& write : writes) {
+		result.insert(std::end(result),
+					  {write.dstBinding,
+					   write.dstArrayElement,
+					   static_cast<uint64_t>(write.descriptorType),
+					   write.descriptorCount});
+		for(uint32_t i = 0; i < write.descriptorCount; ++i) {
+			if(write.pImageInfo) {
+				result.insert(std::end(result),
+							  {to_integer(write.pImageInfo[i].sampler),
+							   to_integer(write.pImageInfo[i].imageView),
+							   static_cast<uint64_t>(write.pImageInfo[i].imageLayout)});
+			} else if(write.pBufferInfo) {
+				result.insert(
+				  std::end(result),
+				  {to_integer(write.pBufferInfo[i].buffer), write.pBufferInfo[i].offset, write.pBufferInfo[i].range});
+			} else if(write.pTexelBufferView) {
+				result.emplace_back(to_integer(write.pTexelBufferView[i]));
+			}
+		}
+	}
+	return result;
+}
+}	 // namespace
+
+descriptor_allocator::descriptor_allocator(core::ivk::context& context, uint32_t setsPerPool)
+	: m_Context(context), m_SetsPerPool(setsPerPool) {}
+
+descriptor_allocator::~descriptor_allocator() {
+	const auto& device = m_Context.device();
+	for(auto& layout : m_Layouts) {
+		// destroying the pools frees all sets allocated from them
+		for(auto pool : layout->pools) device.destroyDescriptorPool(pool);
+		device.destroyDescriptorSetLayout(layout->layout);
+	}
+}
+
+vk::DescriptorSetLayout descriptor_allocator::layout(psl::array_view<vk::DescriptorSetLayoutBinding> bindings) {
+	std::vector<vk::DescriptorSetLayoutBinding> key {std::begin(bindings), std::end(bindings)};
+	std::sort(
+	  std::begin(key), std::end(key), [](const auto& lhs, const auto& rhs) { return lhs.binding < rhs.binding; });
+	if(auto it = std::find_if(std::begin(m_Layouts),
+							  std::end(m_Layouts),
+							  [&key](const auto& layout) { return layout->bindings == key; });
+	   it != std::end(m_Layouts))
+		return (*it)->layout;
+
+	auto& layout	 = m_Layouts.emplace_back(std::make_unique<layout_t>());
+	layout->bindings = std::move(key);
+
+	vk::DescriptorSetLayoutCreateInfo layoutInfo;
+	layoutInfo.bindingCount = (uint32_t)layout->bindings.size();
+	layoutInfo.pBindings	= layout->bindings.data();
+	utility::vulkan::check(m_Context.device().createDescriptorSetLayout(&layoutInfo, nullptr, &layout->layout));
+
+	// the pools of a layout are sized to hold exactly m_SetsPerPool sets of it
+	for(const auto& binding : layout->bindings) {
+		auto it = std::find_if(std::begin(layout->sizes), std::end(layout->sizes), [&binding](const auto& size) {
+			return size.type == binding.descriptorType;
+		});
+		if(it == std::end(layout->sizes))
+			it = layout->sizes.insert(std::end(layout->sizes), vk::DescriptorPoolSize {binding.descriptorType, 0});
+		it->descriptorCount += binding.descriptorCount * m_SetsPerPool;
+	}
+	return layout->layout;
+}
+
+vk::DescriptorSet descriptor_allocator::acquire(vk::DescriptorSetLayout layout,
+												psl::array_view<vk::WriteDescriptorSet> writes) {
+	auto target = find(layout);
+	if(!target) {
+		core::ivk::log->error("tried to acquire a descriptor set of a layout that was not created by the allocator");
+		return {};
+	}
+
+	auto contents = flatten(writes);
+	uint64_t hash {to_integer(layout)};
+	for(auto value : contents) hash_combine(hash, value);
+
+	if(auto it = m_Shared.find(hash); it != std::end(m_Shared)) {
+		auto& shared = m_Sets[to_integer(it->second)];
+		if(shared.layout == target && shared.contents == contents) {
+			++shared.references;
+			return it->second;
+		}
+	}
+
+	auto set = allocate(*target);
+	if(!set)
+		return set;
+
+	// all descriptors of the set are written in one call
+	std::vector<vk::WriteDescriptorSet> descriptors {std::begin(writes), std::end(writes)};
+	for(auto& descriptor : descriptors) descriptor.dstSet = set;
+	m_Context.device().updateDescriptorSets((uint32_t)descriptors.size(), descriptors.data(), 0, nullptr);
+
+	m_Sets[to_integer(set)] = set_t {target, std::move(contents), hash, 1};
+	m_Shared.try_emplace(hash, set);
+	return set;
+}
+
+void descriptor_allocator::release(vk::DescriptorSet set) {
+	auto it = m_Sets.find(to_integer(set));
+	if(it == std::end(m_Sets) || --it->second.references > 0)
+		return;
+
+	if(auto shared = m_Shared.find(it->second.hash); shared != std::end(m_Shared) && shared->second == set)
+		m_Shared.erase(shared);
+	m_Retired.emplace_back(retired_t {m_Frame, it->second.layout, set});
+	m_Sets.erase(it);
+}
+
+void descriptor_allocator::advance(uint32_t framesInFlight) {
+	++m_Frame;
+	std::erase_if(m_Retired, [this, framesInFlight](const retired_t& retired) {
+		if(retired.frame + framesInFlight >= m_Frame)
+			return false;
+		retired.layout->free.emplace_back(retired.set);
+		return true;
+	});
+}
+
+descriptor_allocator::layout_t* descriptor_allocator::find(vk::DescriptorSetLayout layout) noexcept {
+	auto it = std::find_if(
+	  std::begin(m_Layouts), std::end(m_Layouts), [layout](const auto& entry) { return entry->layout == layout; });
+	return (it != std::end(m_Layouts)) ? it->get() : nullptr;
+}
+
+vk::DescriptorSet descriptor_allocator::allocate(layout_t& layout) {
+	if(!layout.free.empty()) {
+		auto set = layout.free.back();
+		layout.free.pop_back();
+		return set;
+	}
+
+	if(layout.remaining == 0) {
+		vk::DescriptorPoolCreateInfo poolInfo;
+		poolInfo.maxSets	   = m_SetsPerPool;
+		poolInfo.poolSizeCount = (uint32_t)layout.sizes.size();
+		poolInfo.pPoolSizes	   = layout.sizes.data();
+		vk::DescriptorPool pool;
+		if(!utility::vulkan::check(m_Context.device().createDescriptorPool(&poolInfo, nullptr, &pool))) {
+			core::ivk::log->error("could not create a descriptor pool");
+			return {};
+		}
+		layout.pools.emplace_back(pool);
+		layout.remaining = m_SetsPerPool;
+	}
+
+	vk::DescriptorSetAllocateInfo allocInfo;
+	allocInfo.descriptorPool	 = layout.pools.back();
+	allocInfo.descriptorSetCount = 1;
+	allocInfo.pSetLayouts		 = &layout.layout;
+	vk::DescriptorSet set;
+	if(!utility::vulkan::check(m_Context.device().allocateDescriptorSets(&allocInfo, &set)))
+		return {};
+	--layout.remaining;
+	return set;
+}
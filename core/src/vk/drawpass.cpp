@@ -13,14 +13,246 @@
 #include "core/vk/framebuffer.hpp"
 #include "core/vk/geometry.hpp"
 #include "core/vk/material.hpp"
+#include "core/vk/staging_ring.hpp"
 #include "core/vk/swapchain.hpp"
 
+#include "psl/async/batch.hpp"
 #include "psl/utility/cast.hpp"
+#include "psl/utility/hash.hpp"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <optional>
 
 using namespace core::resource;
 using namespace core::gfx;
 using namespace core::ivk;
+using psl::utility::hash_combine;
 
+namespace {
+template <typename T>
+uint64_t to_integer(T handle) noexcept {
+	// non-dispatchable handles are either pointers or 64bit integers, depending on the platform
+	return (uint64_t)(static_cast<typename T::CType>(handle));
+}
+}	 // namespace
+
+/// \brief the resolved draw instructions of a render index of a drawlayer, and the secondary command buffers they are
+/// recorded into.
+/// \details the resolved state holds no resource handles, which allows the layer to be recorded on any thread. The
+/// pipelines it depends on are only inspected by the thread that builds the pass.
+struct drawpass::layer_t {
+	struct draw_t {
+		size_t material {0};
+		core::ivk::geometry_t::bindings_t geometry;
+		vk::Buffer instanceBuffer;
+		std::vector<core::ivk::geometry_t::vertex_binding_t> instances;
+		uint32_t indices {0};
+		uint32_t instanceCount {0};
+	};
+	/// \brief a run of consecutive draws that share their bindings, recorded as a single indirect draw.
+	struct batch_t {
+		size_t first {0};
+		uint32_t count {0};
+	};
+
+	/// \returns the draw as an indirect command relative to the bindings of the base draw, or nothing when the
+	/// draw cannot be expressed relative to it (i.e. the streams are in different buffers, or are not offset by the
+	/// same amount of elements).
+	static std::optional<vk::DrawIndexedIndirectCommand>
+	relative(const draw_t& base, const draw_t& draw, bool firstInstance) noexcept;
+
+	/// \brief groups the draws into batches, and generates their indirect commands.
+	/// \param[in] firstInstance if the device supports a non-zero firstInstance in indirect commands.
+	/// \param[in] maxDrawCount the maximum amount of draws in a batch, 1 disables batching.
+	void batch(bool firstInstance, uint32_t maxDrawCount);
+
+	/// \returns a hash of all the resolved state, layers with the same hash record the same commands.
+	uint64_t compute_hash() const noexcept;
+
+	/// \returns if the pipelines still hold the descriptor sets the layer was resolved with.
+	bool is_current() const noexcept;
+
+	/// \brief records the secondary command buffer of the given framebuffer index.
+	void record(uint32_t index, const vk::CommandBufferBeginInfo& beginInfo, vk::Extent2D extent, depth_bias bias);
+
+	std::vector<core::ivk::material_t::bindings_t> materials;
+	std::vector<draw_t> draws;
+	std::vector<batch_t> batches;
+	// one command per draw, so the commands of a batch start at the index of its first draw.
+	std::vector<vk::DrawIndexedIndirectCommand> indirect;
+	vk::Buffer indirectBuffer;
+	vk::DeviceMemory indirectMemory;
+	uint64_t hash {0};
+	// the version of the drawgroup segment the layer was resolved from, see core::gfx::drawgroup::segments()
+	uint64_t version {0};
+	// the pipelines the materials resolved to, and their generation at the time, see core::ivk::pipeline::generation()
+	std::vector<std::pair<handle<core::ivk::pipeline>, uint64_t>> pipelines;
+
+	// every layer has its own pool, so layers can be recorded concurrently without synchronizing on a pool.
+	vk::CommandPool pool;
+	std::vector<vk::CommandBuffer> commands;
+	std::vector<bool> dirty;
+	// only used once retired, which primary command buffers might still execute the commands of this layer.
+	std::vector<bool> referenced;
+};
+
+std::optional<vk::DrawIndexedIndirectCommand>
+drawpass::layer_t::relative(const draw_t& base, const draw_t& draw, bool firstInstance) noexcept {
+	const auto& from = base.geometry;
+	const auto& to	 = draw.geometry;
+	if(base.material != draw.material || base.instanceBuffer != draw.instanceBuffer ||
+	   from.vertexBuffer != to.vertexBuffer || from.indexBuffer != to.indexBuffer || from.indexType != to.indexType ||
+	   from.vertices.size() != to.vertices.size() || base.instances.size() != draw.instances.size())
+		return std::nullopt;
+
+	const vk::DeviceSize indexSize = (from.indexType == vk::IndexType::eUint16) ? 2 : 4;
+	if(to.indexOffset < from.indexOffset || (to.indexOffset - from.indexOffset) % indexSize != 0 ||
+	   (to.indexOffset - from.indexOffset) / indexSize > std::numeric_limits<uint32_t>::max())
+		return std::nullopt;
+
+	// every stream has to be offset by the same amount of elements, as there is only one offset in the command.
+	auto element_offset = [](const auto& lhs, const auto& rhs) -> std::optional<int64_t> {
+		std::optional<int64_t> result {};
+		for(size_t i = 0; i < lhs.size(); ++i) {
+			if(lhs[i].location != rhs[i].location || lhs[i].stride != rhs[i].stride || lhs[i].stride == 0)
+				return std::nullopt;
+			auto distance = static_cast<int64_t>(rhs[i].offset) - static_cast<int64_t>(lhs[i].offset);
+			auto stride	  = static_cast<int64_t>(lhs[i].stride);
+			if(distance % stride != 0 || (result && result.value() != distance / stride))
+				return std::nullopt;
+			result = distance / stride;
+		}
+		return result.value_or(0);
+	};
+
+	auto vertexOffset	= element_offset(from.vertices, to.vertices);
+	auto instanceOffset = element_offset(base.instances, draw.instances);
+	if(!vertexOffset || vertexOffset.value() < std::numeric_limits<int32_t>::min() ||
+	   vertexOffset.value() > std::numeric_limits<int32_t>::max() || !instanceOffset || instanceOffset.value() < 0 ||
+	   instanceOffset.value() > std::numeric_limits<uint32_t>::max() || (!firstInstance && instanceOffset.value() != 0))
+		return std::nullopt;
+
+	return vk::DrawIndexedIndirectCommand {draw.indices,
+										   draw.instanceCount,
+										   static_cast<uint32_t>((to.indexOffset - from.indexOffset) / indexSize),
+										   static_cast<int32_t>(vertexOffset.value()),
+										   static_cast<uint32_t>(instanceOffset.value())};
+}
+
+void drawpass::layer_t::batch(bool firstInstance, uint32_t maxDrawCount) {
+	batches.clear();
+	indirect.clear();
+	for(size_t i = 0; i < draws.size(); ++i) {
+		if(!batches.empty() && batches.back().count < maxDrawCount) {
+			if(auto command = relative(draws[batches.back().first], draws[i], firstInstance); command) {
+				indirect.emplace_back(command.value());
+				++batches.back().count;
+				continue;
+			}
+		}
+		batches.emplace_back(batch_t {i, 1});
+		indirect.emplace_back(vk::DrawIndexedIndirectCommand {draws[i].indices, draws[i].instanceCount, 0, 0, 0});
+	}
+}
+
+uint64_t drawpass::layer_t::compute_hash() const noexcept {
+	uint64_t seed {0};
+	for(const auto& material : materials) {
+		hash_combine(seed, static_cast<uint64_t>(material.bindPoint));
+		hash_combine(seed, to_integer(material.pipeline));
+		hash_combine(seed, to_integer(material.layout));
+		hash_combine(seed, to_integer(material.descriptorSet));
+		hash_combine(seed, material.pushConstants);
+		for(auto offset : material.dynamicOffsets) hash_combine(seed, offset);
+	}
+	for(const auto& draw : draws) {
+		hash_combine(seed, draw.material);
+		hash_combine(seed, to_integer(draw.geometry.vertexBuffer));
+		for(const auto& vertex : draw.geometry.vertices) {
+			hash_combine(seed, vertex.location);
+			hash_combine(seed, vertex.offset);
+			hash_combine(seed, vertex.stride);
+		}
+		hash_combine(seed, to_integer(draw.geometry.indexBuffer));
+		hash_combine(seed, draw.geometry.indexOffset);
+		hash_combine(seed, static_cast<uint64_t>(draw.geometry.indexType));
+		hash_combine(seed, to_integer(draw.instanceBuffer));
+		for(const auto& instance : draw.instances) {
+			hash_combine(seed, instance.location);
+			hash_combine(seed, instance.offset);
+			hash_combine(seed, instance.stride);
+		}
+		hash_combine(seed, draw.indices);
+		hash_combine(seed, draw.instanceCount);
+	}
+	return seed;
+}
+
+bool drawpass::layer_t::is_current() const noexcept {
+	return std::all_of(std::begin(pipelines), std::end(pipelines), [](const auto& entry) {
+		return entry.first->generation() == entry.second;
+	});
+}
+
+void drawpass::layer_t::record(uint32_t index,
+							   const vk::CommandBufferBeginInfo& beginInfo,
+							   vk::Extent2D extent,
+							   depth_bias bias) {
+	auto cmdBuffer = commands[index];
+	utility::vulkan::check(cmdBuffer.begin(beginInfo));
+
+	// dynamic state is not inherited from the primary command buffer
+	vk::Viewport viewport;
+	viewport.height	  = (float)extent.height;
+	viewport.width	  = (float)extent.width;
+	viewport.minDepth = (float)0.0f;
+	viewport.maxDepth = (float)1.0f;
+	cmdBuffer.setViewport(0, 1, &viewport);
+
+	vk::Rect2D scissor;
+	scissor.extent	 = extent;
+	scissor.offset.x = 0;
+	scissor.offset.y = 0;
+	cmdBuffer.setScissor(0, 1, &scissor);
+
+	cmdBuffer.setDepthBias(bias.components[0], bias.components[1], bias.components[2]);
+
+	// the draws are ordered on their material and geometry, so only the state that differs from the previous draw is
+	// bound.
+	const draw_t* previous {nullptr};
+	for(const auto& batch : batches) {
+		const auto& draw = draws[batch.first];
+		if(!previous) {
+			core::ivk::material_t::bind(cmdBuffer, materials[draw.material], index);
+		} else if(draw.material != previous->material) {
+			core::ivk::material_t::bind(cmdBuffer, materials[draw.material], materials[previous->material], index);
+		}
+
+		// the geometry could bind a vertex stream to the location of an instance stream, so those are bound again too
+		const bool geometry = !previous || draw.geometry != previous->geometry;
+		if(geometry)
+			core::ivk::geometry_t::bind(cmdBuffer, draw.geometry);
+		if(geometry || draw.instanceBuffer != previous->instanceBuffer || draw.instances != previous->instances) {
+			for(const auto& instance : draw.instances) {
+				cmdBuffer.bindVertexBuffers(instance.location, 1, &draw.instanceBuffer, &instance.offset);
+			}
+		}
+		previous = &draw;
+
+		if(batch.count == 1) {
+			cmdBuffer.drawIndexed(draw.indices, draw.instanceCount, 0, 0, 0);
+		} else {
+			cmdBuffer.drawIndexedIndirect(indirectBuffer,
+										  batch.first * sizeof(vk::DrawIndexedIndirectCommand),
+										  batch.count,
+										  sizeof(vk::DrawIndexedIndirectCommand));
+		}
+	}
+
+	utility::vulkan::check(cmdBuffer.end());
+	dirty[index] = false;
+}
 
 drawpass::drawpass(handle<core::ivk::context> context, handle<core::ivk::framebuffer_t> framebuffer)
 	: m_Context(context), m_Framebuffer(framebuffer), m_UsingSwap(false) {
@@ -31,6 +263,8 @@ drawpass::drawpass(handle<core::ivk::context> context, handle<core::ivk::framebu
 	utility::vulkan::check(m_Context->device().createSemaphore(&semaphoreCreateInfo, nullptr, &m_RenderComplete));
 
 	m_DrawCommandBuffers.resize(m_Framebuffer->framebuffers().size());
+	m_Dirty.resize(m_DrawCommandBuffers.size(), true);
+	m_Recorded.resize(m_DrawCommandBuffers.size(), false);
 
 	// Set up submit info structure
 	// Semaphores will stay the same during application lifetime
@@ -42,6 +276,8 @@ drawpass::drawpass(handle<core::ivk::context> context, handle<core::ivk::framebu
 	m_SubmitInfo.pSignalSemaphores	  = &m_RenderComplete;
 
 	create_fences(m_Framebuffer->framebuffers().size());
+	// the pass can be this many frames behind, which the context has to account for when recycling resources
+	m_Context->frames_in_flight((uint32_t)m_WaitFences.size());
 
 	build();
 }
@@ -55,6 +291,8 @@ drawpass::drawpass(handle<core::ivk::context> context, handle<core::ivk::swapcha
 	utility::vulkan::check(m_Context->device().createSemaphore(&semaphoreCreateInfo, nullptr, &m_RenderComplete));
 
 	m_DrawCommandBuffers.resize(m_Swapchain->framebuffers().size());
+	m_Dirty.resize(m_DrawCommandBuffers.size(), true);
+	m_Recorded.resize(m_DrawCommandBuffers.size(), false);
 
 	// Set up submit info structure
 	// Semaphores will stay the same during application lifetime
@@ -66,6 +304,8 @@ drawpass::drawpass(handle<core::ivk::context> context, handle<core::ivk::swapcha
 	m_SubmitInfo.pSignalSemaphores	  = &m_RenderComplete;
 
 	create_fences(m_Swapchain->framebuffers().size());
+	// the pass can be this many frames behind, which the context has to account for when recycling resources
+	m_Context->frames_in_flight((uint32_t)m_WaitFences.size());
 
 	// build();
 }
@@ -91,140 +331,321 @@ drawpass::~drawpass() {
 	m_Context->device().freeCommandBuffers(
 	  m_Context->command_pool(), (uint32_t)m_DrawCommandBuffers.size(), m_DrawCommandBuffers.data());
 
+	for(auto& layer : m_Layers) destroy(*layer);
+	for(auto& layer : m_Retired) destroy(*layer);
+
 	m_Context->device().destroySemaphore(m_PresentComplete);
 
 	/* todo: this can cause a validation error when deleted during-inflight */
 	m_Context->device().destroySemaphore(m_RenderComplete);
 }
-bool drawpass::build() {
+
+bool drawpass::build(bool force) {
+	PROFILE_SCOPE(core::profiler)
 	LOG_INFO("Rebuilding Command Buffers");
 	m_LastBuildFrame = m_FrameCount;
+	m_Buffers		 = (uint32_t)m_DrawCommandBuffers.size();
+
+	// every render index of a drawlayer is a layer of its own, which is only resolved again when one of the drawcalls
+	// with a material at that render index changed. The others are moved over as is.
+	core::profiler.scope_begin("sort");
+	std::vector<std::unique_ptr<layer_t>> layers;
+	std::vector<std::pair<size_t, uint64_t>> pending;
+	bool changed {false};
+	m_DrawList.clear();
+	for(const auto& group : m_AllGroups) {
+		for(const drawlayer& drawLayer : group->layers()) {
+			for(const auto& segment : group->segments(drawLayer)) {
+				// an unchanged segment can still bind descriptor sets that its pipelines have since replaced
+				auto it = std::find_if(std::begin(m_Layers), std::end(m_Layers), [&segment](const auto& layer) {
+					return layer && layer->version == segment.version && layer->is_current();
+				});
+				if(!force && it != std::end(m_Layers)) {
+					changed |= std::distance(std::begin(m_Layers), it) != static_cast<std::ptrdiff_t>(layers.size());
+					layers.emplace_back(std::move(*it));
+					continue;
+				}
+				pending.emplace_back(layers.size(), segment.version);
+				layers.emplace_back(nullptr);
+				group->build(m_DrawList, drawLayer, segment.renderIndex);
+			}
+		}
+	}
+	m_DrawList.sort();
+	core::profiler.scope_end();
+
+	std::vector<std::unique_ptr<layer_t>> resolved;
+	resolve(resolved);
+
+	// layers that resolve to the same state as a previous layer keep its recorded commands
+	changed |= layers.size() != m_Layers.size();
+	for(size_t i = 0; i < pending.size(); ++i) {
+		auto [index, version] = pending[i];
+		auto it = std::find_if(std::begin(m_Layers), std::end(m_Layers), [hash = resolved[i]->hash](const auto& layer) {
+			return layer && layer->hash == hash;
+		});
+		if(it != std::end(m_Layers)) {
+			changed |= std::distance(std::begin(m_Layers), it) != static_cast<std::ptrdiff_t>(index);
+			layers[index]			 = std::move(*it);
+			layers[index]->pipelines = std::move(resolved[i]->pipelines);
+		} else {
+			changed		  = true;
+			layers[index] = std::move(resolved[i]);
+			allocate(*layers[index]);
+		}
+		layers[index]->version = version;
+	}
 
-	m_Context->device().waitIdle();
-	m_Context->device().freeCommandBuffers(
-	  m_Context->command_pool(), (uint32_t)m_DrawCommandBuffers.size(), m_DrawCommandBuffers.data());
+	for(auto& layer : m_Layers) {
+		if(layer)
+			retire(std::move(layer));
+	}
+	m_Layers = std::move(layers);
 
-	m_Buffers = (uint32_t)m_DrawCommandBuffers.size();
+	if(changed)
+		std::fill(std::begin(m_Dirty), std::end(m_Dirty), true);
+	return true;
+}
 
-	vk::CommandBufferAllocateInfo cmdBufAllocateInfo;
-	cmdBufAllocateInfo.commandPool		  = m_Context->command_pool();
-	cmdBufAllocateInfo.commandBufferCount = (uint32_t)m_DrawCommandBuffers.size();	  // one for each image
-	cmdBufAllocateInfo.level			  = vk::CommandBufferLevel::ePrimary;
+void drawpass::resolve(std::vector<std::unique_ptr<layer_t>>& layers) {
+	const auto& features = m_Context->features();
+	size_t next {0};
+	for(uint32_t index = 0; index < m_DrawList.layers().size(); ++index) {
+		auto layer = std::make_unique<layer_t>();
+
+		// the draws of the layer are consecutive in the sorted list, ordered on their render index and then on their
+		// material and geometry, so the material only has to be resolved again when the bundle or render index changes.
+		handle<core::gfx::bundle> bundle {};
+		uint32_t renderLayer {0};
+		std::optional<size_t> material {};
+		psl::array<uint32_t> strides {};
+		for(; next < m_DrawList.size() && m_DrawList[next].layer == index; ++next) {
+			const auto& entry = m_DrawList[next];
+			auto gfxmat {entry.material};
+			auto mat {gfxmat->resource<gfx::graphics_backend::vulkan>()};
+			if(entry.bundle != bundle || entry.renderLayer != renderLayer) {
+				bundle		= entry.bundle;
+				renderLayer = entry.renderLayer;
+				material	= std::nullopt;
+				// updates the offsets of the instance data, which end up in the dynamic offsets of the material
+				std::optional<core::ivk::material_t::bindings_t> bindings {};
+				if(bundle->bind_material(renderLayer))
+					bindings = (m_UsingSwap) ? mat->bindings(m_Swapchain) : mat->bindings(m_Framebuffer);
+				if(bindings) {
+					// bundles that resolve to the same material state share it, so their draws can be batched
+					if(layer->materials.empty() || layer->materials.back() != bindings.value())
+						layer->materials.emplace_back(std::move(bindings.value()));
+					auto pipeline = mat->bound();
+					if(std::none_of(std::begin(layer->pipelines),
+									std::end(layer->pipelines),
+									[&pipeline](const auto& entry) { return entry.first == pipeline; }))
+						layer->pipelines.emplace_back(pipeline, pipeline->generation());
+					material = layer->materials.size() - 1;
+					strides	 = bundle->m_InstanceData.strides(gfxmat);
+				}
+			}
+			if(!material)
+				continue;
+
+			auto geometryHandle = entry.geometry->resource<gfx::graphics_backend::vulkan>();
+			if(!geometryHandle->compatible(mat.value()))
+				continue;
+
+			auto& draw	  = layer->draws.emplace_back();
+			draw.material = material.value();
+			draw.geometry = geometryHandle->bindings(mat.value());
+			auto bindings = bundle->m_InstanceData.bindings(gfxmat, entry.geometry);
+			for(size_t i = 0; i < bindings.size(); ++i) {
+				draw.instances.emplace_back(core::ivk::geometry_t::vertex_binding_t {
+				  psl::utility::narrow_cast<uint32_t>(bindings[i].first),
+				  vk::DeviceSize {bindings[i].second},
+				  (i < strides.size()) ? vk::DeviceSize {strides[i]} : vk::DeviceSize {0}});
+			}
+			if(!draw.instances.empty()) {
+				draw.instanceBuffer =
+				  bundle->m_InstanceData.vertex_buffer()->resource<gfx::graphics_backend::vulkan>()->gpu_buffer();
+			}
+			draw.indices	   = (uint32_t)geometryHandle->data()->indices().size();
+			draw.instanceCount = entry.instances;
+		}
 
-	if(!utility::vulkan::check(
-		 m_Context->device().allocateCommandBuffers(&cmdBufAllocateInfo, m_DrawCommandBuffers.data())))
+		// draws that share their buffers are merged into indirect draws when the device supports it.
+		layer->batch(features.drawIndirectFirstInstance,
+					 (features.multiDrawIndirect) ? m_Context->properties().limits.maxDrawIndirectCount : 1u);
+		layer->hash = layer->compute_hash();
+		layers.emplace_back(std::move(layer));
+	}
+}
+
+void drawpass::allocate(layer_t& layer) {
+	vk::CommandPoolCreateInfo poolInfo;
+	poolInfo.queueFamilyIndex = m_Context->graphics_queue_index();
+	poolInfo.flags			  = vk::CommandPoolCreateFlagBits::eResetCommandBuffer;
+	utility::vulkan::check(m_Context->device().createCommandPool(&poolInfo, nullptr, &layer.pool));
+
+	layer.commands.resize(m_DrawCommandBuffers.size());
+	layer.dirty.resize(m_DrawCommandBuffers.size(), true);
+
+	vk::CommandBufferAllocateInfo cmdBufAllocateInfo;
+	cmdBufAllocateInfo.commandPool		  = layer.pool;
+	cmdBufAllocateInfo.commandBufferCount = (uint32_t)layer.commands.size();
+	cmdBufAllocateInfo.level			  = vk::CommandBufferLevel::eSecondary;
+	if(!utility::vulkan::check(m_Context->device().allocateCommandBuffers(&cmdBufAllocateInfo, layer.commands.data())))
 		throw new std::runtime_error("Critical issue");
 
-	vk::CommandBufferBeginInfo cmdBufInfo;
-	cmdBufInfo.pNext = NULL;
+	if(layer.batches.size() == layer.draws.size())
+		return;
+
+	// the indirect commands of a layer never change, so they are written once into host visible memory
+	const auto& device = m_Context->device();
+	vk::BufferCreateInfo bufferInfo;
+	bufferInfo.usage	   = vk::BufferUsageFlagBits::eIndirectBuffer;
+	bufferInfo.size		   = layer.indirect.size() * sizeof(vk::DrawIndexedIndirectCommand);
+	bufferInfo.sharingMode = vk::SharingMode::eExclusive;
+	utility::vulkan::check(device.createBuffer(&bufferInfo, nullptr, &layer.indirectBuffer));
+
+	auto requirements = device.getBufferMemoryRequirements(layer.indirectBuffer);
+	vk::MemoryAllocateInfo allocateInfo;
+	allocateInfo.allocationSize	 = requirements.size;
+	allocateInfo.memoryTypeIndex =
+	  m_Context->memory_type(requirements.memoryTypeBits,
+							 vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+	utility::vulkan::check(device.allocateMemory(&allocateInfo, nullptr, &layer.indirectMemory));
+	utility::vulkan::check(device.bindBufferMemory(layer.indirectBuffer, layer.indirectMemory, 0));
+
+	auto mapping = device.mapMemory(layer.indirectMemory, 0, bufferInfo.size);
+	if(utility::vulkan::check(mapping.result)) {
+		std::memcpy(mapping.value, layer.indirect.data(), bufferInfo.size);
+		device.unmapMemory(layer.indirectMemory);
+	}
+}
 
-	std::vector<vk::ClearValue> clearValues;
+void drawpass::retire(std::unique_ptr<layer_t> layer) {
+	layer->referenced = m_Recorded;
+	if(std::find(std::begin(layer->referenced), std::end(layer->referenced), true) == std::end(layer->referenced))
+		destroy(*layer);
+	else
+		m_Retired.emplace_back(std::move(layer));
+}
+
+void drawpass::destroy(layer_t& layer) {
+	// destroying the pool frees its command buffers as well
+	m_Context->device().destroyCommandPool(layer.pool);
+	m_Context->device().destroyBuffer(layer.indirectBuffer);
+	m_Context->device().freeMemory(layer.indirectMemory);
+	layer.pool = vk::CommandPool {};
+	layer.commands.clear();
+}
+
+void drawpass::record(uint32_t index) {
+	PROFILE_SCOPE(core::profiler)
+	if(!m_DrawCommandBuffers[index]) {
+		vk::CommandBufferAllocateInfo cmdBufAllocateInfo;
+		cmdBufAllocateInfo.commandPool		  = m_Context->command_pool();
+		cmdBufAllocateInfo.commandBufferCount = 1;
+		cmdBufAllocateInfo.level			  = vk::CommandBufferLevel::ePrimary;
+
+		if(!utility::vulkan::check(
+			 m_Context->device().allocateCommandBuffers(&cmdBufAllocateInfo, &m_DrawCommandBuffers[index])))
+			throw new std::runtime_error("Critical issue");
+	}
+
+	const std::vector<vk::Framebuffer>& framebuffers =
+	  (m_UsingSwap) ? m_Swapchain->framebuffers() : m_Framebuffer->framebuffers();
 
+	vk::RenderPassBeginInfo renderPassBeginInfo;
+	std::vector<vk::ClearValue> clearValues;
 	if(m_UsingSwap) {
+		renderPassBeginInfo.renderPass				 = m_Swapchain->renderpass();
+		renderPassBeginInfo.renderArea.extent.width	 = m_Swapchain->width();
+		renderPassBeginInfo.renderArea.extent.height = m_Swapchain->height();
+
 		clearValues.reserve(1 + (size_t)m_Swapchain->has_depth());
-		for(auto i = 0; i < 1; ++i) {
-			clearValues.emplace_back(m_Swapchain->clear_color());
-		}
+		clearValues.emplace_back(m_Swapchain->clear_color());
 		if(m_Swapchain->has_depth()) {
 			clearValues.emplace_back(m_Swapchain->clear_depth());
 		}
 	} else {
+		renderPassBeginInfo.renderPass				 = m_Framebuffer->render_pass();
+		renderPassBeginInfo.renderArea.extent.width	 = m_Framebuffer->data()->width();
+		renderPassBeginInfo.renderArea.extent.height = m_Framebuffer->data()->height();
+
 		const auto& attachments = m_Framebuffer->data()->attachments();
 		std::transform(std::begin(attachments),
 					   std::end(attachments),
 					   std::back_inserter(clearValues),
 					   [](const auto& attach) { return core::gfx::conversion::to_vk(attach.clear_value()); });
 	}
-	bool success = false;
-	for(auto i = 0; i < m_DrawCommandBuffers.size(); ++i) {
-		m_Context->device().waitIdle();
-		if(!utility::vulkan::check(m_DrawCommandBuffers[i].begin(cmdBufInfo)))
-			throw new std::runtime_error("Critical issue");
-
-		const std::vector<vk::Framebuffer>& framebuffers =
-		  (m_UsingSwap) ? m_Swapchain->framebuffers() : m_Framebuffer->framebuffers();
-
-
-		vk::RenderPassBeginInfo renderPassBeginInfo;
-
-		if(m_UsingSwap) {
-			renderPassBeginInfo.renderPass				 = m_Swapchain->renderpass();
-			renderPassBeginInfo.renderArea.extent.width	 = m_Swapchain->width();
-			renderPassBeginInfo.renderArea.extent.height = m_Swapchain->height();
-		} else {
-			renderPassBeginInfo.renderPass				 = m_Framebuffer->render_pass();
-			renderPassBeginInfo.renderArea.extent.width	 = m_Framebuffer->data()->width();
-			renderPassBeginInfo.renderArea.extent.height = m_Framebuffer->data()->height();
-		}
-
-		renderPassBeginInfo.renderArea.offset.x = 0;
-		renderPassBeginInfo.renderArea.offset.y = 0;
-		renderPassBeginInfo.clearValueCount		= (uint32_t)clearValues.size();
-		renderPassBeginInfo.pClearValues		= clearValues.data();
-		if(m_UsingSwap) {
-			renderPassBeginInfo.framebuffer = framebuffers[i];
-
-			m_DrawCommandBuffers[i].beginRenderPass(renderPassBeginInfo, vk::SubpassContents::eInline);
-
-			// Update dynamic viewport state
-			vk::Viewport viewport;
-			viewport.height	  = (float)renderPassBeginInfo.renderArea.extent.height;
-			viewport.width	  = (float)renderPassBeginInfo.renderArea.extent.width;
-			viewport.minDepth = (float)0.0f;
-			viewport.maxDepth = (float)1.0f;
-			m_DrawCommandBuffers[i].setViewport(0, 1, &viewport);
-
-			// Update dynamic scissor state
-			vk::Rect2D scissor;
-			scissor.extent.width  = renderPassBeginInfo.renderArea.extent.width;
-			scissor.extent.height = renderPassBeginInfo.renderArea.extent.height;
-			scissor.offset.x	  = 0;
-			scissor.offset.y	  = 0;
-			m_DrawCommandBuffers[i].setScissor(0, 1, &scissor);
-
-			m_DrawCommandBuffers[i].setDepthBias(
-			  m_DepthBias.components[0], m_DepthBias.components[1], m_DepthBias.components[2]);
-
-			for(auto& group : m_AllGroups) build_drawgroup(group, m_DrawCommandBuffers[i], m_Swapchain, i);
-
-			m_DrawCommandBuffers[i].endRenderPass();
-		} else {
-			for(const auto& framebuffer : framebuffers) {
-				renderPassBeginInfo.framebuffer = framebuffer;
-
-				m_DrawCommandBuffers[i].beginRenderPass(renderPassBeginInfo, vk::SubpassContents::eInline);
+	renderPassBeginInfo.renderArea.offset.x = 0;
+	renderPassBeginInfo.renderArea.offset.y = 0;
+	renderPassBeginInfo.clearValueCount		= (uint32_t)clearValues.size();
+	renderPassBeginInfo.pClearValues		= clearValues.data();
+
+	// the secondary command buffers of changed layers are recorded in parallel, every layer owns its pool
+	vk::CommandBufferInheritanceInfo inheritanceInfo;
+	inheritanceInfo.renderPass = renderPassBeginInfo.renderPass;
+	inheritanceInfo.subpass	   = 0;
+	vk::CommandBufferBeginInfo secondaryInfo;
+	secondaryInfo.flags			   = vk::CommandBufferUsageFlagBits::eRenderPassContinue;
+	secondaryInfo.pInheritanceInfo = &inheritanceInfo;
+	if(m_UsingSwap) {
+		inheritanceInfo.framebuffer = framebuffers[index];
+	} else {
+		// framebuffer passes execute the same commands in the renderpass of each of their framebuffers
+		secondaryInfo.flags |= vk::CommandBufferUsageFlagBits::eSimultaneousUse;
+	}
 
-				// Update dynamic viewport state
-				vk::Viewport viewport;
-				viewport.height	  = (float)renderPassBeginInfo.renderArea.extent.height;
-				viewport.width	  = (float)renderPassBeginInfo.renderArea.extent.width;
-				viewport.minDepth = (float)0.0f;
-				viewport.maxDepth = (float)1.0f;
-				m_DrawCommandBuffers[i].setViewport(0, 1, &viewport);
+	std::vector<layer_t*> jobs {};
+	for(auto& layer : m_Layers) {
+		if(layer->dirty[index])
+			jobs.emplace_back(layer.get());
+	}
 
-				// Update dynamic scissor state
-				vk::Rect2D scissor;
-				scissor.extent.width  = renderPassBeginInfo.renderArea.extent.width;
-				scissor.extent.height = renderPassBeginInfo.renderArea.extent.height;
-				scissor.offset.x	  = 0;
-				scissor.offset.y	  = 0;
-				m_DrawCommandBuffers[i].setScissor(0, 1, &scissor);
+	const auto extent = renderPassBeginInfo.renderArea.extent;
+	if(jobs.size() == 1) {
+		jobs[0]->record(index, secondaryInfo, extent, m_DepthBias);
+	} else if(jobs.size() > 1) {
+		auto workers = psl::async::batch(jobs.size(), [&](size_t begin, size_t end) {
+			for(auto i = begin; i < end; ++i) jobs[i]->record(index, secondaryInfo, extent, m_DepthBias);
+		});
+		for(auto& worker : workers) worker.get();
+	}
 
-				m_DrawCommandBuffers[i].setDepthBias(
-				  m_DepthBias.components[0], m_DepthBias.components[1], m_DepthBias.components[2]);
+	std::vector<vk::CommandBuffer> secondaries {};
+	secondaries.reserve(m_Layers.size());
+	for(const auto& layer : m_Layers) secondaries.emplace_back(layer->commands[index]);
 
+	auto& cmdBuffer = m_DrawCommandBuffers[index];
+	vk::CommandBufferBeginInfo cmdBufInfo;
+	cmdBufInfo.pNext = NULL;
+	if(!utility::vulkan::check(cmdBuffer.begin(cmdBufInfo)))
+		throw new std::runtime_error("Critical issue");
 
-				for(auto& group : m_AllGroups) build_drawgroup(group, m_DrawCommandBuffers[i], m_Framebuffer, i);
+	auto record_renderpass = [&](vk::Framebuffer framebuffer) {
+		renderPassBeginInfo.framebuffer = framebuffer;
+		cmdBuffer.beginRenderPass(renderPassBeginInfo, vk::SubpassContents::eSecondaryCommandBuffers);
+		if(!secondaries.empty())
+			cmdBuffer.executeCommands((uint32_t)secondaries.size(), secondaries.data());
+		cmdBuffer.endRenderPass();
+	};
 
+	if(m_UsingSwap) {
+		record_renderpass(framebuffers[index]);
+	} else {
+		for(const auto& framebuffer : framebuffers) record_renderpass(framebuffer);
+	}
 
-				m_DrawCommandBuffers[i].endRenderPass();
-			}
-		}
+	utility::vulkan::check(cmdBuffer.end());
+	m_Dirty[index]	  = false;
+	m_Recorded[index] = true;
 
-		success |= utility::vulkan::check(m_DrawCommandBuffers[i].end());
+	// the previous recording of this index was the last one that could reference the layers retired before it
+	for(auto& layer : m_Retired) {
+		layer->referenced[index] = false;
+		if(std::find(std::begin(layer->referenced), std::end(layer->referenced), true) == std::end(layer->referenced))
+			destroy(*layer);
 	}
-
-	return success;
+	std::erase_if(m_Retired, [](const auto& layer) { return !layer->pool; });
 }
 
 void drawpass::create_fences(const size_t size) {
@@ -275,6 +696,10 @@ void drawpass::present() {
 			LOG_ERROR("Failed to reset fence");
 	}
 
+	// the frame is no longer in flight, so its command buffers can be re-recorded without stalling the other frames
+	if(m_Dirty[m_CurrentBuffer])
+		record(m_CurrentBuffer);
+
 	std::vector<vk::Semaphore> semaphores {m_WaitFor};
 	std::vector<vk::PipelineStageFlags> stageFlags;
 
@@ -302,6 +727,9 @@ void drawpass::present() {
 	m_SubmitInfo.commandBufferCount = 1;
 
 
+	// the uploads staged during this frame are submitted first, its batch makes them visible to this submission
+	m_Context->staging().submit();
+
 	if(m_WaitFences.size() > 0)
 		utility::vulkan::check(m_Context->queue().submit(1, &m_SubmitInfo, m_WaitFences[m_CurrentBuffer]));
 	else
@@ -320,21 +748,23 @@ bool drawpass::is_swapchain() const noexcept {
 
 
 void drawpass::bias(const core::ivk::depth_bias& bias) noexcept {
+	if(m_DepthBias.bias == bias.bias)
+		return;
 	m_DepthBias = bias;
+	// the bias is dynamic state of the secondary command buffers, which do not inherit it from the primary ones
+	for(auto& layer : m_Layers) std::fill(std::begin(layer->dirty), std::end(layer->dirty), true);
+	std::fill(std::begin(m_Dirty), std::end(m_Dirty), true);
 }
 core::ivk::depth_bias drawpass::bias() const noexcept {
 	return m_DepthBias;
 }
 
 void drawpass::add(core::gfx::drawgroup& group) noexcept {
-	m_AllGroups.push_back(group);
+	if(std::find(std::begin(m_AllGroups), std::end(m_AllGroups), &group) == std::end(m_AllGroups))
+		m_AllGroups.emplace_back(&group);
 }
 void drawpass::remove(const core::gfx::drawgroup& group) noexcept {
-	m_AllGroups.erase(
-	  std::remove_if(std::begin(m_AllGroups),
-					 std::end(m_AllGroups),
-					 [&group](const std::reference_wrapper<drawgroup>& element) { return &group == &element.get(); }),
-	  std::end(m_AllGroups));
+	m_AllGroups.erase(std::remove(std::begin(m_AllGroups), std::end(m_AllGroups), &group), std::end(m_AllGroups));
 }
 
 void drawpass::clear() noexcept {
@@ -349,105 +779,3 @@ void drawpass::connect(psl::view_ptr<drawpass> pass) noexcept {
 void drawpass::disconnect(psl::view_ptr<drawpass> pass) noexcept {
 	m_WaitFor.erase(std::find(std::begin(m_WaitFor), std::end(m_WaitFor), pass->m_RenderComplete), std::end(m_WaitFor));
 }
-
-void drawpass::build_drawgroup(drawgroup& group,
-							   vk::CommandBuffer cmdBuffer,
-							   core::resource::handle<core::ivk::framebuffer_t> framebuffer,
-							   uint32_t index) {
-	for(auto& drawLayer : group.m_Group) {
-		psl::array<uint32_t> render_indices;
-		for(auto& drawCall : drawLayer.second) {
-			auto matIndices = drawCall.m_Bundle->materialIndices(drawLayer.first.begin(), drawLayer.first.end());
-			render_indices.insert(std::end(render_indices), std::begin(matIndices), std::end(matIndices));
-		}
-		std::sort(std::begin(render_indices), std::end(render_indices));
-		render_indices.erase(std::unique(std::begin(render_indices), std::end(render_indices)),
-							 std::end(render_indices));
-		for(auto renderLayer : render_indices) {
-			for(auto& drawCall : drawLayer.second) {
-				if(drawCall.m_Geometry.size() == 0 || !drawCall.m_Bundle->has(renderLayer))
-					continue;
-				auto bundle = drawCall.m_Bundle;
-				if(!bundle->bind_material(renderLayer))
-					continue;
-				auto gfxmat {bundle->bound()};
-				auto mat {gfxmat->resource<gfx::graphics_backend::vulkan>()};
-
-				if(!mat->bind_pipeline(cmdBuffer, framebuffer, index))
-					continue;
-				for(auto& [gfxGeometryHandle, count] : drawCall.m_Geometry) {
-					auto geometryHandle = gfxGeometryHandle->resource<gfx::graphics_backend::vulkan>();
-					uint32_t instance_n = bundle->instances(gfxGeometryHandle);
-					if(instance_n == 0 || !geometryHandle->compatible(mat.value()))
-						continue;
-
-					geometryHandle->bind(cmdBuffer, mat.value());
-
-					// bundle->bind_geometry(cmdBuffer, geometryHandle);
-
-					for(const auto& b : bundle->m_InstanceData.bindings(gfxmat, gfxGeometryHandle)) {
-						cmdBuffer.bindVertexBuffers(psl::utility::narrow_cast<uint32_t>(b.first),
-													1,
-													&bundle->m_InstanceData.vertex_buffer()
-													   ->resource<gfx::graphics_backend::vulkan>()
-													   ->gpu_buffer(),
-													&b.second);
-					}
-
-					cmdBuffer.drawIndexed((uint32_t)geometryHandle->data()->indices().size(), instance_n, 0, 0, 0);
-				}
-			}
-		}
-	}
-}
-
-void drawpass::build_drawgroup(drawgroup& group,
-							   vk::CommandBuffer cmdBuffer,
-							   core::resource::handle<core::ivk::swapchain> swapchain,
-							   uint32_t index) {
-	for(auto& drawLayer : group.m_Group) {
-		psl::array<uint32_t> render_indices;
-		for(auto& drawCall : drawLayer.second) {
-			auto matIndices = drawCall.m_Bundle->materialIndices(drawLayer.first.begin(), drawLayer.first.end());
-			render_indices.insert(std::end(render_indices), std::begin(matIndices), std::end(matIndices));
-		}
-		std::sort(std::begin(render_indices), std::end(render_indices));
-		render_indices.erase(std::unique(std::begin(render_indices), std::end(render_indices)),
-							 std::end(render_indices));
-		for(auto renderLayer : render_indices) {
-			for(auto& drawCall : drawLayer.second) {
-				if(drawCall.m_Geometry.size() == 0 || !drawCall.m_Bundle->has(renderLayer))
-					continue;
-				auto bundle = drawCall.m_Bundle;
-				if(!bundle->bind_material(renderLayer))
-					continue;
-				auto gfxmat {bundle->bound()};
-				auto mat {gfxmat->resource<gfx::graphics_backend::vulkan>()};
-
-				if(!mat->bind_pipeline(cmdBuffer, swapchain, index))
-					continue;
-				for(auto& [gfxGeometryHandle, count] : drawCall.m_Geometry) {
-					auto geometryHandle = gfxGeometryHandle->resource<gfx::graphics_backend::vulkan>();
-					uint32_t instance_n = bundle->instances(gfxGeometryHandle);
-					if(instance_n == 0 || !geometryHandle->compatible(mat.value()))
-						continue;
-
-					geometryHandle->bind(cmdBuffer, mat.value());
-
-					// bundle->bind_geometry(cmdBuffer, geometryHandle);
-
-					for(const auto& b : bundle->m_InstanceData.bindings(gfxmat, gfxGeometryHandle)) {
-						cmdBuffer.bindVertexBuffers(psl::utility::narrow_cast<uint32_t>(b.first),
-													1,
-													&bundle->m_InstanceData.vertex_buffer()
-													   ->resource<gfx::graphics_backend::vulkan>()
-													   ->gpu_buffer(),
-													&b.second);
-					}
-
-					cmdBuffer.drawIndexed((uint32_t)geometryHandle->data()->indices().size(), instance_n, 0, 0, 0);
-				}
-			}
-		}
-	}
-}
@@ -165,6 +165,12 @@ bool geometry_t::compatible(const core::ivk::material_t& material) const noexcep
 }
 
 void geometry_t::bind(vk::CommandBuffer& buffer, const core::ivk::material_t& material) const noexcept {
+	bind(buffer, bindings(material));
+}
+
+geometry_t::bindings_t geometry_t::bindings(const core::ivk::material_t& material) const noexcept {
+	bindings_t result {};
+	result.vertexBuffer = m_GeometryBuffer->gpu_buffer();
 	for(const auto& stage : material.data()->stages()) {
 		for(const auto& attribute : stage.attributes()) {
 			if(!attribute.input_rate() || attribute.input_rate() != core::gfx::vertex_input_rate::vertex)
@@ -175,13 +181,26 @@ void geometry_t::bind(vk::CommandBuffer& buffer, const core::ivk::material_t& ma
 				  return binding.name == tag.data();
 			  });
 
-			auto offset = vk::DeviceSize {binding->segment.range().begin + binding->sub_range.begin};
-			buffer.bindVertexBuffers(attribute.location(), 1, &m_GeometryBuffer->gpu_buffer(), &offset);
+			// geometry without vertices has no stride, which also keeps it from being merged into indirect draws
+			result.vertices.emplace_back(
+			  vertex_binding_t {attribute.location(),
+								binding->segment.range().begin + binding->sub_range.begin,
+								(m_Vertices > 0) ? binding->sub_range.size() / m_Vertices : vk::DeviceSize {0}});
 		}
 	}
 
-	buffer.bindIndexBuffer(
-	  m_IndicesBuffer->gpu_buffer(), m_IndicesSegment.range().begin + m_IndicesSubRange.begin, INDEX_TYPE);
+	result.indexBuffer = m_IndicesBuffer->gpu_buffer();
+	result.indexOffset = m_IndicesSegment.range().begin + m_IndicesSubRange.begin;
+	result.indexType   = INDEX_TYPE;
+	return result;
+}
+
+void geometry_t::bind(vk::CommandBuffer& buffer, const bindings_t& bindings) noexcept {
+	for(const auto& vertex : bindings.vertices) {
+		buffer.bindVertexBuffers(vertex.location, 1, &bindings.vertexBuffer, &vertex.offset);
+	}
+
+	buffer.bindIndexBuffer(bindings.indexBuffer, bindings.indexOffset, bindings.indexType);
 }
 
 
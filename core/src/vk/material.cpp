@@ -15,6 +15,7 @@
 #include "core/vk/texture.hpp"
 
 #include "core/gfx/buffer.hpp"
+#include <algorithm>
 
 using namespace psl;
 using namespace core::ivk;
@@ -145,33 +146,54 @@ const std::vector<std::pair<uint32_t, core::resource::handle<core::ivk::sampler_
 
 core::resource::handle<pipeline> material_t::get(core::resource::handle<framebuffer_t> framebuffer) {
 	PROFILE_SCOPE(core::profiler)
-	if(auto it = m_Pipeline.find(framebuffer); it == std::end(m_Pipeline)) {
-		m_Pipeline[framebuffer] = m_PipelineCache->get(m_UID, m_Data, framebuffer);
-		return m_Pipeline[framebuffer];
-	} else {
-		return it->second;
-	}
+	const auto index = (framebuffer.resource_metadata()) ? framebuffer.resource_metadata()->index : size_t {0};
+	// indices are recycled once a resource is erased from the cache, so the UID has to match as well
+	auto it = std::find_if(std::begin(m_Pipeline), std::end(m_Pipeline), [&](const target_pipeline_t& target) {
+		return target.index == index && target.uid == framebuffer.uid();
+	});
+	if(it == std::end(m_Pipeline))
+		it = m_Pipeline.insert(
+		  it, target_pipeline_t {index, framebuffer.uid(), m_PipelineCache->get(m_UID, m_Data, framebuffer)});
+	return it->pipeline;
 }
 
 core::resource::handle<pipeline> material_t::get(core::resource::handle<swapchain> swapchain) {
 	PROFILE_SCOPE(core::profiler)
-	if(auto it = m_Pipeline.find(swapchain); it == std::end(m_Pipeline)) {
-		m_Pipeline[swapchain] = m_PipelineCache->get(m_UID, m_Data, swapchain);
-		return m_Pipeline[swapchain];
-	} else {
-		return it->second;
-	}
+	const auto index = (swapchain.resource_metadata()) ? swapchain.resource_metadata()->index : size_t {0};
+	auto it = std::find_if(std::begin(m_Pipeline), std::end(m_Pipeline), [&](const target_pipeline_t& target) {
+		return target.index == index && target.uid == swapchain.uid();
+	});
+	if(it == std::end(m_Pipeline))
+		it = m_Pipeline.insert(
+		  it, target_pipeline_t {index, swapchain.uid(), m_PipelineCache->get(m_UID, m_Data, swapchain)});
+	return it->pipeline;
 }
 
 bool material_t::bind_pipeline(vk::CommandBuffer cmdBuffer,
 							   core::resource::handle<framebuffer_t> framebuffer,
 							   uint32_t drawIndex) {
 	PROFILE_SCOPE(core::profiler)
-	m_Bound = get(framebuffer);
-	if(m_Bound->has_pushconstants()) {
-		cmdBuffer.pushConstants(m_Bound->vkLayout(), vk::ShaderStageFlagBits::eVertex, 0, sizeof(uint32_t), &drawIndex);
-	}
+	auto resolved = bindings(framebuffer);
+	if(!resolved)
+		return false;
+	bind(cmdBuffer, resolved.value(), drawIndex);
+	return true;
+}
+
+bool material_t::bind_pipeline(vk::CommandBuffer cmdBuffer,
+							   core::resource::handle<swapchain> swapchain,
+							   uint32_t drawIndex) {
+	PROFILE_SCOPE(core::profiler)
+	auto resolved = bindings(swapchain);
+	if(!resolved)
+		return false;
+	bind(cmdBuffer, resolved.value(), drawIndex);
+	return true;
+}
 
+std::optional<material_t::bindings_t> material_t::bindings(core::resource::handle<framebuffer_t> framebuffer) {
+	PROFILE_SCOPE(core::profiler)
+	m_Bound = get(framebuffer);
 	if(m_MaterialBufferRange.range().size() > 0) {
 		m_Bound->update(
 		  m_MaterialBufferBinding, m_MaterialBufferRange.range().begin, m_MaterialBufferRange.range().size());
@@ -181,30 +203,70 @@ bool material_t::bind_pipeline(vk::CommandBuffer cmdBuffer,
 		core::ivk::log->error(
 		  "tried to bind an incomplete or invalid pipeline, please inspect the logs around material {}",
 		  m_UID.to_string());
-		return false;
+		return std::nullopt;
 	}
 
-	return m_Bound->bind(cmdBuffer, m_DynamicOffsets);
+	return bindings_t {m_Bound->bind_point(),
+					   m_Bound->vkPipeline(),
+					   m_Bound->vkLayout(),
+					   *m_Bound->vkDescriptorSet(),
+					   m_DynamicOffsets,
+					   m_Bound->has_pushconstants()};
 }
 
-bool material_t::bind_pipeline(vk::CommandBuffer cmdBuffer,
-							   core::resource::handle<swapchain> swapchain,
-							   uint32_t drawIndex) {
+std::optional<material_t::bindings_t> material_t::bindings(core::resource::handle<swapchain> swapchain) {
 	PROFILE_SCOPE(core::profiler)
 	m_Bound = get(swapchain);
-	if(m_Bound->has_pushconstants()) {
-		cmdBuffer.pushConstants(m_Bound->vkLayout(), vk::ShaderStageFlagBits::eVertex, 0, sizeof(uint32_t), &drawIndex);
-	}
-
 	if(!m_Bound->is_complete()) {
 		core::ivk::log->error(
 		  "tried to bind an incomplete or invalid pipeline, please inspect the logs around material {}",
 		  m_UID.to_string());
-		return false;
+		return std::nullopt;
 	}
 
+	return bindings_t {m_Bound->bind_point(),
+					   m_Bound->vkPipeline(),
+					   m_Bound->vkLayout(),
+					   *m_Bound->vkDescriptorSet(),
+					   m_DynamicOffsets,
+					   m_Bound->has_pushconstants()};
+}
+
+void material_t::bind(vk::CommandBuffer cmdBuffer, const bindings_t& bindings, uint32_t drawIndex) {
+	if(bindings.pushConstants) {
+		cmdBuffer.pushConstants(bindings.layout, vk::ShaderStageFlagBits::eVertex, 0, sizeof(uint32_t), &drawIndex);
+	}
+
+	cmdBuffer.bindPipeline(bindings.bindPoint, bindings.pipeline);
+	cmdBuffer.bindDescriptorSets(bindings.bindPoint,
+								 bindings.layout,
+								 0,
+								 1,
+								 &bindings.descriptorSet,
+								 static_cast<uint32_t>(bindings.dynamicOffsets.size()),
+								 bindings.dynamicOffsets.data());
+}
+
+void material_t::bind(vk::CommandBuffer cmdBuffer,
+					  const bindings_t& bindings,
+					  const bindings_t& previous,
+					  uint32_t drawIndex) {
+	if(bindings.pushConstants && (!previous.pushConstants || bindings.layout != previous.layout)) {
+		cmdBuffer.pushConstants(bindings.layout, vk::ShaderStageFlagBits::eVertex, 0, sizeof(uint32_t), &drawIndex);
+	}
 
-	return m_Bound->bind(cmdBuffer, m_DynamicOffsets);
+	if(bindings.bindPoint != previous.bindPoint || bindings.pipeline != previous.pipeline)
+		cmdBuffer.bindPipeline(bindings.bindPoint, bindings.pipeline);
+	if(bindings.bindPoint != previous.bindPoint || bindings.layout != previous.layout ||
+	   bindings.descriptorSet != previous.descriptorSet || bindings.dynamicOffsets != previous.dynamicOffsets) {
+		cmdBuffer.bindDescriptorSets(bindings.bindPoint,
+									 bindings.layout,
+									 0,
+									 1,
+									 &bindings.descriptorSet,
+									 static_cast<uint32_t>(bindings.dynamicOffsets.size()),
+									 bindings.dynamicOffsets.data());
+	}
 }
 
 void material_t::bind_material_instance_data(core::resource::handle<core::ivk::buffer_t> buffer,
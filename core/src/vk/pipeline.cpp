@@ -7,16 +7,19 @@
 #include "core/vk/buffer.hpp"
 #include "core/vk/context.hpp"
 #include "core/vk/conversion.hpp"
+#include "core/vk/descriptor_allocator.hpp"
 #include "core/vk/sampler.hpp"
 #include "core/vk/shader.hpp"
 #include "core/vk/texture.hpp"
 
 #include "core/gfx/buffer.hpp"
+#include "psl/utility/hash.hpp"
 
 using namespace psl;
 using namespace core::gfx;
 using namespace core::ivk;
 using namespace core::resource;
+using psl::utility::hash_combine;
 
 inline size_t get_aligned(const core::ivk::context& context, vk::DescriptorType flags, size_t value) {
 	auto alignment = (vk::DescriptorType::eUniformBuffer == flags || vk::DescriptorType::eUniformBufferDynamic == flags)
@@ -108,268 +111,289 @@ bool decode(core::resource::cache_t& cache,
 	return true;
 }
 
+std::optional<details::pipeline_state> details::pipeline_state::resolve(core::resource::cache_t& cache,
+																		  const core::data::material_t& data,
+																		  vk::RenderPass renderPass,
+																		  uint32_t attachmentCount) {
+	pipeline_state state {};
+	if(!decode(cache, data, state.m_LayoutBindings) ||
+	   !decode(cache, data, state.m_VertexBindings, state.m_VertexAttributes))
+		return std::nullopt;
 
-pipeline::pipeline(core::resource::cache_t& cache,
-				   const core::resource::metadata& metaData,
-				   psl::meta::file* metaFile,
-				   core::resource::handle<core::ivk::context> context,
-				   core::resource::handle<core::data::material_t> data,
-				   vk::PipelineCache& pipelineCache,
-				   vk::RenderPass renderPass,
-				   uint32_t attachmentCount)
-	: m_Context(context), m_PipelineCache(pipelineCache), m_Cache(cache) {
-	std::vector<vk::DescriptorSetLayoutBinding> layoutBinding;
-	if(!decode(cache, data.value(), layoutBinding)) {
-		core::ivk::log->error("fatal error happened during the creation of pipeline {}", metaData.uid.to_string());
-		m_IsValid = false;
-		return;
+	for(const auto& stage : data.stages()) {
+		if(stage.shader_stage() == core::gfx::shader_stage::compute)
+			state.m_BindPoint = vk::PipelineBindPoint::eCompute;
+
+		auto shader_handle = cache.find<core::ivk::shader>(stage.shader());
+		if((shader_handle.state() != core::resource::status::loaded) || !shader_handle->pipeline()) {
+			core::ivk::log->error("could not load the shader used in the creation of a pipeline");
+			return std::nullopt;
+		}
+		state.m_Stages.push_back(shader_handle->pipeline().value());
+		state.m_Shaders.emplace_back(std::move(shader_handle));
 	}
 
-	vk::DescriptorSetLayoutCreateInfo descriptorLayout;
-	descriptorLayout.pNext		  = nullptr;
-	descriptorLayout.bindingCount = (uint32_t)layoutBinding.size();
-	descriptorLayout.pBindings	  = layoutBinding.data();
+	state.m_RenderPass		= renderPass;
+	state.m_AttachmentCount = attachmentCount;
+	state.m_Wireframe		= data.wireframe();
+	state.m_CullMode		= conversion::to_vk(data.cull_mode());
+	state.m_DepthTest		= data.depth_test();
+	state.m_DepthWrite		= data.depth_write();
+
+	state.m_BlendAttachments.resize(attachmentCount);
+	const auto& blendState = data.blend_states();
+	core::data::material_t::blendstate def_state;
+	for(size_t i = 0; i < attachmentCount; ++i) {
+		// fill in the remaining with the default blend state;
+		const auto& blend = (i < blendState.size()) ? blendState[i] : def_state;
+		auto& attachment  = state.m_BlendAttachments[i];
+
+		attachment.blendEnable	  = blend.enabled();
+		attachment.colorWriteMask = conversion::to_vk(blend.color_components());
+		if(attachment.blendEnable) {
+			attachment.srcColorBlendFactor = conversion::to_vk(blend.color_blend_src());
+			attachment.dstColorBlendFactor = conversion::to_vk(blend.color_blend_dst());
+			attachment.colorBlendOp		   = conversion::to_vk(blend.color_blend_op());
+
+			attachment.srcAlphaBlendFactor = conversion::to_vk(blend.alpha_blend_src());
+			attachment.dstAlphaBlendFactor = conversion::to_vk(blend.alpha_blend_dst());
+			attachment.alphaBlendOp		   = conversion::to_vk(blend.alpha_blend_op());
+		}
+	}
 
-	utility::vulkan::check(
-	  m_Context->device().createDescriptorSetLayout(&descriptorLayout, nullptr, &m_DescriptorSetLayout));
+	// structural hash, the bound resources (textures, buffers) are not part of the compiled pipeline
+	uint64_t seed {0};
+	hash_combine(seed, static_cast<uint64_t>(state.m_BindPoint));
+	for(const auto& stage : data.stages()) hash_combine(seed, std::hash<psl::UID> {}(stage.shader()));
+	for(const auto& binding : state.m_LayoutBindings) {
+		hash_combine(seed, static_cast<uint64_t>(binding.descriptorType));
+		hash_combine(seed, binding.binding);
+		hash_combine(seed, static_cast<VkShaderStageFlags>(binding.stageFlags));
+	}
+	for(const auto& binding : state.m_VertexBindings) {
+		hash_combine(seed, binding.binding);
+		hash_combine(seed, binding.stride);
+		hash_combine(seed, static_cast<uint64_t>(binding.inputRate));
+	}
+	for(const auto& attribute : state.m_VertexAttributes) {
+		hash_combine(seed, attribute.location);
+		hash_combine(seed, static_cast<uint64_t>(attribute.format));
+		hash_combine(seed, attribute.offset);
+	}
+	if(state.m_BindPoint == vk::PipelineBindPoint::eGraphics) {
+		hash_combine(seed, (uint64_t)renderPass.operator VkRenderPass());
+		hash_combine(seed, attachmentCount);
+		hash_combine(seed, state.m_Wireframe);
+		hash_combine(seed, static_cast<VkCullModeFlags>(state.m_CullMode));
+		hash_combine(seed, state.m_DepthTest);
+		hash_combine(seed, state.m_DepthWrite);
+		for(const auto& attachment : state.m_BlendAttachments) {
+			hash_combine(seed, attachment.blendEnable);
+			hash_combine(seed, static_cast<VkColorComponentFlags>(attachment.colorWriteMask));
+			if(!attachment.blendEnable)
+				continue;
+			hash_combine(seed, static_cast<uint64_t>(attachment.srcColorBlendFactor));
+			hash_combine(seed, static_cast<uint64_t>(attachment.dstColorBlendFactor));
+			hash_combine(seed, static_cast<uint64_t>(attachment.colorBlendOp));
+			hash_combine(seed, static_cast<uint64_t>(attachment.srcAlphaBlendFactor));
+			hash_combine(seed, static_cast<uint64_t>(attachment.dstAlphaBlendFactor));
+			hash_combine(seed, static_cast<uint64_t>(attachment.alphaBlendOp));
+		}
+	}
+	state.m_Hash = seed;
+	return state;
+}
 
+bool details::pipeline_state::create_layout(const vk::Device& device,
+											vk::DescriptorSetLayout& descriptorSetLayout,
+											vk::PipelineLayout& pipelineLayout) const {
+	vk::DescriptorSetLayoutCreateInfo descriptorLayout;
+	descriptorLayout.pNext		  = nullptr;
+	descriptorLayout.bindingCount = (uint32_t)m_LayoutBindings.size();
+	descriptorLayout.pBindings	  = m_LayoutBindings.data();
 
-	vk::PipelineVertexInputStateCreateInfo VertexInputState;
-	std::vector<vk::VertexInputBindingDescription> vertexBindingDescriptions;
-	std::vector<vk::VertexInputAttributeDescription> vertexAttributeDescriptions;
-	if(!decode(cache, data.value(), vertexBindingDescriptions, vertexAttributeDescriptions)) {
-		core::ivk::log->error("fatal error happened during the creation of pipeline {}", metaData.uid.to_string());
-		m_IsValid = false;
-		return;
-	}
+	if(!utility::vulkan::check(device.createDescriptorSetLayout(&descriptorLayout, nullptr, &descriptorSetLayout)))
+		return false;
 
-	// Assign to vertex input state
-	VertexInputState.flags							 = vk::PipelineVertexInputStateCreateFlags();
-	VertexInputState.vertexBindingDescriptionCount	 = (uint32_t)vertexBindingDescriptions.size();
-	VertexInputState.pVertexBindingDescriptions		 = vertexBindingDescriptions.data();
-	VertexInputState.vertexAttributeDescriptionCount = (uint32_t)vertexAttributeDescriptions.size();
-	VertexInputState.pVertexAttributeDescriptions	 = vertexAttributeDescriptions.data();
+	return create_pipeline_layout(device, descriptorSetLayout, pipelineLayout);
+}
 
+bool details::pipeline_state::create_pipeline_layout(const vk::Device& device,
+													 vk::DescriptorSetLayout descriptorSetLayout,
+													 vk::PipelineLayout& pipelineLayout) const {
 	vk::PipelineLayoutCreateInfo pPipelineLayoutCreateInfo;
 	pPipelineLayoutCreateInfo.pNext			 = NULL;
 	pPipelineLayoutCreateInfo.setLayoutCount = 1;
-	pPipelineLayoutCreateInfo.pSetLayouts	 = &m_DescriptorSetLayout;
+	pPipelineLayoutCreateInfo.pSetLayouts	 = &descriptorSetLayout;
 
-	psl::string_view global = "GLOBAL_";
+	return utility::vulkan::check(device.createPipelineLayout(&pPipelineLayoutCreateInfo, nullptr, &pipelineLayout));
+}
 
-	// todo: this should be removed in favour of a generic check for push_constants in the shader meta
-	for(const auto& stage : data.value().stages()) {
-		if(stage.shader_stage() == core::gfx::shader_stage::compute)
-			m_BindPoint = vk::PipelineBindPoint::eCompute;
+std::optional<vk::Pipeline> details::pipeline_state::compile(const vk::Device& device,
+															 vk::PipelineCache pipelineCache,
+															 vk::PipelineLayout layout) const {
+	if(m_BindPoint == vk::PipelineBindPoint::eCompute) {
+		psl_assert(
+		  m_Stages.size() == 1, "expecting only a single compute in the shader stages, but got {}", m_Stages.size());
 
-		for(auto& binding : stage.bindings()) {
-			if(binding.descriptor() == core::gfx::binding_type::uniform_buffer) {
-				// todo: this is a hardcoded setup, brittle and needs to be removed
-				/*if(cache.library().has_tag(binding.buffer(), "GLOBAL_WORLD_VIEW_PROJECTION_MATRIX"))
-				{
-					vk::PushConstantRange pushConstantRange;
-					pushConstantRange.offset = 0;
-					pushConstantRange.setSize(sizeof(uint32_t));
-					pushConstantRange.setStageFlags(vk::ShaderStageFlagBits::eVertex);
-
-					pPipelineLayoutCreateInfo.pushConstantRangeCount = 1;
-					pPipelineLayoutCreateInfo.pPushConstantRanges	 = &pushConstantRange;
-					m_HasPushConstants								 = true;
-					break;
-				}*/
-			}
-		}
+		vk::ComputePipelineCreateInfo pipelineCreateInfo {};
+		pipelineCreateInfo.layout = layout;
+		pipelineCreateInfo.stage  = m_Stages[0];
+
+		vk::Pipeline pipeline;
+		if(!utility::vulkan::check(
+			 device.createComputePipelines(pipelineCache, 1, &pipelineCreateInfo, nullptr, &pipeline)))
+			return std::nullopt;
+		return pipeline;
 	}
 
+	vk::GraphicsPipelineCreateInfo pipelineCreateInfo {};
+	// The layout used for this pipeline
+	pipelineCreateInfo.layout = layout;
+	// Renderpass this pipeline is attached to
+	pipelineCreateInfo.renderPass = m_RenderPass;
 
+	pipelineCreateInfo.stageCount = (uint32_t)m_Stages.size();
+	pipelineCreateInfo.pStages	  = m_Stages.data();
+
+	// Vertex input state
+	vk::PipelineVertexInputStateCreateInfo VertexInputState;
+	VertexInputState.flags							 = vk::PipelineVertexInputStateCreateFlags();
+	VertexInputState.vertexBindingDescriptionCount	 = (uint32_t)m_VertexBindings.size();
+	VertexInputState.pVertexBindingDescriptions		 = m_VertexBindings.data();
+	VertexInputState.vertexAttributeDescriptionCount = (uint32_t)m_VertexAttributes.size();
+	VertexInputState.pVertexAttributeDescriptions	 = m_VertexAttributes.data();
+
+	// Describes the topoloy used with this pipeline
+	vk::PipelineInputAssemblyStateCreateInfo inputAssemblyState;
+	// This pipeline renders vertex data as triangle lists
+	inputAssemblyState.topology = vk::PrimitiveTopology::eTriangleList;
+
+	// Rasterization state
+	vk::PipelineRasterizationStateCreateInfo rasterizationState;
+	rasterizationState.polygonMode			   = (m_Wireframe) ? vk::PolygonMode::eLine : vk::PolygonMode::eFill;
+	rasterizationState.cullMode				   = m_CullMode;
+	rasterizationState.frontFace			   = vk::FrontFace::eCounterClockwise;	  // default winding
+	rasterizationState.depthClampEnable		   = VK_FALSE;
+	rasterizationState.rasterizerDiscardEnable = VK_FALSE;
+	rasterizationState.depthBiasEnable		   = VK_FALSE;
+	rasterizationState.lineWidth			   = 1.0f;
+
+	// Color blend state
+	// Describes blend modes and color masks
+	vk::PipelineColorBlendStateCreateInfo colorBlendState;
+	colorBlendState.attachmentCount = m_AttachmentCount;
+	colorBlendState.pAttachments	= m_BlendAttachments.data();
+
+	// Viewport state
+	vk::PipelineViewportStateCreateInfo viewportState;
+	// One viewport
+	viewportState.viewportCount = 1;
+	// One scissor rectangle
+	viewportState.scissorCount = 1;
+
+	// Enable dynamic states
+	// Describes the dynamic states to be used with this pipeline
+	// Dynamic states can be set even after the pipeline has been created
+	// So there is no need to create new pipelines just for changing
+	// a viewport's dimensions or a scissor box
+	// The dynamic state properties themselves are stored in the command buffer
+	std::array<vk::DynamicState, 3> dynamicStateEnables {
+	  vk::DynamicState::eViewport, vk::DynamicState::eScissor, vk::DynamicState::eDepthBias};
+
+	vk::PipelineDynamicStateCreateInfo dynamicState;
+	dynamicState.pDynamicStates	   = dynamicStateEnables.data();
+	dynamicState.dynamicStateCount = (uint32_t)dynamicStateEnables.size();
+
+	// Depth and stencil state
+	// Describes depth and stenctil test and compare ops
+	vk::PipelineDepthStencilStateCreateInfo depthStencilState;
+	// Basic depth compare setup with depth writes and depth test enabled
+	// No stencil used
+	depthStencilState.depthTestEnable		= m_DepthTest;
+	depthStencilState.depthWriteEnable		= m_DepthWrite;
+	depthStencilState.depthCompareOp		= vk::CompareOp::eLessOrEqual;
+	depthStencilState.depthBoundsTestEnable = VK_FALSE;
+	depthStencilState.back.failOp			= vk::StencilOp::eKeep;
+	depthStencilState.back.passOp			= vk::StencilOp::eKeep;
+	depthStencilState.back.compareOp		= vk::CompareOp::eAlways;
+	depthStencilState.stencilTestEnable		= VK_FALSE;
+	depthStencilState.front					= depthStencilState.back;
+
+	// Multi sampling state
+	vk::PipelineMultisampleStateCreateInfo multisampleState;
+	multisampleState.pSampleMask = NULL;
+	// todo: deal with multi sampling
+	multisampleState.rasterizationSamples = vk::SampleCountFlagBits::e1;
+
+	// Assign states
+	// Assign pipeline state create information
+	pipelineCreateInfo.pVertexInputState   = &VertexInputState;
+	pipelineCreateInfo.pInputAssemblyState = &inputAssemblyState;
+	pipelineCreateInfo.pRasterizationState = &rasterizationState;
+	pipelineCreateInfo.pColorBlendState	   = &colorBlendState;
+	pipelineCreateInfo.pMultisampleState   = &multisampleState;
+	pipelineCreateInfo.pViewportState	   = &viewportState;
+	pipelineCreateInfo.pDepthStencilState  = &depthStencilState;
+	pipelineCreateInfo.pDynamicState	   = &dynamicState;
+
+	// Create rendering pipeline
+	vk::Pipeline pipeline;
 	if(!utility::vulkan::check(
-		 m_Context->device().createPipelineLayout(&pPipelineLayoutCreateInfo, nullptr, &m_PipelineLayout))) {
-		core::ivk::log->error("fatal error happened during the creation of a pipeline");
+		 device.createGraphicsPipelines(pipelineCache, 1, &pipelineCreateInfo, nullptr, &pipeline)))
+		return std::nullopt;
+	return pipeline;
+}
+
+pipeline::pipeline(core::resource::cache_t& cache,
+				   const core::resource::metadata& metaData,
+				   psl::meta::file* metaFile,
+				   core::resource::handle<core::ivk::context> context,
+				   core::resource::handle<core::data::material_t> data,
+				   vk::PipelineCache& pipelineCache,
+				   vk::RenderPass renderPass,
+				   uint32_t attachmentCount)
+	: m_Context(context), m_PipelineCache(pipelineCache), m_Cache(cache) {
+	auto state = details::pipeline_state::resolve(cache, data.value(), renderPass, attachmentCount);
+	if(!state) {
+		core::ivk::log->error("fatal error happened during the creation of pipeline {}", metaData.uid.to_string());
 		m_IsValid = false;
 		return;
 	}
+	m_BindPoint = state->bind_point();
 
+	// todo: push constants should be detected from the shader meta, see has_pushconstants()
 
-	// Load shaders
-	// Shaders are loaded from the SPIR-V format, which can be generated from glsl
-	std::vector<vk::PipelineShaderStageCreateInfo> shaderStages;
-	for(auto& stage : data->stages()) {
-		auto shader_handle = cache.find<core::ivk::shader>(stage.shader());
-		if((shader_handle.state() == core::resource::status::loaded) && shader_handle->pipeline()) {
-			shaderStages.push_back(shader_handle->pipeline().value());
-		} else {
-			core::ivk::log->error("could not load the shader used in the creation of a pipeline");
-			m_IsValid = false;
-			return;
-		}
+	// the descriptor set layout is shared between all pipelines with identical bindings
+	m_DescriptorSetLayout = m_Context->descriptors().layout(state->layout_bindings());
+	if(!m_DescriptorSetLayout ||
+	   !state->create_pipeline_layout(m_Context->device(), m_DescriptorSetLayout, m_PipelineLayout)) {
+		core::ivk::log->error("fatal error happened during the creation of a pipeline");
+		m_IsValid = false;
+		return;
 	}
 
 	core::ivk::log->info("creating a pipeline layout with a {} bindpoint",
 						 ((m_BindPoint == vk::PipelineBindPoint::eCompute) ? "compute" : "graphics"));
 
-	if(m_BindPoint == vk::PipelineBindPoint::eCompute) {
-		psl_assert(shaderStages.size() == 1,
-				   "expecting only a single compute in the shader stages, but got {}",
-				   shaderStages.size());
-
-		vk::ComputePipelineCreateInfo pipelineCreateInfo {};
-		pipelineCreateInfo.layout = m_PipelineLayout;
-		pipelineCreateInfo.stage  = shaderStages[0];
-
-		if(auto pipeline = m_Context->device().createComputePipeline(m_PipelineCache, pipelineCreateInfo);
-		   utility::vulkan::check(pipeline)) {
-			m_Pipeline = pipeline.value;
-		} else {
-			core::ivk::log->error("failed to create a compute pipeline");
-			m_IsValid = false;
-			return;
-		}
+	if(auto pipeline = state->compile(m_Context->device(), m_PipelineCache, m_PipelineLayout); pipeline) {
+		m_Pipeline = pipeline.value();
+	} else if(m_BindPoint == vk::PipelineBindPoint::eCompute) {
+		core::ivk::log->error("failed to create a compute pipeline");
+		m_IsValid = false;
+		return;
 	} else {
-		vk::GraphicsPipelineCreateInfo pipelineCreateInfo {};
-		// The layout used for this pipeline
-		pipelineCreateInfo.layout = m_PipelineLayout;
-		// Renderpass this pipeline is attached to
-		pipelineCreateInfo.renderPass = renderPass;
-
-		pipelineCreateInfo.stageCount = (uint32_t)shaderStages.size();
-		pipelineCreateInfo.pStages	  = shaderStages.data();
-
-		// Vertex input state
-		// Describes the topoloy used with this pipeline
-		vk::PipelineInputAssemblyStateCreateInfo inputAssemblyState;
-		// This pipeline renders vertex data as triangle lists
-		inputAssemblyState.topology = vk::PrimitiveTopology::eTriangleList;
-
-		// Rasterization state
-		vk::PipelineRasterizationStateCreateInfo rasterizationState;
-		rasterizationState.polygonMode		= (data->wireframe()) ? vk::PolygonMode::eLine : vk::PolygonMode::eFill;
-		rasterizationState.cullMode			= conversion::to_vk(data->cull_mode());
-		rasterizationState.frontFace		= vk::FrontFace::eCounterClockwise;	   // default winding
-		rasterizationState.depthClampEnable = VK_FALSE;
-		rasterizationState.rasterizerDiscardEnable = VK_FALSE;
-		rasterizationState.depthBiasEnable		   = VK_FALSE;
-		rasterizationState.lineWidth			   = 1.0f;
-
-		// Color blend state
-		// Describes blend modes and color masks
-		vk::PipelineColorBlendStateCreateInfo colorBlendState;
-
-		// One blend attachment state
-		// Blending is not used in this example
-		std::vector<vk::PipelineColorBlendAttachmentState> blendAttachmentState;
-		blendAttachmentState.resize(attachmentCount);
-
-		const auto& blendState = data->blend_states();
-
-		for(size_t i = 0; i < std::min(blendState.size(), (size_t)attachmentCount); ++i) {
-			blendAttachmentState[i].blendEnable	   = blendState[i].enabled();
-			blendAttachmentState[i].colorWriteMask = conversion::to_vk(blendState[i].color_components());
-			if(blendAttachmentState[i].blendEnable) {
-				blendAttachmentState[i].srcColorBlendFactor = conversion::to_vk(blendState[i].color_blend_src());
-				blendAttachmentState[i].dstColorBlendFactor = conversion::to_vk(blendState[i].color_blend_dst());
-				blendAttachmentState[i].colorBlendOp		= conversion::to_vk(blendState[i].color_blend_op());
-
-				blendAttachmentState[i].srcAlphaBlendFactor = conversion::to_vk(blendState[i].alpha_blend_src());
-				blendAttachmentState[i].dstAlphaBlendFactor = conversion::to_vk(blendState[i].alpha_blend_dst());
-				blendAttachmentState[i].alphaBlendOp		= conversion::to_vk(blendState[i].alpha_blend_op());
-			}
-		}
-
-		// fill in the remaining with the default blend state;
-		core::data::material_t::blendstate def_state;
-		for(size_t i = blendState.size(); i < attachmentCount; ++i) {
-			blendAttachmentState[i].blendEnable	   = def_state.enabled();
-			blendAttachmentState[i].colorWriteMask = conversion::to_vk(def_state.color_components());
-			if(blendAttachmentState[i].blendEnable) {
-				blendAttachmentState[i].srcColorBlendFactor = conversion::to_vk(def_state.color_blend_src());
-				blendAttachmentState[i].dstColorBlendFactor = conversion::to_vk(def_state.color_blend_dst());
-				blendAttachmentState[i].colorBlendOp		= conversion::to_vk(def_state.color_blend_op());
-
-				blendAttachmentState[i].srcAlphaBlendFactor = conversion::to_vk(def_state.alpha_blend_src());
-				blendAttachmentState[i].dstAlphaBlendFactor = conversion::to_vk(def_state.alpha_blend_dst());
-				blendAttachmentState[i].alphaBlendOp		= conversion::to_vk(def_state.alpha_blend_op());
-			}
-		}
-		colorBlendState.attachmentCount = attachmentCount;
-		colorBlendState.pAttachments	= blendAttachmentState.data();
-
-		// Viewport state
-		vk::PipelineViewportStateCreateInfo viewportState;
-		// One viewport
-		viewportState.viewportCount = 1;
-		// One scissor rectangle
-		viewportState.scissorCount = 1;
-
-		// Enable dynamic states
-		// Describes the dynamic states to be used with this pipeline
-		// Dynamic states can be set even after the pipeline has been created
-		// So there is no need to create new pipelines just for changing
-		// a viewport's dimensions or a scissor box
-		// The dynamic state properties themselves are stored in the command buffer
-		std::vector<vk::DynamicState> dynamicStateEnables;
-		dynamicStateEnables.push_back(vk::DynamicState::eViewport);
-		dynamicStateEnables.push_back(vk::DynamicState::eScissor);
-		dynamicStateEnables.push_back(vk::DynamicState::eDepthBias);
-
-		vk::PipelineDynamicStateCreateInfo dynamicState;
-		dynamicState.pDynamicStates	   = dynamicStateEnables.data();
-		dynamicState.dynamicStateCount = (uint32_t)dynamicStateEnables.size();
-
-		// Depth and stencil state
-		// Describes depth and stenctil test and compare ops
-		vk::PipelineDepthStencilStateCreateInfo depthStencilState;
-		// Basic depth compare setup with depth writes and depth test enabled
-		// No stencil used
-		depthStencilState.depthTestEnable		= data->depth_test();
-		depthStencilState.depthWriteEnable		= data->depth_write();
-		depthStencilState.depthCompareOp		= vk::CompareOp::eLessOrEqual;
-		depthStencilState.depthBoundsTestEnable = VK_FALSE;
-		depthStencilState.back.failOp			= vk::StencilOp::eKeep;
-		depthStencilState.back.passOp			= vk::StencilOp::eKeep;
-		depthStencilState.back.compareOp		= vk::CompareOp::eAlways;
-		depthStencilState.stencilTestEnable		= VK_FALSE;
-		depthStencilState.front					= depthStencilState.back;
-
-		// Multi sampling state
-		vk::PipelineMultisampleStateCreateInfo multisampleState;
-		multisampleState.pSampleMask = NULL;
-		// todo: deal with multi sampling
-		multisampleState.rasterizationSamples = vk::SampleCountFlagBits::e1;
-
-
-		// Assign states
-		// Assign pipeline state create information
-		pipelineCreateInfo.pVertexInputState   = &VertexInputState;
-		pipelineCreateInfo.pInputAssemblyState = &inputAssemblyState;
-		pipelineCreateInfo.pRasterizationState = &rasterizationState;
-		pipelineCreateInfo.pColorBlendState	   = &colorBlendState;
-		pipelineCreateInfo.pMultisampleState   = &multisampleState;
-		pipelineCreateInfo.pViewportState	   = &viewportState;
-		pipelineCreateInfo.pDepthStencilState  = &depthStencilState;
-		pipelineCreateInfo.renderPass		   = renderPass;
-		pipelineCreateInfo.pDynamicState	   = &dynamicState;
-
-		// Create rendering pipeline
-		if(!utility::vulkan::check(m_Context->device().createGraphicsPipelines(
-			 m_PipelineCache, 1, &pipelineCreateInfo, nullptr, &m_Pipeline))) {
-			debug_break();
-		}
+		debug_break();
 	}
-	vk::DescriptorSetAllocateInfo allocInfo;
-	allocInfo.descriptorSetCount = 1;
-	allocInfo.pSetLayouts		 = &m_DescriptorSetLayout;
-	allocInfo.descriptorPool	 = m_Context->descriptor_pool();
-
-	utility::vulkan::check(m_Context->device().allocateDescriptorSets(&allocInfo, &m_DescriptorSet));
 
-
-	update(m_Cache, data.value(), m_DescriptorSet);
+	update(m_Cache, data.value());
 }
 
 pipeline::~pipeline() {
+	if(m_DescriptorSet)
+		m_Context->descriptors().release(m_DescriptorSet);
 	m_Context->device().destroyPipeline(m_Pipeline, nullptr);
 	m_Context->device().destroyPipelineLayout(m_PipelineLayout, nullptr);
-	m_Context->device().destroyDescriptorSetLayout(m_DescriptorSetLayout, nullptr);
 }
 
 inline size_t get_range(const core::ivk::context& context,
@@ -386,7 +410,7 @@ inline size_t get_range(const core::ivk::context& context,
 	return get_aligned(context, conversion::to_vk(binding.descriptor()), fallback);
 }
 
-bool pipeline::update(core::resource::cache_t& cache, const core::data::material_t& data, vk::DescriptorSet set) {
+bool pipeline::update(core::resource::cache_t& cache, const core::data::material_t& data) {
 	m_IsComplete = true;
 	for(const auto& stage : data.stages()) {
 		auto shader_handle = cache.find<core::ivk::shader>(stage.shader());
@@ -417,7 +441,6 @@ bool pipeline::update(core::resource::cache_t& cache, const core::data::material
 
 					vk::WriteDescriptorSet writeDescriptorSet {};
 					writeDescriptorSet.pNext		   = nullptr;
-					writeDescriptorSet.dstSet		   = set;
 					writeDescriptorSet.descriptorType  = vk::DescriptorType::eCombinedImageSampler;
 					writeDescriptorSet.dstBinding	   = binding.binding_slot();
 					writeDescriptorSet.pImageInfo	   = &tex_handle->descriptor(binding.sampler());
@@ -432,7 +455,6 @@ bool pipeline::update(core::resource::cache_t& cache, const core::data::material
 				case core::gfx::binding_type::uniform_buffer_dynamic: {
 					auto& writeDescriptorSet		  = m_DescriptorSets.emplace_back();
 					writeDescriptorSet.pNext		  = NULL;
-					writeDescriptorSet.dstSet		  = set;
 					writeDescriptorSet.descriptorType = conversion::to_vk(binding.descriptor());
 					writeDescriptorSet.dstBinding	  = binding.binding_slot();
 					writeDescriptorSet.pImageInfo	  = nullptr;
@@ -491,11 +513,22 @@ bool pipeline::update(core::resource::cache_t& cache, const core::data::material
 	}
 
 	if(m_IsComplete)
-		m_Context->device().updateDescriptorSets(
-		  static_cast<uint32_t>(m_DescriptorSets.size()), m_DescriptorSets.data(), 0, nullptr);
+		commit();
 	return m_IsComplete;
 }
 
+void pipeline::commit() {
+	// the previous set might still be in use by the GPU, so it is never rewritten. The allocator either hands out a
+	// set with identical contents, or a fresh one, and recycles the previous set once it is no longer in flight.
+	auto set = m_Context->descriptors().acquire(m_DescriptorSetLayout, m_DescriptorSets);
+	if(set != m_DescriptorSet)
+		++m_Generation;
+	if(m_DescriptorSet)
+		m_Context->descriptors().release(m_DescriptorSet);
+	m_DescriptorSet = set;
+	for(auto& descriptor : m_DescriptorSets) descriptor.dstSet = m_DescriptorSet;
+}
+
 bool pipeline::update(uint32_t bindingLocation, vk::WriteDescriptorSet descriptor) {
 	for(auto& set : m_DescriptorSets) {
 		if(set.dstBinding == bindingLocation) {
@@ -503,10 +536,9 @@ bool pipeline::update(uint32_t bindingLocation, vk::WriteDescriptorSet descripto
 				LOG_ERROR("Tried to set a DescriptorSet of the wrong type");
 				return false;
 			}
-			set		   = descriptor;
-			set.dstSet = m_DescriptorSet;
-			m_Context->device().updateDescriptorSets(
-			  static_cast<uint32_t>(m_DescriptorSets.size()), m_DescriptorSets.data(), 0, nullptr);
+			set = descriptor;
+			if(completeness_check())
+				commit();
 			return true;
 		}
 	}
@@ -535,8 +567,8 @@ bool pipeline::update(uint32_t bindingLocation, const UID& textureMeta, const UI
 				}
 
 				set.pImageInfo = &tex_handle->descriptor(samplerMeta);
-				m_Context->device().updateDescriptorSets(
-				  static_cast<uint32_t>(m_DescriptorSets.size()), m_DescriptorSets.data(), 0, nullptr);
+				if(completeness_check())
+					commit();
 				return true;
 			} break;
 			default:
@@ -558,20 +590,25 @@ bool pipeline::update(uint32_t bindingLocation, vk::DeviceSize offset, vk::Devic
 			case vk::DescriptorType::eUniformBuffer:
 			case vk::DescriptorType::eUniformBufferDynamic:
 			case vk::DescriptorType::eStorageBufferDynamic: {
+				range = get_aligned(m_Context.value(), set.descriptorType, range);
+				// this is called every time the material gets bound, so only changes should acquire a new set
+				if(set.pBufferInfo->offset == offset && set.pBufferInfo->range == range)
+					return true;
+
 				auto bufferInfo = std::make_unique<vk::DescriptorBufferInfo>();
 				auto oldbuffer	= set.pBufferInfo;
 
 				bufferInfo->buffer = set.pBufferInfo->buffer;
 				bufferInfo->offset = offset;
-				bufferInfo->range  = get_aligned(m_Context.value(), set.descriptorType, range);
+				bufferInfo->range  = range;
 				set.pBufferInfo	   = bufferInfo.get();
 
-				m_Context->device().updateDescriptorSets(
-				  static_cast<uint32_t>(m_DescriptorSets.size()), m_DescriptorSets.data(), 0, nullptr);
-
 				*std::find_if(std::begin(m_TrackedBufferInfos),
 							  std::end(m_TrackedBufferInfos),
 							  [oldbuffer](const auto& ptr) { return oldbuffer == ptr.get(); }) = std::move(bufferInfo);
+
+				if(m_IsComplete)
+					commit();
 				return true;
 			} break;
 			default:
@@ -597,23 +634,25 @@ bool pipeline::unsafe_update(uint32_t bindingLocation,
 			case vk::DescriptorType::eUniformBuffer:
 			case vk::DescriptorType::eUniformBufferDynamic:
 			case vk::DescriptorType::eStorageBufferDynamic: {
+				range = get_aligned(m_Context.value(), set.descriptorType, range);
+				if(set.pBufferInfo->buffer == buffer->buffer_info().buffer && set.pBufferInfo->offset == offset &&
+				   set.pBufferInfo->range == range)
+					return true;
+
 				auto bufferInfo = std::make_unique<vk::DescriptorBufferInfo>();
 				auto oldbuffer	= set.pBufferInfo;
 
 				bufferInfo->buffer = buffer->buffer_info().buffer;
 				bufferInfo->offset = offset;
-				bufferInfo->range  = get_aligned(m_Context.value(), set.descriptorType, range);
+				bufferInfo->range  = range;
 				set.pBufferInfo	   = bufferInfo.get();
-				m_Context->device().updateDescriptorSets(
-				  static_cast<uint32_t>(m_DescriptorSets.size()), m_DescriptorSets.data(), 0, nullptr);
-
 
 				*std::find_if(std::begin(m_TrackedBufferInfos),
 							  std::end(m_TrackedBufferInfos),
 							  [oldbuffer](const auto& ptr) { return oldbuffer == ptr.get(); }) = std::move(bufferInfo);
 
-				if(!m_IsComplete)
-					completeness_check();
+				if(m_IsComplete || completeness_check())
+					commit();
 				return true;
 			}
 			}
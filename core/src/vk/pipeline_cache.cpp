@@ -6,71 +6,252 @@
 #include "core/vk/framebuffer.hpp"
 #include "core/vk/pipeline.hpp"
 #include "core/vk/swapchain.hpp"
+#include "psl/async/batch.hpp"
 #include "psl/meta.hpp"
+#include <chrono>
+#include <cstring>
+#include <iterator>
+#include <memory>
 
 using namespace psl;
 using namespace core::gfx;
 using namespace core::ivk;
 using namespace core::resource;
 
+namespace {
+// prefixed to the driver's blob when it gets persisted. The driver's own header does not contain the driver version,
+// and loading data from an older driver is, depending on the vendor, either silently ignored or a crash.
+struct cache_header_t {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t vendorID;
+	uint32_t deviceID;
+	uint32_t driverVersion;
+	uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+	uint64_t size;
+	uint64_t checksum;
+};
+
+constexpr uint32_t cache_magic {0x50564B43};	// "CKVP"
+constexpr uint32_t cache_version {1};
+
+uint64_t checksum(const std::byte* data, size_t size) noexcept {
+	// fnv-1a
+	uint64_t hash {0xcbf29ce484222325};
+	for(size_t i = 0; i < size; ++i) {
+		hash ^= static_cast<uint64_t>(data[i]);
+		hash *= 0x100000001b3;
+	}
+	return hash;
+}
+
+cache_header_t make_header(const vk::PhysicalDeviceProperties& properties) noexcept {
+	cache_header_t header {};
+	header.magic		 = cache_magic;
+	header.version		 = cache_version;
+	header.vendorID		 = properties.vendorID;
+	header.deviceID		 = properties.deviceID;
+	header.driverVersion = properties.driverVersion;
+	std::memcpy(header.pipelineCacheUUID, properties.pipelineCacheUUID.data(), VK_UUID_SIZE);
+	return header;
+}
+
+/// \returns the driver's blob in case the persisted data is compatible with the current physical device.
+std::optional<psl::string8::view> validate(psl::string8::view content, const vk::PhysicalDeviceProperties& properties) {
+	if(content.size() < sizeof(cache_header_t))
+		return {};
+
+	cache_header_t header {};
+	std::memcpy(&header, content.data(), sizeof(cache_header_t));
+	const auto expected = make_header(properties);
+	if(header.magic != expected.magic || header.version != expected.version || header.vendorID != expected.vendorID ||
+	   header.deviceID != expected.deviceID || header.driverVersion != expected.driverVersion ||
+	   std::memcmp(header.pipelineCacheUUID, expected.pipelineCacheUUID, VK_UUID_SIZE) != 0 ||
+	   header.size != content.size() - sizeof(cache_header_t))
+		return {};
+
+	auto blob = content.substr(sizeof(cache_header_t));
+	if(header.checksum != checksum(reinterpret_cast<const std::byte*>(blob.data()), blob.size()))
+		return {};
+	return blob;
+}
+}	 // namespace
+
 pipeline_cache::pipeline_cache(core::resource::cache_t& cache,
 							   const core::resource::metadata& metaData,
 							   psl::meta::file* metaFile,
 							   core::resource::handle<core::ivk::context> context)
-	: m_Context(context), m_Cache(cache) {
+	: m_UID(metaData.uid), m_Context(context), m_Cache(cache) {
 	::vk::PipelineCacheCreateInfo pcci;
-	if(!utility::vulkan::check(m_Context->device().createPipelineCache(&pcci, nullptr, &m_PipelineCache))) {
+
+	auto& library = m_Cache.library();
+	if(library.is_physical_file(m_UID)) {
+		if(auto content = library.load(m_UID); content && !content.value().empty()) {
+			if(auto blob = validate(content.value(), m_Context->properties()); blob) {
+				pcci.initialDataSize = blob.value().size();
+				pcci.pInitialData	 = blob.value().data();
+			} else {
+				core::gfx::log->info("discarding the persisted ivk::pipeline_cache, it was created for another device "
+									 "or driver");
+			}
+		}
+	} else {
+		core::gfx::log->warn(
+		  "the ivk::pipeline_cache [uid: '{}'] has no file in the library, its data won't be persisted",
+		  m_UID.to_string());
+	}
+
+	auto result = m_Context->device().createPipelineCache(&pcci, nullptr, &m_PipelineCache);
+	if(pcci.initialDataSize > 0 && !utility::vulkan::check(result)) {
+		core::gfx::log->warn("the driver rejected the persisted ivk::pipeline_cache, creating an empty one");
+		pcci.initialDataSize = 0;
+		pcci.pInitialData	 = nullptr;
+		result				 = m_Context->device().createPipelineCache(&pcci, nullptr, &m_PipelineCache);
+	}
+	if(!utility::vulkan::check(result)) {
 		core::gfx::log->error("could not create a ivk::pipeline_cache");
 	}
+
+	// the mapping is no longer needed, and should not be open when we overwrite the file later on.
+	library.unload(m_UID);
 }
 
 pipeline_cache::~pipeline_cache() {
+	for(auto& worker : m_Workers) worker.wait();
+	m_Workers.clear();
+	m_Jobs.clear();
+
+	save();
 	m_Context->device().destroyPipelineCache(m_PipelineCache);
 }
 
-// todo: actually generate a hash for these items
+bool pipeline_cache::save() {
+	auto& library = m_Cache.library();
+	if(!m_PipelineCache || !library.is_physical_file(m_UID))
+		return false;
+
+	size_t size {0};
+	if(!utility::vulkan::check(m_Context->device().getPipelineCacheData(m_PipelineCache, &size, nullptr)))
+		return false;
+
+	psl::string8_t content(sizeof(cache_header_t) + size, '\0');
+	if(size > 0 &&
+	   !utility::vulkan::check(
+		 m_Context->device().getPipelineCacheData(m_PipelineCache, &size, content.data() + sizeof(cache_header_t))))
+		return false;
+	content.resize(sizeof(cache_header_t) + size);
+
+	auto header		= make_header(m_Context->properties());
+	header.size		= size;
+	header.checksum = checksum(reinterpret_cast<const std::byte*>(content.data() + sizeof(cache_header_t)), size);
+	std::memcpy(content.data(), &header, sizeof(cache_header_t));
+
+	if(!library.write(m_UID, content)) {
+		core::gfx::log->error("could not persist the ivk::pipeline_cache");
+		return false;
+	}
+	return true;
+}
+
 core::resource::handle<core::ivk::pipeline> pipeline_cache::get(const psl::UID& uid,
 																handle<core::data::material_t> data,
 																core::resource::handle<framebuffer_t> framebuffer) {
-	pipeline_key key(uid, data, framebuffer->render_pass());
-	if(auto it = m_Pipelines.find(key); it != std::end(m_Pipelines)) {
-		return it->second;
-	}
-
-	auto pipelineHandle = m_Cache.create<pipeline>(
-	  m_Context, data, m_PipelineCache, framebuffer->render_pass(), (uint32_t)framebuffer->color_attachments().size());
-	m_Pipelines[key] = pipelineHandle;
-
-	return pipelineHandle;
+	return get(uid, data, framebuffer->render_pass(), (uint32_t)framebuffer->color_attachments().size());
 }
 
 core::resource::handle<core::ivk::pipeline> pipeline_cache::get(const psl::UID& uid,
 																handle<core::data::material_t> data,
 																core::resource::handle<swapchain> swapchain) {
-	pipeline_key key(uid, data, swapchain->renderpass());
+	return get(uid, data, swapchain->renderpass(), 1);
+}
+
+core::resource::handle<core::ivk::pipeline> pipeline_cache::get(const psl::UID& uid,
+																handle<core::data::material_t> data,
+																vk::RenderPass renderPass,
+																uint32_t attachmentCount) {
+	pipeline_key key(uid, renderPass, attachmentCount);
 	if(auto it = m_Pipelines.find(key); it != std::end(m_Pipelines)) {
 		return it->second;
 	}
 
-	auto pipelineHandle = m_Cache.create<pipeline>(m_Context, data, m_PipelineCache, swapchain->renderpass(), 1);
-	m_Pipelines[key]	= pipelineHandle;
+	// only block on the pipeline we need, compiling it ourselves if no worker picked it up yet. The state is only
+	// resolved to find the job, the pipeline resolves it again on creation.
+	if(!m_Jobs.empty()) {
+		if(auto state = details::pipeline_state::resolve(m_Cache, data.value(), renderPass, attachmentCount); state) {
+			if(auto it = m_Jobs.find(state->hash()); it != std::end(m_Jobs)) {
+				compile(*it->second);
+				it->second->finished.wait(false);
+			}
+		}
+	}
+
+	auto pipelineHandle = m_Cache.create<pipeline>(m_Context, data, m_PipelineCache, renderPass, attachmentCount);
+	m_Pipelines[key] = pipelineHandle;
 
 	return pipelineHandle;
 }
 
-std::vector<std::pair<vk::DescriptorType, uint32_t>>
-fill_in_descriptors(core::resource::handle<core::data::material_t> data, vk::RenderPass pass) {
-	std::vector<std::pair<vk::DescriptorType, uint32_t>> descriptors;
-	for(const auto& stage : data->stages()) {
-		for(const auto& shader_descriptor : stage.bindings()) {
-			descriptors.emplace_back(
-			  std::make_pair(conversion::to_vk(shader_descriptor.descriptor()), shader_descriptor.binding_slot()));
-		}
+void pipeline_cache::prewarm(psl::array_view<core::resource::handle<core::data::material_t>> materials,
+							 core::resource::handle<framebuffer_t> framebuffer) {
+	prewarm(materials, framebuffer->render_pass(), (uint32_t)framebuffer->color_attachments().size());
+}
+
+void pipeline_cache::prewarm(psl::array_view<core::resource::handle<core::data::material_t>> materials,
+							 core::resource::handle<swapchain> swapchain) {
+	prewarm(materials, swapchain->renderpass(), 1);
+}
+
+void pipeline_cache::prewarm(psl::array_view<core::resource::handle<core::data::material_t>> materials,
+							 vk::RenderPass renderPass,
+							 uint32_t attachmentCount) {
+	collect();
+
+	// resolving touches the resource cache, so it has to happen here, only the compilation is offloaded
+	std::vector<compile_job_t*> jobs {};
+	for(const auto& material : materials) {
+		auto state = details::pipeline_state::resolve(m_Cache, material.value(), renderPass, attachmentCount);
+		if(!state || !m_Prewarmed.emplace(state->hash()).second)
+			continue;
+		auto hash = state->hash();
+		jobs.emplace_back(m_Jobs.emplace(hash, std::make_unique<compile_job_t>(std::move(state.value())))
+							.first->second.get());
 	}
-	return descriptors;
+	if(jobs.empty())
+		return;
+
+	auto workers = psl::async::batch(
+	  jobs.size(),
+	  [this, jobs = std::make_shared<const std::vector<compile_job_t*>>(std::move(jobs))](size_t begin, size_t end) {
+		  for(auto i = begin; i < end; ++i) compile(*(*jobs)[i]);
+	  });
+	std::move(std::begin(workers), std::end(workers), std::back_inserter(m_Workers));
 }
 
-pipeline_key::pipeline_key(const psl::UID& uid,
-						   core::resource::handle<core::data::material_t> data,
-						   vk::RenderPass pass)
-	: uid(uid), renderPass(pass), descriptors(fill_in_descriptors(data, pass)) {}
+void pipeline_cache::compile(compile_job_t& job) const {
+	if(job.claimed.test_and_set())
+		return;
+
+	// compile into the vk::PipelineCache only, the actual pipeline object is created by get()
+	const auto& device = m_Context->device();
+	vk::DescriptorSetLayout descriptorSetLayout;
+	vk::PipelineLayout pipelineLayout;
+	if(job.state.create_layout(device, descriptorSetLayout, pipelineLayout)) {
+		if(auto pipeline = job.state.compile(device, m_PipelineCache, pipelineLayout); pipeline)
+			device.destroyPipeline(pipeline.value());
+	}
+	device.destroyPipelineLayout(pipelineLayout);
+	device.destroyDescriptorSetLayout(descriptorSetLayout);
+
+	job.finished.test_and_set();
+	job.finished.notify_all();
+}
+
+void pipeline_cache::collect() {
+	std::erase_if(m_Workers, [](const auto& worker) {
+		return worker.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+	});
+	// the workers reference the jobs of their batch until they are done, and the jobs hold resource handles that
+	// should be released on this thread.
+	if(m_Workers.empty())
+		m_Jobs.clear();
+}
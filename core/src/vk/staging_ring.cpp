@@ -0,0 +1,500 @@
+#include "core/vk/staging_ring.hpp"
+#include "core/logging.hpp"
+#include "core/vk/context.hpp"
+#include <algorithm>
+#include <cstring>
+
+using namespace core::ivk;
+
+staging_ring::staging_ring(core::ivk::context& context, vk::DeviceSize capacity)
+	: m_Context(context), m_Capacity(capacity),
+	  m_Dedicated(context.transfer_que_index() != context.graphics_queue_index()) {
+	const auto& device = m_Context.device();
+	core::ivk::log->info("staging uploads on the {} queue", (m_Dedicated) ? "transfer" : "graphics");
+
+	vk::BufferCreateInfo bufferInfo;
+	bufferInfo.usage	   = vk::BufferUsageFlagBits::eTransferSrc;
+	bufferInfo.size		   = m_Capacity;
+	bufferInfo.sharingMode = vk::SharingMode::eExclusive;
+	utility::vulkan::check(device.createBuffer(&bufferInfo, nullptr, &m_Buffer));
+
+	auto requirements = device.getBufferMemoryRequirements(m_Buffer);
+	vk::MemoryAllocateInfo allocateInfo;
+	allocateInfo.allocationSize	 = requirements.size;
+	allocateInfo.memoryTypeIndex =
+	  m_Context.memory_type(requirements.memoryTypeBits,
+							vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+	utility::vulkan::check(device.allocateMemory(&allocateInfo, nullptr, &m_Memory));
+	utility::vulkan::check(device.bindBufferMemory(m_Buffer, m_Memory, 0));
+
+	auto mapping = device.mapMemory(m_Memory, 0, m_Capacity);
+	if(!utility::vulkan::check(mapping.result)) {
+		core::ivk::log->critical("could not map the staging ring of {} bytes", m_Capacity);
+	}
+	m_Data = static_cast<std::byte*>(mapping.value);
+
+	vk::SemaphoreTypeCreateInfo typeInfo;
+	typeInfo.semaphoreType = vk::SemaphoreType::eTimeline;
+	typeInfo.initialValue  = 0;
+	vk::SemaphoreCreateInfo semaphoreInfo;
+	semaphoreInfo.pNext = &typeInfo;
+	utility::vulkan::check(device.createSemaphore(&semaphoreInfo, nullptr, &m_Semaphore));
+}
+
+staging_ring::~staging_ring() {
+	const auto& device = m_Context.device();
+	wait(m_Submitted);
+	while(!m_InFlight.empty()) {
+		recycle(m_InFlight.front());
+		m_InFlight.pop_front();
+	}
+	recycle(m_Current);
+	if(!m_FreeCommands.empty()) {
+		device.freeCommandBuffers(pool(), static_cast<uint32_t>(m_FreeCommands.size()), m_FreeCommands.data());
+	}
+	if(!m_FreeAcquires.empty()) {
+		device.freeCommandBuffers(
+		  m_Context.command_pool(), static_cast<uint32_t>(m_FreeAcquires.size()), m_FreeAcquires.data());
+	}
+
+	device.destroySemaphore(m_Semaphore);
+	device.unmapMemory(m_Memory);
+	device.destroyBuffer(m_Buffer);
+	device.freeMemory(m_Memory);
+}
+
+const vk::CommandPool& staging_ring::pool() const noexcept {
+	return (m_Dedicated) ? m_Context.transfer_command_pool() : m_Context.command_pool();
+}
+
+const vk::Queue& staging_ring::queue() const noexcept {
+	return (m_Dedicated) ? m_Context.transfer_queue() : m_Context.queue();
+}
+
+std::optional<staging_ring::allocation_t>
+staging_ring::write(const void* data, vk::DeviceSize size, vk::DeviceSize alignment) {
+	PROFILE_SCOPE(core::profiler)
+	if(size > m_Capacity)
+		return write_overflow(data, size);
+
+	reclaim();
+	auto offset = allocate(size, alignment);
+	while(!offset) {
+		// all space is either in use by the current batch, or by batches that are still executing
+		if(m_InFlight.empty())
+			submit();
+		if(m_InFlight.empty() || !wait(m_InFlight.front().value))
+			return write_overflow(data, size);
+		reclaim();
+		offset = allocate(size, alignment);
+	}
+
+	commands();
+	std::memcpy(m_Data + offset.value(), data, size);
+	return allocation_t {m_Buffer, offset.value()};
+}
+
+std::optional<staging_ring::allocation_t> staging_ring::write_overflow(const void* data, vk::DeviceSize size) {
+	core::ivk::log->warn("uploading {} bytes, which exceeds the staging ring capacity of {} bytes.", size, m_Capacity);
+	const auto& device = m_Context.device();
+
+	overflow_t overflow;
+	vk::BufferCreateInfo bufferInfo;
+	bufferInfo.usage	   = vk::BufferUsageFlagBits::eTransferSrc;
+	bufferInfo.size		   = size;
+	bufferInfo.sharingMode = vk::SharingMode::eExclusive;
+	if(!utility::vulkan::check(device.createBuffer(&bufferInfo, nullptr, &overflow.buffer)))
+		return {};
+
+	auto requirements = device.getBufferMemoryRequirements(overflow.buffer);
+	vk::MemoryAllocateInfo allocateInfo;
+	allocateInfo.allocationSize = requirements.size;
+	if(!m_Context.memory_type(requirements.memoryTypeBits,
+							  vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+							  &allocateInfo.memoryTypeIndex) ||
+	   !utility::vulkan::check(device.allocateMemory(&allocateInfo, nullptr, &overflow.memory))) {
+		device.destroyBuffer(overflow.buffer);
+		return {};
+	}
+	utility::vulkan::check(device.bindBufferMemory(overflow.buffer, overflow.memory, 0));
+
+	auto mapping = device.mapMemory(overflow.memory, 0, size);
+	if(!utility::vulkan::check(mapping.result)) {
+		device.destroyBuffer(overflow.buffer);
+		device.freeMemory(overflow.memory);
+		return {};
+	}
+	std::memcpy(mapping.value, data, size);
+	device.unmapMemory(overflow.memory);
+
+	commands();
+	m_Current.overflow.emplace_back(overflow);
+	return allocation_t {overflow.buffer, 0};
+}
+
+std::optional<vk::DeviceSize> staging_ring::allocate(vk::DeviceSize size, vk::DeviceSize alignment) {
+	uint64_t start = (m_Head + alignment - 1) & ~(alignment - 1);
+	// allocations never straddle the end of the ring, skip ahead to its start instead
+	if(start % m_Capacity + size > m_Capacity)
+		start = (start / m_Capacity + 1) * m_Capacity;
+	if(start + size - m_Tail > m_Capacity)
+		return {};
+
+	m_Head = start + size;
+	return start % m_Capacity;
+}
+
+void staging_ring::copy(const allocation_t& source,
+						vk::Buffer destination,
+						vk::DeviceSize dstOffset,
+						vk::DeviceSize size) {
+	if(size == 0)
+		return;
+
+	// writes to overlapping regions have to be ordered, which a single copyBuffer command does not guarantee.
+	const auto overlaps = std::any_of(std::begin(m_Copies), std::end(m_Copies), [&](const copy_t& copy) {
+		return copy.destination == destination &&
+			   std::any_of(std::begin(copy.regions), std::end(copy.regions), [&](const vk::BufferCopy& region) {
+				   return region.dstOffset < dstOffset + size && dstOffset < region.dstOffset + region.size;
+			   });
+	});
+	if(overlaps)
+		flush();
+	release(destination);
+
+	auto it = std::find_if(std::begin(m_Copies), std::end(m_Copies), [&](const copy_t& copy) {
+		return copy.source == source.buffer && copy.destination == destination;
+	});
+	if(it == std::end(m_Copies))
+		it = m_Copies.insert(std::end(m_Copies), copy_t {source.buffer, destination, {}});
+
+	if(!it->regions.empty() && it->regions.back().srcOffset + it->regions.back().size == source.offset &&
+	   it->regions.back().dstOffset + it->regions.back().size == dstOffset) {
+		it->regions.back().size += size;
+	} else {
+		it->regions.emplace_back(source.offset, dstOffset, size);
+	}
+}
+
+uint64_t staging_ring::copy(vk::Buffer source, vk::Buffer destination, std::vector<vk::BufferCopy> regions) {
+	if(regions.empty())
+		return pending();
+
+	coalesce(regions);
+	flush();
+	release(destination);
+	commands().copyBuffer(source, destination, static_cast<uint32_t>(regions.size()), regions.data());
+	flush();
+	return pending();
+}
+
+void staging_ring::flush() {
+	for(auto& copy : m_Copies) record(copy);
+	m_Copies.clear();
+
+	vk::MemoryBarrier barrier;
+	barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+	barrier.dstAccessMask = vk::AccessFlagBits::eTransferRead | vk::AccessFlagBits::eTransferWrite;
+	commands().pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+							   vk::PipelineStageFlagBits::eTransfer,
+							   vk::DependencyFlags {},
+							   1,
+							   &barrier,
+							   0,
+							   nullptr,
+							   0,
+							   nullptr);
+}
+
+vk::CommandBuffer staging_ring::commands() {
+	if(m_Current.commands)
+		return m_Current.commands;
+
+	if(!m_FreeCommands.empty()) {
+		m_Current.commands = m_FreeCommands.back();
+		m_FreeCommands.pop_back();
+	} else {
+		vk::CommandBufferAllocateInfo allocateInfo;
+		allocateInfo.commandPool		= pool();
+		allocateInfo.level				= vk::CommandBufferLevel::ePrimary;
+		allocateInfo.commandBufferCount = 1;
+		utility::vulkan::check(m_Context.device().allocateCommandBuffers(&allocateInfo, &m_Current.commands));
+	}
+
+	vk::CommandBufferBeginInfo beginInfo;
+	beginInfo.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+	utility::vulkan::check(m_Current.commands.begin(&beginInfo));
+	return m_Current.commands;
+}
+
+void staging_ring::record(copy_t& copy) {
+	coalesce(copy.regions);
+	commands().copyBuffer(
+	  copy.source, copy.destination, static_cast<uint32_t>(copy.regions.size()), copy.regions.data());
+}
+
+void staging_ring::release(vk::Buffer destination) {
+	if(std::find(std::begin(m_Current.destinations), std::end(m_Current.destinations), destination) ==
+	   std::end(m_Current.destinations))
+		m_Current.destinations.emplace_back(destination);
+	if(m_Current.release || !m_Written.contains(static_cast<VkBuffer>(destination)))
+		return;
+
+	m_Current.release = true;
+	if(m_Dedicated)
+		return;
+
+	// the reads of earlier frames have to finish before the buffer is overwritten, no memory dependency is needed.
+	commands().pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands,
+							   vk::PipelineStageFlagBits::eTransfer,
+							   vk::DependencyFlags {},
+							   0,
+							   nullptr,
+							   0,
+							   nullptr,
+							   0,
+							   nullptr);
+}
+
+void staging_ring::forget(vk::Buffer buffer) {
+	m_Written.erase(static_cast<VkBuffer>(buffer));
+}
+
+void staging_ring::handoff(vk::Image image,
+						   const vk::ImageSubresourceRange& range,
+						   vk::ImageLayout oldLayout,
+						   vk::ImageLayout newLayout) {
+	auto barrier			 = utility::vulkan::image_memory_barrier_for(oldLayout, newLayout);
+	barrier.image			 = image;
+	barrier.subresourceRange = range;
+	if(!m_Dedicated) {
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		commands().pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+								   vk::PipelineStageFlagBits::eAllCommands,
+								   vk::DependencyFlags {},
+								   0,
+								   nullptr,
+								   0,
+								   nullptr,
+								   1,
+								   &barrier);
+		return;
+	}
+
+	// the release half is recorded on the transfer queue, the acquire half on the graphics queue (see submit()).
+	barrier.srcQueueFamilyIndex = m_Context.transfer_que_index();
+	barrier.dstQueueFamilyIndex = m_Context.graphics_queue_index();
+
+	auto release		  = barrier;
+	release.dstAccessMask = {};
+	commands().pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+							   vk::PipelineStageFlagBits::eBottomOfPipe,
+							   vk::DependencyFlags {},
+							   0,
+							   nullptr,
+							   0,
+							   nullptr,
+							   1,
+							   &release);
+
+	barrier.srcAccessMask = {};
+	m_Acquires.emplace_back(barrier);
+}
+
+vk::CommandBuffer staging_ring::record_acquire() {
+	if(!m_FreeAcquires.empty()) {
+		m_Current.acquire = m_FreeAcquires.back();
+		m_FreeAcquires.pop_back();
+	} else {
+		vk::CommandBufferAllocateInfo allocateInfo;
+		allocateInfo.commandPool		= m_Context.command_pool();
+		allocateInfo.level				= vk::CommandBufferLevel::ePrimary;
+		allocateInfo.commandBufferCount = 1;
+		utility::vulkan::check(m_Context.device().allocateCommandBuffers(&allocateInfo, &m_Current.acquire));
+	}
+
+	vk::CommandBufferBeginInfo beginInfo;
+	beginInfo.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+	utility::vulkan::check(m_Current.acquire.begin(&beginInfo));
+
+	// makes the transferred data visible to the graphics queue, and takes ownership of the handed off images.
+	vk::MemoryBarrier barrier;
+	barrier.dstAccessMask = vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite;
+	m_Current.acquire.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands,
+									  vk::PipelineStageFlagBits::eAllCommands,
+									  vk::DependencyFlags {},
+									  1,
+									  &barrier,
+									  0,
+									  nullptr,
+									  static_cast<uint32_t>(m_Acquires.size()),
+									  m_Acquires.data());
+	m_Acquires.clear();
+	utility::vulkan::check(m_Current.acquire.end());
+	return m_Current.acquire;
+}
+
+uint64_t staging_ring::submit() {
+	PROFILE_SCOPE(core::profiler)
+	if(!m_Current.commands)
+		return m_Submitted;
+
+	for(auto& copy : m_Copies) record(copy);
+	m_Copies.clear();
+
+	if(!m_Dedicated) {
+		// make the uploads visible to everything that gets submitted after this batch
+		vk::MemoryBarrier barrier;
+		barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+		barrier.dstAccessMask = vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite;
+		m_Current.commands.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+										   vk::PipelineStageFlagBits::eAllCommands,
+										   vk::DependencyFlags {},
+										   1,
+										   &barrier,
+										   0,
+										   nullptr,
+										   0,
+										   nullptr);
+	}
+	utility::vulkan::check(m_Current.commands.end());
+
+	for(auto destination : m_Current.destinations) m_Written.emplace(static_cast<VkBuffer>(destination));
+
+	// on a dedicated transfer queue the values are reserved in groups of three: the graphics queue releases the
+	// buffers the batch overwrites, the transfer queue executes the batch, and the graphics queue acquires it.
+	uint64_t released					= m_Submitted + 1;
+	uint64_t transferred				= (m_Dedicated) ? released + 1 : released;
+	vk::PipelineStageFlags releaseStage = vk::PipelineStageFlagBits::eTransfer;
+	if(m_Dedicated && m_Current.release) {
+		// signalled once everything submitted to the graphics queue so far, including the frames that could still be
+		// reading the buffers, has completed.
+		vk::TimelineSemaphoreSubmitInfo releaseTimelineInfo;
+		releaseTimelineInfo.signalSemaphoreValueCount = 1;
+		releaseTimelineInfo.pSignalSemaphoreValues	  = &released;
+
+		vk::SubmitInfo releaseInfo;
+		releaseInfo.pNext				 = &releaseTimelineInfo;
+		releaseInfo.signalSemaphoreCount = 1;
+		releaseInfo.pSignalSemaphores	 = &m_Semaphore;
+		utility::vulkan::check(m_Context.queue().submit(1, &releaseInfo, nullptr));
+	}
+
+	vk::TimelineSemaphoreSubmitInfo timelineInfo;
+	timelineInfo.signalSemaphoreValueCount = 1;
+	timelineInfo.pSignalSemaphoreValues	   = &transferred;
+
+	vk::SubmitInfo submitInfo;
+	submitInfo.pNext				= &timelineInfo;
+	submitInfo.commandBufferCount	= 1;
+	submitInfo.pCommandBuffers		= &m_Current.commands;
+	submitInfo.signalSemaphoreCount = 1;
+	submitInfo.pSignalSemaphores	= &m_Semaphore;
+	if(m_Dedicated && m_Current.release) {
+		timelineInfo.waitSemaphoreValueCount = 1;
+		timelineInfo.pWaitSemaphoreValues	 = &released;
+		submitInfo.waitSemaphoreCount		 = 1;
+		submitInfo.pWaitSemaphores			 = &m_Semaphore;
+		submitInfo.pWaitDstStageMask		 = &releaseStage;
+	}
+	utility::vulkan::check(queue().submit(1, &submitInfo, nullptr));
+	m_Current.value = transferred;
+
+	if(m_Dedicated) {
+		// hand the batch over to the graphics queue, everything submitted to it afterwards sees the uploads.
+		auto acquire					 = record_acquire();
+		uint64_t acquired				 = transferred + 1;
+		vk::PipelineStageFlags waitStage = vk::PipelineStageFlagBits::eAllCommands;
+
+		vk::TimelineSemaphoreSubmitInfo acquireTimelineInfo;
+		acquireTimelineInfo.waitSemaphoreValueCount	  = 1;
+		acquireTimelineInfo.pWaitSemaphoreValues	  = &transferred;
+		acquireTimelineInfo.signalSemaphoreValueCount = 1;
+		acquireTimelineInfo.pSignalSemaphoreValues	  = &acquired;
+
+		vk::SubmitInfo acquireInfo;
+		acquireInfo.pNext				 = &acquireTimelineInfo;
+		acquireInfo.waitSemaphoreCount	 = 1;
+		acquireInfo.pWaitSemaphores		 = &m_Semaphore;
+		acquireInfo.pWaitDstStageMask	 = &waitStage;
+		acquireInfo.commandBufferCount	 = 1;
+		acquireInfo.pCommandBuffers		 = &acquire;
+		acquireInfo.signalSemaphoreCount = 1;
+		acquireInfo.pSignalSemaphores	 = &m_Semaphore;
+		utility::vulkan::check(m_Context.queue().submit(1, &acquireInfo, nullptr));
+		m_Current.value = acquired;
+	}
+
+	m_Current.end = m_Head;
+	m_Submitted	  = m_Current.value;
+	m_InFlight.emplace_back(std::move(m_Current));
+	m_Current = {};
+	return m_Submitted;
+}
+
+bool staging_ring::is_complete(uint64_t value) const {
+	if(value > m_Submitted)
+		return false;
+	auto [result, counter] = m_Context.device().getSemaphoreCounterValue(m_Semaphore);
+	return result == vk::Result::eSuccess && counter >= value;
+}
+
+bool staging_ring::wait(uint64_t value, uint64_t timeout) {
+	PROFILE_SCOPE(core::profiler)
+	if(value > m_Submitted)
+		submit();
+	if(value > m_Submitted)
+		return false;
+
+	vk::SemaphoreWaitInfo waitInfo;
+	waitInfo.semaphoreCount = 1;
+	waitInfo.pSemaphores	= &m_Semaphore;
+	waitInfo.pValues		= &value;
+	return utility::vulkan::check(m_Context.device().waitSemaphores(waitInfo, timeout));
+}
+
+void staging_ring::reclaim() {
+	if(m_InFlight.empty())
+		return;
+
+	auto [result, counter] = m_Context.device().getSemaphoreCounterValue(m_Semaphore);
+	if(result != vk::Result::eSuccess)
+		return;
+
+	while(!m_InFlight.empty() && m_InFlight.front().value <= counter) {
+		m_Tail = m_InFlight.front().end;
+		recycle(m_InFlight.front());
+		m_InFlight.pop_front();
+	}
+}
+
+void staging_ring::recycle(batch_t& batch) {
+	const auto& device = m_Context.device();
+	for(auto& overflow : batch.overflow) {
+		device.destroyBuffer(overflow.buffer);
+		device.freeMemory(overflow.memory);
+	}
+	batch.overflow.clear();
+	if(batch.commands)
+		m_FreeCommands.emplace_back(batch.commands);
+	if(batch.acquire)
+		m_FreeAcquires.emplace_back(batch.acquire);
+	batch.commands = nullptr;
+	batch.acquire  = nullptr;
+}
+
+void staging_ring::coalesce(std::vector<vk::BufferCopy>& regions) {
+	if(regions.size() < 2)
+		return;
+
+	auto last = std::begin(regions);
+	for(auto it = std::next(last); it != std::end(regions); ++it) {
+		if(last->srcOffset + last->size == it->srcOffset && last->dstOffset + last->size == it->dstOffset) {
+			last->size += it->size;
+		} else {
+			*(++last) = *it;
+		}
+	}
+	regions.erase(std::next(last), std::end(regions));
+}
@@ -6,6 +6,7 @@
 #include "core/vk/context.hpp"
 #include "core/vk/conversion.hpp"
 #include "core/vk/sampler.hpp"
+#include "core/vk/staging_ring.hpp"
 #ifdef fseek
 	#define cached_fseek fseek
 	#define cached_fclose fclose
@@ -32,6 +33,8 @@ using namespace core::gfx::conversion;
 using namespace core::ivk;
 using namespace core::resource;
 
+// alignment of the texture data in the staging ring, satisfies the texel (block) size of all formats
+static const vk::DeviceSize staging_alignment {16};
 
 texture_t::texture_t(core::resource::cache_t& cache,
 					 const core::resource::metadata& metaData,
@@ -86,6 +89,7 @@ fail:
 }
 
 texture_t::~texture_t() {
+	m_Context->staging().wait(m_Pending);
 	for(auto& item : m_Descriptors) {
 		delete(item.second);
 	}
@@ -145,35 +149,31 @@ void texture_t::create_2D(void* data) {
 	}
 	m_Context->physical_device().getFormatProperties(to_vk(m_Meta->format()), &formatProperties);
 
-	auto stagingBuffer = m_StagingBuffer;
+	vk::Buffer stagingSource;
 	vk::BufferImageCopy bufferCopyRegion;
 	if(data != nullptr) {
 		auto size = m_Meta->width() * m_Meta->height();
-		if(!m_StagingBuffer) {
-			core::ivk::log->warn(
-			  "missing a staging buffer in ivk::texture_t, will create one dynamically, but this is inefficient");
-			auto tempBuffer = m_Cache.create<core::data::buffer_t>(
-			  core::gfx::memory_usage::transfer_source,
-			  core::gfx::memory_property::host_visible | core::gfx::memory_property::host_coherent,
-			  memory::region {size + 1024, 4, new memory::default_allocator(false)});
-			stagingBuffer = m_Cache.create<ivk::buffer_t>(m_Context, tempBuffer);
-		}
-		if(!stagingBuffer) {
-			core::ivk::log->error("could not create a staging buffer in ivk::texture_t");
-			return;
-		}
-		memory::segment segment;
-		if(auto segmentOpt = stagingBuffer->reserve((vk::DeviceSize)size); segmentOpt) {
-			segment = segmentOpt.value();
-			gfx::commit_instruction instr;
-			instr.segment = segment;
-			instr.size	  = (vk::DeviceSize)size;
-			instr.source  = (std::uintptr_t)data;
-			if(!stagingBuffer->commit({instr})) {
-				core::ivk::log->error("could not commit an ivk::texture_t in a staging buffer");
+		if(m_StagingBuffer) {
+			if(auto segmentOpt = m_StagingBuffer->reserve((vk::DeviceSize)size); segmentOpt) {
+				gfx::commit_instruction instr;
+				instr.segment = segmentOpt.value();
+				instr.size	  = (vk::DeviceSize)size;
+				instr.source  = (std::uintptr_t)data;
+				if(!m_StagingBuffer->commit({instr})) {
+					core::ivk::log->error("could not commit an ivk::texture_t in a staging buffer");
+				}
+			} else {
+				core::ivk::log->error("could not allocate a segment in the staging buffer for an ivk::texture_t");
+				return;
 			}
+			stagingSource				  = m_StagingBuffer->gpu_buffer();
+			bufferCopyRegion.bufferOffset = 0;
+		} else if(auto allocation = m_Context->staging().write(data, (vk::DeviceSize)size, staging_alignment);
+				  allocation) {
+			stagingSource				  = allocation.value().buffer;
+			bufferCopyRegion.bufferOffset = allocation.value().offset;
 		} else {
-			core::ivk::log->error("could not allocate a segment in the staging buffer for an ivk::texture_t");
+			core::ivk::log->error("could not stage the data of an ivk::texture_t");
 			return;
 		}
 
@@ -184,7 +184,6 @@ void texture_t::create_2D(void* data) {
 		bufferCopyRegion.imageExtent.width				 = m_Meta->width();
 		bufferCopyRegion.imageExtent.height				 = m_Meta->height();
 		bufferCopyRegion.imageExtent.depth				 = 1;
-		bufferCopyRegion.bufferOffset					 = 0;
 	}
 
 	// Create optimal tiled target image
@@ -221,8 +220,8 @@ void texture_t::create_2D(void* data) {
 	m_Context->device().bindImageMemory(m_Image, m_DeviceMemory, 0);
 
 	if(data != nullptr) {
-		vk::CommandBuffer copyCmd = utility::vulkan::create_cmd_buffer(
-		  m_Context->device(), m_Context->command_pool(), vk::CommandBufferLevel::ePrimary, true, 1);
+		// recorded in the staging batch, which gets submitted together with the next frame
+		vk::CommandBuffer copyCmd = m_Context->staging().commands();
 
 		vk::ImageSubresourceRange subresourceRange;
 		subresourceRange.aspectMask	  = vk::ImageAspectFlagBits::eColor;
@@ -236,15 +235,14 @@ void texture_t::create_2D(void* data) {
 
 		// Copy mip levels from staging buffer
 		copyCmd.copyBufferToImage(
-		  stagingBuffer->gpu_buffer(), m_Image, vk::ImageLayout::eTransferDstOptimal, (uint32_t)1, &bufferCopyRegion);
+		  stagingSource, m_Image, vk::ImageLayout::eTransferDstOptimal, (uint32_t)1, &bufferCopyRegion);
 
 		// Change texture image layout to shader read after all mip levels have been copied
 		m_ImageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
 
-		utility::vulkan::set_image_layout(
-		  copyCmd, m_Image, vk::ImageLayout::eTransferDstOptimal, m_ImageLayout, subresourceRange);
+		m_Context->staging().handoff(m_Image, subresourceRange, vk::ImageLayout::eTransferDstOptimal, m_ImageLayout);
 
-		m_Context->flush(copyCmd, true);
+		m_Pending = m_Context->staging().pending();
 	}
 
 	// Create image view
@@ -317,39 +315,35 @@ void texture_t::load_2D() {
 	useStaging = true;
 
 	if(useStaging) {
-		auto stagingBuffer = m_StagingBuffer;
-		if(!m_StagingBuffer) {
-			core::ivk::log->warn(
-			  "missing a staging buffer in ivk::texture_t, will create one dynamically, but this is inefficient");
-			auto tempBuffer = m_Cache.create<core::data::buffer_t>(
-			  core::gfx::memory_usage::transfer_source,
-			  core::gfx::memory_property::host_visible | core::gfx::memory_property::host_coherent,
-			  memory::region {m_Texture2DData->size() + 1024, 4, new memory::default_allocator(false)});
-			stagingBuffer = m_Cache.create<ivk::buffer_t>(m_Context, tempBuffer);
-		}
-		if(!stagingBuffer) {
-			core::ivk::log->error("could not create a staging buffer in ivk::texture_t");
-			return;
-		}
-		memory::segment segment;
-		if(auto segmentOpt = stagingBuffer->reserve((vk::DeviceSize)m_Texture2DData->size()); segmentOpt) {
-			segment = segmentOpt.value();
-			gfx::commit_instruction instr;
-			instr.segment = segment;
-			instr.size	  = (vk::DeviceSize)m_Texture2DData->size();
-			instr.source  = (std::uintptr_t)m_Texture2DData->data();
-			if(!stagingBuffer->commit({instr})) {
-				core::ivk::log->error("could not commit an ivk::texture_t in a staging buffer");
+		vk::Buffer stagingSource;
+		uintptr_t offset = 0;
+		if(m_StagingBuffer) {
+			if(auto segmentOpt = m_StagingBuffer->reserve((vk::DeviceSize)m_Texture2DData->size()); segmentOpt) {
+				gfx::commit_instruction instr;
+				instr.segment = segmentOpt.value();
+				instr.size	  = (vk::DeviceSize)m_Texture2DData->size();
+				instr.source  = (std::uintptr_t)m_Texture2DData->data();
+				if(!m_StagingBuffer->commit({instr})) {
+					core::ivk::log->error("could not commit an ivk::texture_t in a staging buffer");
+				}
+				offset = instr.segment.range().begin;
+			} else {
+				core::ivk::log->error("could not allocate a segment in the staging buffer for an ivk::texture_t");
+				return;
 			}
+			stagingSource = m_StagingBuffer->gpu_buffer();
+		} else if(auto allocation = m_Context->staging().write(
+					m_Texture2DData->data(), (vk::DeviceSize)m_Texture2DData->size(), staging_alignment);
+				  allocation) {
+			stagingSource = allocation.value().buffer;
+			offset		  = allocation.value().offset;
 		} else {
-			core::ivk::log->error("could not allocate a segment in the staging buffer for an ivk::texture_t");
+			core::ivk::log->error("could not stage the data of an ivk::texture_t");
 			return;
 		}
-		// stagingBuffer->map(m_Texture2DData->data(), (vk::DeviceSize)m_Texture2DData->size(), 0);
 
 		// Setup buffer copy regions for each mip level
 		std::vector<vk::BufferImageCopy> bufferCopyRegions;
-		uintptr_t offset = segment.range().begin;
 
 		for(uint32_t i = 0; i < m_MipLevels; i++) {
 			vk::BufferImageCopy bufferCopyRegion;
@@ -398,8 +392,8 @@ void texture_t::load_2D() {
 		utility::vulkan::check(m_Context->device().allocateMemory(&memAllocInfo, nullptr, &m_DeviceMemory));
 		m_Context->device().bindImageMemory(m_Image, m_DeviceMemory, 0);
 
-		vk::CommandBuffer copyCmd = utility::vulkan::create_cmd_buffer(
-		  m_Context->device(), m_Context->command_pool(), vk::CommandBufferLevel::ePrimary, true, 1);
+		// recorded in the staging batch, which gets submitted together with the next frame
+		vk::CommandBuffer copyCmd = m_Context->staging().commands();
 
 		vk::ImageSubresourceRange subresourceRange;
 		subresourceRange.aspectMask	  = vk::ImageAspectFlagBits::eColor;
@@ -434,7 +428,7 @@ void texture_t::load_2D() {
 		}
 
 		// Copy mip levels from staging buffer
-		copyCmd.copyBufferToImage(stagingBuffer->gpu_buffer(),
+		copyCmd.copyBufferToImage(stagingSource,
 								  m_Image,
 								  vk::ImageLayout::eTransferDstOptimal,
 								  (uint32_t)bufferCopyRegions.size(),
@@ -443,33 +437,13 @@ void texture_t::load_2D() {
 		// Change texture image layout to shader read after all mip levels have been copied
 		m_ImageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
 
+		core::ivk::log->info("transitioning image {} from {} to {} and handing it over to the graphics queue",
+							 meta().ID().to_string(),
+							 vk::to_string(vk::ImageLayout::eTransferDstOptimal),
+							 vk::to_string(m_ImageLayout));
+		m_Context->staging().handoff(m_Image, subresourceRange, vk::ImageLayout::eTransferDstOptimal, m_ImageLayout);
 
-		{
-			auto barrier =
-			  utility::vulkan::image_memory_barrier_for(vk::ImageLayout::eTransferDstOptimal, m_ImageLayout);
-			barrier.image				= m_Image;
-			barrier.subresourceRange	= subresourceRange;
-			barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-			barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-
-			core::ivk::log->info("transitioning image {} from {} to {} in pipeline stage {} to {}",
-								 meta().ID().to_string(),
-								 vk::to_string(barrier.srcAccessMask),
-								 vk::to_string(barrier.dstAccessMask),
-								 vk::to_string(vk::PipelineStageFlagBits::eTransfer),
-								 vk::to_string(vk::PipelineStageFlagBits::eFragmentShader));
-			copyCmd.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
-									vk::PipelineStageFlagBits::eFragmentShader,
-									(vk::DependencyFlagBits)0,
-									0,
-									nullptr,
-									0,
-									nullptr,
-									1,
-									&barrier);
-		}
-
-		m_Context->flush(copyCmd, true);
+		m_Pending = m_Context->staging().pending();
 	}
 
 
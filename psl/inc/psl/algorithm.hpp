@@ -1,5 +1,9 @@
 #pragma once
 #include <algorithm>
+#include <array>
+#include <concepts>
+#include <functional>
+#include <utility>
 
 namespace psl {
 enum class sorter { hybrid, quick_3way, insertion, heap, merge };
@@ -66,6 +70,47 @@ namespace sorting {
 		insertion(first, last, std::less<typename std::iterator_traits<It>::value_type>());
 	}
 
+	/// \brief stable LSD radix sort of unsigned integer keys, along with a value per key.
+	/// \details sorts one byte per pass, all histograms are gathered in a single read up front so passes in which every
+	/// key has the same byte can be skipped entirely (i.e. unused bits of packed keys cost nothing).
+	/// \param[in,out] keys the keys to sort, sorted on return.
+	/// \param[in,out] values the value of every key, reordered along with the keys.
+	/// \param[in] count the amount of keys (and values).
+	/// \param keysScratch, valuesScratch scratch memory with room for `count` elements.
+	template <std::unsigned_integral Key, typename Value>
+	void radix(Key* keys, Value* values, size_t count, Key* keysScratch, Value* valuesScratch) noexcept {
+		constexpr size_t passes {sizeof(Key)};
+		std::array<std::array<size_t, 256>, passes> histograms {};
+		for(size_t i = 0; i < count; ++i) {
+			for(size_t pass = 0; pass < passes; ++pass) ++histograms[pass][(keys[i] >> (pass * 8)) & 0xFF];
+		}
+
+		Key* srcKeys	 = keys;
+		Value* srcValues = values;
+		Key* dstKeys	 = keysScratch;
+		Value* dstValues = valuesScratch;
+		for(size_t pass = 0; pass < passes; ++pass) {
+			auto& histogram = histograms[pass];
+			if(std::find(std::begin(histogram), std::end(histogram), count) != std::end(histogram))
+				continue;
+
+			size_t offset {0};
+			for(auto& bucket : histogram) offset += std::exchange(bucket, offset);
+			for(size_t i = 0; i < count; ++i) {
+				const auto index = histogram[(srcKeys[i] >> (pass * 8)) & 0xFF]++;
+				dstKeys[index]	 = srcKeys[i];
+				dstValues[index] = srcValues[i];
+			}
+			std::swap(srcKeys, dstKeys);
+			std::swap(srcValues, dstValues);
+		}
+
+		if(srcKeys != keys) {
+			std::copy(srcKeys, srcKeys + count, keys);
+			std::copy(srcValues, srcValues + count, values);
+		}
+	}
+
 }	 // namespace sorting
 template <typename Sorter, typename It, typename Pred>
 void sort(Sorter&&, const It first, const It last, Pred&& pred) noexcept {
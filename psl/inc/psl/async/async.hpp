@@ -1,4 +1,5 @@
 #pragma once
 #include "barrier.hpp"
+#include "batch.hpp"
 #include "scheduler.hpp"
 #include "token.hpp"
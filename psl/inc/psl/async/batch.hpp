@@ -0,0 +1,32 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace psl::async {
+/// \brief splits the range [0, count) into contiguous batches, and invokes the function for every batch on a worker of
+/// its own.
+///
+/// There are at most as many batches as there are hardware threads. Every batch gets the same amount of elements,
+/// except for the last one, which gets the remainder.
+/// \param[in] count the amount of elements to split.
+/// \param[in] fn invoked as fn(begin, end) for every batch, every worker gets a copy of it.
+/// \returns the futures of the workers, in the order of their batches.
+template <typename Fn>
+std::vector<std::future<void>> batch(size_t count, Fn fn) {
+	std::vector<std::future<void>> workers {};
+	if(count == 0)
+		return workers;
+
+	const size_t worker_count = std::min<size_t>(count, std::max<size_t>(1, std::thread::hardware_concurrency()));
+	const size_t batch_size	  = (count + worker_count - 1) / worker_count;
+	workers.reserve(worker_count);
+	for(size_t begin = 0; begin < count; begin += batch_size) {
+		const auto end = std::min(begin + batch_size, count);
+		workers.emplace_back(std::async(std::launch::async, [fn, begin, end]() mutable { fn(begin, end); }));
+	}
+	return workers;
+}
+}	 // namespace psl::async
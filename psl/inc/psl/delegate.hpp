@@ -7,6 +7,7 @@
 #endif
 
 
+#include "psl/utility/hash.hpp"
 #include <memory>
 #include <new>
 #include <type_traits>
@@ -269,10 +270,9 @@ namespace std {
 template <typename R, typename... A>
 struct hash<psl::delegate<R(A...)>> {
 	size_t operator()(psl::delegate<R(A...)> const& d) const noexcept {
-		auto const seed(hash<void*>()(d.object_ptr_));
-
-		return hash<typename psl::delegate<R(A...)>::stub_ptr_type>()(d.stub_ptr_) + 0x9e3779b9 + (seed << 6) +
-			   (seed >> 2);
+		uint64_t seed = hash<void*>()(d.object_ptr_);
+		psl::utility::hash_combine(seed, hash<typename psl::delegate<R(A...)>::stub_ptr_type>()(d.stub_ptr_));
+		return static_cast<size_t>(seed);
 	}
 };
 }	 // namespace std
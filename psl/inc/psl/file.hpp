@@ -24,6 +24,9 @@ class file {
 		TRUNCATE
 	};
 
+	// hints on how the mapped memory is going to be accessed
+	enum advice { NORMAL, SEQUENTIAL, RANDOM, WILL_NEED, DONT_NEED };
+
 
 	file(psl::string_view filename,
 		 mode mode					  = mode::READ_AND_WRITE,
@@ -32,13 +35,18 @@ class file {
 		 std::optional<size_t> length = {});
 	~file();
 
+	file(const file&)			 = delete;
+	file(file&&)				 = delete;
+	file& operator=(const file&) = delete;
+	file& operator=(file&&)		 = delete;
 
 	operator bool() const { return m_Data; }
 
 	std::optional<psl::string_view> view() const {
 		if(!m_Data)
 			return {};
-		return psl::string_view {&m_Data[0], m_ContentSize};
+		// the content size is in bytes, which differs from the amount of characters when psl::char_t is wide
+		return psl::string_view {&m_Data[0], m_ContentSize / sizeof(psl::char_t)};
 	}
 
 	std::optional<psl::char_t*> data() const {
@@ -47,6 +55,13 @@ class file {
 		return m_Data;
 	}
 
+	/// \returns the size in bytes of the content that is mapped.
+	size_t size() const noexcept { return m_ContentSize; }
+
+	/// \brief hints the OS on how the mapped memory will be accessed.
+	/// \returns false when the hint could not be applied, or the platform does not support it.
+	bool advise(advice hint) const noexcept;
+
   private:
 	bool close();
 
@@ -57,6 +72,10 @@ class file {
 	std::optional<void*> m_File;
 	std::optional<void*> m_Map;
 	std::optional<void*> m_MapView;
+#else
+	int m_Descriptor {-1};
+	void* m_MapView {nullptr};
+	size_t m_MapSize {0};
 #endif
 };
 }	 // namespace utility::os
@@ -6,11 +6,19 @@
 #include <cstdio>	 // For printf(). Remove if you don't need the PrintRanges() function (mostly for debugging anyway).
 #include <cstdlib>
 #include <cstring>
+#include <limits>
+#include <utility>
 #include <vector>
 #undef max
 #undef min
 
 namespace psl {
+/// \brief hands out unique ids, and continuous ranges of ids, from [0, capacity).
+/// \details The free ids are stored as ranges in a treap (a randomized balanced search tree) ordered on their first
+/// id, where every node also knows the size of the largest free range in its subtree. Creating ids takes them from the
+/// front of the first (lowest) free range that is large enough, while creating, destroying, and validating ids are
+/// O(log n) in the amount of free ranges, no matter how fragmented the ids are. The amount of available ids is kept up
+/// to date as ids are created and destroyed.
 template <typename T = uint32_t>
 class generator {
   private:
@@ -37,176 +45,285 @@ class generator {
 		T size() const noexcept { return last - first; };
 	};
 
-	std::vector<range> m_FreeRanges {};	   // Sorted array of ranges of free IDs
+	using index_t = uint32_t;
+	static constexpr index_t npos {std::numeric_limits<index_t>::max()};
+
+	struct node {
+		range value {};
+		T largest {0};	  // size of the largest free range in this subtree
+		uint32_t priority {0};
+		index_t left {npos};
+		index_t right {npos};
+	};
+
+	std::vector<node> m_Nodes {};
+	std::vector<index_t> m_Unused {};	 // nodes that were released, and can be reused
+	index_t m_Root {npos};
 	T m_Max {0};
+	T m_Available {0};
+	uint32_t m_Seed {0x9e3779b9};
 
   public:
-	explicit generator(T max) : m_FreeRanges({range {0, max}}), m_Max(max) {}
+	explicit generator(T max) : m_Max(max), m_Available(max) {
+		if(max > 0)
+			m_Root = allocate(range {0, max});
+	}
 
 	generator() : generator(std::numeric_limits<T>::max()) {};
 
 	generator& operator=(const generator&) = default;
 	generator(const generator&)			   = default;
 
-	generator(generator&& other) : m_FreeRanges(std::move(other.m_FreeRanges)), m_Max(other.m_Max) {}
+	generator(generator&& other) noexcept
+		: m_Nodes(std::move(other.m_Nodes)), m_Unused(std::move(other.m_Unused)),
+		  m_Root(std::exchange(other.m_Root, npos)), m_Max(other.m_Max),
+		  m_Available(std::exchange(other.m_Available, T {0})), m_Seed(other.m_Seed) {}
 
-	generator& operator=(generator&& other) {
+	generator& operator=(generator&& other) noexcept {
 		if(this != &other) {
-			m_FreeRanges = std::move(other.m_FreeRanges);
-			m_Max		 = other.m_Max;
+			m_Nodes		= std::move(other.m_Nodes);
+			m_Unused	= std::move(other.m_Unused);
+			m_Root		= std::exchange(other.m_Root, npos);
+			m_Max		= other.m_Max;
+			m_Available = std::exchange(other.m_Available, T {0});
+			m_Seed		= other.m_Seed;
 		}
 		return *this;
 	}
 
 	T capacity() const noexcept { return m_Max; }
 	T size() const noexcept { return capacity() - available(); }
-	T available() const noexcept {
-		T acc {0};
-		for(const auto& range : m_FreeRanges) {
-			acc += range.size();
-		}
-		return acc;
-	};
+	T available() const noexcept { return m_Available; };
 
 
 	T create(T count = 1) {
 		if(count == 0)
 			throw std::runtime_error("there should be at least 1 ID created");
-		if(m_FreeRanges.size() == 0)
-			throw std::runtime_error("out of available ID's");
-
-		auto i = 0;
-		for(auto& r : m_FreeRanges) {
-			if(r.size() >= count) {
-				auto result = r.first;
-				r.first += count;
-
-				if(r.size() == 0)
-					m_FreeRanges.erase(std::next(std::begin(m_FreeRanges), i));
-
-				return result;
-			}
-			++i;
-		}
 
-		throw std::runtime_error("out of available ID's");
+		T result {};
+		if(!try_create(result, count))
+			throw std::runtime_error("out of available ID's");
+		return result;
 	}
 
+	/// \brief creates the given amount of ids, spread over as many ranges as needed.
+	/// \returns the [first, last) ranges of the created ids, ordered from low to high.
 	std::vector<std::pair<T, T>> create_multi(T count = 1) {
+		if(count > m_Available)
+			throw std::runtime_error("out of available ID's");
+
 		std::vector<std::pair<T, T>> result {};
-		for(auto i = 0; i < m_FreeRanges.size();) {
-			auto& r		 = m_FreeRanges[i];
-			auto consume = std::min(r.size(), count);
+		while(count > 0) {
+			// the first free range is always the first fit for its own size
+			auto consume = std::min(m_Nodes[leftmost(m_Root)].value.size(), count);
+			T first {};
+			m_Root = take(m_Root, consume, first);
+			m_Available -= consume;
 			count -= consume;
-
-			result.emplace_back(std::pair<T, T> {r.first, r.first + consume});
-			r.first += consume;
-			if(r.size() == 0)
-				m_FreeRanges.erase(std::next(std::begin(m_FreeRanges), i));
-			else
-				++i;
-
-			if(count == 0)
-				break;
-		}
-		if(count > 0) {
-			for(auto& r : result) destroy(r.first, r.second - r.first);
-
-			throw std::runtime_error("out of available ID's");
+			result.emplace_back(std::pair<T, T> {first, first + consume});
 		}
 		return result;
 	}
 
 	bool try_create(T& out, T count = 1) {
-		if(m_FreeRanges.size() == 0 || count == 0) {
+		if(count == 0 || largest(m_Root) < count)
 			return false;
-		}
-
-		auto i = 0;
-		for(auto& r : m_FreeRanges) {
-			if(r.size() >= count) {
-				out = r.first;
-				r.first += count;
 
-				if(r.size() == 0)
-					m_FreeRanges.erase(std::next(std::begin(m_FreeRanges), i));
-
-				return true;
-			}
-			++i;
-		}
-
-		return false;
+		m_Root = take(m_Root, count, out);
+		m_Available -= count;
+		return true;
 	}
 
 	bool destroy(T id, T count = 1) {
-		if(count == 0)
+		if(count == 0 || count > m_Max || id > m_Max - count)
 			return false;
-		range r {id, id + count};
-		auto insert_loc = std::upper_bound(std::begin(m_FreeRanges), std::end(m_FreeRanges), r);
 
-		if((insert_loc != std::begin(m_FreeRanges) && std::prev(insert_loc)->overlaps(r)) ||
-		   (insert_loc != std::end(m_FreeRanges) && insert_loc->overlaps(r))) {
+		index_t lower, upper;
+		split(m_Root, id, lower, upper);
+		auto previous = rightmost(lower);
+		auto next	  = leftmost(upper);
+		if((previous != npos && m_Nodes[previous].value.last > id) ||
+		   (next != npos && m_Nodes[next].value.first < id + count)) {
+			m_Root = merge(lower, upper);
 			return false;
 		}
 
-		size_t index = std::distance(std::begin(m_FreeRanges), m_FreeRanges.insert(insert_loc, r));
-
-		for(size_t i = ((index > 0) ? index - 1 : index), end = std::min(index + 1, m_FreeRanges.size()); i < end;) {
-			if(m_FreeRanges.size() <= i + 1)
-				break;
-			if(m_FreeRanges[i].last == m_FreeRanges[i + 1].first) {
-				m_FreeRanges[i].last = m_FreeRanges[i + 1].last;
-				m_FreeRanges.erase(std::next(std::begin(m_FreeRanges), i + 1));
-				continue;
-			}
-			++i;
+		// the destroyed ids are merged with the free ranges they border
+		range freed {id, id + count};
+		if(previous != npos && m_Nodes[previous].value.last == id) {
+			freed.first = m_Nodes[previous].value.first;
+			lower		= pop_back(lower);
 		}
+		if(next != npos && m_Nodes[next].value.first == id + count) {
+			freed.last = m_Nodes[next].value.last;
+			upper	   = pop_front(upper);
+		}
+		m_Root = merge(merge(lower, allocate(freed)), upper);
+		m_Available += count;
 		return true;
 	}
 
+	/// \returns true when none of the ids in the range are free.
 	bool valid(T id, T count = 1) const noexcept {
-		range r {id, id + count};
-		auto insert_loc = std::upper_bound(std::begin(m_FreeRanges), std::end(m_FreeRanges), r);
-		if((insert_loc != std::begin(m_FreeRanges) && std::prev(insert_loc)->overlaps(r)) ||
-		   (insert_loc != std::end(m_FreeRanges) && insert_loc->overlaps(r))) {
-			return false;
+		// only the last free range that starts before the end of the ids can overlap them
+		index_t candidate {npos};
+		for(auto t = m_Root; t != npos;) {
+			if(m_Nodes[t].value.first < id + count) {
+				candidate = t;
+				t		  = m_Nodes[t].right;
+			} else {
+				t = m_Nodes[t].left;
+			}
 		}
-
-		return true;
+		return candidate == npos || m_Nodes[candidate].value.last <= id;
 	}
 
-	T largest_continuous_range() const noexcept {
-		range r {};
-		for(const auto& range : m_FreeRanges) {
-			if(range.size() > r.size())
-				r = range;
-		}
-		return r;
-	}
+	T largest_continuous_range() const noexcept { return largest(m_Root); }
 
+	/// \brief changes the capacity of the generator.
+	/// \returns false when shrinking would drop ids that are in use.
 	bool resize(T size) {
 		if(size == m_Max)
 			return true;
+
+		auto last		= rightmost(m_Root);
+		const bool tail = last != npos && m_Nodes[last].value.last == m_Max;
 		if(size > m_Max) {
-			if(m_FreeRanges.size() > 0) {
-				m_FreeRanges[m_FreeRanges.size() - 1].last = size;
-			} else {
-				m_FreeRanges.emplace_back(range {m_Max, size});
+			range grown {m_Max, size};
+			if(tail) {
+				grown.first = m_Nodes[last].value.first;
+				m_Root		= pop_back(m_Root);
 			}
+			m_Root = merge(m_Root, allocate(grown));
+			m_Available += size - m_Max;
 			m_Max = size;
 			return true;
-		} else if(m_FreeRanges.size() > 0 && m_FreeRanges[m_FreeRanges.size() - 1].begin() >= size) {
-			m_FreeRanges[m_FreeRanges.size() - 1].last = size;
-
+		} else if(tail && m_Nodes[last].value.first <= size) {
+			range shrunk {m_Nodes[last].value.first, size};
+			m_Root = pop_back(m_Root);
+			if(shrunk.size() > 0)
+				m_Root = merge(m_Root, allocate(shrunk));
+			m_Available -= m_Max - size;
 			m_Max = size;
-			if(m_FreeRanges[m_FreeRanges.size() - 1].size() == 0)
-				m_FreeRanges.erase(std::prev(std::end(m_FreeRanges)));
 			return true;
 		}
 
 		return false;
 	}
+
+  private:
+	T largest(index_t t) const noexcept { return (t == npos) ? T {0} : m_Nodes[t].largest; }
+
+	index_t leftmost(index_t t) const noexcept {
+		if(t != npos)
+			while(m_Nodes[t].left != npos) t = m_Nodes[t].left;
+		return t;
+	}
+
+	index_t rightmost(index_t t) const noexcept {
+		if(t != npos)
+			while(m_Nodes[t].right != npos) t = m_Nodes[t].right;
+		return t;
+	}
+
+	void update(index_t t) noexcept {
+		auto& n	  = m_Nodes[t];
+		n.largest = std::max({n.value.size(), largest(n.left), largest(n.right)});
+	}
+
+	index_t allocate(range value) {
+		// xorshift32, the priorities only need to be spread well enough to keep the tree balanced
+		m_Seed ^= m_Seed << 13;
+		m_Seed ^= m_Seed >> 17;
+		m_Seed ^= m_Seed << 5;
+		node n {value, value.size(), m_Seed, npos, npos};
+		if(!m_Unused.empty()) {
+			auto index = m_Unused.back();
+			m_Unused.pop_back();
+			m_Nodes[index] = n;
+			return index;
+		}
+		m_Nodes.emplace_back(n);
+		return static_cast<index_t>(m_Nodes.size() - 1);
+	}
+
+	void release(index_t t) { m_Unused.emplace_back(t); }
+
+	/// \brief joins both subtrees, where all ranges of lhs come before the ones of rhs.
+	index_t merge(index_t lhs, index_t rhs) noexcept {
+		if(lhs == npos)
+			return rhs;
+		if(rhs == npos)
+			return lhs;
+		if(m_Nodes[lhs].priority > m_Nodes[rhs].priority) {
+			m_Nodes[lhs].right = merge(m_Nodes[lhs].right, rhs);
+			update(lhs);
+			return lhs;
+		}
+		m_Nodes[rhs].left = merge(lhs, m_Nodes[rhs].left);
+		update(rhs);
+		return rhs;
+	}
+
+	/// \brief splits the subtree into the ranges that start before the id (lower), and the ones that don't (upper).
+	void split(index_t t, T id, index_t& lower, index_t& upper) noexcept {
+		if(t == npos) {
+			lower = upper = npos;
+			return;
+		}
+		if(m_Nodes[t].value.first < id) {
+			split(m_Nodes[t].right, id, m_Nodes[t].right, upper);
+			lower = t;
+		} else {
+			split(m_Nodes[t].left, id, lower, m_Nodes[t].left);
+			upper = t;
+		}
+		update(t);
+	}
+
+	/// \brief takes count ids from the front of the first range in the subtree that is large enough.
+	/// \returns the new root of the subtree.
+	/// \warning the subtree should contain a range that is large enough.
+	index_t take(index_t t, T count, T& out) {
+		auto& n = m_Nodes[t];
+		if(largest(n.left) >= count) {
+			n.left = take(n.left, count, out);
+		} else if(n.value.size() >= count) {
+			out = n.value.first;
+			n.value.first += count;
+			if(n.value.size() == 0) {
+				auto res = merge(n.left, n.right);
+				release(t);
+				return res;
+			}
+		} else {
+			n.right = take(n.right, count, out);
+		}
+		update(t);
+		return t;
+	}
+
+	/// \brief removes the first range of the subtree.
+	index_t pop_front(index_t t) {
+		if(m_Nodes[t].left == npos) {
+			release(t);
+			return m_Nodes[t].right;
+		}
+		m_Nodes[t].left = pop_front(m_Nodes[t].left);
+		update(t);
+		return t;
+	}
+
+	/// \brief removes the last range of the subtree.
+	index_t pop_back(index_t t) {
+		if(m_Nodes[t].right == npos) {
+			release(t);
+			return m_Nodes[t].left;
+		}
+		m_Nodes[t].right = pop_back(m_Nodes[t].right);
+		update(t);
+		return t;
+	}
 };
 
 
@@ -1,12 +1,14 @@
 #pragma once
 //#include <string>
 //#include <string_view>
+#include "psl/file.hpp"
 #include "psl/logging.hpp"
 #include "psl/meta.hpp"
 #include "psl/serialization/polymorphic.hpp"
 #include "psl/serialization/serializer.hpp"
 #include "ustring.hpp"
 #include <bitset>
+#include <list>
 #include <memory>
 #include <unordered_map>
 #include <unordered_set>
@@ -102,7 +104,9 @@ class library {
 	library(library&& other) noexcept
 		: m_TagMap(std::move(other.m_TagMap)), m_MetaData(std::move(other.m_MetaData)),
 		  m_LibraryFile(std::move(other.m_LibraryFile)), m_LibraryFolder(std::move(other.m_LibraryFolder)),
-		  m_LibraryLocation(std::move(other.m_LibraryLocation)), m_Environment(std::move(other.m_Environment)) {};
+		  m_LibraryLocation(std::move(other.m_LibraryLocation)), m_Environment(std::move(other.m_Environment)),
+		  m_Mappings(std::move(other.m_Mappings)), m_MappingLookup(std::move(other.m_MappingLookup)),
+		  m_MappingCapacity(other.m_MappingCapacity) {};
 	library& operator=(const library& other) = delete;
 	library& operator=(library&& other) noexcept {
 		if(this != &other) {
@@ -112,6 +116,9 @@ class library {
 			m_LibraryFolder	  = std::move(other.m_LibraryFolder);
 			m_LibraryLocation = std::move(other.m_LibraryLocation);
 			m_Environment	  = std::move(other.m_Environment);
+			m_Mappings		  = std::move(other.m_Mappings);
+			m_MappingLookup	  = std::move(other.m_MappingLookup);
+			m_MappingCapacity = other.m_MappingCapacity;
 		}
 		return *this;
 	};
@@ -163,6 +170,29 @@ class library {
 		return std::pair<const psl::UID&, MF&>(pair.first->first, *(static_cast<MF*>(pair.first->second.data.get())));
 	}
 
+	/// \brief creates a new entry with the given psl::UID, that is backed by a file on disk which does not have to
+	/// exist yet.
+	///
+	/// This allows resources that are created at runtime, such as caches, to persist their content through load() and
+	/// write() without being listed in the library file.
+	/// \param[in] uid The psl::UID that should be associated with this entry.
+	/// \param[in] path the location of the file, relative to the meta::library's location.
+	/// \note the entry itself is not persisted, and has to be created again on the next run.
+	/// \warning giving an already present psl::UID will result in an error log, and you will be given back the instance
+	/// that is already present.
+	template <typename MF = file>
+	std::pair<const psl::UID&, MF&> create_physical(const psl::UID& uid, psl::string8::view path) {
+		const bool exists = m_MetaData.find(uid) != m_MetaData.end();
+		auto pair		  = create<MF>(uid);
+		if(!exists) {
+			auto& data		  = m_MetaData[uid];
+			data.flags[0]	  = true;
+			data.readableName = psl::string8_t {path};
+			m_TagMap[data.readableName].insert(uid);
+		}
+		return pair;
+	}
+
 	/// \brief serializes the given psl::UID to disk in case it is present, and an on-disk file.
 	///
 	/// When you send a psl::UID to this method, the meta::library will verify that it has an entry with the given
@@ -255,11 +285,13 @@ class library {
 	/// Loads the specified psl::UID's associated file, **not** meta::file, and returns it (if found).
 	/// The associated file is the companion file for which the meta::file was generated, for example a shader will
 	/// have a core::meta::shader file on disk, but also the actual shader file (SPIR-V for Vulkan). This returns
-	/// the SPIR-V file. The file content will get cached into the meta::library to make subsequent load() calls
-	/// faster.
+	/// the SPIR-V file. The file gets memory mapped, and the meta::library keeps the most recently used mappings
+	/// open to make subsequent load() calls faster (see mapping_capacity()).
 	/// \param[in] uid the given psl::UID to optionally find the content for.
 	/// \returns the resulting content in UTF-8 format if found.
 	/// \warning this method requires the file to satisfy is_physical_file(), otherwise it will silently fail.
+	/// \warning the returned view is only valid until the psl::UID is unloaded, or its mapping gets evicted by
+	/// subsequent load() calls. Copy the content out when it needs to outlive that.
 	std::optional<psl::string8::view> load(const psl::UID& uid);
 
 	/// \brief purges the specific psl::UID's cachec content.
@@ -274,6 +306,17 @@ class library {
 	/// \warning this method requires the file to satisfy is_physical_file(), otherwise it will silently fail.
 	bool unload(const psl::UID& uid);
 
+	/// \brief writes the content to the specific psl::UID's associated file.
+	///
+	/// Replaces the content of the associated file on disk, **not** the meta::file. Any content that is cached or
+	/// mapped for the psl::UID gets released first, so that views that were returned by load() for this psl::UID are
+	/// invalidated.
+	/// \param[in] uid the given psl::UID to write the content for.
+	/// \param[in] content the (binary) content to write.
+	/// \returns true if it was found on the meta::library, and the content was written.
+	/// \warning this method requires the file to satisfy is_physical_file(), otherwise it will silently fail.
+	bool write(const psl::UID& uid, psl::string8::view content);
+
 	/// \brief get the psl::UID's associated meta::file from the meta::library and tries to cast to the templated
 	/// type.
 	///
@@ -309,6 +352,13 @@ class library {
 
 	const std::vector<psl::string8_t>& environment() const noexcept { return m_Environment; }
 
+	/// \returns the maximum amount of file mappings that are kept open.
+	size_t mapping_capacity() const noexcept { return m_MappingCapacity; }
+
+	/// \brief sets the maximum amount of file mappings that are kept open, evicting the least recently used
+	/// mappings if needed.
+	void mapping_capacity(size_t capacity);
+
   private:
 	struct UIDData {
 		UIDData(std::unique_ptr<file>&& dataPtr) : data(std::move(dataPtr)), flags(0) {};
@@ -336,6 +386,15 @@ class library {
 	psl::string8::view m_LibraryFolder;
 	psl::string8_t m_LibraryLocation;
 	std::vector<psl::string8_t> m_Environment;
+
+	struct mapping_t {
+		psl::UID uid;
+		std::unique_ptr<utility::os::file> file;
+	};
+	// most recently used mapping at the front
+	std::list<mapping_t> m_Mappings;
+	std::unordered_map<psl::UID, std::list<mapping_t>::iterator> m_MappingLookup;
+	size_t m_MappingCapacity {64};
 };
 template <typename T>
 std::optional<T*> library::get(const psl::UID& uid) const {
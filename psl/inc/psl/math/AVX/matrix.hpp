@@ -1,8 +1,120 @@
 #pragma once
-#if INSTRUCTION_SET == 2
-	#undef INSTRUCTION_SET
-	#define INSTRUCTION_SET 1
-	#include "math/SSE/matrix.hpp"
-	#undef INSTRUCTION_SET
-	#define INSTRUCTION_SET 2
+#if INSTRUCTION_SET >= 2
+	#include "psl/math/matrix.hpp"
+	#include "psl/math/vec.hpp"
+	#include <immintrin.h>
+	#include <type_traits>
+
+namespace psl {
+template <typename precision_t, size_t d1, size_t d2, size_t d3>
+constexpr tmat<precision_t, d1, d3> operator*(const tmat<precision_t, d1, d2>& left,
+											  const tmat<precision_t, d2, d3>& right) noexcept {
+	tmat<precision_t, d1, d3> res {1};
+	if constexpr(std::is_same_v<precision_t, float> && d1 == 4 && d2 == 4 && d3 == 4) {
+		// every column of left is repeated in both halves of a register, so that two columns of the result are
+		// computed at once, each half taking its factors from its own column of right.
+		__m256 columns[4];
+		for(size_t j = 0; j < 4; ++j) {
+			const __m128 column {_mm_loadu_ps(&left[j * 4])};
+			columns[j] = _mm256_set_m128(column, column);
+		}
+		for(size_t i = 0; i < 16; i += 8) {
+			const __m256 factors {_mm256_loadu_ps(&right[i])};
+			__m256 r_line {_mm256_mul_ps(columns[0], _mm256_permute_ps(factors, _MM_SHUFFLE(0, 0, 0, 0)))};
+			r_line = details::fmadd(columns[1], _mm256_permute_ps(factors, _MM_SHUFFLE(1, 1, 1, 1)), r_line);
+			r_line = details::fmadd(columns[2], _mm256_permute_ps(factors, _MM_SHUFFLE(2, 2, 2, 2)), r_line);
+			r_line = details::fmadd(columns[3], _mm256_permute_ps(factors, _MM_SHUFFLE(3, 3, 3, 3)), r_line);
+			_mm256_storeu_ps(&res[i], r_line);
+		}
+	} else {
+		for(size_t column = 0; column < d1; column++) {
+			for(size_t row = 0; row < d3; row++) {
+				res[{row, column}] = precision_t {0};
+				for(size_t p = 0; p < d2; p++) {
+					res[{row, column}] += left[{p, column}] * right[{row, p}];
+				}
+			}
+		}
+	}
+	return res;
+}
+}	 // namespace psl
+
+namespace psl::details {
+// the 2x2 matrix operations of SSE/matrix.hpp, on two pairs of matrices at once
+/// \returns left * right
+inline __m256 mul_2x2(__m256 left, __m256 right) noexcept {
+	return fmadd(left,
+				 _mm256_permute_ps(right, _MM_SHUFFLE(3, 0, 3, 0)),
+				 _mm256_mul_ps(_mm256_permute_ps(left, _MM_SHUFFLE(2, 3, 0, 1)),
+							   _mm256_permute_ps(right, _MM_SHUFFLE(1, 2, 1, 2))));
+}
+/// \returns adj(left) * right
+inline __m256 adj_mul_2x2(__m256 left, __m256 right) noexcept {
+	return fmsub(_mm256_permute_ps(left, _MM_SHUFFLE(0, 0, 3, 3)),
+				 right,
+				 _mm256_mul_ps(_mm256_permute_ps(left, _MM_SHUFFLE(2, 2, 1, 1)),
+							   _mm256_permute_ps(right, _MM_SHUFFLE(1, 0, 3, 2))));
+}
+/// \returns left * adj(right)
+inline __m256 mul_adj_2x2(__m256 left, __m256 right) noexcept {
+	return fmsub(left,
+				 _mm256_permute_ps(right, _MM_SHUFFLE(0, 3, 0, 3)),
+				 _mm256_mul_ps(_mm256_permute_ps(left, _MM_SHUFFLE(2, 3, 0, 1)),
+							   _mm256_permute_ps(right, _MM_SHUFFLE(1, 2, 1, 2))));
+}
+
+/// \brief inverts the 16 components of a 4x4 matrix, see psl::math::inverse.
+/// \details this is the block inversion of the SSE version, where the blocks that go through the same operations are
+/// paired in the halves of a single register.
+/// \param[in] in the components of the matrix, these do not need to be aligned.
+/// \param[out] out the components of the inverted matrix, this can be the same as `in`.
+inline void inverse_4x4(const float* in, float* out) noexcept {
+	const __m128 r0 {_mm_loadu_ps(in)};
+	const __m128 r1 {_mm_loadu_ps(in + 4)};
+	const __m128 r2 {_mm_loadu_ps(in + 8)};
+	const __m128 r3 {_mm_loadu_ps(in + 12)};
+	const __m128 a {_mm_movelh_ps(r0, r1)};
+	const __m128 b {_mm_movehl_ps(r1, r0)};
+	const __m128 c {_mm_movelh_ps(r2, r3)};
+	const __m128 d {_mm_movehl_ps(r3, r2)};
+	const __m256 ad {_mm256_set_m128(d, a)};
+	const __m256 da {_mm256_set_m128(a, d)};
+	const __m256 bc {_mm256_set_m128(c, b)};
+	const __m256 cb {_mm256_set_m128(b, c)};
+
+	// the determinants of the blocks as [|A|, |B|, |C|, |D|]
+	const __m128 determinants {_mm_sub_ps(
+	  _mm_mul_ps(_mm_shuffle_ps(r0, r2, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(r1, r3, _MM_SHUFFLE(3, 1, 3, 1))),
+	  _mm_mul_ps(_mm_shuffle_ps(r0, r2, _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_ps(r1, r3, _MM_SHUFFLE(2, 0, 2, 0))))};
+	const __m256 determinantsx2 {_mm256_set_m128(determinants, determinants)};
+	const __m256 detDA {_mm256_permutevar_ps(determinantsx2, _mm256_setr_epi32(3, 3, 3, 3, 0, 0, 0, 0))};
+	const __m256 detBC {_mm256_permutevar_ps(determinantsx2, _mm256_setr_epi32(1, 1, 1, 1, 2, 2, 2, 2))};
+
+	// [adj(D) * C, adj(A) * B], and the same with its halves swapped
+	const __m256 dcab {adj_mul_2x2(da, cb)};
+	const __m256 abdc {_mm256_permute2f128_ps(dcab, dcab, 0x01)};
+	// the adjugates of the blocks of the inverse, as [X, W] and [Y, Z]
+	const __m256 xw {fmsub(detDA, ad, mul_2x2(bc, dcab))};
+	const __m256 yz {fmsub(detBC, cb, mul_adj_2x2(da, abdc))};
+
+	// |M| = |A| * |D| + |B| * |C| - trace(adj(A) * B * adj(D) * C)
+	const __m128 dc {_mm256_castps256_ps128(dcab)};
+	const __m128 ab {_mm256_castps256_ps128(abdc)};
+	const __m128 trace {dot(ab, _mm_shuffle_ps(dc, dc, _MM_SHUFFLE(3, 1, 2, 0)))};
+	// [|A|, |B|, 0, 0] against [|D|, |C|, |B|, |A|], so that every product is only summed once
+	const __m128 products {dot(_mm_movelh_ps(determinants, _mm_setzero_ps()),
+							   _mm_shuffle_ps(determinants, determinants, _MM_SHUFFLE(0, 1, 2, 3)))};
+	const __m128 reciprocal {_mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), _mm_sub_ps(products, trace))};
+	const __m256 reciprocalx2 {_mm256_set_m128(reciprocal, reciprocal)};
+
+	// regroup the blocks as [X, Z] and [Y, W], so that taking their adjugate results in the rows [0, 2] and [1, 3]
+	const __m256 xz {_mm256_mul_ps(_mm256_blend_ps(xw, yz, 0xF0), reciprocalx2)};
+	const __m256 yw {_mm256_mul_ps(_mm256_blend_ps(yz, xw, 0xF0), reciprocalx2)};
+	const __m256 rows02 {_mm256_shuffle_ps(xz, yw, _MM_SHUFFLE(1, 3, 1, 3))};
+	const __m256 rows13 {_mm256_shuffle_ps(xz, yw, _MM_SHUFFLE(0, 2, 0, 2))};
+	_mm256_storeu_ps(out, _mm256_permute2f128_ps(rows02, rows13, 0x20));
+	_mm256_storeu_ps(out + 8, _mm256_permute2f128_ps(rows02, rows13, 0x31));
+}
+}	 // namespace psl::details
 #endif
@@ -1,8 +1,89 @@
 #pragma once
-#if INSTRUCTION_SET == 2
-	#undef INSTRUCTION_SET
-	#define INSTRUCTION_SET 1
-	#include "math/SSE/vec.hpp"
-	#undef INSTRUCTION_SET
-	#define INSTRUCTION_SET 2
+#if INSTRUCTION_SET >= 2
+	#include "psl/math/vec.hpp"
+	#include <immintrin.h>
+	#include <type_traits>
+
+namespace psl {
+// tvec<double, 4> is only aligned on 16 bytes, so its 256bit registers are loaded and stored unaligned
+template <typename precision_t>
+constexpr tvec<precision_t, 4>& operator+=(tvec<precision_t, 4>& owner, const tvec<precision_t, 4>& other) noexcept {
+	if constexpr(std::is_same<float, precision_t>::value) {
+		_mm_store_ps(owner.value.data(), _mm_add_ps(_mm_load_ps(owner.value.data()), _mm_load_ps(other.value.data())));
+	} else if constexpr(std::is_same<double, precision_t>::value) {
+		_mm256_storeu_pd(owner.value.data(),
+						 _mm256_add_pd(_mm256_loadu_pd(owner.value.data()), _mm256_loadu_pd(other.value.data())));
+	} else {
+		owner.value[0] += other.value[0];
+		owner.value[1] += other.value[1];
+		owner.value[2] += other.value[2];
+		owner.value[3] += other.value[3];
+	}
+	return owner;
+}
+
+template <typename precision_t>
+constexpr tvec<precision_t, 4>& operator*=(tvec<precision_t, 4>& owner, const tvec<precision_t, 4>& other) noexcept {
+	if constexpr(std::is_same<float, precision_t>::value) {
+		_mm_store_ps(owner.value.data(), _mm_mul_ps(_mm_load_ps(owner.value.data()), _mm_load_ps(other.value.data())));
+	} else if constexpr(std::is_same<double, precision_t>::value) {
+		_mm256_storeu_pd(owner.value.data(),
+						 _mm256_mul_pd(_mm256_loadu_pd(owner.value.data()), _mm256_loadu_pd(other.value.data())));
+	} else {
+		owner.value[0] *= other.value[0];
+		owner.value[1] *= other.value[1];
+		owner.value[2] *= other.value[2];
+		owner.value[3] *= other.value[3];
+	}
+	return owner;
+}
+
+template <typename precision_t>
+constexpr tvec<precision_t, 4>& operator/=(tvec<precision_t, 4>& owner, const tvec<precision_t, 4>& other) noexcept {
+	#ifdef MATH_DIV_ZERO_CHECK
+	if(other.value[0] == 0 || other.value[1] == 0 || other.value[2] == 0 || other.value[3] == 0)
+		throw std::runtime_exception("division by 0");
+	#endif
+	if constexpr(std::is_same<float, precision_t>::value) {
+		_mm_store_ps(owner.value.data(), _mm_div_ps(_mm_load_ps(owner.value.data()), _mm_load_ps(other.value.data())));
+	} else if constexpr(std::is_same<double, precision_t>::value) {
+		_mm256_storeu_pd(owner.value.data(),
+						 _mm256_div_pd(_mm256_loadu_pd(owner.value.data()), _mm256_loadu_pd(other.value.data())));
+	} else {
+		owner.value[0] /= other.value[0];
+		owner.value[1] /= other.value[1];
+		owner.value[2] /= other.value[2];
+		owner.value[3] /= other.value[3];
+	}
+	return owner;
+}
+
+template <typename precision_t>
+constexpr tvec<precision_t, 4>& operator-=(tvec<precision_t, 4>& owner, const tvec<precision_t, 4>& other) noexcept {
+	if constexpr(std::is_same<float, precision_t>::value) {
+		_mm_store_ps(owner.value.data(), _mm_sub_ps(_mm_load_ps(owner.value.data()), _mm_load_ps(other.value.data())));
+	} else if constexpr(std::is_same<double, precision_t>::value) {
+		_mm256_storeu_pd(owner.value.data(),
+						 _mm256_sub_pd(_mm256_loadu_pd(owner.value.data()), _mm256_loadu_pd(other.value.data())));
+	} else {
+		owner.value[0] -= other.value[0];
+		owner.value[1] -= other.value[1];
+		owner.value[2] -= other.value[2];
+		owner.value[3] -= other.value[3];
+	}
+	return owner;
+}
+}	 // namespace psl
+
+namespace psl::details {
+	#if INSTRUCTION_SET == 2
+/// \brief multiply-add operations on 8 lanes, see their 4 lane versions in SSE/vec.hpp.
+inline __m256 fmadd(__m256 a, __m256 b, __m256 c) noexcept {
+	return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+}
+inline __m256 fmsub(__m256 a, __m256 b, __m256 c) noexcept {
+	return _mm256_sub_ps(_mm256_mul_ps(a, b), c);
+}
+	#endif
+}	 // namespace psl::details
 #endif
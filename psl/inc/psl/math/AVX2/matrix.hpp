@@ -1,8 +1,24 @@
 #pragma once
 #if INSTRUCTION_SET == 3
-	#undef INSTRUCTION_SET
-	#define INSTRUCTION_SET 2
-	#include "math/AVX/matrix.hpp"
-	#undef INSTRUCTION_SET
-	#define INSTRUCTION_SET 3
+	#include "psl/math/matrix.hpp"
+	#include <immintrin.h>
+
+namespace psl::details {
+/// \brief transposes the 16 components of a 4x4 matrix, see psl::math::transpose.
+/// \details the components are interleaved within the halves of the registers, after which a single cross lane
+/// permute puts each of them in place.
+/// \param[in] in the components of the matrix, these do not need to be aligned.
+/// \param[out] out the components of the transposed matrix, this can be the same as `in`.
+inline void transpose_4x4(const float* in, float* out) noexcept {
+	const __m256 r01 {_mm256_loadu_ps(in)};
+	const __m256 r23 {_mm256_loadu_ps(in + 8)};
+	const __m256i order {_mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7)};
+	// [m0, m8, m1, m9, m4, m12, m5, m13] and [m2, m10, m3, m11, m6, m14, m7, m15]
+	_mm256_storeu_ps(out, _mm256_permutevar8x32_ps(_mm256_unpacklo_ps(r01, r23), order));
+	_mm256_storeu_ps(out + 8, _mm256_permutevar8x32_ps(_mm256_unpackhi_ps(r01, r23), order));
+}
+}	 // namespace psl::details
+
+	// the remaining kernels are those of AVX/matrix.hpp, using the fused multiply-add operations of AVX2/vec.hpp
+	#include "psl/math/AVX/matrix.hpp"
 #endif
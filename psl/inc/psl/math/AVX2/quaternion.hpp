@@ -1,8 +1,6 @@
 #pragma once
 #if INSTRUCTION_SET == 3
-	#undef INSTRUCTION_SET
-	#define INSTRUCTION_SET 2
-	#include "math/AVX/quaternion.hpp"
-	#undef INSTRUCTION_SET
-	#define INSTRUCTION_SET 3
+	// the quaternion operations of AVX/quaternion.hpp and SSE/quaternion.hpp are used as is, the kernels of the latter
+	// use the fused multiply-add operations of AVX2/vec.hpp
+	#include "psl/math/AVX/quaternion.hpp"
 #endif
@@ -1,8 +1,25 @@
 #pragma once
 #if INSTRUCTION_SET == 3
-	#undef INSTRUCTION_SET
-	#define INSTRUCTION_SET 2
-	#include "math/AVX/vec.hpp"
-	#undef INSTRUCTION_SET
-	#define INSTRUCTION_SET 3
+	#include "psl/math/vec.hpp"
+	#include <immintrin.h>
+
+namespace psl::details {
+/// \brief fused multiply-add operations, `fmadd` is `a * b + c` and `fmsub` is `a * b - c`.
+/// \details these replace the unfused versions of SSE/vec.hpp and AVX/vec.hpp, the kernels of those instruction sets
+/// are used as is otherwise.
+inline __m128 fmadd(__m128 a, __m128 b, __m128 c) noexcept {
+	return _mm_fmadd_ps(a, b, c);
+}
+inline __m128 fmsub(__m128 a, __m128 b, __m128 c) noexcept {
+	return _mm_fmsub_ps(a, b, c);
+}
+inline __m256 fmadd(__m256 a, __m256 b, __m256 c) noexcept {
+	return _mm256_fmadd_ps(a, b, c);
+}
+inline __m256 fmsub(__m256 a, __m256 b, __m256 c) noexcept {
+	return _mm256_fmsub_ps(a, b, c);
+}
+}	 // namespace psl::details
+
+	#include "psl/math/AVX/vec.hpp"
 #endif
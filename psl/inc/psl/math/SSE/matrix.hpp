@@ -1,27 +1,31 @@
 #pragma once
-#if INSTRUCTION_SET == 1
+#if INSTRUCTION_SET >= 1
 	#include "psl/math/matrix.hpp"
+	#include "psl/math/vec.hpp"
+	#include <type_traits>
 	#include <xmmintrin.h>
 
+	#if INSTRUCTION_SET == 1
 namespace psl {
 template <typename precision_t, size_t d1, size_t d2, size_t d3>
 constexpr tmat<precision_t, d1, d3> operator*(const tmat<precision_t, d1, d2>& left,
 											  const tmat<precision_t, d2, d3>& right) noexcept {
 	tmat<precision_t, d1, d3> res {1};
-	if constexpr(d1 * d3 == 16) {
+	if constexpr(std::is_same_v<precision_t, float> && d1 == 4 && d2 == 4 && d3 == 4) {
+		// tmat is not over-aligned, so its columns are loaded and stored unaligned
 		__m128 a_line, b_line, r_line;
 		for(int i = 0; i < 16; i += 4) {
 			// unroll the first step of the loop to avoid having to initialize r_line to zero
-			a_line = _mm_load_ps(left.value.data());	// a_line = vec4(column(a, 0))
-			b_line = _mm_set1_ps(right[i]);				// b_line = vec4(b[i][0])
-			r_line = _mm_mul_ps(a_line, b_line);		// r_line = a_line * b_line
+			a_line = _mm_loadu_ps(left.value.data());	 // a_line = vec4(column(a, 0))
+			b_line = _mm_set1_ps(right[i]);				 // b_line = vec4(b[i][0])
+			r_line = _mm_mul_ps(a_line, b_line);		 // r_line = a_line * b_line
 			for(int j = 1; j < 4; j++) {
-				a_line = _mm_load_ps(&left[j * 4]);	   // a_line = vec4(column(a, j))
-				b_line = _mm_set1_ps(right[i + j]);	   // b_line = vec4(b[i][j])
-													   // r_line += a_line * b_line
+				a_line = _mm_loadu_ps(&left[j * 4]);	// a_line = vec4(column(a, j))
+				b_line = _mm_set1_ps(right[i + j]);		// b_line = vec4(b[i][j])
+														// r_line += a_line * b_line
 				r_line = _mm_add_ps(_mm_mul_ps(a_line, b_line), r_line);
 			}
-			_mm_store_ps(&res[i], r_line);	  // r[i] = r_line
+			_mm_storeu_ps(&res[i], r_line);	   // r[i] = r_line
 		}
 	} else {
 		for(size_t column = 0; column < d1; column++) {
@@ -36,4 +40,182 @@ constexpr tmat<precision_t, d1, d3> operator*(const tmat<precision_t, d1, d2>& l
 	return res;
 }
 }	 // namespace psl
+	#endif
+
+namespace psl::details {
+/// \brief composes 4 model matrices at once, see psl::math::compose.
+/// \details the inputs are transposed so every lane processes one transform, and the rows of the results are
+/// transposed back before being stored.
+/// \param[in] rotations the xyzw components of the quaternions.
+/// \param[in] positions the xyz components of the translations.
+/// \param[in] scales the xyz components of the scales.
+/// \param[out] out the 16 components of the resulting matrices, these do not need to be aligned.
+inline void compose_x4(const float* const (&rotations)[4],
+					   const float* const (&positions)[4],
+					   const float* const (&scales)[4],
+					   float* const (&out)[4]) noexcept {
+	__m128 x {_mm_loadu_ps(rotations[0])};
+	__m128 y {_mm_loadu_ps(rotations[1])};
+	__m128 z {_mm_loadu_ps(rotations[2])};
+	__m128 w {_mm_loadu_ps(rotations[3])};
+	_MM_TRANSPOSE4_PS(x, y, z, w);
+
+	const __m128 one {_mm_set1_ps(1.0f)};
+	const __m128 two {_mm_set1_ps(2.0f)};
+	const __m128 qxx {_mm_mul_ps(x, x)};
+	const __m128 qyy {_mm_mul_ps(y, y)};
+	const __m128 qzz {_mm_mul_ps(z, z)};
+	const __m128 qxz {_mm_mul_ps(x, z)};
+	const __m128 qxy {_mm_mul_ps(x, y)};
+	const __m128 qyz {_mm_mul_ps(y, z)};
+	const __m128 qwx {_mm_mul_ps(w, x)};
+	const __m128 qwy {_mm_mul_ps(w, y)};
+	const __m128 qwz {_mm_mul_ps(w, z)};
+
+	const __m128 sx {_mm_setr_ps(scales[0][0], scales[1][0], scales[2][0], scales[3][0])};
+	const __m128 sy {_mm_setr_ps(scales[0][1], scales[1][1], scales[2][1], scales[3][1])};
+	const __m128 sz {_mm_setr_ps(scales[0][2], scales[1][2], scales[2][2], scales[3][2])};
+	const __m128 sx2 {_mm_mul_ps(sx, two)};
+	const __m128 sy2 {_mm_mul_ps(sy, two)};
+	const __m128 sz2 {_mm_mul_ps(sz, two)};
+
+	// row n of the rotation matrix is scaled by component n of the scale, and the last column is always 0
+	__m128 r0 {_mm_sub_ps(sx, _mm_mul_ps(sx2, _mm_add_ps(qyy, qzz)))};
+	__m128 r1 {_mm_mul_ps(sx2, _mm_add_ps(qxy, qwz))};
+	__m128 r2 {_mm_mul_ps(sx2, _mm_sub_ps(qxz, qwy))};
+	__m128 r3 {_mm_setzero_ps()};
+	_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+	_mm_storeu_ps(out[0], r0);
+	_mm_storeu_ps(out[1], r1);
+	_mm_storeu_ps(out[2], r2);
+	_mm_storeu_ps(out[3], r3);
+
+	r0 = _mm_mul_ps(sy2, _mm_sub_ps(qxy, qwz));
+	r1 = _mm_sub_ps(sy, _mm_mul_ps(sy2, _mm_add_ps(qxx, qzz)));
+	r2 = _mm_mul_ps(sy2, _mm_add_ps(qyz, qwx));
+	r3 = _mm_setzero_ps();
+	_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+	_mm_storeu_ps(out[0] + 4, r0);
+	_mm_storeu_ps(out[1] + 4, r1);
+	_mm_storeu_ps(out[2] + 4, r2);
+	_mm_storeu_ps(out[3] + 4, r3);
+
+	r0 = _mm_mul_ps(sz2, _mm_add_ps(qxz, qwy));
+	r1 = _mm_mul_ps(sz2, _mm_sub_ps(qyz, qwx));
+	r2 = _mm_sub_ps(sz, _mm_mul_ps(sz2, _mm_add_ps(qxx, qyy)));
+	r3 = _mm_setzero_ps();
+	_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+	_mm_storeu_ps(out[0] + 8, r0);
+	_mm_storeu_ps(out[1] + 8, r1);
+	_mm_storeu_ps(out[2] + 8, r2);
+	_mm_storeu_ps(out[3] + 8, r3);
+
+	r0 = _mm_setr_ps(positions[0][0], positions[1][0], positions[2][0], positions[3][0]);
+	r1 = _mm_setr_ps(positions[0][1], positions[1][1], positions[2][1], positions[3][1]);
+	r2 = _mm_setr_ps(positions[0][2], positions[1][2], positions[2][2], positions[3][2]);
+	r3 = one;
+	_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+	_mm_storeu_ps(out[0] + 12, r0);
+	_mm_storeu_ps(out[1] + 12, r1);
+	_mm_storeu_ps(out[2] + 12, r2);
+	_mm_storeu_ps(out[3] + 12, r3);
+}
+
+	#if INSTRUCTION_SET < 3
+/// \brief transposes the 16 components of a 4x4 matrix, see psl::math::transpose.
+/// \details AVX2/matrix.hpp replaces this with a version that uses cross lane permutes.
+/// \param[in] in the components of the matrix, these do not need to be aligned.
+/// \param[out] out the components of the transposed matrix, this can be the same as `in`.
+inline void transpose_4x4(const float* in, float* out) noexcept {
+	__m128 r0 {_mm_loadu_ps(in)};
+	__m128 r1 {_mm_loadu_ps(in + 4)};
+	__m128 r2 {_mm_loadu_ps(in + 8)};
+	__m128 r3 {_mm_loadu_ps(in + 12)};
+	_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+	_mm_storeu_ps(out, r0);
+	_mm_storeu_ps(out + 4, r1);
+	_mm_storeu_ps(out + 8, r2);
+	_mm_storeu_ps(out + 12, r3);
+}
+	#endif
+
+	#if INSTRUCTION_SET == 1
+// operations on 2x2 matrices, which are stored in a register as `[m00, m01, m10, m11]`, and where adj() is the
+// adjugate of the matrix.
+/// \returns left * right
+inline __m128 mul_2x2(__m128 left, __m128 right) noexcept {
+	return fmadd(left,
+				 _mm_shuffle_ps(right, right, _MM_SHUFFLE(3, 0, 3, 0)),
+				 _mm_mul_ps(_mm_shuffle_ps(left, left, _MM_SHUFFLE(2, 3, 0, 1)),
+							_mm_shuffle_ps(right, right, _MM_SHUFFLE(1, 2, 1, 2))));
+}
+/// \returns adj(left) * right
+inline __m128 adj_mul_2x2(__m128 left, __m128 right) noexcept {
+	return fmsub(_mm_shuffle_ps(left, left, _MM_SHUFFLE(0, 0, 3, 3)),
+				 right,
+				 _mm_mul_ps(_mm_shuffle_ps(left, left, _MM_SHUFFLE(2, 2, 1, 1)),
+							_mm_shuffle_ps(right, right, _MM_SHUFFLE(1, 0, 3, 2))));
+}
+/// \returns left * adj(right)
+inline __m128 mul_adj_2x2(__m128 left, __m128 right) noexcept {
+	return fmsub(left,
+				 _mm_shuffle_ps(right, right, _MM_SHUFFLE(0, 3, 0, 3)),
+				 _mm_mul_ps(_mm_shuffle_ps(left, left, _MM_SHUFFLE(2, 3, 0, 1)),
+							_mm_shuffle_ps(right, right, _MM_SHUFFLE(1, 2, 1, 2))));
+}
+
+/// \brief inverts the 16 components of a 4x4 matrix, see psl::math::inverse.
+/// \details the matrix is split in the 2x2 blocks `| A B |` and `| C D |`, the inverse is then composed of the
+/// adjugates of the blocks, and their determinants. As the inverse of the transpose is the transpose of the inverse,
+/// the components are treated as if they are stored row-major.
+/// \param[in] in the components of the matrix, these do not need to be aligned.
+/// \param[out] out the components of the inverted matrix, this can be the same as `in`.
+inline void inverse_4x4(const float* in, float* out) noexcept {
+	const __m128 r0 {_mm_loadu_ps(in)};
+	const __m128 r1 {_mm_loadu_ps(in + 4)};
+	const __m128 r2 {_mm_loadu_ps(in + 8)};
+	const __m128 r3 {_mm_loadu_ps(in + 12)};
+	const __m128 a {_mm_movelh_ps(r0, r1)};
+	const __m128 b {_mm_movehl_ps(r1, r0)};
+	const __m128 c {_mm_movelh_ps(r2, r3)};
+	const __m128 d {_mm_movehl_ps(r3, r2)};
+
+	// the determinants of the blocks as [|A|, |B|, |C|, |D|]
+	const __m128 determinants {fmsub(_mm_shuffle_ps(r0, r2, _MM_SHUFFLE(2, 0, 2, 0)),
+									 _mm_shuffle_ps(r1, r3, _MM_SHUFFLE(3, 1, 3, 1)),
+									 _mm_mul_ps(_mm_shuffle_ps(r0, r2, _MM_SHUFFLE(3, 1, 3, 1)),
+												_mm_shuffle_ps(r1, r3, _MM_SHUFFLE(2, 0, 2, 0))))};
+	const __m128 detA {_mm_shuffle_ps(determinants, determinants, _MM_SHUFFLE(0, 0, 0, 0))};
+	const __m128 detB {_mm_shuffle_ps(determinants, determinants, _MM_SHUFFLE(1, 1, 1, 1))};
+	const __m128 detC {_mm_shuffle_ps(determinants, determinants, _MM_SHUFFLE(2, 2, 2, 2))};
+	const __m128 detD {_mm_shuffle_ps(determinants, determinants, _MM_SHUFFLE(3, 3, 3, 3))};
+
+	const __m128 dc {adj_mul_2x2(d, c)};
+	const __m128 ab {adj_mul_2x2(a, b)};
+	// the adjugates of the blocks of the inverse
+	__m128 x {fmsub(detD, a, mul_2x2(b, dc))};
+	__m128 y {fmsub(detB, c, mul_adj_2x2(d, ab))};
+	__m128 z {fmsub(detC, b, mul_adj_2x2(a, dc))};
+	__m128 w {fmsub(detA, d, mul_2x2(c, ab))};
+
+	// |M| = |A| * |D| + |B| * |C| - trace(adj(A) * B * adj(D) * C)
+	__m128 trace {_mm_mul_ps(ab, _mm_shuffle_ps(dc, dc, _MM_SHUFFLE(3, 1, 2, 0)))};
+	trace = _mm_add_ps(trace, _mm_movehl_ps(trace, trace));
+	trace = _mm_add_ps(trace, _mm_shuffle_ps(trace, trace, _MM_SHUFFLE(1, 1, 1, 1)));
+	const __m128 determinant {_mm_sub_ps(fmadd(detA, detD, _mm_mul_ps(detB, detC)),
+										 _mm_shuffle_ps(trace, trace, _MM_SHUFFLE(0, 0, 0, 0)))};
+	const __m128 reciprocal {_mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), determinant)};
+	x = _mm_mul_ps(x, reciprocal);
+	y = _mm_mul_ps(y, reciprocal);
+	z = _mm_mul_ps(z, reciprocal);
+	w = _mm_mul_ps(w, reciprocal);
+
+	// taking the adjugate of the blocks is combined with storing them
+	_mm_storeu_ps(out, _mm_shuffle_ps(x, y, _MM_SHUFFLE(1, 3, 1, 3)));
+	_mm_storeu_ps(out + 4, _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 2, 0, 2)));
+	_mm_storeu_ps(out + 8, _mm_shuffle_ps(z, w, _MM_SHUFFLE(1, 3, 1, 3)));
+	_mm_storeu_ps(out + 12, _mm_shuffle_ps(z, w, _MM_SHUFFLE(0, 2, 0, 2)));
+}
+	#endif
+}	 // namespace psl::details
 #endif
@@ -1,7 +1,11 @@
 #pragma once
-#if INSTRUCTION_SET == 1
+#if INSTRUCTION_SET >= 1
 	#include "psl/math/quaternion.hpp"
+	#include "psl/math/vec.hpp"
+	#include <cmath>
 	#include <xmmintrin.h>
+
+	#if INSTRUCTION_SET == 1
 namespace psl {
 template <typename precision_t>
 tquat<precision_t>& operator+=(tquat<precision_t>& owner, const tquat<precision_t>& other) noexcept {
@@ -11,7 +15,9 @@ tquat<precision_t>& operator+=(tquat<precision_t>& owner, const tquat<precision_
 		auto addR {_mm_add_ps(ownL, othL)};
 		_mm_store_ps(owner.value.data(), addR);
 	} else if constexpr(std::is_same<double, precision_t>::value) {
-		_mm_store_pd(owner.value.data(), _mm_add_pd(_mm_load_pd(owner.value.data()), _mm_load_pd(other.value.data())));
+		// a register only holds 2 doubles
+		for(size_t i = 0; i < 4; i += 2)
+			_mm_store_pd(&owner.value[i], _mm_add_pd(_mm_load_pd(&owner.value[i]), _mm_load_pd(&other.value[i])));
 	} else {
 		owner.value[0] += other.value[0];
 		owner.value[1] += other.value[1];
@@ -21,31 +27,18 @@ tquat<precision_t>& operator+=(tquat<precision_t>& owner, const tquat<precision_
 	return owner;
 }
 
-template <typename precision_t>
-constexpr tquat<precision_t>& operator*=(tquat<precision_t>& owner, const tquat<precision_t>& other) noexcept {
-	tquat<precision_t> left = owner;
-	owner.value[0] = left.value[0] * other.value[3] + left.value[1] * other.value[2] - left.value[2] * other.value[1] +
-					 left.value[3] * other.value[0];
-	owner.value[1] = -left.value[0] * other.value[2] + left.value[1] * other.value[3] + left.value[2] * other.value[0] +
-					 left.value[3] * other.value[1];
-	owner.value[2] = left.value[0] * other.value[1] - left.value[1] * other.value[0] + left.value[2] * other.value[3] +
-					 left.value[3] * other.value[2];
-	owner.value[3] = -left.value[0] * other.value[0] - left.value[1] * other.value[1] - left.value[2] * other.value[2] +
-					 left.value[3] * other.value[3];
-	return owner;
-}
-
-
 template <typename precision_t>
 constexpr tquat<precision_t>& operator/=(tquat<precision_t>& owner, const tquat<precision_t>& other) {
-	#ifdef MATH_DIV_ZERO_CHECK
+		#ifdef MATH_DIV_ZERO_CHECK
 	if(other.value[0] == 0 || other.value[1] == 0 || other.value[2] == 0 || other.value[3] == 0)
 		throw std::runtime_exception("division by 0");
-	#endif
+		#endif
 	if constexpr(std::is_same<float, precision_t>::value) {
 		_mm_store_ps(owner.value.data(), _mm_div_ps(_mm_load_ps(owner.value.data()), _mm_load_ps(other.value.data())));
 	} else if constexpr(std::is_same<double, precision_t>::value) {
-		_mm_store_pd(owner.value.data(), _mm_div_pd(_mm_load_pd(owner.value.data()), _mm_load_pd(other.value.data())));
+		// a register only holds 2 doubles
+		for(size_t i = 0; i < 4; i += 2)
+			_mm_store_pd(&owner.value[i], _mm_div_pd(_mm_load_pd(&owner.value[i]), _mm_load_pd(&other.value[i])));
 	} else {
 		owner.value[0] /= other.value[0];
 		owner.value[1] /= other.value[1];
@@ -59,7 +52,9 @@ constexpr tquat<precision_t>& operator-=(tquat<precision_t>& owner, const tquat<
 	if constexpr(std::is_same<float, precision_t>::value) {
 		_mm_store_ps(owner.value.data(), _mm_sub_ps(_mm_load_ps(owner.value.data()), _mm_load_ps(other.value.data())));
 	} else if constexpr(std::is_same<double, precision_t>::value) {
-		_mm_store_pd(owner.value.data(), _mm_sub_pd(_mm_load_pd(owner.value.data()), _mm_load_pd(other.value.data())));
+		// a register only holds 2 doubles
+		for(size_t i = 0; i < 4; i += 2)
+			_mm_store_pd(&owner.value[i], _mm_sub_pd(_mm_load_pd(&owner.value[i]), _mm_load_pd(&other.value[i])));
 	} else {
 		owner.value[0] -= other.value[0];
 		owner.value[1] -= other.value[1];
@@ -68,6 +63,66 @@ constexpr tquat<precision_t>& operator-=(tquat<precision_t>& owner, const tquat<
 	}
 	return owner;
 }
+}	 // namespace psl
+	#endif
+
+namespace psl {
+// the quaternion product is written out as is, and used by the higher instruction sets as well
+template <typename precision_t>
+constexpr tquat<precision_t>& operator*=(tquat<precision_t>& owner, const tquat<precision_t>& other) noexcept {
+	tquat<precision_t> left = owner;
+	owner.value[0] = left.value[0] * other.value[3] + left.value[1] * other.value[2] - left.value[2] * other.value[1] +
+					 left.value[3] * other.value[0];
+	owner.value[1] = -left.value[0] * other.value[2] + left.value[1] * other.value[3] + left.value[2] * other.value[0] +
+					 left.value[3] * other.value[1];
+	owner.value[2] = left.value[0] * other.value[1] - left.value[1] * other.value[0] + left.value[2] * other.value[3] +
+					 left.value[3] * other.value[2];
+	owner.value[3] = -left.value[0] * other.value[0] - left.value[1] * other.value[1] - left.value[2] * other.value[2] +
+					 left.value[3] * other.value[3];
+	return owner;
+}
 }	 // namespace psl
 
+namespace psl::details {
+/// \brief rotates the vector by the quaternion, see psl::math::rotate.
+/// \param[in] quat the xyzw components of the quaternion, these should be aligned on 16 bytes.
+/// \param[in] vec the xyz components of the vector.
+/// \param[out] out the xyz components of the rotated vector.
+inline void rotate(const float* quat, const float* vec, float* out) noexcept {
+	const __m128 q {_mm_load_ps(quat)};
+	const __m128 v {_mm_setr_ps(vec[0], vec[1], vec[2], 0.0f)};
+	const __m128 uv {cross(q, v)};
+	const __m128 uuv {cross(q, uv)};
+	// vec + (uv * w + uuv) * 2
+	const __m128 res {fmadd(fmadd(uv, _mm_shuffle_ps(q, q, _MM_SHUFFLE(3, 3, 3, 3)), uuv), _mm_set1_ps(2.0f), v)};
+	alignas(16) float components[4];
+	_mm_store_ps(components, res);
+	out[0] = components[0];
+	out[1] = components[1];
+	out[2] = components[2];
+}
+
+/// \brief spherically interpolates between two unit quaternions, see psl::math::slerp.
+/// \param[in] from the xyzw components of the quaternion at `t == 0`, these should be aligned on 16 bytes.
+/// \param[in] to the xyzw components of the quaternion at `t == 1`, these should be aligned on 16 bytes.
+/// \param[out] out the xyzw components of the result, these should be aligned on 16 bytes.
+inline void slerp(const float* from, const float* to, float t, float* out) noexcept {
+	const __m128 a {_mm_load_ps(from)};
+	__m128 b {_mm_load_ps(to)};
+	const __m128 cosine {dot(a, b)};
+	// negate the target when the cosine is negative, so that the shortest path is taken
+	b = _mm_xor_ps(b, _mm_and_ps(cosine, _mm_set1_ps(-0.0f)));
+	const float absCosine {std::abs(_mm_cvtss_f32(cosine))};
+	if(absCosine > 0.9995f) {
+		const __m128 res {fmadd(_mm_sub_ps(b, a), _mm_set1_ps(t), a)};
+		_mm_store_ps(out, _mm_div_ps(res, _mm_sqrt_ps(dot(res, res))));
+		return;
+	}
+	const float angle {std::acos(absCosine)};
+	const float sine {std::sin(angle)};
+	const __m128 fromWeight {_mm_set1_ps(std::sin((1.0f - t) * angle) / sine)};
+	const __m128 toWeight {_mm_set1_ps(std::sin(t * angle) / sine)};
+	_mm_store_ps(out, fmadd(a, fromWeight, _mm_mul_ps(b, toWeight)));
+}
+}	 // namespace psl::details
 #endif
@@ -1,14 +1,19 @@
 #pragma once
-#if INSTRUCTION_SET == 1
+#if INSTRUCTION_SET >= 1
 	#include "psl/math/vec.hpp"
+	#include <type_traits>
 	#include <xmmintrin.h>
+
+	#if INSTRUCTION_SET == 1
 namespace psl {
 template <typename precision_t>
 constexpr tvec<precision_t, 4>& operator+=(tvec<precision_t, 4>& owner, const tvec<precision_t, 4>& other) noexcept {
 	if constexpr(std::is_same<float, precision_t>::value) {
 		_mm_store_ps(owner.value.data(), _mm_add_ps(_mm_load_ps(owner.value.data()), _mm_load_ps(other.value.data())));
 	} else if constexpr(std::is_same<double, precision_t>::value) {
-		_mm_store_pd(owner.value.data(), _mm_add_pd(_mm_load_pd(owner.value.data()), _mm_load_pd(other.value.data())));
+		// a register only holds 2 doubles
+		for(size_t i = 0; i < 4; i += 2)
+			_mm_store_pd(&owner.value[i], _mm_add_pd(_mm_load_pd(&owner.value[i]), _mm_load_pd(&other.value[i])));
 	} else {
 		owner.value[0] += other.value[0];
 		owner.value[1] += other.value[1];
@@ -23,7 +28,9 @@ constexpr tvec<precision_t, 4>& operator*=(tvec<precision_t, 4>& owner, const tv
 	if constexpr(std::is_same<float, precision_t>::value) {
 		_mm_store_ps(owner.value.data(), _mm_mul_ps(_mm_load_ps(owner.value.data()), _mm_load_ps(other.value.data())));
 	} else if constexpr(std::is_same<double, precision_t>::value) {
-		_mm_store_pd(owner.value.data(), _mm_mul_pd(_mm_load_pd(owner.value.data()), _mm_load_pd(other.value.data())));
+		// a register only holds 2 doubles
+		for(size_t i = 0; i < 4; i += 2)
+			_mm_store_pd(&owner.value[i], _mm_mul_pd(_mm_load_pd(&owner.value[i]), _mm_load_pd(&other.value[i])));
 	} else {
 		owner.value[0] *= other.value[0];
 		owner.value[1] *= other.value[1];
@@ -36,14 +43,16 @@ constexpr tvec<precision_t, 4>& operator*=(tvec<precision_t, 4>& owner, const tv
 
 template <typename precision_t>
 constexpr tvec<precision_t, 4>& operator/=(tvec<precision_t, 4>& owner, const tvec<precision_t, 4>& other) noexcept {
-	#ifdef MATH_DIV_ZERO_CHECK
+		#ifdef MATH_DIV_ZERO_CHECK
 	if(other.value[0] == 0 || other.value[1] == 0 || other.value[2] == 0 || other.value[3] == 0)
 		throw std::runtime_exception("division by 0");
-	#endif
+		#endif
 	if constexpr(std::is_same<float, precision_t>::value) {
 		_mm_store_ps(owner.value.data(), _mm_div_ps(_mm_load_ps(owner.value.data()), _mm_load_ps(other.value.data())));
 	} else if constexpr(std::is_same<double, precision_t>::value) {
-		_mm_store_pd(owner.value.data(), _mm_div_pd(_mm_load_pd(owner.value.data()), _mm_load_pd(other.value.data())));
+		// a register only holds 2 doubles
+		for(size_t i = 0; i < 4; i += 2)
+			_mm_store_pd(&owner.value[i], _mm_div_pd(_mm_load_pd(&owner.value[i]), _mm_load_pd(&other.value[i])));
 	} else {
 		owner.value[0] /= other.value[0];
 		owner.value[1] /= other.value[1];
@@ -57,7 +66,9 @@ constexpr tvec<precision_t, 4>& operator-=(tvec<precision_t, 4>& owner, const tv
 	if constexpr(std::is_same<float, precision_t>::value) {
 		_mm_store_ps(owner.value.data(), _mm_sub_ps(_mm_load_ps(owner.value.data()), _mm_load_ps(other.value.data())));
 	} else if constexpr(std::is_same<double, precision_t>::value) {
-		_mm_store_pd(owner.value.data(), _mm_sub_pd(_mm_load_pd(owner.value.data()), _mm_load_pd(other.value.data())));
+		// a register only holds 2 doubles
+		for(size_t i = 0; i < 4; i += 2)
+			_mm_store_pd(&owner.value[i], _mm_sub_pd(_mm_load_pd(&owner.value[i]), _mm_load_pd(&other.value[i])));
 	} else {
 		owner.value[0] -= other.value[0];
 		owner.value[1] -= other.value[1];
@@ -67,4 +78,53 @@ constexpr tvec<precision_t, 4>& operator-=(tvec<precision_t, 4>& owner, const tv
 	return owner;
 }
 }	 // namespace psl
+	#endif
+
+namespace psl::details {
+	#if INSTRUCTION_SET < 3
+/// \brief multiply-add operations, `fmadd` is `a * b + c` and `fmsub` is `a * b - c`.
+/// \details AVX2/vec.hpp replaces these with their fused versions, so that the kernels that are shared with the higher
+/// instruction sets use them as well.
+inline __m128 fmadd(__m128 a, __m128 b, __m128 c) noexcept {
+	return _mm_add_ps(_mm_mul_ps(a, b), c);
+}
+inline __m128 fmsub(__m128 a, __m128 b, __m128 c) noexcept {
+	return _mm_sub_ps(_mm_mul_ps(a, b), c);
+}
+	#endif
+
+/// \returns the dot product of the 4 lanes, broadcast to every lane.
+/// \note this is used by the higher instruction sets as well, as it is faster than their `_mm_dp_ps`.
+inline __m128 dot(__m128 left, __m128 right) noexcept {
+	__m128 res {_mm_mul_ps(left, right)};
+	res = _mm_add_ps(res, _mm_shuffle_ps(res, res, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_add_ps(res, _mm_shuffle_ps(res, res, _MM_SHUFFLE(1, 0, 3, 2)));
+}
+
+/// \returns the cross product of the xyz lanes, the w lane is 0 when the w lanes of the inputs are finite.
+inline __m128 cross(__m128 left, __m128 right) noexcept {
+	const __m128 leftYzx {_mm_shuffle_ps(left, left, _MM_SHUFFLE(3, 0, 2, 1))};
+	const __m128 rightYzx {_mm_shuffle_ps(right, right, _MM_SHUFFLE(3, 0, 2, 1))};
+	// this results in the cross product in zxy order
+	const __m128 res {fmsub(left, rightYzx, _mm_mul_ps(leftYzx, right))};
+	return _mm_shuffle_ps(res, res, _MM_SHUFFLE(3, 0, 2, 1));
+}
+}	 // namespace psl::details
+
+namespace psl::math {
+inline constexpr float dot(const tvec<float, 4>& left, const tvec<float, 4>& right) noexcept {
+	if(std::is_constant_evaluated())
+		return dot<float, 4>(left, right);
+	return _mm_cvtss_f32(psl::details::dot(_mm_load_ps(left.value.data()), _mm_load_ps(right.value.data())));
+}
+
+inline constexpr tvec<float, 4> normalize(const tvec<float, 4>& vec) noexcept {
+	if(std::is_constant_evaluated())
+		return normalize<float, 4>(vec);
+	const __m128 value {_mm_load_ps(vec.value.data())};
+	tvec<float, 4> res {};
+	_mm_store_ps(res.value.data(), _mm_div_ps(value, _mm_sqrt_ps(psl::details::dot(value, value))));
+	return res;
+}
+}	 // namespace psl::math
 #endif
@@ -0,0 +1,78 @@
+#pragma once
+#include "psl/array.hpp"
+#include "psl/array_view.hpp"
+#include "psl/math/culling.hpp"
+#include "psl/math/matrix.hpp"
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+
+namespace psl {
+/// \brief subdivides the view frustum of a perspective projection into a grid of clusters (froxels).
+/// \details the clusters are screen space tiles, which are sliced exponentially along the depth, so that the clusters
+/// keep roughly the same proportions from the near to the far plane. Their bounds are stored as view space boxes,
+/// where the camera looks down the negative z axis (as psl::math::look_at does). Clusters are ordered on their x
+/// tile first, then their y tile, then their depth slice, see index().
+class cluster_grid {
+  public:
+	cluster_grid() = default;
+	/// \param[in] projection a projection as created by psl::math::perspective_projection, the sign of its vertical
+	/// axis is ignored, so a flipped projection can be passed as is.
+	/// \param[in] dimensions the amount of tiles on the x and y axis, and the amount of depth slices.
+	cluster_grid(const psl::mat4x4& projection, std::array<uint32_t, 3> dimensions);
+
+	const std::array<uint32_t, 3>& dimensions() const noexcept { return m_Dimensions; }
+	size_t size() const noexcept { return m_Bounds.size(); }
+	float near() const noexcept { return m_Near; }
+	float far() const noexcept { return m_Far; }
+
+	/// \returns the scale and bias that map a view space depth to its slice, as `log(depth) * scale + bias`.
+	std::pair<float, float> slice_transform() const noexcept { return {m_SliceScale, m_SliceBias}; }
+	/// \returns the slice of the (positive) view space depth, clamped to the grid.
+	uint32_t slice(float depth) const noexcept;
+
+	uint32_t index(uint32_t x, uint32_t y, uint32_t slice) const noexcept {
+		return x + m_Dimensions[0] * (y + m_Dimensions[1] * slice);
+	}
+
+	/// \returns the view space bounds of every cluster.
+	const psl::aabb_array& bounds() const noexcept { return m_Bounds; }
+
+  private:
+	std::array<uint32_t, 3> m_Dimensions {0, 0, 0};
+	float m_Near {0.0f};
+	float m_Far {0.0f};
+	float m_SliceScale {0.0f};
+	float m_SliceBias {0.0f};
+	psl::aabb_array m_Bounds {};
+};
+
+/// \brief compact lists of the lights that overlap every cluster of a psl::cluster_grid.
+/// \details the lights of cluster `n` are the indices in [offsets()[n], offsets()[n + 1]).
+class cluster_lights {
+  public:
+	/// \brief rebuilds the lists from (cluster, light) pairs, the lights of a cluster keep the order of the pairs.
+	void build(size_t clusters, psl::array_view<std::pair<uint32_t, uint32_t>> pairs);
+
+	psl::array_view<uint32_t> lights(size_t cluster) const noexcept {
+		return {std::next(std::begin(m_Indices), m_Offsets[cluster]),
+				std::next(std::begin(m_Indices), m_Offsets[cluster + 1])};
+	}
+
+	const psl::array<uint32_t>& offsets() const noexcept { return m_Offsets; }
+	const psl::array<uint32_t>& indices() const noexcept { return m_Indices; }
+
+  private:
+	psl::array<uint32_t> m_Offsets {};
+	psl::array<uint32_t> m_Indices {};
+};
+}	 // namespace psl
+
+namespace psl::math {
+/// \brief writes the indices of the clusters that the view space sphere (light) overlaps.
+/// \details only the clusters of the depth slices the sphere spans are tested, with psl::math::cull.
+/// \param[out] clusters destination of the cluster indices, it should have room for grid.size() indices.
+/// \returns the amount of indices that were written, they are written in ascending order.
+size_t assign(const psl::cluster_grid& grid, const psl::sphere& light, uint32_t* clusters);
+}	 // namespace psl::math
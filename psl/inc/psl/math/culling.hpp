@@ -0,0 +1,139 @@
+#pragma once
+#include "psl/array.hpp"
+#include "psl/math/matrix.hpp"
+#include "psl/math/vec.hpp"
+#include <array>
+#include <cstdint>
+
+namespace psl {
+/// \brief an axis aligned bounding box, described by its center and its half size on every axis.
+struct aabb {
+	psl::vec3 center {0.0f};
+	psl::vec3 extents {0.0f};
+};
+
+/// \brief a sphere, described by its center and radius.
+struct sphere {
+	psl::vec3 center {0.0f};
+	float radius {0.0f};
+};
+
+/// \brief the 6 planes of a view frustum (left, right, bottom, top, near, far).
+/// \details every plane is stored as (normal, distance) with the normal pointing inwards, so a point `p` lies inside of
+/// a plane when `dot(plane.xyz, p) + plane.w >= 0`. The planes do not need to be normalized.
+struct frustum {
+	std::array<psl::vec4, 6> planes {};
+};
+
+/// \brief a collection of axis aligned bounding boxes, stored as a structure of arrays.
+/// \details every component of the centers and extents is stored in its own array, so psl::math::cull can test
+/// several boxes at a time.
+class aabb_array {
+  public:
+	size_t size() const noexcept { return m_Center[0].size(); }
+	void resize(size_t size) {
+		for(auto& axis : m_Center) axis.resize(size);
+		for(auto& axis : m_Extents) axis.resize(size);
+	}
+	void clear() noexcept {
+		for(auto& axis : m_Center) axis.clear();
+		for(auto& axis : m_Extents) axis.clear();
+	}
+
+	/// \note this does not resize the array, so distinct indices can be written to from several threads.
+	void set(size_t index, const aabb& value) noexcept {
+		for(size_t axis = 0; axis < 3; ++axis) {
+			m_Center[axis][index]  = value.center[axis];
+			m_Extents[axis][index] = value.extents[axis];
+		}
+	}
+	aabb get(size_t index) const noexcept {
+		return aabb {psl::vec3 {m_Center[0][index], m_Center[1][index], m_Center[2][index]},
+					 psl::vec3 {m_Extents[0][index], m_Extents[1][index], m_Extents[2][index]}};
+	}
+
+	const float* center(size_t axis) const noexcept { return m_Center[axis].data(); }
+	const float* extents(size_t axis) const noexcept { return m_Extents[axis].data(); }
+
+  private:
+	std::array<psl::array<float>, 3> m_Center {};
+	std::array<psl::array<float>, 3> m_Extents {};
+};
+}	 // namespace psl
+
+namespace psl::math {
+/// \brief extracts the frustum planes from a `projection * view` matrix.
+/// \details the projection is expected to map the depth to [0, 1], as psl::math::perspective_projection does.
+constexpr static psl::frustum to_frustum(const psl::mat4x4& viewProjection) noexcept {
+	// row n of the clip space transform, i.e. clip[n] = dot(row(n), vec4(position, 1))
+	auto row = [&viewProjection](size_t n) {
+		return psl::vec4 {
+		  viewProjection[{0, n}], viewProjection[{1, n}], viewProjection[{2, n}], viewProjection[{3, n}]};
+	};
+	const auto x = row(0);
+	const auto y = row(1);
+	const auto z = row(2);
+	const auto w = row(3);
+	return psl::frustum {{w + x, w - x, w + y, w - y, z, w - z}};
+}
+
+/// \returns the box that encloses the given box after it has been transformed by the matrix.
+constexpr static psl::aabb transform(const psl::aabb& box, const psl::mat4x4& matrix) noexcept {
+	psl::aabb res {};
+	for(size_t axis = 0; axis < 3; ++axis) {
+		res.center[axis]  = matrix[{3, axis}];
+		res.extents[axis] = 0.0f;
+		for(size_t n = 0; n < 3; ++n) {
+			const auto value = matrix[{n, axis}];
+			res.center[axis] += value * box.center[n];
+			res.extents[axis] += ((value < 0.0f) ? -value : value) * box.extents[n];
+		}
+	}
+	return res;
+}
+
+/// \returns false when the box lies fully outside of one of the planes of the frustum.
+/// \note boxes that are not fully outside of any single plane are considered visible, even when they are outside of
+/// the frustum near one of its corners. Boxes with infinite extents are always visible.
+constexpr static bool intersects(const psl::frustum& frustum, const psl::aabb& box) noexcept {
+	for(const auto& plane : frustum.planes) {
+		// the signed distance of the center, plus the extents projected onto the normal
+		float value {plane[3]};
+		for(size_t axis = 0; axis < 3; ++axis) value += plane[axis] * box.center[axis];
+		for(size_t axis = 0; axis < 3; ++axis)
+			value += ((plane[axis] < 0.0f) ? -plane[axis] : plane[axis]) * box.extents[axis];
+		if(value < 0.0f)
+			return false;
+	}
+	return true;
+}
+
+/// \brief writes the indices of the boxes in [begin, end) that intersect the frustum, see intersects().
+/// \details when a SIMD instruction set is enabled, the boxes are tested 4 (SSE) or 8 (AVX) at a time. Distinct
+/// ranges of the same array can be culled in parallel.
+/// \param[in] frustum the frustum to test against.
+/// \param[in] boxes the boxes to test.
+/// \param[in] begin the index of the first box to test.
+/// \param[in] end the index one past the last box to test.
+/// \param[out] visible destination of the indices of the visible boxes, it should have room for `end - begin`
+/// indices.
+/// \returns the amount of indices that were written, they are written in ascending order.
+size_t cull(const psl::frustum& frustum, const psl::aabb_array& boxes, size_t begin, size_t end, uint32_t* visible);
+
+/// \returns true when the sphere overlaps the box, i.e. the closest point of the box lies within the radius.
+constexpr static bool intersects(const psl::sphere& sphere, const psl::aabb& box) noexcept {
+	float distance {0.0f};
+	for(size_t axis = 0; axis < 3; ++axis) {
+		const auto offset = sphere.center[axis] - box.center[axis];
+		const auto value  = ((offset < 0.0f) ? -offset : offset) - box.extents[axis];
+		if(value > 0.0f)
+			distance += value * value;
+	}
+	return distance <= sphere.radius * sphere.radius;
+}
+
+/// \brief writes the indices of the boxes in [begin, end) that the sphere overlaps, see intersects().
+/// \details tests the boxes 4 (SSE) or 8 (AVX) at a time, like the frustum overload does.
+/// \returns the amount of indices that were written, they are written in ascending order.
+size_t cull(const psl::sphere& sphere, const psl::aabb_array& boxes, size_t begin, size_t end, uint32_t* visible);
+}	 // namespace psl::math
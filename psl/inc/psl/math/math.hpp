@@ -19,6 +19,15 @@ namespace psl {
 template <typename precision_t>
 constexpr psl::tvec<precision_t, 3> operator*(const psl::tquat<precision_t>& quat,
 											  const psl::tvec<precision_t, 3>& vec) noexcept {
+#if INSTRUCTION_SET > 0
+	if constexpr(std::is_same_v<precision_t, float>) {
+		if(!std::is_constant_evaluated()) {
+			tvec<precision_t, 3> res {};
+			psl::details::rotate(quat.value.data(), vec.value.data(), res.value.data());
+			return res;
+		}
+	}
+#endif
 	const tvec<precision_t, 3> qVec {quat[0], quat[1], quat[2]};
 	const tvec<precision_t, 3> uv(psl::math::cross(qVec, vec));
 	const tvec<precision_t, 3> uuv(psl::math::cross(qVec, uv));
@@ -106,6 +115,43 @@ constexpr inline auto lerp(precision_t t, const L& left, const R& right) noexcep
 	return res;
 }
 
+/// \brief spherically interpolates between two unit quaternions, along the shortest path.
+/// \details when the quaternions are (nearly) the same, they are linearly interpolated and normalized instead.
+template <typename precision_t>
+constexpr static tquat<precision_t>
+slerp(const tquat<precision_t>& from, const tquat<precision_t>& to, precision_t t) noexcept {
+#if INSTRUCTION_SET > 0
+	if constexpr(std::is_same_v<precision_t, float>) {
+		if(!std::is_constant_evaluated()) {
+			tquat<precision_t> res {};
+			psl::details::slerp(from.value.data(), to.value.data(), t, res.value.data());
+			return res;
+		}
+	}
+#endif
+	auto target = to;
+	auto cosine = dot(from, to);
+	if(cosine < precision_t {0}) {
+		target = tquat<precision_t> {-to[0], -to[1], -to[2], -to[3]};
+		cosine = -cosine;
+	}
+	if(cosine > precision_t {0.9995}) {
+		return normalize(tquat<precision_t> {lerp(t, from[0], target[0]),
+											 lerp(t, from[1], target[1]),
+											 lerp(t, from[2], target[2]),
+											 lerp(t, from[3], target[3])});
+	}
+
+	const precision_t angle		 = acos(cosine);
+	const precision_t sine		 = sin(angle);
+	const precision_t fromWeight = sin((precision_t {1} - t) * angle) / sine;
+	const precision_t toWeight	 = sin(t * angle) / sine;
+	return tquat<precision_t> {from[0] * fromWeight + target[0] * toWeight,
+							   from[1] * fromWeight + target[1] * toWeight,
+							   from[2] * fromWeight + target[2] * toWeight,
+							   from[3] * fromWeight + target[3] * toWeight};
+}
+
 template <typename precision_t>
 constexpr static precision_t saturate(precision_t value) noexcept {
 	return std::clamp(value, precision_t {0}, precision_t {1});
@@ -421,6 +467,74 @@ rotate(const psl::tmat<precision_t, 4, 4>& tmat, const psl::tvec<precision_t, 3>
 	return res;
 }
 
+/// \brief swaps the rows and columns of the matrix.
+template <typename precision_t, size_t columns_n, size_t rows_n>
+constexpr static tmat<precision_t, rows_n, columns_n>
+transpose(const tmat<precision_t, columns_n, rows_n>& mat) noexcept {
+#if INSTRUCTION_SET > 0
+	if constexpr(std::is_same_v<precision_t, float> && columns_n == 4 && rows_n == 4) {
+		if(!std::is_constant_evaluated()) {
+			tmat<precision_t, 4, 4> res {};
+			psl::details::transpose_4x4(mat.value.data(), res.value.data());
+			return res;
+		}
+	}
+#endif
+	tmat<precision_t, rows_n, columns_n> res {};
+	for(size_t row = 0; row < rows_n; ++row) {
+		for(size_t column = 0; column < columns_n; ++column) res[{column, row}] = mat[{row, column}];
+	}
+	return res;
+}
+
+/// \brief inverts the matrix, the matrix is expected to be invertible (its determinant is not 0).
+/// \details the inverse is the adjugate divided by the determinant, both of which are expanded from the 2x2
+/// determinants of the upper and lower halves of the matrix.
+template <typename precision_t>
+constexpr static tmat<precision_t, 4, 4> inverse(const tmat<precision_t, 4, 4>& mat) noexcept {
+#if INSTRUCTION_SET > 0
+	if constexpr(std::is_same_v<precision_t, float>) {
+		if(!std::is_constant_evaluated()) {
+			tmat<precision_t, 4, 4> res {};
+			psl::details::inverse_4x4(mat.value.data(), res.value.data());
+			return res;
+		}
+	}
+#endif
+	// as the inverse of the transpose is the transpose of the inverse, the layout of the components does not matter
+	const auto& m = mat.value;
+	const precision_t s0 {m[0] * m[5] - m[4] * m[1]};
+	const precision_t s1 {m[0] * m[6] - m[4] * m[2]};
+	const precision_t s2 {m[0] * m[7] - m[4] * m[3]};
+	const precision_t s3 {m[1] * m[6] - m[5] * m[2]};
+	const precision_t s4 {m[1] * m[7] - m[5] * m[3]};
+	const precision_t s5 {m[2] * m[7] - m[6] * m[3]};
+	const precision_t c0 {m[8] * m[13] - m[12] * m[9]};
+	const precision_t c1 {m[8] * m[14] - m[12] * m[10]};
+	const precision_t c2 {m[8] * m[15] - m[12] * m[11]};
+	const precision_t c3 {m[9] * m[14] - m[13] * m[10]};
+	const precision_t c4 {m[9] * m[15] - m[13] * m[11]};
+	const precision_t c5 {m[10] * m[15] - m[14] * m[11]};
+	const precision_t reciprocal {precision_t {1} / (s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0)};
+
+	return tmat<precision_t, 4, 4> {(m[5] * c5 - m[6] * c4 + m[7] * c3) * reciprocal,
+									(-m[1] * c5 + m[2] * c4 - m[3] * c3) * reciprocal,
+									(m[13] * s5 - m[14] * s4 + m[15] * s3) * reciprocal,
+									(-m[9] * s5 + m[10] * s4 - m[11] * s3) * reciprocal,
+									(-m[4] * c5 + m[6] * c2 - m[7] * c1) * reciprocal,
+									(m[0] * c5 - m[2] * c2 + m[3] * c1) * reciprocal,
+									(-m[12] * s5 + m[14] * s2 - m[15] * s1) * reciprocal,
+									(m[8] * s5 - m[10] * s2 + m[11] * s1) * reciprocal,
+									(m[4] * c4 - m[5] * c2 + m[7] * c0) * reciprocal,
+									(-m[0] * c4 + m[1] * c2 - m[3] * c0) * reciprocal,
+									(m[12] * s4 - m[13] * s2 + m[15] * s0) * reciprocal,
+									(-m[8] * s4 + m[9] * s2 - m[11] * s0) * reciprocal,
+									(-m[4] * c3 + m[5] * c1 - m[6] * c0) * reciprocal,
+									(m[0] * c3 - m[1] * c1 + m[2] * c0) * reciprocal,
+									(-m[12] * s3 + m[13] * s1 - m[14] * s0) * reciprocal,
+									(m[8] * s3 - m[9] * s1 + m[10] * s0) * reciprocal};
+}
+
 template <typename precision_t>
 constexpr static tmat<precision_t, 3, 3> to_matrix(const psl::tquat<precision_t>& value) noexcept {
 	tmat<precision_t, 3, 3> res {1};
@@ -448,6 +562,71 @@ constexpr static tmat<precision_t, 3, 3> to_matrix(const psl::tquat<precision_t>
 	return res;
 };
 
+/// \brief composes a model matrix, equivalent to `translate(position) * to_matrix(rotation) * scale(scale)`.
+/// \details this writes the closed form of the composition directly, instead of constructing and multiplying the
+/// intermediate matrices.
+template <typename precision_t>
+constexpr static tmat<precision_t, 4, 4> compose(const psl::tvec<precision_t, 3>& position,
+												 const psl::tquat<precision_t>& rotation,
+												 const psl::tvec<precision_t, 3>& scale) noexcept {
+	const auto rotationMat = to_matrix(rotation);
+	tmat<precision_t, 4, 4> res {};
+	for(size_t row = 0; row < 3; ++row) {
+		for(size_t column = 0; column < 3; ++column) res[{row, column}] = rotationMat[{row, column}] * scale[row];
+		res[{row, 3}] = precision_t {0};
+	}
+	res[{3, 0}] = position[0];
+	res[{3, 1}] = position[1];
+	res[{3, 2}] = position[2];
+	res[{3, 3}] = precision_t {1};
+	return res;
+}
+
+/// \brief composes the model matrices of a range of transforms, see compose(position, rotation, scale).
+/// \details the elements of the range are expected to have a `position`, `rotation`, and `scale` member (such as
+/// core::ecs::components::transform), and dereferencing the iterator should return a reference to them. The range
+/// does not need to be contiguous, so it can be any (partial) slice of a component pack.
+/// When a SIMD instruction set is enabled, single precision transforms are composed 4 at a time.
+/// \param[in] first the start of the range of transforms.
+/// \param[in] last the end of the range of transforms.
+/// \param[out] out the destination of the matrices, it should have room for `std::distance(first, last)` elements.
+template <typename iterator_t, typename precision_t>
+static void compose(iterator_t first, iterator_t last, tmat<precision_t, 4, 4>* out) noexcept {
+#if INSTRUCTION_SET > 0
+	if constexpr(std::is_same_v<precision_t, float>) {
+		using transform_t = std::remove_reference_t<decltype(*first)>;
+		const transform_t* transforms[4];
+		while(first != last) {
+			size_t count {0};
+			for(; count < 4 && first != last; ++count, ++first) transforms[count] = &(*first);
+			if(count < 4) {
+				for(size_t i = 0; i < count; ++i)
+					out[i] = compose(transforms[i]->position, transforms[i]->rotation, transforms[i]->scale);
+				return;
+			}
+
+			const float* rotations[4];
+			const float* positions[4];
+			const float* scales[4];
+			float* results[4];
+			for(size_t i = 0; i < 4; ++i) {
+				rotations[i] = transforms[i]->rotation.value.data();
+				positions[i] = transforms[i]->position.value.data();
+				scales[i]	 = transforms[i]->scale.value.data();
+				results[i]	 = out[i].value.data();
+			}
+			psl::details::compose_x4(rotations, positions, scales, results);
+			out += 4;
+		}
+		return;
+	}
+#endif
+	for(; first != last; ++first, ++out) {
+		const auto& transform = *first;
+		*out				  = compose(transform.position, transform.rotation, transform.scale);
+	}
+}
+
 template <typename precision_t>
 static constexpr tquat<precision_t> to_quat(tmat<precision_t, 3, 3> const& mat) noexcept {
 	precision_t fourXSquaredMinus1 = mat[{0, 0}] - mat[{1, 1}] - mat[{2, 2}];
@@ -222,7 +222,7 @@ using mat1x1_sz = tmat<size_t, 1, 1>;
 }	 // namespace psl
 
 
-#include "psl/math/AVX/matrix.hpp"
 #include "psl/math/AVX2/matrix.hpp"
+#include "psl/math/AVX/matrix.hpp"
 #include "psl/math/SSE/matrix.hpp"
 #include "psl/math/fallback/matrix.hpp"
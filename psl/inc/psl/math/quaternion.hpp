@@ -185,7 +185,7 @@ constexpr static tquat<precision_t> inverse(const tquat<precision_t>& quat) {
 }
 }	 // namespace psl::math
 
-#include "psl/math/AVX/quaternion.hpp"
 #include "psl/math/AVX2/quaternion.hpp"
+#include "psl/math/AVX/quaternion.hpp"
 #include "psl/math/SSE/quaternion.hpp"
 #include "psl/math/fallback/quaternion.hpp"
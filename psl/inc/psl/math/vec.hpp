@@ -1369,7 +1369,7 @@ constexpr static tvec<precision_t, 3> cross(const tvec<precision_t, 3>& left,
 }
 }	 // namespace psl::math
 
-#include "psl/math/AVX/vec.hpp"
 #include "psl/math/AVX2/vec.hpp"
+#include "psl/math/AVX/vec.hpp"
 #include "psl/math/SSE/vec.hpp"
 #include "psl/math/fallback/vec.hpp"
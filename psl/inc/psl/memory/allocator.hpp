@@ -2,6 +2,8 @@
 #include "range.hpp"
 #include "segment.hpp"
 #include <cmath>
+#include <deque>
+#include <functional>
 #include <list>
 #include <optional>
 #include <stack>
@@ -95,4 +97,86 @@ class block_allocator : public allocator_base {
 	std::stack<size_t> m_Free;
 	const size_t m_BlockSize;
 };
+
+/// \brief bump allocator that hands out memory linearly from the start of the region.
+///
+/// Allocations are O(1) and only the most recent allocation can be individually deallocated, all other memory is
+/// reclaimed in one go by calling memory::linear_allocator::reset(). This makes it a good fit for data that only lives
+/// for the duration of a frame.
+class linear_allocator : public allocator_base {
+  public:
+	linear_allocator(bool physically_backed = true) : allocator_base(physically_backed) {};
+	virtual ~linear_allocator() = default;
+
+	/// \brief releases all allocations at once, invalidating every segment that was handed out.
+	void reset() noexcept;
+
+	/// \returns the amount of bytes that are still available for allocation.
+	size_t free_size() const noexcept { return m_End - m_Head; }
+
+  private:
+	std::optional<segment> do_allocate(region* region, std::size_t bytes) override;
+	bool do_deallocate(segment& segment) override;
+	void initialize(region* region) override;
+	std::vector<range_t> get_committed() const override;
+	std::vector<range_t> get_available() const override;
+	bool get_owns(const memory::segment& segment) const noexcept override;
+
+	// deque so that the ranges the segments point to stay stable while we grow
+	std::deque<range_t> m_Committed;
+	std::uintptr_t m_Begin {0};
+	std::uintptr_t m_Head {0};
+	std::uintptr_t m_End {0};
+};
+
+/// \brief linear allocator that splits its region into a ring of equally sized frames.
+///
+/// Every frame behaves like a memory::linear_allocator, calling memory::ring_allocator::next_frame() moves to the next
+/// frame and resets it. As the GPU might still be reading from a frame we are about to recycle, a fence can be set
+/// that will be invoked with the frame index right before it gets reused, it should block until it is safe to do so.
+class ring_allocator : public allocator_base {
+  public:
+	using fence_t = std::function<void(size_t frame)>;
+
+	/// \param[in] frames the amount of frames that can be in-flight, 2 for double buffering, 3 for triple buffering.
+	ring_allocator(size_t frames = 3, bool physically_backed = true)
+		: allocator_base(physically_backed), m_Frames(frames) {
+		psl_assert(frames > 0, "a ring_allocator requires atleast one frame");
+	};
+	virtual ~ring_allocator() = default;
+
+	/// \brief advances to the next frame, waiting on its fence (if any) and releasing all of its allocations.
+	void next_frame();
+
+	/// \brief sets the hook that is invoked before a frame gets reused.
+	void fence(fence_t fence) { m_Fence = std::move(fence); }
+
+	/// \returns the index of the frame that is currently being allocated from.
+	size_t frame() const noexcept { return m_Current; }
+	size_t frames() const noexcept { return m_Frames; }
+
+	/// \returns the size (in bytes) of a single frame.
+	size_t frame_size() const noexcept { return m_FrameSize; }
+
+  private:
+	struct frame_t {
+		std::deque<range_t> committed;
+		std::uintptr_t begin {0};
+		std::uintptr_t head {0};
+		std::uintptr_t end {0};
+	};
+
+	std::optional<segment> do_allocate(region* region, std::size_t bytes) override;
+	bool do_deallocate(segment& segment) override;
+	void initialize(region* region) override;
+	std::vector<range_t> get_committed() const override;
+	std::vector<range_t> get_available() const override;
+	bool get_owns(const memory::segment& segment) const noexcept override;
+
+	std::vector<frame_t> m_Ring;
+	fence_t m_Fence {};
+	size_t m_Current {0};
+	size_t m_FrameSize {0};
+	const size_t m_Frames;
+};
 }	 // namespace memory
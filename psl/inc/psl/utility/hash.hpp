@@ -0,0 +1,12 @@
+#pragma once
+#include <cstdint>
+
+namespace psl::utility {
+/// \brief mixes the value into the seed, so that a sequence of values results in a single hash.
+/// \details the order of the values matters, combining `a` then `b` results in a different hash than `b` then `a`.
+/// \param[in, out] seed the hash that is being accumulated.
+/// \param[in] value the (hash of the) value to mix in.
+constexpr void hash_combine(uint64_t& seed, uint64_t value) noexcept {
+	seed ^= value + 0x9e3779b97f4a7c15 + (seed << 6) + (seed >> 2);
+}
+}	 // namespace psl::utility
@@ -2,6 +2,11 @@
 #include "psl/platform_def.hpp"
 #if defined(PLATFORM_WINDOWS)
 	#include <Windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
 #endif
 #include "psl/logging.hpp"
 
@@ -91,20 +96,74 @@ file::file(psl::string_view filename,
 	// Calculate the pointer to the data.
 	m_Data = (psl::char_t*)m_MapView.value() + view_delta;
 
-	if(length) {
-		m_ContentSize = length.value();
-	} else {
-		auto view_ = psl::string_view {&m_Data[0], m_Size};
+	// trailing zeroes are not trimmed, binary content (such as SPIR-V) can end on them
+	m_ContentSize = m_Size;
+#else
+	int flags = (mode == mode::READ) ? O_RDONLY : O_RDWR;	 // mapping for writing requires read access as well
+	switch(method) {
+	case method::OPEN:
+		break;
+	case method::OPEN_OR_CREATE:
+		flags |= O_CREAT;
+		break;
+	case method::CREATE:
+		flags |= O_CREAT | O_EXCL;
+		break;
+	case method::TRUNCATE:
+		flags |= O_TRUNC;
+		break;
+	case method::TRUNCATE_OR_CREATE:
+		flags |= O_CREAT | O_TRUNC;
+		break;
+	}
+
+	m_Descriptor = ::open(psl::to_string8_t(filename).c_str(), flags, 0644);
+	if(m_Descriptor == -1)
+		return;
+
+	struct stat file_stat;
+	if(fstat(m_Descriptor, &file_stat) == -1) {
+		close();
+		return;
+	}
 
-		size_t index = m_Size;
-		for(auto it = std::end(view_) - 1; it != std::begin(view_); --it) {
-			if(*it != _T('\0')) {
-				break;
-			}
-			--index;
-		}
-		m_ContentSize = index;
+	const size_t file_size	= static_cast<size_t>(file_stat.st_size);
+	const size_t page_size	= static_cast<size_t>(sysconf(_SC_PAGE_SIZE));
+	const size_t offset_val = offset.value_or(0u);
+
+	if(!length && offset_val >= file_size) {
+		close();
+		return;
+	}
+	m_Size = length.value_or(file_size - offset_val);
+
+	// grow the file in case we are mapping for writing beyond its end
+	if(mode != mode::READ && offset_val + m_Size > file_size &&
+	   ftruncate(m_Descriptor, static_cast<off_t>(offset_val + m_Size)) == -1) {
+		close();
+		return;
 	}
+	if(m_Size == 0) {
+		close();
+		return;
+	}
+
+	auto file_start = (offset_val / page_size) * page_size;
+	auto view_delta = offset_val - file_start;
+	m_MapSize		= view_delta + m_Size;
+
+	auto permission = (mode == mode::READ) ? PROT_READ : PROT_READ | PROT_WRITE;
+	auto view		= mmap(nullptr, m_MapSize, permission, MAP_SHARED, m_Descriptor, static_cast<off_t>(file_start));
+	if(view == MAP_FAILED) {
+		m_MapSize = 0;
+		close();
+		return;
+	}
+	m_MapView = view;
+	m_Data	  = (psl::char_t*)m_MapView + view_delta;
+
+	// trailing zeroes are not trimmed, binary content (such as SPIR-V) can end on them
+	m_ContentSize = m_Size;
 #endif
 }
 
@@ -136,6 +195,48 @@ bool file::close() {
 	}
 	return success;
 #else
-	throw std::runtime_error("not implemented");
+	bool success = true;
+	if(m_MapView && munmap(m_MapView, m_MapSize) == -1) {
+		spdlog::get("main")->error("Error occurred during the closing of the mmap view with error: {}", errno);
+		success = false;
+	}
+	m_MapView = nullptr;
+	m_MapSize = 0;
+	if(m_Descriptor != -1 && ::close(m_Descriptor) == -1) {
+		spdlog::get("main")->error("Error occurred during the closing of the file handle with error: {}", errno);
+		success = false;
+	}
+	m_Descriptor = -1;
+	m_Data		 = nullptr;
+	return success;
+#endif
+}
+
+bool file::advise(advice hint) const noexcept {
+#ifdef PLATFORM_WINDOWS
+	return false;
+#else
+	if(!m_MapView)
+		return false;
+
+	int flag = MADV_NORMAL;
+	switch(hint) {
+	case advice::NORMAL:
+		flag = MADV_NORMAL;
+		break;
+	case advice::SEQUENTIAL:
+		flag = MADV_SEQUENTIAL;
+		break;
+	case advice::RANDOM:
+		flag = MADV_RANDOM;
+		break;
+	case advice::WILL_NEED:
+		flag = MADV_WILLNEED;
+		break;
+	case advice::DONT_NEED:
+		flag = MADV_DONTNEED;
+		break;
+	}
+	return madvise(m_MapView, m_MapSize, flag) == 0;
 #endif
 }
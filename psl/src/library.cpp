@@ -3,6 +3,7 @@
 #include "psl/platform_utils.hpp"
 #include "psl/serialization/encoder.hpp"
 #include "psl/serialization/polymorphic.hpp"
+#include <fstream>
 
 using namespace psl::meta;
 using namespace psl::serialization;
@@ -237,6 +238,31 @@ std::optional<psl::string8::view> library::load(const UID& uid) {
 	if(it->second.flags[0] != true || it->second.file_data.size() > 0)
 		return it->second.file_data;
 
+	if(auto mapping = m_MappingLookup.find(uid); mapping != std::end(m_MappingLookup)) {
+		m_Mappings.splice(std::begin(m_Mappings), m_Mappings, mapping->second);
+		const auto& file = *mapping->second->file;
+		return psl::string8::view {reinterpret_cast<const psl::string8::char_t*>(file.data().value()), file.size()};
+	}
+
+	auto path = psl::from_string8_t(m_LibraryFolder) + utility::platform::directory::seperator +
+				psl::from_string8_t(it->second.readableName);
+	if(auto file = std::make_unique<utility::os::file>(
+		 path, utility::os::file::mode::READ, utility::os::file::method::OPEN);
+	   *file && m_MappingCapacity > 0) {
+		file->advise(utility::os::file::advice::SEQUENTIAL);
+		file->advise(utility::os::file::advice::WILL_NEED);
+		auto view = psl::string8::view {reinterpret_cast<const psl::string8::char_t*>(file->data().value()), file->size()};
+
+		m_Mappings.emplace_front(mapping_t {uid, std::move(file)});
+		m_MappingLookup[uid] = std::begin(m_Mappings);
+		while(m_Mappings.size() > m_MappingCapacity) {
+			m_MappingLookup.erase(m_Mappings.back().uid);
+			m_Mappings.pop_back();
+		}
+		return view;
+	}
+
+	// fallback for files that cannot be mapped (such as empty files)
 	if(auto res =
 		 utility::platform::file::read(psl::from_string8_t(m_LibraryFolder) + utility::platform::directory::seperator +
 									   psl::from_string8_t(it->second.readableName));
@@ -249,13 +275,47 @@ std::optional<psl::string8::view> library::load(const UID& uid) {
 
 bool library::unload(const UID& uid) {
 	auto it = m_MetaData.find(uid);
-	if(it == std::end(m_MetaData) || it->second.flags[0] != true || it->second.file_data.empty())
+	if(it == std::end(m_MetaData) || it->second.flags[0] != true)
+		return false;
+
+	if(auto mapping = m_MappingLookup.find(uid); mapping != std::end(m_MappingLookup)) {
+		m_Mappings.erase(mapping->second);
+		m_MappingLookup.erase(mapping);
+		return true;
+	}
+
+	if(it->second.file_data.empty())
 		return false;
 
 	it->second.file_data = {};
 	return true;
 }
 
+bool library::write(const UID& uid, psl::string8::view content) {
+	auto it = m_MetaData.find(uid);
+	if(it == std::end(m_MetaData) || it->second.flags[0] != true)
+		return false;
+
+	// release the mapping before truncating the file underneath it
+	unload(uid);
+
+	std::ofstream output {psl::from_string8_t(m_LibraryFolder) + utility::platform::directory::seperator +
+							psl::from_string8_t(it->second.readableName),
+						  std::ios::trunc | std::ios::out | std::ios::binary};
+	if(!output.is_open())
+		return false;
+	output.write(content.data(), content.size());
+	return output.good();
+}
+
+void library::mapping_capacity(size_t capacity) {
+	m_MappingCapacity = capacity;
+	while(m_Mappings.size() > m_MappingCapacity) {
+		m_MappingLookup.erase(m_Mappings.back().uid);
+		m_Mappings.pop_back();
+	}
+}
+
 
 void library::replace_content(psl::UID uid, psl::string8_t content) noexcept {
 	if(auto it = m_MetaData.find(uid); it != std::end(m_MetaData)) {
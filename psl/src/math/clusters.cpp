@@ -0,0 +1,76 @@
+#include "psl/math/clusters.hpp"
+#include "psl/math/math.hpp"
+#include <algorithm>
+#include <cmath>
+
+using namespace psl;
+
+#undef near
+#undef far
+
+cluster_grid::cluster_grid(const psl::mat4x4& projection, std::array<uint32_t, 3> dimensions)
+	: m_Dimensions(dimensions) {
+	// see psl::math::perspective_projection, clip.x = x / (aspect * tan(fov / 2)), and clip.w = -z
+	const float scaleX = projection[{0, 0}];
+	const float scaleY = std::abs(projection[{1, 1}]);
+	m_Near			   = projection[{3, 2}] / projection[{2, 2}];
+	m_Far			   = projection[{3, 2}] / (projection[{2, 2}] + 1.0f);
+
+	const auto slices = static_cast<float>(m_Dimensions[2]);
+	m_SliceScale	  = slices / std::log(m_Far / m_Near);
+	m_SliceBias		  = -slices * std::log(m_Near) / std::log(m_Far / m_Near);
+
+	m_Bounds.resize(static_cast<size_t>(m_Dimensions[0]) * m_Dimensions[1] * m_Dimensions[2]);
+	for(uint32_t z = 0; z < m_Dimensions[2]; ++z) {
+		const float near = m_Near * std::pow(m_Far / m_Near, static_cast<float>(z) / slices);
+		const float far	 = m_Near * std::pow(m_Far / m_Near, static_cast<float>(z + 1) / slices);
+		for(uint32_t y = 0; y < m_Dimensions[1]; ++y) {
+			const float top	   = -1.0f + 2.0f * static_cast<float>(y) / static_cast<float>(m_Dimensions[1]);
+			const float bottom = -1.0f + 2.0f * static_cast<float>(y + 1) / static_cast<float>(m_Dimensions[1]);
+			for(uint32_t x = 0; x < m_Dimensions[0]; ++x) {
+				const float left  = -1.0f + 2.0f * static_cast<float>(x) / static_cast<float>(m_Dimensions[0]);
+				const float right = -1.0f + 2.0f * static_cast<float>(x + 1) / static_cast<float>(m_Dimensions[0]);
+
+				// the tile widens with the depth, so its extremes are either on the near or on the far plane
+				const vec3 min {std::min(left * near, left * far) / scaleX,
+								std::min(top * near, top * far) / scaleY,
+								-far};
+				const vec3 max {std::max(right * near, right * far) / scaleX,
+								std::max(bottom * near, bottom * far) / scaleY,
+								-near};
+				m_Bounds.set(index(x, y, z), aabb {(min + max) * 0.5f, (max - min) * 0.5f});
+			}
+		}
+	}
+}
+
+uint32_t cluster_grid::slice(float depth) const noexcept {
+	if(depth <= m_Near)
+		return 0;
+	const auto value = std::log(depth) * m_SliceScale + m_SliceBias;
+	return std::min(static_cast<uint32_t>(std::max(value, 0.0f)), m_Dimensions[2] - 1);
+}
+
+void cluster_lights::build(size_t clusters, psl::array_view<std::pair<uint32_t, uint32_t>> pairs) {
+	// a counting sort on the cluster, the offsets are first used to count, and then as the insertion points
+	m_Offsets.assign(clusters + 1, 0u);
+	for(const auto& [cluster, light] : pairs) ++m_Offsets[cluster + 1];
+	for(size_t i = 1; i < m_Offsets.size(); ++i) m_Offsets[i] += m_Offsets[i - 1];
+
+	m_Indices.resize(pairs.size());
+	psl::array<uint32_t> next {std::begin(m_Offsets), std::prev(std::end(m_Offsets))};
+	for(const auto& [cluster, light] : pairs) m_Indices[next[cluster]++] = light;
+}
+
+size_t psl::math::assign(const psl::cluster_grid& grid, const psl::sphere& light, uint32_t* clusters) {
+	const float depth = -light.center[2];
+	if(grid.size() == 0 || depth + light.radius < grid.near() || depth - light.radius > grid.far())
+		return 0;
+
+	// the slices are widened by one on either side, so that rounding in slice() never skips a cluster, the box tests
+	// are exact
+	const auto slices = grid.dimensions()[0] * grid.dimensions()[1];
+	const auto first  = grid.slice(depth - light.radius);
+	const auto last	  = std::min(grid.slice(depth + light.radius) + 1, grid.dimensions()[2] - 1);
+	return cull(light, grid.bounds(), (first > 0 ? first - 1 : 0) * slices, (last + 1) * slices, clusters);
+}
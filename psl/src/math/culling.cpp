@@ -0,0 +1,167 @@
+#include "psl/math/culling.hpp"
+#include <bit>
+
+#if INSTRUCTION_SET >= 2
+	#include <immintrin.h>
+#elif INSTRUCTION_SET == 1
+	#include <xmmintrin.h>
+#endif
+
+using namespace psl;
+
+namespace {
+/// \brief appends the indices of the set bits of the mask, offset by the given index.
+inline size_t compact(uint32_t mask, size_t index, uint32_t* visible) noexcept {
+	size_t count {0};
+	while(mask != 0) {
+		visible[count++] = static_cast<uint32_t>(index + std::countr_zero(mask));
+		mask &= mask - 1;
+	}
+	return count;
+}
+}	 // namespace
+
+size_t psl::math::cull(
+  const psl::frustum& frustum, const psl::aabb_array& boxes, size_t begin, size_t end, uint32_t* visible) {
+	const float* cx = boxes.center(0);
+	const float* cy = boxes.center(1);
+	const float* cz = boxes.center(2);
+	const float* ex = boxes.extents(0);
+	const float* ey = boxes.extents(1);
+	const float* ez = boxes.extents(2);
+
+	size_t count {0};
+	size_t i {begin};
+#if INSTRUCTION_SET >= 2
+	// the planes are splatted once, every lane tests the same plane against a different box.
+	__m256 normal[6][3];
+	__m256 absolute[6][3];
+	__m256 distance[6];
+	for(size_t p = 0; p < 6; ++p) {
+		for(size_t axis = 0; axis < 3; ++axis) {
+			const float value	= frustum.planes[p][axis];
+			normal[p][axis]		= _mm256_set1_ps(value);
+			absolute[p][axis]	= _mm256_set1_ps((value < 0.0f) ? -value : value);
+		}
+		distance[p] = _mm256_set1_ps(frustum.planes[p][3]);
+	}
+	const __m256 zero {_mm256_setzero_ps()};
+
+	for(; i + 8 <= end; i += 8) {
+		const __m256 x {_mm256_loadu_ps(cx + i)};
+		const __m256 y {_mm256_loadu_ps(cy + i)};
+		const __m256 z {_mm256_loadu_ps(cz + i)};
+		const __m256 w {_mm256_loadu_ps(ex + i)};
+		const __m256 h {_mm256_loadu_ps(ey + i)};
+		const __m256 d {_mm256_loadu_ps(ez + i)};
+
+		__m256 outside {zero};
+		for(size_t p = 0; p < 6; ++p) {
+			__m256 value {_mm256_add_ps(_mm256_mul_ps(normal[p][0], x), distance[p])};
+			value = _mm256_add_ps(_mm256_mul_ps(normal[p][1], y), value);
+			value = _mm256_add_ps(_mm256_mul_ps(normal[p][2], z), value);
+			value = _mm256_add_ps(_mm256_mul_ps(absolute[p][0], w), value);
+			value = _mm256_add_ps(_mm256_mul_ps(absolute[p][1], h), value);
+			value = _mm256_add_ps(_mm256_mul_ps(absolute[p][2], d), value);
+			// ordered comparison, so boxes with NaN distances (infinite extents) are never culled
+			outside = _mm256_or_ps(outside, _mm256_cmp_ps(value, zero, _CMP_LT_OQ));
+		}
+		count += compact(~static_cast<uint32_t>(_mm256_movemask_ps(outside)) & 0xFFu, i, visible + count);
+	}
+#elif INSTRUCTION_SET == 1
+	__m128 normal[6][3];
+	__m128 absolute[6][3];
+	__m128 distance[6];
+	for(size_t p = 0; p < 6; ++p) {
+		for(size_t axis = 0; axis < 3; ++axis) {
+			const float value = frustum.planes[p][axis];
+			normal[p][axis]	  = _mm_set1_ps(value);
+			absolute[p][axis] = _mm_set1_ps((value < 0.0f) ? -value : value);
+		}
+		distance[p] = _mm_set1_ps(frustum.planes[p][3]);
+	}
+	const __m128 zero {_mm_setzero_ps()};
+
+	for(; i + 4 <= end; i += 4) {
+		const __m128 x {_mm_loadu_ps(cx + i)};
+		const __m128 y {_mm_loadu_ps(cy + i)};
+		const __m128 z {_mm_loadu_ps(cz + i)};
+		const __m128 w {_mm_loadu_ps(ex + i)};
+		const __m128 h {_mm_loadu_ps(ey + i)};
+		const __m128 d {_mm_loadu_ps(ez + i)};
+
+		__m128 outside {zero};
+		for(size_t p = 0; p < 6; ++p) {
+			__m128 value {_mm_add_ps(_mm_mul_ps(normal[p][0], x), distance[p])};
+			value = _mm_add_ps(_mm_mul_ps(normal[p][1], y), value);
+			value = _mm_add_ps(_mm_mul_ps(normal[p][2], z), value);
+			value = _mm_add_ps(_mm_mul_ps(absolute[p][0], w), value);
+			value = _mm_add_ps(_mm_mul_ps(absolute[p][1], h), value);
+			value = _mm_add_ps(_mm_mul_ps(absolute[p][2], d), value);
+			outside = _mm_or_ps(outside, _mm_cmplt_ps(value, zero));
+		}
+		count += compact(~static_cast<uint32_t>(_mm_movemask_ps(outside)) & 0xFu, i, visible + count);
+	}
+#endif
+	for(; i < end; ++i) {
+		if(intersects(frustum, psl::aabb {psl::vec3 {cx[i], cy[i], cz[i]}, psl::vec3 {ex[i], ey[i], ez[i]}}))
+			visible[count++] = static_cast<uint32_t>(i);
+	}
+	return count;
+}
+
+size_t psl::math::cull(
+  const psl::sphere& sphere, const psl::aabb_array& boxes, size_t begin, size_t end, uint32_t* visible) {
+	const float* cx = boxes.center(0);
+	const float* cy = boxes.center(1);
+	const float* cz = boxes.center(2);
+	const float* ex = boxes.extents(0);
+	const float* ey = boxes.extents(1);
+	const float* ez = boxes.extents(2);
+
+	size_t count {0};
+	size_t i {begin};
+#if INSTRUCTION_SET >= 2
+	const __m256 sx {_mm256_set1_ps(sphere.center[0])};
+	const __m256 sy {_mm256_set1_ps(sphere.center[1])};
+	const __m256 sz {_mm256_set1_ps(sphere.center[2])};
+	const __m256 radius {_mm256_set1_ps(sphere.radius * sphere.radius)};
+	const __m256 sign {_mm256_set1_ps(-0.0f)};
+	const __m256 zero {_mm256_setzero_ps()};
+	// the squared distance from the sphere to the boxes on a single axis, i.e. max(|center - sphere| - extents, 0)^2
+	auto distance = [&sign, &zero, &i](const float* center, const float* extents, __m256 position) {
+		const __m256 offset {_mm256_andnot_ps(sign, _mm256_sub_ps(_mm256_loadu_ps(center + i), position))};
+		const __m256 value {_mm256_max_ps(_mm256_sub_ps(offset, _mm256_loadu_ps(extents + i)), zero)};
+		return _mm256_mul_ps(value, value);
+	};
+
+	for(; i + 8 <= end; i += 8) {
+		const __m256 value {
+		  _mm256_add_ps(_mm256_add_ps(distance(cx, ex, sx), distance(cy, ey, sy)), distance(cz, ez, sz))};
+		count += compact(
+		  static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(value, radius, _CMP_LE_OQ))), i, visible + count);
+	}
+#elif INSTRUCTION_SET == 1
+	const __m128 sx {_mm_set1_ps(sphere.center[0])};
+	const __m128 sy {_mm_set1_ps(sphere.center[1])};
+	const __m128 sz {_mm_set1_ps(sphere.center[2])};
+	const __m128 radius {_mm_set1_ps(sphere.radius * sphere.radius)};
+	const __m128 sign {_mm_set1_ps(-0.0f)};
+	const __m128 zero {_mm_setzero_ps()};
+	auto distance = [&sign, &zero, &i](const float* center, const float* extents, __m128 position) {
+		const __m128 offset {_mm_andnot_ps(sign, _mm_sub_ps(_mm_loadu_ps(center + i), position))};
+		const __m128 value {_mm_max_ps(_mm_sub_ps(offset, _mm_loadu_ps(extents + i)), zero)};
+		return _mm_mul_ps(value, value);
+	};
+
+	for(; i + 4 <= end; i += 4) {
+		const __m128 value {_mm_add_ps(_mm_add_ps(distance(cx, ex, sx), distance(cy, ey, sy)), distance(cz, ez, sz))};
+		count += compact(static_cast<uint32_t>(_mm_movemask_ps(_mm_cmple_ps(value, radius))), i, visible + count);
+	}
+#endif
+	for(; i < end; ++i) {
+		if(intersects(sphere, psl::aabb {psl::vec3 {cx[i], cy[i], cz[i]}, psl::vec3 {ex[i], ey[i], ez[i]}}))
+			visible[count++] = static_cast<uint32_t>(i);
+	}
+	return count;
+}
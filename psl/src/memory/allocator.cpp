@@ -288,3 +288,137 @@ bool block_allocator::get_owns(const memory::segment& segment) const noexcept {
 						[&segment](const memory::range_t& range)	// expensive search
 						{ return &segment.range() == &range; }) != std::end(m_Ranges);
 }
+
+namespace {
+std::uintptr_t align_up(std::uintptr_t value, size_t alignment) {
+	auto mod = (alignment) ? value % alignment : 0;
+	return (mod) ? value + alignment - mod : value;
+}
+
+// bumps the head, and records the allocation in the committed list, returns nullptr when out of memory.
+range_t*
+bump(std::uintptr_t head, std::uintptr_t end, std::size_t bytes, size_t alignment, std::deque<range_t>& committed) {
+	auto begin = align_up(head, alignment);
+	bytes	   = align_up(bytes, alignment);
+	if(begin > end || end - begin < bytes)
+		return nullptr;
+	return &committed.emplace_back(begin, begin + bytes);
+}
+}	 // namespace
+
+void linear_allocator::initialize(region* region) {
+	m_Begin = (std::uintptr_t)(region->data());
+	m_Head	= m_Begin;
+	m_End	= m_Begin + region->size();
+}
+
+void linear_allocator::reset() noexcept {
+	m_Committed.clear();
+	m_Head = m_Begin;
+}
+
+std::optional<segment> linear_allocator::do_allocate(region* region, std::size_t bytes) {
+	auto range = bump(m_Head, m_End, bytes, region->alignment(), m_Committed);
+	if(!range)
+		return {};
+
+	if(!commit(*range)) {
+		m_Committed.pop_back();
+		return {};
+	}
+	m_Head = range->end;
+	return std::optional<segment> {std::in_place_t {}, *range, is_physically_backed()};
+}
+
+bool linear_allocator::do_deallocate(segment& segment) {
+	// only the last allocation can be rewound, everything else is released on reset
+	if(m_Committed.empty() || m_Committed.back() != segment.range())
+		return false;
+	m_Head = m_Committed.back().begin;
+	m_Committed.pop_back();
+	return true;
+}
+
+std::vector<range_t> linear_allocator::get_committed() const {
+	return std::vector<range_t> {std::begin(m_Committed), std::end(m_Committed)};
+}
+
+std::vector<range_t> linear_allocator::get_available() const {
+	if(m_Head == m_End)
+		return {};
+	return std::vector<range_t> {{m_Head, m_End}};
+}
+
+bool linear_allocator::get_owns(const memory::segment& segment) const noexcept {
+	return segment.range().begin >= m_Begin && segment.range().end <= m_Head;
+}
+
+void ring_allocator::initialize(region* region) {
+	m_FrameSize = region->size() / m_Frames;
+	if(auto mod = (region->alignment()) ? m_FrameSize % region->alignment() : 0; mod != 0)
+		m_FrameSize -= mod;
+
+	m_Ring.resize(m_Frames);
+	auto begin = (std::uintptr_t)(region->data());
+	for(auto& frame : m_Ring) {
+		frame.begin = begin;
+		frame.head	= begin;
+		frame.end	= begin + m_FrameSize;
+		begin		= frame.end;
+	}
+}
+
+void ring_allocator::next_frame() {
+	m_Current	= (m_Current + 1) % m_Frames;
+	auto& frame = m_Ring[m_Current];
+	if(m_Fence)
+		m_Fence(m_Current);
+	frame.committed.clear();
+	frame.head = frame.begin;
+}
+
+std::optional<segment> ring_allocator::do_allocate(region* region, std::size_t bytes) {
+	auto& frame = m_Ring[m_Current];
+	auto range	= bump(frame.head, frame.end, bytes, region->alignment(), frame.committed);
+	if(!range)
+		return {};
+
+	if(!commit(*range)) {
+		frame.committed.pop_back();
+		return {};
+	}
+	frame.head = range->end;
+	return std::optional<segment> {std::in_place_t {}, *range, is_physically_backed()};
+}
+
+bool ring_allocator::do_deallocate(segment& segment) {
+	auto& frame = m_Ring[m_Current];
+	if(frame.committed.empty() || frame.committed.back() != segment.range())
+		return false;
+	frame.head = frame.committed.back().begin;
+	frame.committed.pop_back();
+	return true;
+}
+
+std::vector<range_t> ring_allocator::get_committed() const {
+	std::vector<range_t> res {};
+	for(const auto& frame : m_Ring)
+		res.insert(std::end(res), std::begin(frame.committed), std::end(frame.committed));
+	std::sort(std::begin(res), std::end(res));
+	return res;
+}
+
+std::vector<range_t> ring_allocator::get_available() const {
+	std::vector<range_t> res {};
+	for(const auto& frame : m_Ring) {
+		if(frame.head != frame.end)
+			res.emplace_back(frame.head, frame.end);
+	}
+	return res;
+}
+
+bool ring_allocator::get_owns(const memory::segment& segment) const noexcept {
+	return std::any_of(std::begin(m_Ring), std::end(m_Ring), [&segment](const frame_t& frame) {
+		return segment.range().begin >= frame.begin && segment.range().end <= frame.head;
+	});
+}
@@ -147,4 +147,82 @@ auto m = litmus::suite<"memory">(litmus::generator::range<size_t, 0, 2> {}) = []
 		}
 	};
 };
+
+auto m_linear = litmus::suite<"memory::linear_allocator">() = []() {
+	using namespace litmus;
+	const size_t alignment	 = 16;
+	const size_t region_size = 1024 * 64;
+	auto allocator			 = new memory::linear_allocator {true};
+	memory::region region {region_size, alignment, allocator};
+
+	section<"allocations are sequential and aligned">() = [&] {
+		std::uintptr_t previous = 0u;
+		for(auto i = 0; i < 100; ++i) {
+			auto segm = region.allocate(size_set[1][i % size_set[1].size()] + 3);
+			require(segm.has_value());
+			require(segm.value().range().begin % alignment) == 0;
+			require(segm.value().range().begin) >= previous;
+			previous = segm.value().range().end;
+		}
+		require(used_size(region) + free_size(region)) == region.size();
+		allocator->reset();
+		require(used_size(region)) == 0;
+		require(free_size(region)) == region.size();
+	};
+
+	section<"only the last allocation can be rewound">() = [&] {
+		auto first	= region.allocate(64);
+		auto second = region.allocate(64);
+		require(first.has_value());
+		require(second.has_value());
+		require(!region.deallocate(first));
+		require(region.deallocate(second));
+		auto third = region.allocate(32);
+		require(third.value().range().begin) == second.value().range().begin;
+		allocator->reset();
+	};
+
+	section<"exhaustion">() = [&] {
+		require(region.allocate(region.size()).has_value());
+		require(!region.allocate(1).has_value());
+		allocator->reset();
+		require(region.allocate(1).has_value());
+		allocator->reset();
+	};
+};
+
+auto m_ring = litmus::suite<"memory::ring_allocator">() = []() {
+	using namespace litmus;
+	const size_t frames		 = 3;
+	const size_t alignment	 = 4;
+	const size_t region_size = 1024 * 12;
+	auto allocator			 = new memory::ring_allocator {frames, true};
+	memory::region region {region_size, alignment, allocator};
+
+	std::vector<size_t> fenced {};
+	allocator->fence([&fenced](size_t frame) { fenced.emplace_back(frame); });
+
+	require(allocator->frame_size() * frames) <= region.size();
+
+	std::vector<memory::range_t> first_allocations {};
+	for(size_t frame = 0; frame < frames; ++frame) {
+		auto segm = region.allocate(allocator->frame_size());
+		require(segm.has_value());
+		first_allocations.emplace_back(segm.value().range());
+		require(!region.allocate(1).has_value());
+		allocator->next_frame();
+	}
+
+	// each frame owns its own, non-overlapping, part of the region
+	for(size_t i = 1; i < frames; ++i) require(first_allocations[i - 1].end) <= first_allocations[i].begin;
+
+	require(fenced.size()) == frames;
+	require(fenced.back()) == 0;
+	require(allocator->frame()) == 0;
+
+	// we wrapped around, so frame 0 was released and starts at the same location again
+	auto segm = region.allocate(16);
+	require(segm.has_value());
+	require(segm.value().range().begin) == first_allocations[0].begin;
+};
 }	 // namespace
@@ -1,5 +1,7 @@
 #include "task_test.hpp"
+#include "psl/async/batch.hpp"
 #include "psl/async/scheduler.hpp"
+#include <algorithm>
 #include <chrono>
 
 namespace async = psl::async;
@@ -160,4 +162,17 @@ auto t2 = litmus::suite<"tasks with inter-memory-dependencies">(12) = [](size_t
 		  return sum + value.get();
 	  })) == (iteration_count / shared_output.size()) * calculated_value;
 };
+
+auto t3 = litmus::suite<"batched workers">() = []() {
+	litmus::require(async::batch(0, [](size_t, size_t) {}).size()) == 0;
+
+	// every element is visited exactly once, including the remainder of the last batch
+	std::vector<int> visits(1021, 0);
+	auto workers = async::batch(visits.size(), [&visits](size_t begin, size_t end) {
+		for(auto i = begin; i < end; ++i) visits[i] += 1;
+	});
+	litmus::require(workers.size()) <= std::max<size_t>(1, std::thread::hardware_concurrency());
+	for(auto& worker : workers) worker.get();
+	litmus::require(std::count(std::begin(visits), std::end(visits), 1)) == visits.size();
+};
 }	 // namespace
@@ -0,0 +1,56 @@
+#include "psl/algorithm.hpp"
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <litmus/expect.hpp>
+#include <litmus/section.hpp>
+#include <litmus/suite.hpp>
+
+using namespace litmus;
+
+namespace {
+// sorts the keys along with their original index, and compares against a stable comparison sort
+void radix_matches_stable_sort(std::vector<uint64_t> keys) {
+	std::vector<uint32_t> values(keys.size());
+	std::iota(std::begin(values), std::end(values), 0u);
+
+	std::vector<std::pair<uint64_t, uint32_t>> expected {};
+	for(size_t i = 0; i < keys.size(); ++i) expected.emplace_back(keys[i], values[i]);
+	std::stable_sort(std::begin(expected), std::end(expected), [](const auto& lhs, const auto& rhs) {
+		return lhs.first < rhs.first;
+	});
+
+	std::vector<uint64_t> keysScratch(keys.size());
+	std::vector<uint32_t> valuesScratch(keys.size());
+	psl::sorting::radix(keys.data(), values.data(), keys.size(), keysScratch.data(), valuesScratch.data());
+	for(size_t i = 0; i < keys.size(); ++i) {
+		require(keys[i]) == expected[i].first;
+		require(values[i]) == expected[i].second;
+	}
+}
+
+auto t0 = suite<"radix", "psl", "algorithm">() = []() {
+	std::mt19937_64 generator {1337};
+
+	section<"random keys">() = [&] {
+		std::vector<uint64_t> keys(4099);
+		for(auto& key : keys) key = generator();
+		radix_matches_stable_sort(keys);
+	};
+
+	section<"packed keys with duplicates">() = [&] {
+		// only a few bits are in use, so most passes are skipped, and many keys are identical
+		std::uniform_int_distribution<uint64_t> field {0, 7};
+		std::vector<uint64_t> keys(1000);
+		for(auto& key : keys) key = (field(generator) << 56) | (field(generator) << 40) | (field(generator) << 24);
+		radix_matches_stable_sort(keys);
+	};
+
+	section<"empty and single">() = [&] {
+		radix_matches_stable_sort({});
+		radix_matches_stable_sort({42});
+	};
+};
+}	 // namespace
@@ -0,0 +1,82 @@
+#include "psl/math/clusters.hpp"
+#include "psl/math/math.hpp"
+#include <random>
+#include <vector>
+
+#include <litmus/expect.hpp>
+#include <litmus/section.hpp>
+#include <litmus/suite.hpp>
+
+using namespace litmus;
+using namespace psl;
+
+namespace {
+auto t0 = suite<"clusters", "psl", "math">() = []() {
+	const cluster_grid grid {math::perspective_projection(math::radians(60.0f), 1.5f, 0.5f, 200.0f), {16, 9, 24}};
+
+	std::mt19937 generator {1337};
+	std::uniform_real_distribution<float> position {-60.0f, 60.0f};
+	std::uniform_real_distribution<float> depth {-220.0f, 5.0f};
+	std::uniform_real_distribution<float> radius {0.1f, 12.0f};
+	std::vector<sphere> lights(257);
+	for(auto& light : lights)
+		light = sphere {vec3 {position(generator), position(generator), depth(generator)}, radius(generator)};
+
+	section<"grid">() = [&] {
+		require(grid.size()) == size_t {16 * 9 * 24};
+		require(math::abs(grid.near() - 0.5f)) <= 0.0001f;
+		require(math::abs(grid.far() - 200.0f)) <= 0.01f;
+		require(grid.slice(0.1f)) == 0u;
+		require(grid.slice(0.6f)) == 0u;
+		require(grid.slice(199.0f)) == 23u;
+		require(grid.slice(1000.0f)) == 23u;
+
+		// every slice starts where the previous one ended, and every tile of a slice covers the same depth
+		for(uint32_t z = 0; z + 1 < 24; ++z) {
+			const auto current = grid.bounds().get(grid.index(15, 8, z));
+			const auto next	   = grid.bounds().get(grid.index(0, 0, z + 1));
+			require(math::abs((current.center[2] - current.extents[2]) - (next.center[2] + next.extents[2]))) <=
+			  0.001f;
+		}
+	};
+
+	section<"cull spheres matches the scalar reference">() = [&] {
+		const std::vector<std::pair<size_t, size_t>> ranges {{0, grid.size()}, {3, 1030}, {8, 16}, {5, 7}};
+		for(const auto& light : lights) {
+			for(auto [begin, end] : ranges) {
+				std::vector<uint32_t> expected {};
+				for(size_t i = begin; i < end; ++i) {
+					if(math::intersects(light, grid.bounds().get(i)))
+						expected.emplace_back(static_cast<uint32_t>(i));
+				}
+
+				std::vector<uint32_t> result(end - begin);
+				result.resize(math::cull(light, grid.bounds(), begin, end, result.data()));
+				require(result == expected);
+			}
+		}
+	};
+
+	section<"assign matches brute force">() = [&] {
+		std::vector<std::pair<uint32_t, uint32_t>> pairs {};
+		std::vector<uint32_t> clusters(grid.size());
+		for(uint32_t light = 0; light < lights.size(); ++light) {
+			const auto count = math::assign(grid, lights[light], clusters.data());
+			for(size_t i = 0; i < count; ++i) pairs.emplace_back(clusters[i], light);
+		}
+
+		cluster_lights result {};
+		result.build(grid.size(), pairs);
+		require(result.indices().size()) == pairs.size();
+		for(size_t cluster = 0; cluster < grid.size(); ++cluster) {
+			std::vector<uint32_t> expected {};
+			for(uint32_t light = 0; light < lights.size(); ++light) {
+				if(math::intersects(lights[light], grid.bounds().get(cluster)))
+					expected.emplace_back(light);
+			}
+			const auto assigned = result.lights(cluster);
+			require(std::vector<uint32_t>(std::begin(assigned), std::end(assigned)) == expected);
+		}
+	};
+};
+}	 // namespace
@@ -0,0 +1,74 @@
+#include "psl/math/culling.hpp"
+#include "psl/math/math.hpp"
+#include <random>
+#include <vector>
+
+#include <litmus/expect.hpp>
+#include <litmus/section.hpp>
+#include <litmus/suite.hpp>
+
+using namespace litmus;
+using namespace psl;
+
+namespace {
+auto t0 = suite<"culling", "psl", "math">() = []() {
+	// looks down the positive z axis from the origin
+	const auto frustum =
+	  math::to_frustum(math::perspective_projection(math::radians(60.0f), 1.5f, 0.1f, 100.0f) *
+					   math::look_at(vec3 {0.0f, 0.0f, 0.0f}, vec3 {0.0f, 0.0f, 1.0f}, vec3::up));
+
+	section<"intersects">() = [&] {
+		require(math::intersects(frustum, aabb {vec3 {0.0f, 0.0f, 10.0f}, vec3 {1.0f}}));
+		// behind the camera, and beyond the far plane
+		require(!math::intersects(frustum, aabb {vec3 {0.0f, 0.0f, -10.0f}, vec3 {1.0f}}));
+		require(!math::intersects(frustum, aabb {vec3 {0.0f, 0.0f, 200.0f}, vec3 {1.0f}}));
+		// next to, and partially overlapping the sides of the frustum
+		require(!math::intersects(frustum, aabb {vec3 {100.0f, 0.0f, 10.0f}, vec3 {1.0f}}));
+		require(!math::intersects(frustum, aabb {vec3 {0.0f, -100.0f, 10.0f}, vec3 {1.0f}}));
+		require(math::intersects(frustum, aabb {vec3 {100.0f, 0.0f, 10.0f}, vec3 {95.0f, 1.0f, 1.0f}}));
+		require(math::intersects(frustum, aabb {vec3 {0.0f, 0.0f, -1.0f}, vec3 {2.0f}}));
+		require(math::intersects(frustum, aabb {vec3 {0.0f, 0.0f, -10.0f}, vec3::infinity}));
+	};
+
+	section<"transform">() = [&] {
+		const auto model  = math::compose(vec3 {5.0f, 0.0f, 0.0f},
+										  math::angle_axis(math::radians(90.0f), vec3 {0.0f, 1.0f, 0.0f}),
+										  vec3 {2.0f, 1.0f, 1.0f});
+		const auto result = math::transform(aabb {vec3 {1.0f, 0.0f, 0.0f}, vec3 {1.0f, 2.0f, 3.0f}}, model);
+		for(size_t axis = 0; axis < 3; ++axis) {
+			require(math::abs(result.center[axis] - vec3 {5.0f, 0.0f, -2.0f}[axis])) <= 0.0001f;
+			require(math::abs(result.extents[axis] - vec3 {3.0f, 2.0f, 2.0f}[axis])) <= 0.0001f;
+		}
+	};
+
+	section<"cull matches the scalar reference">() = [&] {
+		std::mt19937 generator {1337};
+		std::uniform_real_distribution<float> position {-150.0f, 150.0f};
+		std::uniform_real_distribution<float> extent {0.0f, 8.0f};
+
+		aabb_array boxes {};
+		boxes.resize(1031);
+		for(size_t i = 0; i < boxes.size(); ++i) {
+			boxes.set(
+			  i,
+			  aabb {vec3 {position(generator), position(generator), position(generator)},
+					vec3 {extent(generator), extent(generator), extent(generator)}});
+		}
+
+		// ranges that start and end both on, and in between, the boundaries of the SIMD widths
+		const std::vector<std::pair<size_t, size_t>> ranges {{0, 1031}, {0, 1024}, {3, 1030}, {8, 16}, {5, 7}};
+		for(auto [begin, end] : ranges) {
+			std::vector<uint32_t> expected {};
+			for(size_t i = begin; i < end; ++i) {
+				if(math::intersects(frustum, boxes.get(i)))
+					expected.emplace_back(static_cast<uint32_t>(i));
+			}
+
+			std::vector<uint32_t> visible(end - begin);
+			visible.resize(math::cull(frustum, boxes, begin, end, visible.data()));
+			require(visible.size()) == expected.size();
+			require(visible == expected);
+		}
+	};
+};
+}	 // namespace
@@ -0,0 +1,41 @@
+#include "core/gfx/drawlist.hpp"
+
+#include <litmus/expect.hpp>
+#include <litmus/section.hpp>
+#include <litmus/suite.hpp>
+
+using namespace litmus;
+using core::gfx::drawlayer;
+using core::gfx::drawlist;
+
+namespace {
+auto t0 = suite<"drawlist", "core", "gfx">() = []() {
+	section<"keys">() = [] {
+		require(drawlist::key(256, 0, 0, 0)) != drawlist::key(0, 0, 0, 0);
+		require(drawlist::key(1, 0, 0, 0)) > drawlist::key(0, 65535, 65535, 65535);
+		require(drawlist::key(0, 1, 0, 0)) > drawlist::key(0, 0, 65535, 65535);
+		require(drawlist::key(0, 0, 1, 0)) > drawlist::key(0, 0, 0, 65535);
+	};
+
+	section<"more layers than fit a byte">() = [] {
+		// one layer per render index, like the drawpasses build their lists per segment
+		constexpr uint32_t count = 1000;
+		drawlist list {};
+		for(uint32_t i = 0; i < count; ++i) list.add_layer(drawlayer {"layer", i, 1});
+
+		// added in reverse, so the sort has to move every draw
+		for(uint32_t i = count; i > 0; --i) {
+			const auto layer = i - 1;
+			list.add(drawlist::key(layer, 0, 0, 0), drawlist::draw_t {{}, {}, {}, layer, layer, 1});
+		}
+		list.sort();
+
+		require(list.size()) == count;
+		for(uint32_t i = 0; i < count; ++i) {
+			require(list[i].layer) == i;
+			if(i > 0)
+				require(list.sort_key(i)) > list.sort_key(i - 1);
+		}
+	};
+};
+}	 // namespace
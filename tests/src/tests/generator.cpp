@@ -1,5 +1,9 @@
 #include "tests/generator.hpp"
 #include "psl/generator.hpp"
+#include <algorithm>
+#include <optional>
+#include <random>
+#include <vector>
 
 #include <litmus/expect.hpp>
 #include <litmus/section.hpp>
@@ -85,4 +89,105 @@ auto t0 = litmus::suite<"psl::generator">() = []() {
 	require(generator.capacity()) == generator.available() + accumulated;
 	require(generator.size()) == accumulated;
 };
+
+// a naive model of the generator, which tracks every id, and creates ids from the first free range that fits
+struct reference_t {
+	std::vector<bool> used;
+
+	std::optional<uint32_t> create(uint32_t count) {
+		for(uint32_t first = 0, last = 0; last < used.size(); ++last) {
+			if(used[last]) {
+				first = last + 1;
+			} else if(last + 1 - first == count) {
+				std::fill(std::next(std::begin(used), first), std::next(std::begin(used), last + 1), true);
+				return first;
+			}
+		}
+		return std::nullopt;
+	}
+
+	bool valid(uint32_t id, uint32_t count) const {
+		for(auto i = id; i < id + count; ++i) {
+			if(i < used.size() && !used[i])
+				return false;
+		}
+		return true;
+	}
+
+	uint32_t available() const { return static_cast<uint32_t>(std::count(std::begin(used), std::end(used), false)); }
+
+	uint32_t largest() const {
+		uint32_t res {0}, current {0};
+		for(bool id : used) {
+			current = id ? 0 : current + 1;
+			res		= std::max(res, current);
+		}
+		return res;
+	}
+};
+
+auto t1 = litmus::suite<"fragmented", "psl", "generator">() = []() {
+	using litmus::require;
+	std::mt19937 random {1337};
+	std::uniform_int_distribution<uint32_t> size {1, 8};
+
+	psl::generator<uint32_t> generator {512};
+	reference_t reference {std::vector<bool>(512, false)};
+	for(size_t i = 0; i < 4096; ++i) {
+		const auto count = size(random);
+		const auto id	 = std::uniform_int_distribution<uint32_t> {0, generator.capacity() - 1}(random);
+		switch(random() % 4) {
+		case 0:
+		case 1: {
+			uint32_t created {};
+			auto expected = reference.create(count);
+			require(generator.try_create(created, count)) == expected.has_value();
+			if(expected)
+				require(created) == expected.value();
+		} break;
+		case 2: {
+			// destroying ids that are (partially) free, or out of range, is refused
+			const bool expected = id + count <= generator.capacity() && reference.valid(id, count);
+			require(generator.valid(id, count)) == reference.valid(id, count);
+			require(generator.destroy(id, count)) == expected;
+			if(expected)
+				std::fill(
+				  std::next(std::begin(reference.used), id), std::next(std::begin(reference.used), id + count), false);
+		} break;
+		case 3: {
+			if(reference.available() < count * 4)
+				break;
+			uint32_t created {0};
+			for(auto [first, last] : generator.create_multi(count * 4)) {
+				for(auto id = first; id < last; ++id) {
+					require(reference.used[id]) == false;
+					reference.used[id] = true;
+				}
+				created += last - first;
+			}
+			require(created) == count * 4;
+		} break;
+		}
+		require(generator.available()) == reference.available();
+		require(generator.size()) == generator.capacity() - reference.available();
+		require(generator.largest_continuous_range()) == reference.largest();
+	}
+
+	// growing frees the new ids, shrinking is only allowed when the dropped ids are free
+	const auto capacity = generator.capacity();
+	require(generator.resize(capacity + 64));
+	reference.used.resize(capacity + 64, false);
+	require(generator.available()) == reference.available();
+	require(generator.create(4)) == reference.create(4).value();
+
+	psl::generator<uint32_t> small {16};
+	require(small.create(8)) == 0u;
+	require(!small.resize(4));
+	require(small.resize(8));
+	require(small.available()) == 0u;
+	uint32_t id {};
+	require(!small.try_create(id));
+	require(small.resize(12));
+	require(small.create(4)) == 8u;
+};
 }
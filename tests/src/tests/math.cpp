@@ -0,0 +1,199 @@
+#include "psl/math/math.hpp"
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <litmus/expect.hpp>
+#include <litmus/section.hpp>
+#include <litmus/suite.hpp>
+
+using namespace litmus;
+using namespace psl;
+
+// Double precision values always take the scalar path (the one the fallback backend takes for every type), so the
+// results of the single precision SIMD kernels of the selected instruction set are compared against them.
+namespace {
+constexpr double epsilon {0.0001};
+
+template <size_t N>
+double max_difference(const psl::static_array<float, N>& value, const psl::static_array<double, N>& expected) {
+	double res {0.0};
+	for(size_t i = 0; i < N; ++i) res = std::max(res, std::abs(static_cast<double>(value[i]) - expected[i]));
+	return res;
+}
+
+template <typename result_t, size_t N>
+result_t widen(const psl::static_array<float, N>& value) {
+	result_t res {};
+	for(size_t i = 0; i < N; ++i) res[i] = value[i];
+	return res;
+}
+
+dmat4x4 widen(const mat4x4& value) {
+	return widen<dmat4x4>(value.value);
+}
+dquat widen(const quat& value) {
+	return widen<dquat>(value.value);
+}
+dvec4 widen(const vec4& value) {
+	return widen<dvec4>(value.value);
+}
+dvec3 widen(const vec3& value) {
+	return widen<dvec3>(value.value);
+}
+
+/// \brief reference model matrix, composed out of the individual transformations in double precision.
+dmat4x4 reference_compose(const vec3& position, const quat& rotation, const vec3& scale) {
+	const auto rotation3x3 = math::to_matrix(widen(rotation));
+	dmat4x4 rotation4x4 {1.0};
+	for(size_t row = 0; row < 3; ++row) {
+		for(size_t column = 0; column < 3; ++column) rotation4x4[{row, column}] = rotation3x3[{row, column}];
+	}
+	return math::translate(widen(position)) * rotation4x4 * math::scale(widen(scale));
+}
+
+struct transform_t {
+	vec3 position;
+	quat rotation;
+	vec3 scale;
+};
+
+auto t0 = suite<"simd", "psl", "math">() = []() {
+	std::mt19937 generator {1337};
+	std::uniform_real_distribution<float> distribution {-1.0f, 1.0f};
+	auto random_matrix = [&]() {
+		// the diagonal is weighted, so that the matrix is well conditioned
+		mat4x4 res {};
+		for(size_t i = 0; i < 16; ++i) res[i] = distribution(generator);
+		for(size_t i = 0; i < 4; ++i) res[{i, i}] += 4.0f;
+		return res;
+	};
+	auto random_quat = [&]() {
+		return math::normalize(
+		  quat {distribution(generator), distribution(generator), distribution(generator), distribution(generator)});
+	};
+
+	section<"matrix::multiply">() = [&] {
+		for(size_t i = 0; i < 100; ++i) {
+			const auto left	 = random_matrix();
+			const auto right = random_matrix();
+			require(max_difference((left * right).value, (widen(left) * widen(right)).value)) <= epsilon;
+		}
+	};
+
+	section<"matrix::transpose">() = [&] {
+		for(size_t i = 0; i < 100; ++i) {
+			const auto mat = random_matrix();
+			const auto res = math::transpose(mat);
+			for(size_t row = 0; row < 4; ++row) {
+				for(size_t column = 0; column < 4; ++column) require(res[{column, row}]) == mat[{row, column}];
+			}
+			require(math::transpose(res).value) == mat.value;
+		}
+	};
+
+	section<"matrix::inverse">() = [&] {
+		const dmat4x4 identity {1.0};
+		for(size_t i = 0; i < 100; ++i) {
+			const auto mat	   = random_matrix();
+			const auto inverse = math::inverse(mat);
+			require(max_difference(inverse.value, math::inverse(widen(mat)).value)) <= epsilon;
+			require(max_difference((mat * inverse).value, identity.value)) <= epsilon;
+		}
+		// a model matrix, as created from a transform
+		const auto model =
+		  math::compose(vec3 {5.0f, -3.0f, 12.0f}, math::normalize(quat {0.3f, 0.5f, -0.1f, 0.8f}), vec3 {2.0f});
+		require(max_difference((math::inverse(model) * model).value, identity.value)) <= epsilon;
+	};
+
+	section<"vectors::geometry">() = [&] {
+		for(size_t i = 0; i < 100; ++i) {
+			const vec4 left {distribution(generator), distribution(generator), distribution(generator), 1.0f};
+			const vec4 right {distribution(generator), distribution(generator), distribution(generator), 0.5f};
+			require(std::abs(math::dot(left, right) - math::dot(widen(left), widen(right)))) <= epsilon;
+			require(max_difference(math::normalize(left).value, math::normalize(widen(left)).value)) <= epsilon;
+		}
+	};
+
+	section<"vectors::double operators">() = [&] {
+		// all 4 components take part in the operations of the double precision registers
+		dvec4 value {1.0, 2.0, 3.0, 4.0};
+		value += dvec4 {4.0, 3.0, 2.0, 1.0};
+		require(value) == dvec4 {5.0, 5.0, 5.0, 5.0};
+		value *= dvec4 {1.0, 2.0, 3.0, 4.0};
+		require(value) == dvec4 {5.0, 10.0, 15.0, 20.0};
+		value -= dvec4 {1.0, 2.0, 3.0, 4.0};
+		require(value) == dvec4 {4.0, 8.0, 12.0, 16.0};
+		value /= dvec4 {2.0, 4.0, 8.0, 16.0};
+		require(value) == dvec4 {2.0, 2.0, 1.5, 1.0};
+
+		dquat quat {1.0, 2.0, 3.0, 4.0};
+		quat += dquat {4.0, 3.0, 2.0, 1.0};
+		require(quat) == dquat {5.0, 5.0, 5.0, 5.0};
+		quat -= dquat {1.0, 2.0, 3.0, 4.0};
+		require(quat) == dquat {4.0, 3.0, 2.0, 1.0};
+	};
+
+	section<"matrix::compose">() = [&] {
+		auto random_transform = [&]() {
+			return transform_t {
+			  vec3 {distribution(generator), distribution(generator), distribution(generator)} * 10.0f,
+			  random_quat(),
+			  vec3 {distribution(generator) + 2.0f, distribution(generator) + 2.0f, distribution(generator) + 2.0f}};
+		};
+		for(size_t i = 0; i < 100; ++i) {
+			const auto transform = random_transform();
+			const auto expected	 = reference_compose(transform.position, transform.rotation, transform.scale);
+			require(max_difference(math::compose(transform.position, transform.rotation, transform.scale).value,
+								   expected.value)) <= epsilon;
+		}
+
+		// the SIMD path composes 4 transforms at a time, the remainder takes the scalar path
+		for(size_t count : {0u, 1u, 4u, 37u}) {
+			std::vector<transform_t> transforms(count);
+			for(auto& transform : transforms) transform = random_transform();
+			std::vector<mat4x4> results(count);
+			math::compose(std::begin(transforms), std::end(transforms), results.data());
+			for(size_t i = 0; i < count; ++i) {
+				const auto expected =
+				  reference_compose(transforms[i].position, transforms[i].rotation, transforms[i].scale);
+				require(max_difference(results[i].value, expected.value)) <= epsilon;
+			}
+		}
+	};
+
+	section<"quaternions::rotate">() = [&] {
+		for(size_t i = 0; i < 100; ++i) {
+			const auto rotation = random_quat();
+			const vec3 vec {distribution(generator), distribution(generator), distribution(generator)};
+			const auto expected = math::rotate(widen(rotation), widen(vec));
+			require(max_difference(math::rotate(rotation, vec).value, expected.value)) <= epsilon;
+		}
+	};
+
+	section<"quaternions::slerp">() = [&] {
+		for(size_t i = 0; i < 100; ++i) {
+			const auto from = random_quat();
+			const auto to	= random_quat();
+			const auto t	= (distribution(generator) + 1.0f) * 0.5f;
+			const auto expected = math::slerp(widen(from), widen(to), double {t});
+			require(max_difference(math::slerp(from, to, t).value, expected.value)) <= epsilon;
+		}
+
+		// the shortest path is taken, so negating the target (which is the same rotation) does not change the result
+		const auto from = math::normalize(quat {0.1f, 0.2f, 0.3f, 0.9f});
+		const auto to	= math::normalize(quat {-0.7f, 0.1f, 0.4f, -0.2f});
+		const quat negated {-to[0], -to[1], -to[2], -to[3]};
+		require(max_difference(math::slerp(from, to, 0.5f).value, widen(math::slerp(from, negated, 0.5f)).value)) <=
+		  epsilon;
+		require(max_difference(math::slerp(from, to, 0.0f).value, widen(from).value)) <= epsilon;
+		// these are more than 90 degrees apart, so the path ends at the negated target
+		require(max_difference(math::slerp(from, to, 1.0f).value, widen(negated).value)) <= epsilon;
+
+		// (nearly) identical quaternions are linearly interpolated instead
+		const auto close = math::normalize(quat {0.1f, 0.2f, 0.3f, 0.9001f});
+		require(max_difference(math::slerp(from, close, 0.25f).value,
+							   math::slerp(widen(from), widen(close), 0.25).value)) <= epsilon;
+	};
+};
+}	 // namespace
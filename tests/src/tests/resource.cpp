@@ -0,0 +1,232 @@
+#include "core/logging.hpp"
+#include "core/resource/details/pool.hpp"
+#include "core/resource/resource.hpp"
+#include "spdlog/sinks/null_sink.h"
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+#include <litmus/expect.hpp>
+#include <litmus/section.hpp>
+#include <litmus/suite.hpp>
+
+using namespace litmus;
+using namespace core::resource;
+
+namespace {
+struct dummy_resource {
+	dummy_resource(cache_t& cache, const metadata& metaData, psl::meta::file* metaFile, size_t value) noexcept
+		: value(value) {}
+
+	size_t value;
+};
+
+struct other_resource {
+	other_resource(cache_t& cache, const metadata& metaData, psl::meta::file* metaFile) noexcept {}
+};
+
+struct settings_resource {
+	friend class psl::serialization::accessor;
+
+	settings_resource() = default;
+	settings_resource(cache_t& cache, const metadata& metaData, psl::meta::file* metaFile, size_t offset) noexcept
+		: offset(offset) {}
+
+	template <typename S>
+	void serialize(S& serializer) {
+		serializer << m_Value;
+	}
+	static constexpr psl::string8::view serialization_name {"SETTINGS"};
+
+	psl::serialization::property<"VALUE", uint32_t> m_Value {0};
+	size_t offset {0};
+};
+
+psl::string8_t settings_content(uint32_t value) {
+	settings_resource settings {};
+	settings.m_Value = value;
+	psl::format::container container {};
+	psl::serialization::serializer s;
+	s.serialize<psl::serialization::encode_to_format>(settings, container);
+	return container.to_string();
+}
+
+psl::meta::library make_library() {
+	if(!core::log)
+		core::log = spdlog::null_logger_mt("main");
+	auto path = std::filesystem::temp_directory_path() / "resource_tests.metalib";
+	if(!std::filesystem::exists(path))
+		std::ofstream {path};
+	return psl::meta::library {psl::to_string8_t(path.string())};
+}
+
+/// library with a physical entry of which the content is missing on disk.
+psl::meta::library make_library(const psl::UID& missing) {
+	if(!core::log)
+		core::log = spdlog::null_logger_mt("main");
+	auto folder = std::filesystem::temp_directory_path() / "resource_tests";
+	std::filesystem::create_directories(folder);
+	auto path = folder / "missing_content.metalib";
+	psl::meta::file meta {missing};
+	psl::serialization::serializer s;
+	s.serialize<psl::serialization::encode_to_format>(&meta,
+													  psl::to_string8_t((folder / "missing.data.meta").string()));
+	std::filesystem::remove(folder / "missing.data");
+	std::ofstream {path} << "[UID=" << missing.to_string() << "][PATH=missing.data][METAPATH=missing.data.meta]\n";
+	return psl::meta::library {psl::to_string8_t(path.string())};
+}
+
+auto t0 = suite<"slab", "core", "resource">() = []() {
+	details::slab<size_t, 4> slab {};
+
+	section<"addresses are stable">() = [&] {
+		std::vector<size_t*> values {};
+		for(size_t i = 0; i < 9; ++i) values.emplace_back(slab.create(i));
+		require(slab.size()) == 9;
+		require(slab.capacity()) == 12;
+		// growing the slab does not move the objects that were created before
+		for(size_t i = 0; i < values.size(); ++i) require(*values[i]) == i;
+		for(auto* value : values) slab.destroy(value);
+		require(slab.size()) == 0;
+	};
+
+	section<"destroyed slots are reused">() = [&] {
+		auto* first	 = slab.create(size_t {1});
+		auto* second = slab.create(size_t {2});
+		slab.destroy(first);
+		auto* third = slab.create(size_t {3});
+		require(third) == first;
+		require(*second) == 2;
+		require(slab.size()) == 2;
+		slab.destroy(second);
+		slab.destroy(third);
+	};
+
+	section<"reserved storage can be released">() = [&] {
+		auto* storage = slab.reserve();
+		require(slab.size()) == 1;
+		slab.release(storage);
+		require(slab.size()) == 0;
+		require(slab.reserve()) == storage;
+		slab.release(storage);
+	};
+};
+
+auto t1 = suite<"cache_t", "core", "resource">() = []() {
+	section<"dense index">() = [&] {
+		cache_t cache {make_library()};
+		auto first	= cache.create<dummy_resource>(size_t {1});
+		auto second = cache.create<dummy_resource>(size_t {2});
+		require(first.resource_metadata()->index) != second.resource_metadata()->index;
+
+		auto found = cache.at<dummy_resource>(second.resource_metadata()->index);
+		require(found.state()) == status::loaded;
+		require(found.uid()) == second.uid();
+		require(found->value) == 2;
+
+		// the type has to match, and indices that were never handed out resolve to nothing
+		require(cache.at<other_resource>(first.resource_metadata()->index).state()) == status::invalid;
+		require(cache.at<dummy_resource>(second.resource_metadata()->index + 1).state()) == status::invalid;
+	};
+
+	section<"reuse after free">() = [&] {
+		cache_t cache {make_library()};
+		auto freed		 = cache.create<dummy_resource>(size_t {3});
+		const auto index = freed.resource_metadata()->index;
+		const auto uid	 = freed.uid();
+		require(cache.free(freed));
+		require(freed.state()) == status::unloaded;
+
+		// the index is only recycled once the cache erases the unloaded resource
+		freed = {};
+		cache.free();
+		require(!cache.contains(uid));
+		require(cache.at<dummy_resource>(index).state()) == status::invalid;
+
+		auto reused = cache.create<other_resource>();
+		require(reused.resource_metadata()->index) == index;
+		require(cache.at<dummy_resource>(index).state()) == status::invalid;
+		require(cache.at<other_resource>(index).state()) == status::loaded;
+	};
+};
+
+auto t2 = suite<"cache_t::instantiate_async", "core", "resource">() = []() {
+	section<"loaded once finalized">() = [&] {
+		cache_t cache {make_library()};
+		auto uid = cache.library().create<psl::meta::file>(settings_content(42)).first;
+
+		auto settings = cache.instantiate_async<settings_resource>(uid, size_t {7});
+		require(settings.state()) == status::loading;
+		require(!settings);
+		require(cache.await(settings));
+		require(settings.state()) == status::loaded;
+		require(settings->m_Value.value) == 42u;
+		require(settings->offset) == 7;
+	};
+
+	section<"polling finalizes every load">() = [&] {
+		cache_t cache {make_library()};
+		psl::array<handle<settings_resource>> handles {};
+		for(uint32_t i = 0; i < 16; ++i) {
+			auto uid = cache.library().create<psl::meta::file>(settings_content(i)).first;
+			handles.emplace_back(cache.instantiate_async<settings_resource>(uid, size_t {i}));
+		}
+		while(cache.poll() > 0) std::this_thread::yield();
+		for(uint32_t i = 0; i < handles.size(); ++i) {
+			require(handles[i].state()) == status::loaded;
+			require(handles[i]->m_Value.value) == i;
+		}
+	};
+
+	section<"missing content">() = [&] {
+		const auto missing = psl::UID::generate();
+		cache_t cache {make_library(missing)};
+
+		auto settings = cache.instantiate_async<settings_resource>(missing, size_t {0});
+		const auto uid = settings.uid();
+		require(settings.state()) == status::invalid;
+		require(!settings);
+		require(settings.resource_metadata() != nullptr);
+		require(!cache.await(settings));
+
+		// the reserved storage is only given back once nothing refers to it anymore
+		auto copy = settings;
+		settings  = {};
+		cache.free();
+		require(copy.state()) == status::invalid;
+		require(cache.contains(uid));
+
+		copy = {};
+		cache.free();
+		require(!cache.contains(uid));
+	};
+
+	section<"unknown resource">() = [&] {
+		cache_t cache {make_library()};
+		auto settings = cache.instantiate_async<settings_resource>(psl::UID::generate(), size_t {0});
+		require(settings.state()) == status::missing;
+	};
+};
+
+auto t3 = suite<"psl::meta::library::create_physical", "core", "resource">() = []() {
+	auto library	= make_library();
+	const auto uid	= psl::UID::generate();
+	const auto file = std::filesystem::temp_directory_path() / "resource_tests.cache";
+	std::filesystem::remove(file);
+
+	library.create_physical(uid, "resource_tests.cache");
+	require(library.is_physical_file(uid));
+	// the file does not exist until it is written
+	require(!library.load(uid).has_value());
+	require(library.write(uid, "cached"));
+	require(library.load(uid).value()) == psl::string8::view {"cached"};
+	require(std::filesystem::exists(file));
+
+	// resources created for the UID use the physical entry, rather than replacing it
+	cache_t cache {std::move(library)};
+	auto resource = cache.create_using<other_resource>(uid);
+	require(resource.state()) == status::loaded;
+	require(cache.library().is_physical_file(uid));
+};
+}	 // namespace